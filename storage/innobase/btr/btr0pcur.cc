@@ -169,6 +169,7 @@ btr_pcur_store_position(
 
 	cursor->block_when_stored = block;
 	cursor->modify_clock = buf_block_get_modify_clock(block);
+	cursor->withdraw_clock = buf_withdraw_clock;
 }
 
 /**************************************************************//**
@@ -256,6 +257,7 @@ btr_pcur_restore_position_func(
 		cursor->latch_mode = latch_mode;
 		cursor->pos_state = BTR_PCUR_IS_POSITIONED;
 		cursor->block_when_stored = btr_pcur_get_block(cursor);
+		cursor->withdraw_clock = buf_withdraw_clock;
 
 		return(FALSE);
 	}
@@ -263,8 +265,10 @@ btr_pcur_restore_position_func(
 	ut_a(cursor->old_rec);
 	ut_a(cursor->old_n_fields);
 
-	if (UNIV_LIKELY(latch_mode == BTR_SEARCH_LEAF)
-	    || UNIV_LIKELY(latch_mode == BTR_MODIFY_LEAF)) {
+	if ((UNIV_LIKELY(latch_mode == BTR_SEARCH_LEAF)
+	     || UNIV_LIKELY(latch_mode == BTR_MODIFY_LEAF))
+	    /* The block may have been freed by a buffer pool resize. */
+	    && !buf_pool_is_obsolete(cursor->withdraw_clock)) {
 		/* Try optimistic restoration. */
 
 		if (buf_page_optimistic_get(latch_mode,
@@ -362,6 +366,7 @@ btr_pcur_restore_position_func(
 			cursor->modify_clock =
 				buf_block_get_modify_clock(
 					cursor->block_when_stored);
+			cursor->withdraw_clock = buf_withdraw_clock;
 			cursor->old_stored = BTR_PCUR_OLD_STORED;
 
 			mem_heap_free(heap);
@@ -48,15 +48,19 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0log.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "page0zip.h"
 #include "srv0mon.h"
 #include "buf0checksum.h"
+#include "buf0dump.h"
 #ifdef HAVE_LIBNUMA
 #include <numa.h>
 #include <numaif.h>
 #endif // HAVE_LIBNUMA
+#include <stdarg.h>
+#include <vector>
 
 /*
 		IMPLEMENTATION OF THE BUFFER POOL
@@ -255,6 +259,21 @@ static const ulint BUF_PAGE_READ_MAX_RETRIES = 100;
 /** The buffer pools of the database */
 UNIV_INTERN buf_pool_t*	buf_pool_ptr;
 
+/** true when withdrawing buffer pool pages might cause page relocation */
+UNIV_INTERN volatile bool	buf_pool_withdrawing;
+
+/** the clock is incremented every time a pointer to a page may become
+obsolete; if the withdraw clock has not changed, the pointer is still
+valid in buffer pool. if changed, the pointer might not be in buffer pool
+any more. */
+UNIV_INTERN volatile ulint	buf_withdraw_clock;
+
+/** Arrays of chunk descriptors replaced by a larger array while the
+buffer pool was growing. buf_block_align() and friends may still be
+scanning them without holding buf_pool->mutex, so they are only freed
+at shutdown. */
+static std::vector<buf_chunk_t*>	buf_chunks_retired;
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 static ulint	buf_dbg_counter	= 0; /*!< This is used to insert validation
 					operations in execution in the
@@ -1184,6 +1203,26 @@ buf_chunk_init(
 	return(chunk);
 }
 
+/********************************************************************//**
+Frees the block mutexes and rw-locks of a chunk, before the memory of
+the chunk is released while the server is running. */
+static
+void
+buf_chunk_free_sync(
+/*================*/
+	buf_chunk_t*	chunk)	/*!< in/out: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+
+	for (ulint i = chunk->size; i--; block++) {
+		mutex_free(&block->mutex);
+		rw_lock_free(&block->lock);
+#ifdef UNIV_SYNC_DEBUG
+		rw_lock_free(&block->debug_latch);
+#endif /* UNIV_SYNC_DEBUG */
+	}
+}
+
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Finds a block in the given buffer chunk that points to a
@@ -1326,8 +1365,11 @@ buf_pool_init_instance(
 	ulint		instance_no)	/*!< in: id of the instance */
 {
 	ulint		i;
+	ulint		chunk_size;
 	buf_chunk_t*	chunk;
 
+	ut_ad(buf_pool_size % srv_buf_pool_chunk_unit == 0);
+
 	/* 1. Initialize general fields
 	------------------------------- */
 	mutex_create(buf_pool_mutex_key,
@@ -1338,25 +1380,43 @@ buf_pool_init_instance(
 	buf_pool_mutex_enter(buf_pool);
 
 	if (buf_pool_size > 0) {
-		buf_pool->n_chunks = 1;
+		buf_pool->n_chunks
+			= buf_pool_size / srv_buf_pool_chunk_unit;
+		chunk_size = srv_buf_pool_chunk_unit;
 
-		buf_pool->chunks = chunk =
-			(buf_chunk_t*) mem_zalloc(sizeof *chunk);
+		buf_pool->chunks = (buf_chunk_t*) mem_zalloc(
+			buf_pool->n_chunks * sizeof *chunk);
+		buf_pool->n_chunks_alloc = buf_pool->n_chunks;
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
 
 		UT_LIST_INIT(buf_pool->free);
+		UT_LIST_INIT(buf_pool->withdraw);
+		buf_pool->withdraw_target = 0;
+
+		buf_pool->curr_size = 0;
+		chunk = buf_pool->chunks;
+
+		do {
+			if (!buf_chunk_init(buf_pool, chunk, chunk_size)) {
+				while (--chunk >= buf_pool->chunks) {
+					buf_chunk_free_sync(chunk);
+					os_mem_free_large(
+						chunk->mem, chunk->mem_size);
+				}
 
-		if (!buf_chunk_init(buf_pool, chunk, buf_pool_size)) {
-			mem_free(chunk);
-			mem_free(buf_pool);
+				mem_free(buf_pool->chunks);
 
-			buf_pool_mutex_exit(buf_pool);
+				buf_pool_mutex_exit(buf_pool);
 
-			return(DB_ERROR);
-		}
+				return(DB_ERROR);
+			}
+
+			buf_pool->curr_size += chunk->size;
+		} while (++chunk < buf_pool->chunks + buf_pool->n_chunks);
 
 		buf_pool->instance_no = instance_no;
 		buf_pool->old_pool_size = buf_pool_size;
-		buf_pool->curr_size = chunk->size;
+		buf_pool->old_size = buf_pool->curr_size;
 		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
 
 		/* Number of locks protecting page_hash must be a
@@ -1453,6 +1513,7 @@ buf_pool_free_instance(
 	}
 
 	mem_free(buf_pool->chunks);
+	buf_pool->chunks = NULL;
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
@@ -1540,6 +1601,14 @@ buf_pool_free(
 		buf_pool_free_instance(buf_pool_from_array(i));
 	}
 
+	for (std::vector<buf_chunk_t*>::iterator it
+		     = buf_chunks_retired.begin();
+	     it != buf_chunks_retired.end(); ++it) {
+		mem_free(*it);
+	}
+
+	buf_chunks_retired.clear();
+
 	mem_free(buf_pool_ptr);
 	buf_pool_ptr = NULL;
 }
@@ -1680,6 +1749,840 @@ buf_relocate(
 	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold, dpage);
 }
 
+/********************************************************************//**
+Determines if a block is intended to be withdrawn. The caller must
+hold buf_pool->mutex and the buffer pool must be shrinking.
+@return	true if will be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: pointer to control
+						block */
+{
+	ut_ad(buf_pool->curr_size < buf_pool->old_size);
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	const buf_chunk_t*	chunk
+		= buf_pool->chunks + buf_pool->n_chunks_new;
+	const buf_chunk_t*	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	while (chunk < echunk) {
+		if (block >= chunk->blocks
+		    && block < chunk->blocks + chunk->size) {
+			return(true);
+		}
+		++chunk;
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Determines if a frame is intended to be withdrawn. The caller must
+hold buf_pool->mutex and the buffer pool must be shrinking.
+@return	true if will be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr)		/*!< in: pointer to a frame */
+{
+	ut_ad(buf_pool->curr_size < buf_pool->old_size);
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	const buf_chunk_t*	chunk
+		= buf_pool->chunks + buf_pool->n_chunks_new;
+	const buf_chunk_t*	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	while (chunk < echunk) {
+		if (ptr >= chunk->blocks->frame
+		    && ptr < (chunk->blocks + chunk->size - 1)->frame
+			     + UNIV_PAGE_SIZE) {
+			return(true);
+		}
+		++chunk;
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Relocates a buffer control block with its frame to a free block that
+is not going to be withdrawn. If the page is in use, it is left alone
+and will be tried again later.
+@return	false if there was no free block to relocate the page to */
+static
+bool
+buf_page_realloc(
+/*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_block_t*	block)		/*!< in/out: block to relocate */
+{
+	buf_block_t*	new_block;
+
+	ut_ad(buf_pool_withdrawing);
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+
+	new_block = buf_LRU_get_free_only(buf_pool);
+
+	if (new_block == NULL) {
+		return(false);
+	}
+
+	ulint		fold = buf_page_address_fold(
+		block->page.space, block->page.offset);
+	rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
+	rw_lock_x_lock(hash_lock);
+	mutex_enter(&block->mutex);
+
+	if (!buf_page_can_relocate(&block->page)) {
+		/* The page is in use; it will be tried again later. */
+		rw_lock_x_unlock(hash_lock);
+		mutex_exit(&block->mutex);
+
+		mutex_enter(&new_block->mutex);
+		buf_block_set_state(new_block, BUF_BLOCK_MEMORY);
+		buf_LRU_block_free_non_file_page(new_block);
+		mutex_exit(&new_block->mutex);
+
+		return(true);
+	}
+
+	mutex_enter(&new_block->mutex);
+
+	memcpy(new_block->frame, block->frame, UNIV_PAGE_SIZE);
+	memcpy(&new_block->page, &block->page, sizeof block->page);
+
+	/* relocate buf_pool->LRU */
+	ut_ad(block->page.in_LRU_list);
+	ut_ad(!block->page.in_zip_hash);
+
+	/* Important that we adjust the hazard pointer before
+	removing the page from the LRU list. */
+	buf_LRU_adjust_hp(buf_pool, &block->page);
+
+	ut_d(block->page.in_LRU_list = FALSE);
+
+	buf_page_t*	prev_b = UT_LIST_GET_PREV(LRU, &block->page);
+	UT_LIST_REMOVE(LRU, buf_pool->LRU, &block->page);
+
+	if (prev_b != NULL) {
+		UT_LIST_INSERT_AFTER(LRU, buf_pool->LRU, prev_b,
+				     &new_block->page);
+	} else {
+		UT_LIST_ADD_FIRST(LRU, buf_pool->LRU, &new_block->page);
+	}
+
+	if (buf_pool->LRU_old == &block->page) {
+		buf_pool->LRU_old = &new_block->page;
+	}
+
+	/* relocate buf_pool->unzip_LRU */
+	if (block->page.zip.data != NULL) {
+		ut_ad(block->in_unzip_LRU_list);
+		ut_d(new_block->in_unzip_LRU_list = TRUE);
+
+		buf_block_t*	prev_block = UT_LIST_GET_PREV(unzip_LRU, block);
+		UT_LIST_REMOVE(unzip_LRU, buf_pool->unzip_LRU, block);
+
+		ut_d(block->in_unzip_LRU_list = FALSE);
+		block->page.zip.data = NULL;
+		page_zip_set_size(&block->page.zip, 0);
+
+		if (prev_block != NULL) {
+			UT_LIST_INSERT_AFTER(unzip_LRU, buf_pool->unzip_LRU,
+					     prev_block, new_block);
+		} else {
+			UT_LIST_ADD_FIRST(unzip_LRU, buf_pool->unzip_LRU,
+					  new_block);
+		}
+	} else {
+		ut_ad(!block->in_unzip_LRU_list);
+		ut_d(new_block->in_unzip_LRU_list = FALSE);
+	}
+
+	/* relocate buf_pool->page_hash */
+	ut_ad(block->page.in_page_hash);
+	ut_ad(&block->page == buf_page_hash_get_low(
+		      buf_pool, block->page.space, block->page.offset, fold));
+	ut_d(block->page.in_page_hash = FALSE);
+
+	buf_page_t*	bpage = &block->page;
+	buf_page_t*	new_bpage = &new_block->page;
+
+	HASH_DELETE(buf_page_t, hash, buf_pool->page_hash, fold, bpage);
+	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold, new_bpage);
+
+	/* relocate buf_pool->flush_list */
+	if (block->page.oldest_modification != 0) {
+		buf_flush_relocate_on_flush_list(
+			&block->page, &new_block->page);
+	}
+
+	/* The adaptive hash index is disabled while the buffer pool
+	is being resized. */
+	ut_ad(block->index == NULL);
+	new_block->index = NULL;
+	new_block->n_hash_helps = 0;
+	new_block->n_fields = 1;
+	new_block->n_bytes = 0;
+	new_block->left_side = TRUE;
+
+	new_block->lock_hash_val = block->lock_hash_val;
+	new_block->check_index_page_at_flush
+		= block->check_index_page_at_flush;
+
+	rw_lock_x_unlock(hash_lock);
+	mutex_exit(&new_block->mutex);
+
+	/* Invalidate any pointer to the old block that was stored
+	for optimistic restoration, and free it. */
+	buf_block_modify_clock_inc(block);
+	memset(block->frame + FIL_PAGE_OFFSET, 0xff, 4);
+	memset(block->frame + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID, 0xff, 4);
+	UNIV_MEM_INVALID(block->frame, UNIV_PAGE_SIZE);
+	buf_block_set_state(block, BUF_BLOCK_REMOVE_HASH);
+	buf_block_set_state(block, BUF_BLOCK_MEMORY);
+	buf_LRU_block_free_non_file_page(block);
+
+	mutex_exit(&block->mutex);
+
+	return(true);
+}
+
+/********************************************************************//**
+Sets the status of the buffer pool resize and writes it to the error
+log. */
+static
+void
+buf_resize_status(
+/*==============*/
+	const char*	fmt,	/*!< in: printf-style format string */
+	...)
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+
+	ut_vsnprintf(export_vars.innodb_buffer_pool_resize_status,
+		     sizeof(export_vars.innodb_buffer_pool_resize_status),
+		     fmt, ap);
+
+	va_end(ap);
+
+	ib_logf(IB_LOG_LEVEL_INFO, "%s",
+		export_vars.innodb_buffer_pool_resize_status);
+}
+
+/********************************************************************//**
+Withdraws the blocks of the tail chunks of a buffer pool instance that
+is being shrunk: free blocks are moved to the withdraw list, and the
+pages and compressed pages in those chunks are relocated.
+@return	true if the withdrawal should be retried later */
+static
+bool
+buf_pool_withdraw_blocks(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	buf_block_t*	block;
+	ulint		loop_count = 0;
+	ulint		i = buf_pool_index(buf_pool);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Buffer pool %lu: start to withdraw the last %lu blocks.",
+		i, buf_pool->withdraw_target);
+
+	/* Minimize buf_pool->zip_free[i] lists */
+	buf_pool_mutex_enter(buf_pool);
+	buf_buddy_condense_free(buf_pool);
+	buf_pool_mutex_exit(buf_pool);
+
+	while (UT_LIST_GET_LEN(buf_pool->withdraw)
+	       < buf_pool->withdraw_target) {
+
+		/* try to withdraw from free_list */
+		ulint	count1 = 0;
+
+		buf_pool_mutex_enter(buf_pool);
+		block = reinterpret_cast<buf_block_t*>(
+			UT_LIST_GET_FIRST(buf_pool->free));
+		while (block != NULL
+		       && UT_LIST_GET_LEN(buf_pool->withdraw)
+			  < buf_pool->withdraw_target) {
+			ut_ad(block->page.in_free_list);
+			ut_ad(!block->page.in_flush_list);
+			ut_ad(!block->page.in_LRU_list);
+			ut_a(!buf_page_in_file(&block->page));
+
+			buf_block_t*	next_block;
+			next_block = reinterpret_cast<buf_block_t*>(
+				UT_LIST_GET_NEXT(list, &block->page));
+
+			if (buf_block_will_withdrawn(buf_pool, block)) {
+				/* This should be withdrawn */
+				UT_LIST_REMOVE(list, buf_pool->free,
+					       (&block->page));
+				UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+						 (&block->page));
+				ut_d(block->in_withdraw_list = TRUE);
+				ut_d(block->page.in_free_list = FALSE);
+				count1++;
+			}
+
+			block = next_block;
+		}
+		buf_pool_mutex_exit(buf_pool);
+
+		/* reserve free_list length */
+		if (UT_LIST_GET_LEN(buf_pool->withdraw)
+		    < buf_pool->withdraw_target) {
+			/* The LRU batch scans deeper by the number
+			of blocks still to be withdrawn. */
+			buf_flush_LRU_list(buf_pool);
+			buf_flush_wait_batch_end(buf_pool, BUF_FLUSH_LRU);
+		}
+
+		/* relocate blocks/buddies in withdrawn area */
+		ulint	count2 = 0;
+
+		buf_pool_mutex_enter(buf_pool);
+		buf_page_t*	bpage = UT_LIST_GET_FIRST(buf_pool->LRU);
+		while (bpage != NULL) {
+			ib_mutex_t*	block_mutex;
+			buf_page_t*	next_bpage;
+
+			block_mutex = buf_page_get_mutex(bpage);
+			mutex_enter(block_mutex);
+
+			next_bpage = UT_LIST_GET_NEXT(LRU, bpage);
+
+			if (bpage->zip.data != NULL
+			    && buf_frame_will_withdrawn(
+				    buf_pool,
+				    static_cast<byte*>(bpage->zip.data))) {
+
+				if (buf_page_can_relocate(bpage)) {
+					mutex_exit(block_mutex);
+					buf_pool_mutex_exit_forbid(buf_pool);
+					if (!buf_buddy_realloc(
+						    buf_pool, bpage->zip.data,
+						    page_zip_get_size(
+							    &bpage->zip))) {
+						/* failed to allocate block */
+						buf_pool_mutex_exit_allow(
+							buf_pool);
+						break;
+					}
+					buf_pool_mutex_exit_allow(buf_pool);
+					mutex_enter(block_mutex);
+					count2++;
+				}
+				/* NOTE: if the page is in use,
+				not reallocated yet */
+			}
+
+			if (buf_page_get_state(bpage)
+			    == BUF_BLOCK_FILE_PAGE
+			    && buf_block_will_withdrawn(
+				    buf_pool,
+				    reinterpret_cast<buf_block_t*>(bpage))) {
+
+				if (buf_page_can_relocate(bpage)) {
+					mutex_exit(block_mutex);
+					buf_pool_mutex_exit_forbid(buf_pool);
+					if (!buf_page_realloc(
+						    buf_pool,
+						    reinterpret_cast<
+							    buf_block_t*>(
+								    bpage))) {
+						/* failed to allocate block */
+						buf_pool_mutex_exit_allow(
+							buf_pool);
+						break;
+					}
+					buf_pool_mutex_exit_allow(buf_pool);
+					count2++;
+				} else {
+					mutex_exit(block_mutex);
+				}
+				/* NOTE: if the page is in use,
+				not reallocated yet */
+			} else {
+				mutex_exit(block_mutex);
+			}
+
+			bpage = next_bpage;
+		}
+		buf_pool_mutex_exit(buf_pool);
+
+		buf_resize_status(
+			"Buffer pool %lu: withdrawing blocks. (%lu/%lu)",
+			i, UT_LIST_GET_LEN(buf_pool->withdraw),
+			buf_pool->withdraw_target);
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Buffer pool %lu: withdrew %lu blocks from free"
+			" list. Tried to relocate %lu pages (%lu/%lu).",
+			i, count1, count2,
+			UT_LIST_GET_LEN(buf_pool->withdraw),
+			buf_pool->withdraw_target);
+
+		if (++loop_count >= 10) {
+			/* give up for now.
+			retried after user threads paused. */
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Buffer pool %lu: will retry to withdraw"
+				" later.", i);
+
+			/* need retry later */
+			return(true);
+		}
+	}
+
+	/* confirm withdrawn enough */
+	const buf_chunk_t*	chunk
+		= buf_pool->chunks + buf_pool->n_chunks_new;
+	const buf_chunk_t*	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	while (chunk < echunk) {
+		block = chunk->blocks;
+		for (ulint j = chunk->size; j--; block++) {
+			/* A block in the withdrawn area that is not
+			BUF_BLOCK_NOT_USED means that the withdraw list
+			is corrupted. */
+			ut_a(buf_block_get_state(block) == BUF_BLOCK_NOT_USED);
+			ut_ad(block->in_withdraw_list);
+		}
+		++chunk;
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Buffer pool %lu: withdrawn target %lu blocks.",
+		i, UT_LIST_GET_LEN(buf_pool->withdraw));
+
+	/* retry is not needed */
+	return(false);
+}
+
+/********************************************************************//**
+Rehashes the page_hash and zip_hash of a buffer pool instance for its
+new size. The caller must hold buf_pool->mutex and all the page_hash
+x-latches; the page_hash latches themselves are kept. */
+static
+void
+buf_pool_resize_hash(
+/*=================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	hash_table_t*	new_hash_table;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	/* rehash page_hash into a new cell array, and swap the arrays
+	so that the rw-locks of page_hash stay where they are */
+	new_hash_table = hash_create(2 * buf_pool->curr_size);
+
+	for (ulint i = 0; i < hash_get_n_cells(buf_pool->page_hash); i++) {
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			HASH_GET_FIRST(buf_pool->page_hash, i));
+
+		while (bpage != NULL) {
+			buf_page_t*	prev_bpage = bpage;
+			ulint		fold;
+
+			bpage = static_cast<buf_page_t*>(
+				HASH_GET_NEXT(hash, prev_bpage));
+
+			fold = buf_page_address_fold(
+				prev_bpage->space, prev_bpage->offset);
+
+			HASH_INSERT(buf_page_t, hash, new_hash_table,
+				    fold, prev_bpage);
+		}
+	}
+
+	std::swap(buf_pool->page_hash->array, new_hash_table->array);
+	std::swap(buf_pool->page_hash->n_cells, new_hash_table->n_cells);
+	hash_table_free(new_hash_table);
+
+	/* recreate zip_hash */
+	new_hash_table = hash_create(2 * buf_pool->curr_size);
+
+	for (ulint i = 0; i < hash_get_n_cells(buf_pool->zip_hash); i++) {
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			HASH_GET_FIRST(buf_pool->zip_hash, i));
+
+		while (bpage != NULL) {
+			buf_page_t*	prev_bpage = bpage;
+			ulint		fold;
+
+			bpage = static_cast<buf_page_t*>(
+				HASH_GET_NEXT(hash, prev_bpage));
+
+			fold = BUF_POOL_ZIP_FOLD_BPAGE(prev_bpage);
+
+			HASH_INSERT(buf_page_t, hash, new_hash_table,
+				    fold, prev_bpage);
+		}
+	}
+
+	hash_table_free(buf_pool->zip_hash);
+	buf_pool->zip_hash = new_hash_table;
+}
+
+/********************************************************************//**
+Resizes the buffer pool to srv_buf_pool_size. When shrinking, the tail
+chunks of every instance are first emptied while the server keeps
+running; the chunks are then freed or allocated, and the page hash
+tables rehashed, with all the buffer pool mutexes held. */
+static
+void
+buf_pool_resize(void)
+/*=================*/
+{
+	buf_pool_t*	buf_pool;
+	ulint		new_instance_size;
+	bool		warning = false;
+
+	ut_ad(srv_buf_pool_chunk_unit > 0);
+
+	new_instance_size = srv_buf_pool_size / srv_buf_pool_instances;
+	new_instance_size /= UNIV_PAGE_SIZE;
+
+	buf_resize_status("Resizing buffer pool from %lu to %lu"
+			  " (unit=%lu).",
+			  srv_buf_pool_old_size, srv_buf_pool_size,
+			  srv_buf_pool_chunk_unit);
+
+	/* set new limit for all buffer pool for resizing */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool = buf_pool_from_array(i);
+		buf_pool_mutex_enter(buf_pool);
+
+		ut_ad(buf_pool->curr_size == buf_pool->old_size);
+		ut_ad(buf_pool->n_chunks_new == buf_pool->n_chunks);
+		ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw) == 0);
+
+		buf_pool->curr_size = new_instance_size;
+
+		buf_pool->n_chunks_new = new_instance_size * UNIV_PAGE_SIZE
+			/ srv_buf_pool_chunk_unit;
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+
+	/* disable AHI if needed */
+	bool	btr_search_disabled = false;
+
+	if (btr_search_enabled) {
+		buf_resize_status("Disabling adaptive hash index.");
+
+		btr_search_disable();
+		btr_search_disabled = true;
+	}
+
+	/* set withdraw target */
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool = buf_pool_from_array(i);
+
+		if (buf_pool->curr_size < buf_pool->old_size) {
+			ulint			withdraw_target = 0;
+			const buf_chunk_t*	chunk
+				= buf_pool->chunks + buf_pool->n_chunks_new;
+			const buf_chunk_t*	echunk
+				= buf_pool->chunks + buf_pool->n_chunks;
+
+			while (chunk < echunk) {
+				withdraw_target += chunk->size;
+				++chunk;
+			}
+
+			ut_ad(buf_pool->withdraw_target == 0);
+			buf_pool->withdraw_target = withdraw_target;
+			buf_pool_withdrawing = true;
+		}
+	}
+
+	buf_resize_status("Withdrawing blocks to be shrunken.");
+
+	ib_time_t	withdraw_started = ut_time();
+	ulint		message_interval = 60;
+	ulint		retry_interval = 1;
+
+withdraw_retry:
+	bool	should_retry_withdraw = false;
+
+	/* wait for the number of blocks fit to the new size (if needed)*/
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool = buf_pool_from_array(i);
+
+		if (buf_pool->curr_size < buf_pool->old_size) {
+
+			should_retry_withdraw |=
+				buf_pool_withdraw_blocks(buf_pool);
+		}
+	}
+
+	if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+		/* abort to resize for shutdown. */
+		buf_pool_withdrawing = false;
+		return;
+	}
+
+	/* abort buffer pool load */
+	buf_load_abort();
+
+	if (should_retry_withdraw
+	    && ut_difftime(ut_time(), withdraw_started) >= message_interval) {
+
+		if (message_interval > 900) {
+			message_interval = 1800;
+		} else {
+			message_interval *= 2;
+		}
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Withdrawing blocks from the buffer pool is taking"
+			" long. Pages fixed by long running transactions"
+			" or by other threads cannot be relocated.");
+	}
+
+	if (should_retry_withdraw) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Will retry to withdraw %lu seconds later.",
+			retry_interval);
+		os_thread_sleep(retry_interval * 1000000);
+
+		if (retry_interval > 5) {
+			retry_interval = 10;
+		} else {
+			retry_interval *= 2;
+		}
+
+		goto withdraw_retry;
+	}
+
+	buf_pool_withdrawing = false;
+
+	buf_resize_status("Latching whole of buffer pool.");
+
+	/* Indicate critical path */
+	buf_pool_mutex_enter_all();
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		buf_pool = buf_pool_from_array(i);
+		hash_lock_x_all(buf_pool->page_hash);
+	}
+
+	/* Resize each instance */
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		buf_pool = buf_pool_from_array(i);
+
+		if (buf_pool->n_chunks_new < buf_pool->n_chunks) {
+			/* free the withdrawn chunks */
+			buf_chunk_t*		chunk
+				= buf_pool->chunks + buf_pool->n_chunks_new;
+			const buf_chunk_t*	echunk
+				= buf_pool->chunks + buf_pool->n_chunks;
+			ulint			sum_freed = 0;
+			ulint			n_freed = buf_pool->n_chunks
+				- buf_pool->n_chunks_new;
+
+			/* Hide the chunks from buf_block_align() before
+			their memory is released. */
+			buf_pool->n_chunks = buf_pool->n_chunks_new;
+			os_wmb;
+
+			while (chunk < echunk) {
+				buf_block_t*	block = chunk->blocks;
+
+				for (ulint j = chunk->size; j--; block++) {
+					ut_a(buf_block_get_state(block)
+					     == BUF_BLOCK_NOT_USED);
+					ut_ad(block->in_withdraw_list);
+					UT_LIST_REMOVE(list,
+						       buf_pool->withdraw,
+						       (&block->page));
+				}
+
+				buf_chunk_free_sync(chunk);
+				os_mem_free_large(chunk->mem,
+						  chunk->mem_size);
+
+				sum_freed += chunk->size;
+				++chunk;
+			}
+
+			ut_a(UT_LIST_GET_LEN(buf_pool->withdraw) == 0);
+			buf_pool->withdraw_target = 0;
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Buffer pool %lu: %lu chunks (%lu blocks)"
+				" were freed.", i, n_freed, sum_freed);
+		}
+
+		if (buf_pool->n_chunks_new > buf_pool->n_chunks) {
+			/* allocate the new chunks */
+			buf_chunk_t*	chunks = buf_pool->chunks;
+			ulint		n = buf_pool->n_chunks;
+			const ulint	n_old = n;
+
+			if (buf_pool->n_chunks_new > buf_pool->n_chunks_alloc) {
+				chunks = static_cast<buf_chunk_t*>(
+					mem_zalloc(buf_pool->n_chunks_new
+						   * sizeof *chunks));
+				memcpy(chunks, buf_pool->chunks,
+				       buf_pool->n_chunks * sizeof *chunks);
+			}
+
+			while (n < buf_pool->n_chunks_new) {
+				if (!buf_chunk_init(buf_pool, chunks + n,
+						    srv_buf_pool_chunk_unit)) {
+
+					ib_logf(IB_LOG_LEVEL_ERROR,
+						"Buffer pool %lu: failed to"
+						" allocate new memory.", i);
+
+					warning = true;
+					break;
+				}
+
+				++n;
+			}
+
+			if (chunks != buf_pool->chunks) {
+				/* buf_block_align() may still be
+				scanning the old array. */
+				buf_chunks_retired.push_back(
+					buf_pool->chunks);
+				buf_pool->chunks = chunks;
+				buf_pool->n_chunks_alloc
+					= buf_pool->n_chunks_new;
+			}
+
+			os_wmb;
+			buf_pool->n_chunks = n;
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Buffer pool %lu: %lu chunks were added.",
+				i, n - n_old);
+		}
+
+		/* recalculate the sizes from the chunks */
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
+		buf_pool->curr_size = 0;
+
+		for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+			buf_pool->curr_size += buf_pool->chunks[n].size;
+		}
+
+		buf_pool->old_size = buf_pool->curr_size;
+		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
+		buf_pool->old_pool_size = buf_pool->curr_pool_size;
+
+		/* The page_hash was sized for 2 * curr_size cells.
+		Rehash only if the size changed by more than a factor
+		of two since then. */
+		if (hash_get_n_cells(buf_pool->page_hash)
+		    > 8 * buf_pool->curr_size
+		    || hash_get_n_cells(buf_pool->page_hash)
+		    < buf_pool->curr_size) {
+
+			buf_pool_resize_hash(buf_pool);
+		}
+	}
+
+	for (ulint i = 0; i < srv_buf_pool_instances; ++i) {
+		buf_pool = buf_pool_from_array(i);
+		hash_unlock_x_all(buf_pool->page_hash);
+	}
+
+	buf_pool_mutex_exit_all();
+
+	/* The pointers to the freed chunks are obsolete now. */
+	++buf_withdraw_clock;
+
+	/* Adjust the sizes that are derived from the buffer pool size */
+	buf_pool_set_sizes();
+
+	ibuf_max_size_update(srv_change_buffer_max_size);
+
+	/* The adaptive hash index is empty while it is disabled */
+	if (btr_search_disabled) {
+		btr_search_sys_resize(
+			buf_pool_get_curr_size() / sizeof(void*) / 64);
+
+		btr_search_enable();
+	}
+
+	char	now[32];
+
+	ut_sprintf_timestamp(now);
+
+	if (warning) {
+		buf_resize_status("Resizing buffer pool failed,"
+				  " finished resizing at %s.", now);
+	} else {
+		buf_resize_status("Completed resizing buffer pool at %s.",
+				  now);
+	}
+}
+
+/*****************************************************************//**
+This is the thread for resizing buffer pool. It waits for an event and
+when waked up either performs a resizing and sleeps again.
+@return	this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg MY_ATTRIBUTE((unused)))	/*!< in: a dummy parameter
+						required by os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+	srv_buf_resize_thread_active = TRUE;
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		os_event_wait(srv_buf_resize_event);
+		os_event_reset(srv_buf_resize_event);
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		buf_pool_mutex_enter_all();
+		if (srv_buf_pool_old_size == srv_buf_pool_size) {
+			buf_pool_mutex_exit_all();
+			buf_resize_status("Size did not change (old size ="
+					  " new size = %lu). Nothing to do.",
+					  srv_buf_pool_size);
+			continue;
+		}
+		buf_pool_mutex_exit_all();
+
+		buf_pool_resize();
+	}
+
+	srv_buf_resize_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /** Hazard Pointer implementation. */
 
 /** Set current value
@@ -1958,7 +2861,7 @@ buf_pool_watch_unset(
 	buf_page_t*	bpage;
 	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
 	ulint		fold = buf_page_address_fold(space, offset);
-	rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+	rw_lock_t*	hash_lock;
 
 	/* We only need to have buf_pool mutex in case where we end
 	up calling buf_pool_watch_remove but to obey latching order
@@ -1967,6 +2870,7 @@ buf_pool_watch_unset(
 	called from the purge thread. */
 	buf_pool_mutex_enter(buf_pool);
 
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	/* The page must exist because buf_pool_watch_set() increments
@@ -2016,6 +2920,9 @@ buf_pool_watch_occurred(
 
 	rw_lock_s_lock(hash_lock);
 
+	/* If not own buf_pool_mutex, page_hash can be changed. */
+	hash_lock = buf_page_hash_lock_s_confirm(hash_lock, buf_pool, fold);
+
 	/* The page must exist because buf_pool_watch_set()
 	increments buf_fix_count. */
 	bpage = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -2438,11 +3345,24 @@ buf_block_align_instance(
 	buf_chunk_t*	chunk;
 	ulint		i;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	for (chunk = buf_pool->chunks, i = buf_pool->n_chunks; i--; chunk++) {
+	/* buf_pool->chunks is not protected by a mutex, because it
+	may only change while the buffer pool is being resized. Read
+	n_chunks before chunks: a growing buffer pool publishes the
+	larger chunks[] array before n_chunks, and retired arrays are
+	never freed while the server is running. Chunks that are
+	being freed never contain ptr, so we check the range in the
+	chunk descriptor before dereferencing the chunk memory. */
+	i = buf_pool->n_chunks;
+	os_rmb;
+	for (chunk = buf_pool->chunks; i--; chunk++) {
 		ulint	offs;
 
+		if (ptr < (byte*) chunk->mem
+		    || ptr >= (byte*) chunk->mem + chunk->mem_size) {
+
+			continue;
+		}
+
 		if (UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
 
 			continue;
@@ -2552,11 +3472,13 @@ buf_pointer_is_block_field_instance(
 	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	const void*	ptr)		/*!< in: pointer not dereferenced */
 {
+	const ulint			n_chunks = buf_pool->n_chunks;
+	os_rmb;
 	const buf_chunk_t*		chunk	= buf_pool->chunks;
-	const buf_chunk_t* const	echunk	= chunk + buf_pool->n_chunks;
+	const buf_chunk_t* const	echunk	= chunk + n_chunks;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
+	/* See buf_block_align_instance() for why buf_pool->chunks
+	can be scanned without holding buf_pool->mutex. */
 	while (chunk < echunk) {
 		if (ptr >= (void*) chunk->blocks
 		    && ptr < (void*) (chunk->blocks + chunk->size)) {
@@ -2743,6 +3665,9 @@ loop:
 
 	rw_lock_s_lock(hash_lock);
 
+	/* If not own buf_pool_mutex, page_hash can be changed. */
+	hash_lock = buf_page_hash_lock_s_confirm(hash_lock, buf_pool, fold);
+
 	if (block != NULL) {
 
 		/* If the guess is a compressed page descriptor that
@@ -2777,6 +3702,12 @@ loop:
 
 		if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 			rw_lock_x_lock(hash_lock);
+
+			/* If not own buf_pool_mutex,
+			page_hash can be changed. */
+			hash_lock = buf_page_hash_lock_x_confirm(
+				hash_lock, buf_pool, fold);
+
 			block = (buf_block_t*) buf_pool_watch_set(
 				space, offset, fold);
 
@@ -2925,6 +3856,11 @@ got_block:
 
 		buf_pool_mutex_enter(buf_pool);
 
+		/* As we have released the page_hash lock and the
+		block_mutex to allocate an uncompressed page it is
+		possible that the page_hash was resized meanwhile. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
 		rw_lock_x_lock(hash_lock);
 
 		/* Buffer-fixing prevents the page_hash from changing. */
@@ -3036,6 +3972,10 @@ got_block:
 				ut_a(ibuf_count_get(space, offset) == 0);
 #endif /* UNIV_IBUF_COUNT_DEBUG */
 			} else {
+				/* The page is decompressed because it
+				is accessed. */
+				block->page.read_for_ibuf_merge = false;
+
 				ibuf_merge_or_delete_for_page(
 					block, space, offset, zip_size, TRUE);
 			}
@@ -3098,6 +4038,11 @@ got_block:
 			buf_pool_mutex_exit(buf_pool);
 			rw_lock_x_lock(hash_lock);
 
+			/* If not own buf_pool_mutex,
+			page_hash can be changed. */
+			hash_lock = buf_page_hash_lock_x_confirm(
+				hash_lock, buf_pool, fold);
+
 			if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 				/* Set the watch, as it would have
 				been set if the page were not in the
@@ -3556,6 +4501,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
+	bpage->read_for_ibuf_merge = false;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
 	HASH_INVALIDATE(bpage, hash);
@@ -3723,9 +4669,10 @@ buf_page_init_for_read(
 	}
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	buf_pool_mutex_enter(buf_pool);
+
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	watch_page = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -3823,6 +4770,9 @@ err_exit:
 		uninitialized data. */
 		data = buf_buddy_alloc(buf_pool, zip_size, &lru);
 
+		/* buf_pool->mutex may have been released and
+		reacquired, and the page_hash resized meanwhile. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 
 		/* If buf_buddy_alloc() allocated storage from the LRU list,
@@ -3962,9 +4912,10 @@ buf_page_create(
 	free_block = buf_LRU_get_free_block(buf_pool);
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	buf_pool_mutex_enter(buf_pool);
+
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	block = (buf_block_t*) buf_page_hash_get_low(
@@ -4826,7 +5777,8 @@ assert_s_latched:
 
 	mutex_exit(&buf_pool->zip_mutex);
 
-	if (n_lru + n_free > buf_pool->curr_size + n_zip) {
+	if (buf_pool->curr_size == buf_pool->old_size
+	    && n_lru + n_free > buf_pool->curr_size + n_zip) {
 		fprintf(stderr, "n LRU %lu, n free %lu, pool %lu zip %lu\n",
 			(ulong) n_lru, (ulong) n_free,
 			(ulong) buf_pool->curr_size, (ulong) n_zip);
@@ -4834,7 +5786,8 @@ assert_s_latched:
 	}
 
 	ut_a(UT_LIST_GET_LEN(buf_pool->LRU) == n_lru);
-	if (UT_LIST_GET_LEN(buf_pool->free) != n_free) {
+	if (UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw) != n_free) {
 		fprintf(stderr, "Free list len %lu, free blocks %lu\n",
 			(ulong) UT_LIST_GET_LEN(buf_pool->free),
 			(ulong) n_free);
@@ -41,6 +41,7 @@ Created 2011/12/19
 #ifdef UNIV_PFS_MUTEX
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	buf_dblwr_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	buf_dblwr_seg_mutex_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 /** The doublewrite buffer */
@@ -49,6 +50,14 @@ UNIV_INTERN buf_dblwr_t*	buf_dblwr = NULL;
 /** Set to TRUE when the doublewrite buffer is being created */
 UNIV_INTERN ibool	buf_dblwr_being_created = FALSE;
 
+/** Unaligned buffers holding the contents of the parallel doublewrite
+files read at startup. Freed by buf_dblwr_process(). */
+static std::list<byte*>	buf_dblwr_recv_bufs;
+
+/** Number of pages from the parallel doublewrite files appended to
+recv_sys->dblwr.pages */
+static ulint		buf_dblwr_n_recv_pages = 0;
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -119,6 +128,232 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(FIL_TABLESPACE);
 }
 
+/****************************************************************//**
+Builds the name of the parallel doublewrite file of a buffer pool
+instance. */
+static
+void
+buf_dblwr_file_name(
+/*================*/
+	char*	name,		/*!< out: file name, OS_FILE_MAX_PATH
+				bytes */
+	ulint	instance_no)	/*!< in: buffer pool instance number */
+{
+	ulint	dirnamelen = strlen(srv_data_home);
+
+	ut_a(dirnamelen + sizeof(BUF_DBLWR_FILE_PREFIX) + 20
+	     < OS_FILE_MAX_PATH);
+
+	memcpy(name, srv_data_home, dirnamelen);
+
+	/* Add a path separator if needed. */
+	if (dirnamelen && name[dirnamelen - 1] != SRV_PATH_SEPARATOR) {
+		name[dirnamelen++] = SRV_PATH_SEPARATOR;
+	}
+
+	ut_snprintf(name + dirnamelen, OS_FILE_MAX_PATH - dirnamelen,
+		    BUF_DBLWR_FILE_PREFIX "%lu", (ulong) instance_no);
+}
+
+/****************************************************************//**
+Opens or creates the parallel doublewrite files and sets up the
+segments of every buffer pool instance. If a file cannot be opened,
+batch flushes keep using the doublewrite blocks in the system
+tablespace. */
+static
+void
+buf_dblwr_init_parallel(void)
+/*=========================*/
+{
+	ulint	n_files = srv_buf_pool_instances;
+	ulint	i;
+
+	if (!srv_parallel_doublewrite
+	    || !srv_use_doublewrite_buf
+	    || srv_read_only_mode) {
+
+		return;
+	}
+
+	buf_dblwr->files = static_cast<os_file_t*>(
+		mem_zalloc(n_files * sizeof(os_file_t)));
+
+	buf_dblwr->file_names = static_cast<char*>(
+		mem_zalloc(n_files * OS_FILE_MAX_PATH));
+
+	for (i = 0; i < n_files; i++) {
+		char*	name = buf_dblwr->file_names + i * OS_FILE_MAX_PATH;
+		ibool	success;
+
+		buf_dblwr_file_name(name, i);
+
+		/* Do not truncate an existing file: it may hold pages
+		that buf_dblwr_process() has yet to restore. Segments
+		are overwritten only by batch flushes, which cannot
+		start before that. */
+		buf_dblwr->files[i] = os_file_create(
+			innodb_file_data_key, name,
+			OS_FILE_OPEN | OS_FILE_ON_ERROR_NO_EXIT
+			| OS_FILE_ON_ERROR_SILENT,
+			OS_FILE_NORMAL, OS_DATA_FILE, &success);
+
+		if (!success) {
+			buf_dblwr->files[i] = os_file_create(
+				innodb_file_data_key, name,
+				OS_FILE_CREATE | OS_FILE_ON_ERROR_NO_EXIT,
+				OS_FILE_NORMAL, OS_DATA_FILE, &success);
+		}
+
+		if (!success) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Cannot open or create the parallel "
+				"doublewrite file %s. Batch flushes will "
+				"use the doublewrite buffer in the system "
+				"tablespace.", name);
+
+			while (i > 0) {
+				os_file_close(buf_dblwr->files[--i]);
+			}
+
+			mem_free(buf_dblwr->files);
+			buf_dblwr->files = NULL;
+
+			mem_free(buf_dblwr->file_names);
+			buf_dblwr->file_names = NULL;
+
+			return;
+		}
+	}
+
+	buf_dblwr->n_segs = n_files * BUF_DBLWR_SEGS_PER_POOL;
+
+	buf_dblwr->segs = static_cast<buf_dblwr_seg_t*>(
+		mem_zalloc(buf_dblwr->n_segs * sizeof(buf_dblwr_seg_t)));
+
+	for (i = 0; i < buf_dblwr->n_segs; i++) {
+		buf_dblwr_seg_t*	seg = &buf_dblwr->segs[i];
+		ulint			file_no = i / BUF_DBLWR_SEGS_PER_POOL;
+
+		mutex_create(buf_dblwr_seg_mutex_key,
+			     &seg->mutex, SYNC_DOUBLEWRITE);
+
+		seg->b_event = os_event_create();
+		seg->file = buf_dblwr->files[file_no];
+		seg->file_name = buf_dblwr->file_names
+			+ file_no * OS_FILE_MAX_PATH;
+		seg->offset = static_cast<os_offset_t>(
+			i % BUF_DBLWR_SEGS_PER_POOL)
+			* srv_doublewrite_batch_size * UNIV_PAGE_SIZE;
+
+		seg->write_buf_unaligned = static_cast<byte*>(
+			ut_malloc((1 + srv_doublewrite_batch_size)
+				  * UNIV_PAGE_SIZE));
+
+		seg->write_buf = static_cast<byte*>(
+			ut_align(seg->write_buf_unaligned, UNIV_PAGE_SIZE));
+
+		seg->buf_block_arr = static_cast<buf_page_t**>(
+			mem_zalloc(srv_doublewrite_batch_size
+				   * sizeof(void*)));
+	}
+}
+
+/****************************************************************//**
+Gets the parallel doublewrite segment that batches of a flush type from
+a buffer pool instance are written to.
+@return segment */
+UNIV_INLINE
+buf_dblwr_seg_t*
+buf_dblwr_get_seg(
+/*==============*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_flush_t		flush_type)	/*!< in: BUF_FLUSH_LRU or
+						BUF_FLUSH_LIST */
+{
+	ulint	i;
+
+	ut_ad(buf_dblwr->segs != NULL);
+	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
+
+	i = buf_pool_index(buf_pool) * BUF_DBLWR_SEGS_PER_POOL
+		+ (flush_type == BUF_FLUSH_LIST);
+
+	ut_ad(i < buf_dblwr->n_segs);
+
+	return(&buf_dblwr->segs[i]);
+}
+
+/****************************************************************//**
+Reads the parallel doublewrite files of all possible buffer pool
+instances, as the number of instances may have changed since they were
+written, and adds the pages found in them to recv_sys->dblwr. */
+static
+void
+buf_dblwr_load_parallel_pages(void)
+/*===============================*/
+{
+	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
+
+	for (ulint i = 0; i < MAX_BUFFER_POOLS; i++) {
+		char		name[OS_FILE_MAX_PATH];
+		os_file_t	file;
+		os_offset_t	size;
+		ulint		n_pages;
+		ibool		success;
+
+		buf_dblwr_file_name(name, i);
+
+		file = os_file_create_simple_no_error_handling(
+			innodb_file_data_key, name, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, &success);
+
+		if (!success) {
+			continue;
+		}
+
+		size = os_file_get_size(file);
+
+		n_pages = size == (os_offset_t) -1
+			? 0 : static_cast<ulint>(size / UNIV_PAGE_SIZE);
+
+		if (n_pages > 0) {
+			byte*	unaligned_buf;
+			byte*	buf;
+
+			unaligned_buf = static_cast<byte*>(
+				ut_malloc((1 + n_pages) * UNIV_PAGE_SIZE));
+
+			buf = static_cast<byte*>(
+				ut_align(unaligned_buf, UNIV_PAGE_SIZE));
+
+			if (!os_file_read(file, buf, 0,
+					  n_pages * UNIV_PAGE_SIZE)) {
+
+				ib_logf(IB_LOG_LEVEL_WARN,
+					"Cannot read the parallel "
+					"doublewrite file %s.", name);
+
+				ut_free(unaligned_buf);
+				n_pages = 0;
+			} else {
+				buf_dblwr_recv_bufs.push_back(unaligned_buf);
+			}
+
+			for (ulint j = 0; j < n_pages; j++) {
+				byte*	page = buf + j * UNIV_PAGE_SIZE;
+
+				/* Skip slots that were never written. */
+				if (!buf_page_is_zeroes(page, 0)) {
+					recv_dblwr.add(page);
+					buf_dblwr_n_recv_pages++;
+				}
+			}
+		}
+
+		os_file_close(file);
+	}
+}
+
 /****************************************************************//**
 Creates or initialializes the doublewrite buffer at a database start. */
 static
@@ -168,6 +403,8 @@ buf_dblwr_init(
 
 	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		mem_zalloc(buf_size * sizeof(void*)));
+
+	buf_dblwr_init_parallel();
 }
 
 /****************************************************************//**
@@ -460,6 +697,10 @@ buf_dblwr_init_or_load_pages(
 		page += UNIV_PAGE_SIZE;
 	}
 
+	if (load_corrupt_pages) {
+		buf_dblwr_load_parallel_pages();
+	}
+
 	if (reset_space_ids) {
 		os_file_flush(file);
 	}
@@ -468,6 +709,19 @@ leave_func:
 	ut_free(unaligned_read_buf);
 }
 
+/****************************************************************//**
+Frees the contents of the parallel doublewrite files read at startup. */
+static
+void
+buf_dblwr_free_recv_bufs(void)
+/*==========================*/
+{
+	while (!buf_dblwr_recv_bufs.empty()) {
+		ut_free(buf_dblwr_recv_bufs.front());
+		buf_dblwr_recv_bufs.pop_front();
+	}
+}
+
 /****************************************************************//**
 Process the double write buffer pages. */
 void
@@ -520,6 +774,11 @@ buf_dblwr_process()
 
 			if (buf_page_is_corrupted(true, read_buf, zip_size)) {
 
+				/* With parallel doublewrite, older copies
+				of the page may have been left behind in
+				other segments. Restore the latest one. */
+				page = recv_dblwr.find_page(space_id, page_no);
+
 				fprintf(stderr,
 					"InnoDB: Warning: database page"
 					" corruption or a failed\n"
@@ -574,6 +833,8 @@ buf_dblwr_process()
 
 			} else if (buf_page_is_zeroes(read_buf, zip_size)) {
 
+				page = recv_dblwr.find_page(space_id, page_no);
+
 				if (!buf_page_is_zeroes(page, zip_size)
 				    && !buf_page_is_corrupted(true, page,
 							      zip_size)) {
@@ -594,6 +855,54 @@ buf_dblwr_process()
 
 	fil_flush_file_spaces(FIL_TABLESPACE);
 	ut_free(unaligned_read_buf);
+
+	/* The pages read from the parallel doublewrite files were
+	appended last; forget them and free their buffers. */
+	for (; buf_dblwr_n_recv_pages > 0; buf_dblwr_n_recv_pages--) {
+		recv_dblwr.pages.pop_back();
+	}
+
+	buf_dblwr_free_recv_bufs();
+}
+
+/****************************************************************//**
+Removes the parallel doublewrite files that are no longer written to: all
+of them when innodb_parallel_doublewrite is disabled, otherwise those of
+buffer pool instances beyond innodb_buffer_pool_instances. Must be called
+after crash recovery restored the pages from them. */
+UNIV_INTERN
+void
+buf_dblwr_remove_stale_files(void)
+/*==============================*/
+{
+	ulint	n_files = 0;
+
+	/* A forced recovery may not have restored the pages. */
+	if (srv_read_only_mode || srv_force_recovery > 0) {
+		return;
+	}
+
+	if (buf_dblwr != NULL && buf_dblwr->segs != NULL) {
+		n_files = buf_dblwr->n_segs / BUF_DBLWR_SEGS_PER_POOL;
+	}
+
+	for (ulint i = n_files; i < MAX_BUFFER_POOLS; i++) {
+		char		name[OS_FILE_MAX_PATH];
+		ibool		exists;
+		os_file_type_t	type;
+
+		buf_dblwr_file_name(name, i);
+
+		if (!os_file_status(name, &exists, &type) || !exists) {
+			continue;
+		}
+
+		if (os_file_delete_if_exists(innodb_file_data_key, name)) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Removed the unused parallel doublewrite "
+				"file %s.", name);
+		}
+	}
 }
 
 /****************************************************************//**
@@ -619,11 +928,69 @@ buf_dblwr_free(void)
 	mem_free(buf_dblwr->in_use);
 	buf_dblwr->in_use = NULL;
 
+	for (ulint i = 0; i < buf_dblwr->n_segs; i++) {
+		buf_dblwr_seg_t*	seg = &buf_dblwr->segs[i];
+
+		ut_ad(seg->b_reserved == 0);
+
+		os_event_free(seg->b_event);
+		ut_free(seg->write_buf_unaligned);
+		mem_free(seg->buf_block_arr);
+		mutex_free(&seg->mutex);
+	}
+
+	if (buf_dblwr->segs != NULL) {
+		for (ulint i = 0;
+		     i < buf_dblwr->n_segs / BUF_DBLWR_SEGS_PER_POOL;
+		     i++) {
+			os_file_close(buf_dblwr->files[i]);
+		}
+
+		mem_free(buf_dblwr->segs);
+		mem_free(buf_dblwr->files);
+		mem_free(buf_dblwr->file_names);
+	}
+
+	buf_dblwr_free_recv_bufs();
+
 	mutex_free(&buf_dblwr->mutex);
 	mem_free(buf_dblwr);
 	buf_dblwr = NULL;
 }
 
+/********************************************************************//**
+Updates a parallel doublewrite segment when the datafile write of a page
+of its batch is completed. */
+static
+void
+buf_dblwr_seg_update(
+/*=================*/
+	buf_dblwr_seg_t*	seg)	/*!< in/out: segment */
+{
+	mutex_enter(&seg->mutex);
+
+	ut_ad(seg->batch_running);
+	ut_ad(seg->b_reserved > 0);
+	ut_ad(seg->b_reserved <= seg->first_free);
+
+	seg->b_reserved--;
+
+	if (seg->b_reserved == 0) {
+		mutex_exit(&seg->mutex);
+		/* This will finish the batch. Sync data files
+		to the disk. */
+		fil_flush_file_spaces(FIL_TABLESPACE);
+		mutex_enter(&seg->mutex);
+
+		/* We can now reuse the segment: */
+		seg->first_free = 0;
+		seg->batch_running = false;
+		os_event_set(seg->b_event);
+	}
+
+	mutex_exit(&seg->mutex);
+}
+
 /********************************************************************//**
 Updates the doublewrite buffer when an IO request is completed. */
 UNIV_INTERN
@@ -637,9 +1004,23 @@ buf_dblwr_update(
 		return;
 	}
 
+	if (fsp_is_system_temporary(buf_page_get_space(bpage))) {
+		/* The page was not written through the doublewrite
+		buffer, see buf_flush_write_block_low(). */
+		return;
+	}
+
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
+		if (buf_dblwr->segs != NULL) {
+			buf_dblwr_seg_update(
+				buf_dblwr_get_seg(
+					buf_pool_from_bpage(bpage),
+					flush_type));
+			break;
+		}
+
 		mutex_enter(&buf_dblwr->mutex);
 
 		ut_ad(buf_dblwr->batch_running);
@@ -782,8 +1163,12 @@ void
 buf_dblwr_write_block_to_datafile(
 /*==============================*/
 	const buf_page_t*	bpage,	/*!< in: page to write */
-	bool			sync)	/*!< in: true if sync IO
+	bool			sync,	/*!< in: true if sync IO
 					is requested */
+	bool			batch)	/*!< in: true if the write is
+					part of a batch that the caller
+					submits with buf_dblwr_submit_batch();
+					ignored if sync */
 {
 	ut_a(bpage);
 	ut_a(buf_page_in_file(bpage));
@@ -791,14 +1176,15 @@ buf_dblwr_write_block_to_datafile(
 	const ulint flags = sync
 		? OS_FILE_WRITE
 		: OS_FILE_WRITE | OS_AIO_SIMULATED_WAKE_LATER;
+	const bool should_buffer = batch && !sync;
 
 	if (bpage->zip.data) {
-		fil_io(flags, sync, buf_page_get_space(bpage),
-		       buf_page_get_zip_size(bpage),
-		       buf_page_get_page_no(bpage), 0,
-		       buf_page_get_zip_size(bpage),
-		       (void*) bpage->zip.data,
-		       (void*) bpage);
+		_fil_io(flags, sync, buf_page_get_space(bpage),
+			buf_page_get_zip_size(bpage),
+			buf_page_get_page_no(bpage), 0,
+			buf_page_get_zip_size(bpage),
+			(void*) bpage->zip.data,
+			(void*) bpage, should_buffer);
 
 		return;
 	}
@@ -808,12 +1194,129 @@ buf_dblwr_write_block_to_datafile(
 	ut_a(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
 	buf_dblwr_check_page_lsn(block->frame);
 
-	fil_io(flags, sync, buf_block_get_space(block), 0,
-	       buf_block_get_page_no(block), 0, UNIV_PAGE_SIZE,
-	       (void*) block->frame, (void*) block);
+	_fil_io(flags, sync, buf_block_get_space(block), 0,
+		buf_block_get_page_no(block), 0, UNIV_PAGE_SIZE,
+		(void*) block->frame, (void*) block, should_buffer);
 
 }
 
+/********************************************************************//**
+Submits the datafile writes that a batch posted, and wakes up the aio
+threads if simulated aio is used. */
+static
+void
+buf_dblwr_submit_batch(void)
+/*========================*/
+{
+#if defined(LINUX_NATIVE_AIO)
+	os_aio_linux_dispatch_write_array_submit();
+#endif /* LINUX_NATIVE_AIO */
+
+	os_aio_simulated_wake_handler_threads();
+}
+
+/********************************************************************//**
+Checks the pages of a batch before it is written to the doublewrite
+buffer. */
+static
+void
+buf_dblwr_check_batch(
+/*==================*/
+	buf_page_t**	buf_block_arr,	/*!< in: blocks of the batch */
+	const byte*	write_buf,	/*!< in: copies of the pages */
+	ulint		n_pages)	/*!< in: number of pages */
+{
+	for (ulint len2 = 0, i = 0;
+	     i < n_pages;
+	     len2 += UNIV_PAGE_SIZE, i++) {
+
+		const buf_block_t*	block;
+
+		block = (buf_block_t*) buf_block_arr[i];
+
+		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
+		    || block->page.zip.data) {
+			/* No simple validate for compressed
+			pages exists. */
+			continue;
+		}
+
+		/* Check that the actual page in the buffer pool is
+		not corrupt and the LSN values are sane. */
+		buf_dblwr_check_block(block);
+
+		/* Check that the page as written to the doublewrite
+		buffer has sane LSN values. */
+		buf_dblwr_check_page_lsn(write_buf + len2);
+	}
+}
+
+/********************************************************************//**
+Writes the buffered batch of a parallel doublewrite segment to its file,
+syncs the file and then posts the writes to the datafiles. The segment
+is released by buf_dblwr_seg_update() when all of them have completed. */
+static
+void
+buf_dblwr_seg_flush(
+/*================*/
+	buf_dblwr_seg_t*	seg)	/*!< in/out: segment */
+{
+	ulint	first_free;
+
+try_again:
+	mutex_enter(&seg->mutex);
+
+	if (seg->first_free == 0) {
+
+		mutex_exit(&seg->mutex);
+
+		return;
+	}
+
+	if (seg->batch_running) {
+		/* The datafile writes of the previous batch have not
+		completed yet. Wait for them. */
+		ib_int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
+
+		os_event_wait_low(seg->b_event, sig_count);
+		goto try_again;
+	}
+
+	ut_ad(seg->first_free == seg->b_reserved);
+
+	/* Disallow anyone else to post to this segment until the
+	batch is finished. */
+	seg->batch_running = true;
+	first_free = seg->first_free;
+
+	mutex_exit(&seg->mutex);
+
+	buf_dblwr_check_batch(seg->buf_block_arr, seg->write_buf, first_free);
+
+	if (!os_file_write(seg->file_name, seg->file, seg->write_buf,
+			   seg->offset, first_free * UNIV_PAGE_SIZE)
+	    || !os_file_flush(seg->file)) {
+
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Cannot write to the parallel doublewrite "
+			"file %s.", seg->file_name);
+	}
+
+	srv_stats.dblwr_pages_written.add(first_free);
+	srv_stats.dblwr_writes.inc();
+
+	/* The batch is now durable in the segment and crash recovery
+	will find it there. Next do the writes to the intended
+	positions. */
+	for (ulint i = 0; i < first_free; i++) {
+		buf_dblwr_write_block_to_datafile(
+			seg->buf_block_arr[i], false, true);
+	}
+
+	buf_dblwr_submit_batch();
+}
+
 /********************************************************************//**
 Flushes possible buffered writes from the doublewrite memory buffer to disk,
 and also wakes up the aio thread if simulated aio is used. It is very
@@ -835,6 +1338,14 @@ buf_dblwr_flush_buffered_writes(void)
 		return;
 	}
 
+	if (buf_dblwr->segs != NULL) {
+		for (ulint i = 0; i < buf_dblwr->n_segs; i++) {
+			buf_dblwr_seg_flush(&buf_dblwr->segs[i]);
+		}
+
+		return;
+	}
+
 try_again:
 	mutex_enter(&buf_dblwr->mutex);
 
@@ -875,29 +1386,8 @@ try_again:
 
 	write_buf = buf_dblwr->write_buf;
 
-	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
-	     len2 += UNIV_PAGE_SIZE, i++) {
-
-		const buf_block_t*	block;
-
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
-
-		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
-		    || block->page.zip.data) {
-			/* No simple validate for compressed
-			pages exists. */
-			continue;
-		}
-
-		/* Check that the actual page in the buffer pool is
-		not corrupt and the LSN values are sane. */
-		buf_dblwr_check_block(block);
-
-		/* Check that the page as written to the doublewrite
-		buffer has sane LSN values. */
-		buf_dblwr_check_page_lsn(write_buf + len2);
-	}
+	buf_dblwr_check_batch(buf_dblwr->buf_block_arr, write_buf,
+			      first_free);
 
 	/* Write out the first block of the doublewrite buffer */
 	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
@@ -949,14 +1439,106 @@ flush:
 	ut_ad(first_free == buf_dblwr->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			buf_dblwr->buf_block_arr[i], false, true);
 	}
 
-	/* Wake possible simulated aio thread to actually post the
-	writes to the operating system. We don't flush the files
-	at this point. We leave it to the IO helper thread to flush
+	/* Submit the writes to the operating system, or wake possible
+	simulated aio thread to actually post them. We don't flush the
+	files at this point. We leave it to the IO helper thread to flush
 	datafiles when the whole batch has been processed. */
-	os_aio_simulated_wake_handler_threads();
+	buf_dblwr_submit_batch();
+}
+
+/********************************************************************//**
+Flushes the buffered writes of one flush batch of a buffer pool instance.
+With parallel doublewrite only the segment of that instance and flush
+type is written, so that batches of other instances are not serialized
+behind it; otherwise this is buf_dblwr_flush_buffered_writes(). */
+UNIV_INTERN
+void
+buf_dblwr_flush_batch(
+/*==================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_flush_t		flush_type)	/*!< in: BUF_FLUSH_LRU or
+						BUF_FLUSH_LIST */
+{
+	if (!srv_use_doublewrite_buf
+	    || buf_dblwr == NULL
+	    || buf_dblwr->segs == NULL) {
+
+		buf_dblwr_flush_buffered_writes();
+		return;
+	}
+
+	buf_dblwr_seg_flush(buf_dblwr_get_seg(buf_pool, flush_type));
+}
+
+/********************************************************************//**
+Copies a buffer page to a parallel doublewrite segment. If the segment
+is full, its batch is written first. */
+static
+void
+buf_dblwr_seg_add_to_batch(
+/*=======================*/
+	buf_dblwr_seg_t*	seg,	/*!< in/out: segment */
+	buf_page_t*		bpage)	/*!< in: buffer block to write */
+{
+	ulint	zip_size;
+	byte*	dest;
+
+try_again:
+	mutex_enter(&seg->mutex);
+
+	ut_a(seg->first_free <= srv_doublewrite_batch_size);
+
+	if (seg->batch_running) {
+		ib_int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
+
+		os_event_wait_low(seg->b_event, sig_count);
+		goto try_again;
+	}
+
+	if (seg->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&seg->mutex);
+
+		buf_dblwr_seg_flush(seg);
+
+		goto try_again;
+	}
+
+	dest = seg->write_buf + UNIV_PAGE_SIZE * seg->first_free;
+	zip_size = buf_page_get_zip_size(bpage);
+
+	if (zip_size) {
+		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
+		/* Copy the compressed page and clear the rest. */
+		memcpy(dest, bpage->zip.data, zip_size);
+		memset(dest + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
+	} else {
+		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
+		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
+				   UNIV_PAGE_SIZE);
+
+		memcpy(dest, ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
+	}
+
+	seg->buf_block_arr[seg->first_free] = bpage;
+
+	seg->first_free++;
+	seg->b_reserved++;
+
+	ut_ad(seg->first_free == seg->b_reserved);
+
+	if (seg->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&seg->mutex);
+
+		buf_dblwr_seg_flush(seg);
+
+		return;
+	}
+
+	mutex_exit(&seg->mutex);
 }
 
 /********************************************************************//**
@@ -973,6 +1555,14 @@ buf_dblwr_add_to_batch(
 
 	ut_a(buf_page_in_file(bpage));
 
+	if (buf_dblwr->segs != NULL) {
+		buf_dblwr_seg_add_to_batch(
+			buf_dblwr_get_seg(buf_pool_from_bpage(bpage),
+					  buf_page_get_flush_type(bpage)),
+			bpage);
+		return;
+	}
+
 try_again:
 	mutex_enter(&buf_dblwr->mutex);
 
@@ -1166,6 +1756,6 @@ retry:
 	/* We know that the write has been flushed to disk now
 	and during recovery we will find it in the doublewrite buffer
 	blocks. Next do the write to the intended position. */
-	buf_dblwr_write_block_to_datafile(bpage, sync);
+	buf_dblwr_write_block_to_datafile(bpage, sync, false);
 }
 #endif /* !UNIV_HOTBACKUP */
@@ -28,8 +28,10 @@ Created April 08, 2011 Vasil Dimov
 #include <stdarg.h> /* va_* */
 #include <string.h> /* strerror() */
 
+#include "btr0btr.h" /* btr_page_get_level_low() */
 #include "buf0buf.h" /* buf_pool_mutex_enter(), srv_buf_pool_instances */
 #include "buf0dump.h"
+#include "buf0rea.h" /* buf_read_load_pages() */
 #include "db0err.h"
 #include "dict0dict.h" /* dict_operation_lock */
 #include "os0file.h" /* OS_FILE_MAX_PATH */
@@ -68,6 +70,31 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/** Number of dump entries that a load thread takes at a time. The dump
+is written hottest page first; each batch is sorted on space_no,page_no
+before its reads are issued, so that the hottest pages are read first
+while adjacent pages of a batch can still be merged. */
+#define BUF_LOAD_BATCH_SIZE	256
+
+/** State of a buffer pool load, shared by the threads reading pages */
+struct buf_load_t {
+	buf_dump_t*	dump;		/*!< dump entries, hottest first */
+	ulint		dump_n;		/*!< number of entries in dump */
+	ulint		n_batches;	/*!< number of batches in dump */
+	ulint		next_batch;	/*!< next batch to be taken by a
+					thread, incremented atomically */
+	ulint		n_done;		/*!< number of dump entries
+					processed, incremented atomically */
+	ulint		n_read;		/*!< number of pages read from
+					disk, incremented atomically */
+	ulint		n_threads_active;/*!< number of buf_load_thread
+					instances still running */
+	ullint		start_us;	/*!< when the reads were started */
+};
+
+/** The buffer pool load being executed */
+static buf_load_t	buf_load_sys;
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -186,6 +213,55 @@ get_buf_dump_dir()
 	return(dump_dir);
 }
 
+/*****************************************************************//**
+Checks whether a page in the LRU list is a non-leaf B-tree page. The
+frame is read without a page latch: the page type and level of a page
+that is being modified cannot change in a way that would matter for the
+ordering of a dump.
+@return true if bpage is a B-tree page above the leaf level */
+static
+bool
+buf_dump_is_node_ptr_page(
+/*======================*/
+	const buf_page_t*	bpage)	/*!< in: page in the LRU list */
+{
+	const page_t*	frame;
+
+	if (buf_page_get_io_fix(bpage) == BUF_IO_READ) {
+		/* The frame has not been read in yet */
+		return(false);
+	}
+
+	if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE) {
+		frame = reinterpret_cast<const buf_block_t*>(bpage)->frame;
+	} else {
+		/* The page header of a compressed page is stored
+		uncompressed. */
+		frame = bpage->zip.data;
+	}
+
+	return(frame != NULL
+	       && fil_page_get_type(frame) == FIL_PAGE_INDEX
+	       && btr_page_get_level_low(frame) > 0);
+}
+
+/*****************************************************************//**
+Frees the per buffer pool instance arrays of a dump. */
+static
+void
+buf_dump_free(
+/*==========*/
+	buf_dump_t**	dumps,	/*!< in/out: arrays, NULL if not allocated */
+	ulint		n)	/*!< in: number of arrays */
+{
+	for (ulint i = 0; i < n; i++) {
+		if (dumps[i] != NULL) {
+			ut_free(dumps[i]);
+			dumps[i] = NULL;
+		}
+	}
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -201,12 +277,17 @@ buf_dump(
 {
 #define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
 
-	char	full_filename[OS_FILE_MAX_PATH];
-	char	tmp_filename[OS_FILE_MAX_PATH];
-	char	now[32];
-	FILE*	f;
-	ulint	i;
-	int	ret;
+	char		full_filename[OS_FILE_MAX_PATH];
+	char		tmp_filename[OS_FILE_MAX_PATH];
+	char		now[32];
+	FILE*		f;
+	buf_dump_t*	dumps[MAX_BUFFER_POOLS];
+	ulint		dumps_n[MAX_BUFFER_POOLS];
+	ulint		n_total;
+	ulint		n_written;
+	ulint		rank;
+	ulint		i;
+	int		ret;
 
 	ut_snprintf(full_filename, sizeof(full_filename),
 		    "%s%c%s", get_buf_dump_dir(), SRV_PATH_SEPARATOR,
@@ -227,12 +308,17 @@ buf_dump(
 	}
 	/* else */
 
+	memset(dumps, 0, sizeof(dumps));
+	memset(dumps_n, 0, sizeof(dumps_n));
+	n_total = 0;
+
 	/* walk through each buffer pool */
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
 		buf_dump_t*		dump;
 		ulint			n_pages;
+		ulint			n_node_ptr;
 		ulint			j;
 
 		buf_pool = buf_pool_from_array(i);
@@ -250,10 +336,11 @@ buf_dump(
 		}
 
 		dump = static_cast<buf_dump_t*>(
-			ut_malloc(n_pages * sizeof(*dump))) ;
+			ut_malloc(n_pages * sizeof(*dump)));
 
 		if (dump == NULL) {
 			buf_pool_mutex_exit(buf_pool);
+			buf_dump_free(dumps, i);
 			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
@@ -263,26 +350,70 @@ buf_dump(
 			return;
 		}
 
-		for (bpage = UT_LIST_GET_LAST(buf_pool->LRU), j = 0;
+		/* Walk the LRU list from the most recently used end.
+		The non-leaf B-tree pages are stored from the start of
+		the array and the other pages from the end of it, so that
+		the former are loaded before any leaf or undo page. */
+		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0,
+		     n_node_ptr = 0;
 		     bpage != NULL;
-		     bpage = UT_LIST_GET_PREV(LRU, bpage), j++) {
+		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
+
+			buf_dump_t	entry;
 
 			ut_a(buf_page_in_file(bpage));
 
-			dump[j] = BUF_DUMP_CREATE(buf_page_get_space(bpage),
-						  buf_page_get_page_no(bpage));
+			entry = BUF_DUMP_CREATE(buf_page_get_space(bpage),
+						buf_page_get_page_no(bpage));
+
+			if (buf_dump_is_node_ptr_page(bpage)) {
+				dump[n_node_ptr++] = entry;
+			} else {
+				dump[n_pages - 1 - (j - n_node_ptr)] = entry;
+			}
 		}
 
 		ut_a(j == n_pages);
 
 		buf_pool_mutex_exit(buf_pool);
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
+		/* Restore the LRU order of the other pages, which
+		were stored backwards. */
+		for (j = 0; j < (n_pages - n_node_ptr) / 2; j++) {
+			buf_dump_t	tmp = dump[n_node_ptr + j];
+
+			dump[n_node_ptr + j] = dump[n_pages - 1 - j];
+			dump[n_pages - 1 - j] = tmp;
+		}
+
+		/* Only keep the hottest srv_buf_pool_dump_pct percent */
+		if (srv_buf_pool_dump_pct < 100) {
+			n_pages = ut_max(n_pages * srv_buf_pool_dump_pct
+					 / 100, 1);
+		}
+
+		dumps[i] = dump;
+		dumps_n[i] = n_pages;
+		n_total += n_pages;
+	}
+
+	/* Interleave the buffer pool instances, so that the file is
+	ordered hottest page first across all of them. */
+	for (rank = 0, n_written = 0;
+	     n_written < n_total && !SHOULD_QUIT();
+	     rank++) {
+
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+
+			if (rank >= dumps_n[i]) {
+				continue;
+			}
+
 			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+				      BUF_DUMP_SPACE(dumps[i][rank]),
+				      BUF_DUMP_PAGE(dumps[i][rank]));
 			if (ret < 0) {
-				ut_free(dump);
+				buf_dump_free(dumps, srv_buf_pool_instances);
 				fclose(f);
 				buf_dump_status(STATUS_ERR,
 						"Cannot write to '%s': %s",
@@ -291,20 +422,20 @@ buf_dump(
 				return;
 			}
 
-			if (j % 128 == 0) {
+			if (n_written % 128 == 0) {
 				buf_dump_status(
 					STATUS_INFO,
-					"Dumping buffer pool "
-					ULINTPF "/" ULINTPF ", "
+					"Dumping buffer pool(s), "
 					"page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
+					n_written + 1, n_total);
 			}
-		}
 
-		ut_free(dump);
+			n_written++;
+		}
 	}
 
+	buf_dump_free(dumps, srv_buf_pool_instances);
+
 	ret = fclose(f);
 	if (ret != 0) {
 		buf_dump_status(STATUS_ERR,
@@ -379,6 +510,137 @@ buf_dump_sort(
 			      buf_dump_cmp);
 }
 
+/*****************************************************************//**
+Sleeps as long as the buffer pool load is ahead of
+innodb_buffer_pool_load_io_capacity pages per second. */
+static
+void
+buf_load_throttle(
+/*==============*/
+	ulint	n_read)	/*!< in: number of pages read so far by the load */
+{
+	ulong	io_capacity = srv_buf_load_io_capacity;
+	ullint	elapsed_us;
+	ullint	target_us;
+
+	if (io_capacity == 0) {
+		return;
+	}
+
+	target_us = (ullint) n_read * 1000000 / io_capacity;
+
+	for (;;) {
+		elapsed_us = ut_time_us(NULL) - buf_load_sys.start_us;
+
+		if (elapsed_us >= target_us
+		    || SHUTTING_DOWN() || buf_load_abort_flag) {
+			break;
+		}
+
+		/* Sleep in slices so that an abort or shutdown
+		request is noticed promptly. */
+		os_thread_sleep(ut_min(target_us - elapsed_us, 100000));
+	}
+}
+
+/*****************************************************************//**
+Reads batches of the buffer pool load until all of them have been taken,
+or the load is aborted. Each batch is sorted on space_no,page_no and its
+pages are read with one buf_read_load_pages() call per tablespace. */
+static
+void
+buf_load_batches(
+/*=============*/
+	bool	report)	/*!< in: whether to update
+			innodb_buffer_pool_load_status */
+{
+	buf_dump_t	tmp[BUF_LOAD_BATCH_SIZE];
+	ulint		page_nos[BUF_LOAD_BATCH_SIZE];
+
+	while (!SHUTTING_DOWN() && !buf_load_abort_flag) {
+		buf_dump_t*	batch;
+		ulint		batch_no;
+		ulint		n;
+		ulint		n_read;
+		ulint		n_done;
+		ulint		i;
+
+		batch_no = os_atomic_increment_ulint(
+			&buf_load_sys.next_batch, 1) - 1;
+
+		if (batch_no >= buf_load_sys.n_batches) {
+			break;
+		}
+
+		batch = buf_load_sys.dump + batch_no * BUF_LOAD_BATCH_SIZE;
+		n = ut_min(BUF_LOAD_BATCH_SIZE,
+			   buf_load_sys.dump_n
+			   - batch_no * BUF_LOAD_BATCH_SIZE);
+
+		buf_dump_sort(batch, tmp, 0, n);
+
+		/* Keep about one batch per load thread in flight, so
+		that the reads do not crowd out the rest of the
+		workload. */
+		while (buf_get_n_pending_read_ios()
+		       >= BUF_LOAD_BATCH_SIZE * srv_buf_load_threads
+		       && !SHUTTING_DOWN() && !buf_load_abort_flag) {
+
+			os_aio_simulated_wake_handler_threads();
+			os_thread_sleep(1000);
+		}
+
+		n_read = 0;
+
+		for (i = 0; i < n; ) {
+			ulint	space = BUF_DUMP_SPACE(batch[i]);
+			ulint	n_pages = 0;
+
+			do {
+				page_nos[n_pages++] = BUF_DUMP_PAGE(batch[i]);
+				i++;
+			} while (i < n && BUF_DUMP_SPACE(batch[i]) == space);
+
+			n_read += buf_read_load_pages(space, page_nos,
+						      n_pages);
+		}
+
+		n_done = os_atomic_increment_ulint(&buf_load_sys.n_done, n);
+
+		if (report) {
+			buf_load_status(STATUS_INFO,
+					"Loaded " ULINTPF "/" ULINTPF " pages",
+					n_done, buf_load_sys.dump_n);
+		}
+
+		buf_load_throttle(os_atomic_increment_ulint(
+			&buf_load_sys.n_read, n_read));
+	}
+}
+
+/******************************************************************//**
+Thread that reads batches of a buffer pool load in parallel with the
+buffer pool dump/load thread.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_load_thread)(
+/*============================*/
+	void*	arg MY_ATTRIBUTE((unused)))	/*!< in: a dummy parameter
+						required by os_thread_create */
+{
+	buf_load_batches(false);
+
+	os_atomic_decrement_ulint(&buf_load_sys.n_threads_active, 1);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -394,8 +656,8 @@ buf_load()
 	char		now[32];
 	FILE*		f;
 	buf_dump_t*	dump;
-	buf_dump_t*	dump_tmp;
 	ulint		dump_n;
+	ulint		n_threads;
 	ulint		total_buffer_pools_pages;
 	ulint		i;
 	ulint		space_id;
@@ -465,19 +727,6 @@ buf_load()
 		return;
 	}
 
-	dump_tmp = static_cast<buf_dump_t*>(
-		ut_malloc(dump_n * sizeof(*dump_tmp)));
-
-	if (dump_tmp == NULL) {
-		ut_free(dump);
-		fclose(f);
-		buf_load_status(STATUS_ERR,
-				"Cannot allocate " ULINTPF " bytes: %s",
-				(ulint) (dump_n * sizeof(*dump_tmp)),
-				strerror(errno));
-		return;
-	}
-
 	rewind(f);
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
@@ -491,7 +740,6 @@ buf_load()
 			/* else */
 
 			ut_free(dump);
-			ut_free(dump_tmp);
 			fclose(f);
 			buf_load_status(STATUS_ERR,
 					"Error parsing '%s', unable "
@@ -502,7 +750,6 @@ buf_load()
 
 		if (space_id > ULINT32_MASK || page_no > ULINT32_MASK) {
 			ut_free(dump);
-			ut_free(dump_tmp);
 			fclose(f);
 			buf_load_status(STATUS_ERR,
 					"Error parsing '%s': bogus "
@@ -534,35 +781,43 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		buf_dump_sort(dump, dump_tmp, 0, dump_n);
-	}
+	/* The dump is ordered hottest page first. It is read in batches
+of BUF_LOAD_BATCH_SIZE entries in that order by this thread and
+srv_buf_load_threads - 1 buf_load_thread instances. */
+	buf_load_sys.dump = dump;
+	buf_load_sys.dump_n = dump_n;
+	buf_load_sys.n_batches = (dump_n + BUF_LOAD_BATCH_SIZE - 1)
+		/ BUF_LOAD_BATCH_SIZE;
+	buf_load_sys.next_batch = 0;
+	buf_load_sys.n_done = 0;
+	buf_load_sys.n_read = 0;
+	buf_load_sys.start_us = ut_time_us(NULL);
 
-	ut_free(dump_tmp);
+	n_threads = ut_min(srv_buf_load_threads, buf_load_sys.n_batches);
+	n_threads = ut_max(n_threads, 1);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	buf_load_sys.n_threads_active = n_threads - 1;
 
-		buf_read_page_async(BUF_DUMP_SPACE(dump[i]),
-				    BUF_DUMP_PAGE(dump[i]));
+	os_wmb;
 
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
+	for (i = 1; i < n_threads; i++) {
+		os_thread_create(buf_load_thread, NULL, NULL);
+	}
 
-		if (i % 128 == 0) {
-			buf_load_status(STATUS_INFO,
-					"Loaded " ULINTPF "/" ULINTPF " pages",
-					i + 1, dump_n);
-		}
+	buf_load_batches(true);
 
-		if (buf_load_abort_flag) {
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_NOTICE,
-				"Buffer pool(s) load aborted on request");
-			return;
-		}
+	/* Wait for the other threads to finish their last batch */
+	while (buf_load_sys.n_threads_active > 0) {
+		os_thread_sleep(10000);
+	}
+
+	if (buf_load_abort_flag) {
+		buf_load_abort_flag = FALSE;
+		ut_free(dump);
+		buf_load_status(
+			STATUS_NOTICE,
+			"Buffer pool(s) load aborted on request");
+		return;
 	}
 
 	ut_free(dump);
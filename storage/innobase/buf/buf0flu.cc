@@ -65,8 +65,93 @@ reduce the wait time for the threads waiting for a clean block */
 
 #ifdef UNIV_PFS_THREAD
 UNIV_INTERN mysql_pfs_key_t buf_page_cleaner_thread_key;
+UNIV_INTERN mysql_pfs_key_t buf_page_cleaner_worker_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
+#ifdef UNIV_PFS_MUTEX
+UNIV_INTERN mysql_pfs_key_t page_cleaner_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
+/** State of a page_cleaner request for one buffer pool instance */
+enum page_cleaner_state_t {
+	PAGE_CLEANER_STATE_NONE = 0,	/*!< no request pending */
+	PAGE_CLEANER_STATE_REQUESTED,	/*!< waiting to be picked up
+					by a page_cleaner thread */
+	PAGE_CLEANER_STATE_FLUSHING,	/*!< being flushed by a
+					page_cleaner thread */
+	PAGE_CLEANER_STATE_FINISHED	/*!< flushed, waiting for the
+					coordinator to collect it */
+};
+
+/** Per buffer pool instance flush request of the page_cleaner. The
+coordinator fills in the request, any page_cleaner thread picks it up
+and reports the outcome back in the same slot. All the fields are
+protected by page_cleaner_t::mutex, except that the thread which has
+moved the slot to PAGE_CLEANER_STATE_FLUSHING may update the result
+fields without holding it. */
+struct page_cleaner_slot_t {
+	page_cleaner_state_t	state;		/*!< state of the request */
+	ulint			n_pages_requested;
+						/*!< number of pages to flush
+						from the flush_list */
+	ulint			n_flushed_lru;	/*!< number of pages
+						processed by the LRU batch */
+	ulint			n_flushed_list;	/*!< number of pages
+						flushed by the flush_list
+						batch */
+	bool			succeeded_list;	/*!< false if another
+						flush_list batch was already
+						running in the instance */
+	ulint			flush_lru_time;	/*!< elapsed time in ms
+						spent in LRU batches */
+	ulint			flush_lru_pass;	/*!< number of LRU batches */
+	ulint			flush_list_time;/*!< elapsed time in ms
+						spent in flush_list batches */
+	ulint			flush_list_pass;/*!< number of flush_list
+						batches */
+};
+
+/** Shared state of the page_cleaner coordinator and its workers */
+struct page_cleaner_t {
+	ib_mutex_t		mutex;		/*!< protects the fields
+						below and the slots */
+	os_event_t		is_requested;	/*!< set when there are
+						requested slots to flush */
+	os_event_t		is_finished;	/*!< set when all the slots
+						of a request are finished */
+	volatile ulint		n_workers;	/*!< number of running
+						worker threads */
+	bool			requested;	/*!< true while a request
+						is being served */
+	bool			flush_lru;	/*!< whether the LRU tail
+						is flushed as well */
+	lsn_t			lsn_limit;	/*!< upper limit of LSN
+						to be flushed */
+	ulint			n_slots;	/*!< number of slots, same
+						as srv_buf_pool_instances */
+	ulint			n_slots_requested;
+						/*!< number of slots in state
+						PAGE_CLEANER_STATE_REQUESTED */
+	ulint			n_slots_flushing;
+						/*!< number of slots in state
+						PAGE_CLEANER_STATE_FLUSHING */
+	ulint			n_slots_finished;
+						/*!< number of slots in state
+						PAGE_CLEANER_STATE_FINISHED */
+	ulint			flush_time;	/*!< elapsed time in ms
+						spent serving requests */
+	ulint			flush_pass;	/*!< number of requests
+						served */
+	page_cleaner_slot_t*	slots;		/*!< one slot per buffer
+						pool instance */
+	bool			is_running;	/*!< false once the
+						coordinator asks the workers
+						to exit */
+};
+
+/** The page_cleaner shared state, NULL if there is no page_cleaner */
+static page_cleaner_t*	page_cleaner = NULL;
+
 /** If LRU list of a buf_pool is less than this size then LRU eviction
 should not happen. This is because when we do LRU flushing we also put
 the blocks on free list. If LRU list is very small then we can end up
@@ -867,8 +952,11 @@ buf_flush_write_block_low(
 		      stderr);
 	}
 #else
-	/* Force the log to the disk before writing the modified block */
-	log_write_up_to(bpage->newest_modification, TRUE);
+	/* Force the log to the disk before writing the modified block.
+	Changes to the temporary tablespace are not redo logged. */
+	if (!fsp_is_system_temporary(buf_page_get_space(bpage))) {
+		log_write_up_to(bpage->newest_modification, TRUE);
+	}
 #endif
 	switch (buf_page_get_state(bpage)) {
 	case BUF_BLOCK_POOL_WATCH:
@@ -907,6 +995,17 @@ buf_flush_write_block_low(
 		       buf_page_get_page_no(bpage), 0,
 		       zip_size ? zip_size : UNIV_PAGE_SIZE,
 		       frame, bpage);
+	} else if (fsp_is_system_temporary(buf_page_get_space(bpage))) {
+		/* The temporary tablespace is re-created at startup:
+		a torn page in it never needs to be restored. The
+		simulated aio threads are woken up at once, because
+		the batch may not write anything to the doublewrite
+		buffer. */
+		fil_io(OS_FILE_WRITE,
+		       sync, buf_page_get_space(bpage), zip_size,
+		       buf_page_get_page_no(bpage), 0,
+		       zip_size ? zip_size : UNIV_PAGE_SIZE,
+		       frame, bpage);
 	} else if (flush_type == BUF_FLUSH_SINGLE_PAGE) {
 		buf_dblwr_write_single_page(bpage, sync);
 	} else {
@@ -1012,7 +1111,7 @@ buf_flush_page(
 			/* avoiding deadlock possibility involves doublewrite
 			buffer, should flush it, because it might hold the
 			another block->lock. */
-			buf_dblwr_flush_buffered_writes();
+			buf_dblwr_flush_batch(buf_pool, flush_type);
 
 			rw_lock_s_lock_gen(rw_lock, BUF_IO_WRITE);
                 }
@@ -1318,6 +1417,29 @@ buf_flush_page_and_try_neighbors(
 	return(flushed);
 }
 
+/*******************************************************************//**
+Calculates the number of blocks that still have to be moved to the
+withdraw list of a buffer pool instance that is being shrunk.
+@return number of blocks to withdraw, 0 if not shrinking */
+static inline
+ulint
+buf_get_withdraw_depth(
+/*===================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	if (buf_pool->curr_size < buf_pool->old_size
+	    && UT_LIST_GET_LEN(buf_pool->withdraw)
+	       < buf_pool->withdraw_target) {
+
+		return(buf_pool->withdraw_target
+		       - UT_LIST_GET_LEN(buf_pool->withdraw));
+	}
+
+	return(0);
+}
+
 /*******************************************************************//**
 This utility moves the uncompressed frames of pages to the free list.
 Note that this function does not actually flush any data to disk. It
@@ -1343,9 +1465,11 @@ buf_free_from_unzip_LRU_list_batch(
 
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
+	ulint		withdraw_depth = buf_get_withdraw_depth(buf_pool);
+
 	block = UT_LIST_GET_LAST(buf_pool->unzip_LRU);
 	while (block != NULL && count < max
-	       && free_len < srv_LRU_scan_depth
+	       && free_len < srv_LRU_scan_depth + withdraw_depth
 	       && lru_len > UT_LIST_GET_LEN(buf_pool->LRU) / 10) {
 
 		++scanned;
@@ -1403,9 +1527,11 @@ buf_flush_LRU_list_batch(
 
 	ut_ad(buf_pool_mutex_own(buf_pool));
 
+	ulint		withdraw_depth = buf_get_withdraw_depth(buf_pool);
+
 	for (bpage = UT_LIST_GET_LAST(buf_pool->LRU);
 	     bpage != NULL && (flush_count + evict_count) < max
-	     && free_len < srv_LRU_scan_depth
+	     && free_len < srv_LRU_scan_depth + withdraw_depth
 	     && lru_len > BUF_LRU_MIN_LEN;
 	     ++scanned,
 	     bpage = buf_pool->lru_hp.get()) {
@@ -1644,10 +1770,11 @@ static
 void
 buf_flush_common(
 /*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_dblwr_flush_buffered_writes();
+	buf_dblwr_flush_batch(buf_pool, flush_type);
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
@@ -1749,6 +1876,54 @@ buf_flush_wait_batch_end(
 	}
 }
 
+/*******************************************************************//**
+Flushes dirty blocks from the end of the flush list of a single buffer
+pool instance.
+NOTE: The calling thread is not allowed to own any latches on pages!
+@return true if a batch was queued successfully, false if another batch
+of the same type was already running in the instance */
+static
+bool
+buf_flush_do_batch(
+/*===============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	ulint		min_n,		/*!< in: wished minimum mumber of blocks
+					flushed (it is not guaranteed that the
+					actual number is that big, though) */
+	lsn_t		lsn_limit,	/*!< in: all blocks whose
+					oldest_modification is smaller than
+					this should be flushed (if their
+					number does not exceed min_n) */
+	ulint*		n_processed)	/*!< out: the number of pages
+					which were processed */
+{
+	std::pair<ulint, ulint>	res;
+
+	*n_processed = 0;
+
+	if (!buf_flush_start(buf_pool, BUF_FLUSH_LIST)) {
+		return(false);
+	}
+
+	res = buf_flush_batch(buf_pool, BUF_FLUSH_LIST, min_n, lsn_limit);
+
+	buf_flush_end(buf_pool, BUF_FLUSH_LIST);
+
+	buf_flush_common(buf_pool, BUF_FLUSH_LIST, res.first);
+
+	if (res.first) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_FLUSH_BATCH_TOTAL_PAGE,
+			MONITOR_FLUSH_BATCH_COUNT,
+			MONITOR_FLUSH_BATCH_PAGES,
+			res.first);
+	}
+
+	*n_processed = res.first;
+
+	return(true);
+}
+
 /*******************************************************************//**
 This utility flushes dirty blocks from the end of the flush list of
 all buffer pool instances.
@@ -1791,12 +1966,10 @@ buf_flush_list(
 
 	/* Flush to lsn_limit in all buffer pool instances */
 	for (i = 0; i < srv_buf_pool_instances; i++) {
-		buf_pool_t*		buf_pool;
-		std::pair<ulint, ulint>	res;
+		ulint	page_count;
 
-		buf_pool = buf_pool_from_array(i);
-
-		if (!buf_flush_start(buf_pool, BUF_FLUSH_LIST)) {
+		if (!buf_flush_do_batch(buf_pool_from_array(i),
+					min_n, lsn_limit, &page_count)) {
 			/* We have two choices here. If lsn_limit was
 			specified then skipping an instance of buffer
 			pool means we cannot guarantee that all pages
@@ -1812,23 +1985,8 @@ buf_flush_list(
 			continue;
 		}
 
-		res = buf_flush_batch(
-			buf_pool, BUF_FLUSH_LIST, min_n, lsn_limit);
-
-		buf_flush_end(buf_pool, BUF_FLUSH_LIST);
-
-		buf_flush_common(BUF_FLUSH_LIST, res.first);
-
 		if (n_processed) {
-			*n_processed += res.first;
-		}
-
-		if (res.first) {
-			MONITOR_INC_VALUE_CUMULATIVE(
-				MONITOR_FLUSH_BATCH_TOTAL_PAGE,
-				MONITOR_FLUSH_BATCH_COUNT,
-				MONITOR_FLUSH_BATCH_PAGES,
-				res.first);
+			*n_processed += page_count;
 		}
 	}
 
@@ -1916,64 +2074,80 @@ buf_flush_single_page_from_LRU(
 }
 
 /*********************************************************************//**
-Clears up tail of the LRU lists:
+Clears up tail of the LRU list of a single buffer pool instance:
 * Put replaceable pages at the tail of LRU to the free list
 * Flush dirty pages at the tail of LRU to the disk
-The depth to which we scan each buffer pool is controlled by dynamic
+The depth to which we scan the buffer pool is controlled by dynamic
 config parameter innodb_LRU_scan_depth.
 @return total pages processed. */
 UNIV_INTERN
 ulint
-buf_flush_LRU_tail(void)
-/*====================*/
+buf_flush_LRU_list(
+/*===============*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
 {
-	ulint	total_processed = 0;
+	std::pair<ulint, ulint>	res;
+	ulint			scan_depth;
+	ulint			withdraw_depth;
 
-	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+	/* srv_LRU_scan_depth can be arbitrarily large value.
+	We cap it with current LRU size. */
+	buf_pool_mutex_enter(buf_pool);
+	scan_depth = UT_LIST_GET_LEN(buf_pool->LRU);
+	withdraw_depth = buf_get_withdraw_depth(buf_pool);
+	buf_pool_mutex_exit(buf_pool);
 
-		buf_pool_t*	buf_pool = buf_pool_from_array(i);
-		std::pair<ulint, ulint>	res;
-		ulint	scan_depth;
+	scan_depth = ut_min(srv_LRU_scan_depth + withdraw_depth, scan_depth);
 
-		/* srv_LRU_scan_depth can be arbitrarily large value.
-		We cap it with current LRU size. */
-		buf_pool_mutex_enter(buf_pool);
-		scan_depth = UT_LIST_GET_LEN(buf_pool->LRU);
-		buf_pool_mutex_exit(buf_pool);
+	/* Currently only the page_cleaner threads can trigger an
+	LRU flush and each instance is handled by exactly one of
+	them at a time. It is possible that a batch triggered
+	during last iteration is still running. */
+	if (!buf_flush_start(buf_pool, BUF_FLUSH_LRU)) {
+		return(0);
+	}
 
-		scan_depth = ut_min(srv_LRU_scan_depth, scan_depth);
+	res = buf_flush_batch(buf_pool, BUF_FLUSH_LRU, scan_depth, 0);
 
-		/* Currently page_cleaner is the only thread
-		that can trigger an LRU flush. It is possible
-		that a batch triggered during last iteration is
-		still running, */
-		if (!buf_flush_start(buf_pool, BUF_FLUSH_LRU)) {
-			continue;
-		}
+	buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-		res = buf_flush_batch(buf_pool, BUF_FLUSH_LRU, scan_depth, 0);
+	buf_flush_common(buf_pool, BUF_FLUSH_LRU, res.first);
 
-		buf_flush_end(buf_pool, BUF_FLUSH_LRU);
+	if (res.first) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
+			MONITOR_LRU_BATCH_FLUSH_COUNT,
+			MONITOR_LRU_BATCH_FLUSH_PAGES,
+			res.first);
+	}
 
-		buf_flush_common(BUF_FLUSH_LRU, res.first);
+	if (res.second) {
+		MONITOR_INC_VALUE_CUMULATIVE(
+			MONITOR_LRU_BATCH_EVICT_TOTAL_PAGE,
+			MONITOR_LRU_BATCH_EVICT_COUNT,
+			MONITOR_LRU_BATCH_EVICT_PAGES,
+			res.second);
+	}
 
-		if (res.first) {
-			MONITOR_INC_VALUE_CUMULATIVE(
-				MONITOR_LRU_BATCH_FLUSH_TOTAL_PAGE,
-				MONITOR_LRU_BATCH_FLUSH_COUNT,
-				MONITOR_LRU_BATCH_FLUSH_PAGES,
-				res.first);
-		}
+	return(res.first + res.second);
+}
 
-		if (res.second) {
-			MONITOR_INC_VALUE_CUMULATIVE(
-				MONITOR_LRU_BATCH_EVICT_TOTAL_PAGE,
-				MONITOR_LRU_BATCH_EVICT_COUNT,
-				MONITOR_LRU_BATCH_EVICT_PAGES,
-				res.second);
-		}
+/*********************************************************************//**
+Clears up tail of the LRU lists:
+* Put replaceable pages at the tail of LRU to the free list
+* Flush dirty pages at the tail of LRU to the disk
+The depth to which we scan each buffer pool is controlled by dynamic
+config parameter innodb_LRU_scan_depth.
+@return total pages processed. */
+UNIV_INTERN
+ulint
+buf_flush_LRU_tail(void)
+/*====================*/
+{
+	ulint	total_processed = 0;
 
-		total_processed += (res.first + res.second);
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		total_processed += buf_flush_LRU_list(buf_pool_from_array(i));
 	}
 
 	return(total_processed);
@@ -2004,26 +2178,345 @@ buf_flush_wait_LRU_batch_end(void)
 	}
 }
 
+/******************************************************************//**
+Initialize the page_cleaner shared state. Must be called before the
+page_cleaner threads are created. */
+UNIV_INTERN
+void
+buf_flush_page_cleaner_init(void)
+/*=============================*/
+{
+	ut_ad(page_cleaner == NULL);
+	ut_ad(srv_n_page_cleaners >= 1);
+	ut_ad(srv_n_page_cleaners <= srv_buf_pool_instances);
+
+	page_cleaner = static_cast<page_cleaner_t*>(
+		mem_zalloc(sizeof(*page_cleaner)));
+
+	mutex_create(page_cleaner_mutex_key,
+		     &page_cleaner->mutex, SYNC_PAGE_CLEANER);
+
+	page_cleaner->is_requested = os_event_create();
+	page_cleaner->is_finished = os_event_create();
+
+	page_cleaner->n_slots = srv_buf_pool_instances;
+
+	page_cleaner->slots = static_cast<page_cleaner_slot_t*>(
+		mem_zalloc(page_cleaner->n_slots
+			  * sizeof(*page_cleaner->slots)));
+
+	/* The workers are accounted for before they are created, so
+	that the coordinator never frees the shared state under a
+	worker that has not yet started running. */
+	page_cleaner->n_workers = srv_n_page_cleaners - 1;
+
+	page_cleaner->is_running = true;
+}
+
+/******************************************************************//**
+Free the page_cleaner shared state. All the worker threads must have
+exited. */
+static
+void
+buf_flush_page_cleaner_close(void)
+/*==============================*/
+{
+	ut_ad(page_cleaner->n_workers == 0);
+
+	mutex_free(&page_cleaner->mutex);
+
+	os_event_free(page_cleaner->is_finished);
+	os_event_free(page_cleaner->is_requested);
+
+	mem_free(page_cleaner->slots);
+	mem_free(page_cleaner);
+
+	page_cleaner = NULL;
+}
+
+/******************************************************************//**
+Request flushing of all the buffer pool instances from the page_cleaner
+threads. The request is spread evenly amongst the instances. */
+static
+void
+pc_request(
+/*=======*/
+	ulint		min_n,		/*!< in: wished minimum number of
+					blocks flushed from the flush_list,
+					0 to skip the flush_list */
+	lsn_t		lsn_limit,	/*!< in: all blocks whose
+					oldest_modification is smaller than
+					this should be flushed */
+	bool		flush_lru)	/*!< in: whether the tail of the LRU
+					lists is flushed as well */
+{
+	if (min_n != ULINT_MAX) {
+		/* Ensure that flushing is spread evenly amongst the
+		buffer pool instances. When min_n is ULINT_MAX
+		we need to flush everything up to the lsn limit
+		so no limit here. */
+		min_n = (min_n + page_cleaner->n_slots - 1)
+			/ page_cleaner->n_slots;
+	}
+
+	mutex_enter(&page_cleaner->mutex);
+
+	ut_ad(!page_cleaner->requested);
+	ut_ad(page_cleaner->n_slots_requested == 0);
+	ut_ad(page_cleaner->n_slots_flushing == 0);
+	ut_ad(page_cleaner->n_slots_finished == 0);
+
+	page_cleaner->requested = true;
+	page_cleaner->flush_lru = flush_lru;
+	page_cleaner->lsn_limit = lsn_limit;
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+
+		ut_ad(slot->state == PAGE_CLEANER_STATE_NONE);
+
+		slot->state = PAGE_CLEANER_STATE_REQUESTED;
+		slot->n_pages_requested = min_n;
+	}
+
+	page_cleaner->n_slots_requested = page_cleaner->n_slots;
+
+	os_event_set(page_cleaner->is_requested);
+
+	mutex_exit(&page_cleaner->mutex);
+}
+
+/******************************************************************//**
+Pick up one requested slot, if any, and flush its buffer pool instance.
+Called by the coordinator and by the worker threads.
+@return number of slots still waiting to be picked up */
+static
+ulint
+pc_flush_slot(void)
+/*===============*/
+{
+	ulint	lru_tm = 0;
+	ulint	list_tm = 0;
+	ulint	lru_pass = 0;
+	ulint	list_pass = 0;
+
+	mutex_enter(&page_cleaner->mutex);
+
+	if (page_cleaner->n_slots_requested > 0) {
+		page_cleaner_slot_t*	slot = NULL;
+		ulint			i;
+
+		for (i = 0; i < page_cleaner->n_slots; i++) {
+			slot = &page_cleaner->slots[i];
+
+			if (slot->state == PAGE_CLEANER_STATE_REQUESTED) {
+				break;
+			}
+		}
+
+		/* A slot must be found because n_slots_requested > 0 */
+		ut_a(i < page_cleaner->n_slots);
+
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+		bool		flush_lru = page_cleaner->flush_lru;
+		lsn_t		lsn_limit = page_cleaner->lsn_limit;
+
+		page_cleaner->n_slots_requested--;
+		page_cleaner->n_slots_flushing++;
+		slot->state = PAGE_CLEANER_STATE_FLUSHING;
+
+		if (page_cleaner->n_slots_requested == 0) {
+			os_event_reset(page_cleaner->is_requested);
+		}
+
+		mutex_exit(&page_cleaner->mutex);
+
+		/* Flush pages from end of LRU if required */
+		slot->n_flushed_lru = 0;
+
+		if (flush_lru) {
+			lru_tm = ut_time_ms();
+			slot->n_flushed_lru = buf_flush_LRU_list(buf_pool);
+			lru_tm = ut_time_ms() - lru_tm;
+			lru_pass++;
+		}
+
+		/* Flush pages from flush_list if required */
+		slot->n_flushed_list = 0;
+		slot->succeeded_list = true;
+
+		if (slot->n_pages_requested > 0) {
+			list_tm = ut_time_ms();
+			slot->succeeded_list = buf_flush_do_batch(
+				buf_pool, slot->n_pages_requested,
+				lsn_limit, &slot->n_flushed_list);
+			list_tm = ut_time_ms() - list_tm;
+			list_pass++;
+		}
+
+		mutex_enter(&page_cleaner->mutex);
+
+		page_cleaner->n_slots_flushing--;
+		page_cleaner->n_slots_finished++;
+		slot->state = PAGE_CLEANER_STATE_FINISHED;
+
+		slot->flush_lru_time += lru_tm;
+		slot->flush_list_time += list_tm;
+		slot->flush_lru_pass += lru_pass;
+		slot->flush_list_pass += list_pass;
+
+		if (page_cleaner->n_slots_requested == 0
+		    && page_cleaner->n_slots_flushing == 0) {
+			os_event_set(page_cleaner->is_finished);
+		}
+	}
+
+	ulint	ret = page_cleaner->n_slots_requested;
+
+	mutex_exit(&page_cleaner->mutex);
+
+	return(ret);
+}
+
+/******************************************************************//**
+Wait until all the slots of the current request are flushed and
+collect the results. */
+static
+void
+pc_wait_finished(
+/*=============*/
+	ulint*	n_flushed_lru,	/*!< out: number of pages processed
+				by the LRU batches */
+	ulint*	n_flushed_list)	/*!< out: number of pages flushed
+				by the flush_list batches */
+{
+	*n_flushed_lru = 0;
+	*n_flushed_list = 0;
+
+	os_event_wait(page_cleaner->is_finished);
+
+	mutex_enter(&page_cleaner->mutex);
+
+	ut_ad(page_cleaner->n_slots_requested == 0);
+	ut_ad(page_cleaner->n_slots_flushing == 0);
+	ut_ad(page_cleaner->n_slots_finished == page_cleaner->n_slots);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+
+		ut_ad(slot->state == PAGE_CLEANER_STATE_FINISHED);
+
+		slot->state = PAGE_CLEANER_STATE_NONE;
+
+		*n_flushed_lru += slot->n_flushed_lru;
+		*n_flushed_list += slot->n_flushed_list;
+	}
+
+	page_cleaner->n_slots_finished = 0;
+	page_cleaner->requested = false;
+
+	os_event_reset(page_cleaner->is_finished);
+
+	mutex_exit(&page_cleaner->mutex);
+}
+
 /*********************************************************************//**
-Flush a batch of dirty pages from the flush list
-@return number of pages flushed, 0 if no page is flushed or if another
-flush_list type batch is running */
+Flush a batch of dirty pages from the flush list and optionally from the
+tail of the LRU list of all the buffer pool instances. The instances are
+handed out to the page_cleaner threads and flushed in parallel, the
+calling coordinator taking its share of the work.
+@return number of pages flushed from the flush_list, 0 if no page is
+flushed or if another flush_list type batch is running */
 static
 ulint
 page_cleaner_do_flush_batch(
 /*========================*/
 	ulint		n_to_flush,	/*!< in: number of pages that
 					we should attempt to flush. */
-	lsn_t		lsn_limit)	/*!< in: LSN up to which flushing
+	lsn_t		lsn_limit,	/*!< in: LSN up to which flushing
 					must happen */
+	bool		flush_lru,	/*!< in: whether the tail of the
+					LRU lists is flushed as well */
+	ulint*		n_flushed_lru)	/*!< out: number of pages
+					processed by the LRU batches */
 {
-	ulint n_flushed;
+	ulint	n_flushed;
+	ulint	flush_tm = ut_time_ms();
+
+	pc_request(n_to_flush, lsn_limit, flush_lru);
+
+	while (pc_flush_slot() > 0) {
+		/* The coordinator works as one of the page_cleaners
+		until every slot has been picked up. */
+	}
 
-	buf_flush_list(n_to_flush, lsn_limit, &n_flushed);
+	pc_wait_finished(n_flushed_lru, &n_flushed);
+
+	/* Only ever accessed by the coordinator. */
+	page_cleaner->flush_time += ut_time_ms() - flush_tm;
+	page_cleaner->flush_pass++;
 
 	return(n_flushed);
 }
 
+/*********************************************************************//**
+Aggregate the timings of the page_cleaner slots collected since the last
+call and publish their averages through the monitor counters. */
+static
+void
+page_cleaner_update_stats(void)
+/*===========================*/
+{
+	ulint	lru_tm = 0;
+	ulint	list_tm = 0;
+	ulint	lru_pass = 0;
+	ulint	list_pass = 0;
+	ulint	flush_tm = page_cleaner->flush_time;
+	ulint	flush_pass = page_cleaner->flush_pass;
+
+	page_cleaner->flush_time = 0;
+	page_cleaner->flush_pass = 0;
+
+	mutex_enter(&page_cleaner->mutex);
+
+	for (ulint i = 0; i < page_cleaner->n_slots; i++) {
+		page_cleaner_slot_t*	slot = &page_cleaner->slots[i];
+
+		lru_tm += slot->flush_lru_time;
+		list_tm += slot->flush_list_time;
+		lru_pass += slot->flush_lru_pass;
+		list_pass += slot->flush_list_pass;
+
+		slot->flush_lru_time = 0;
+		slot->flush_list_time = 0;
+		slot->flush_lru_pass = 0;
+		slot->flush_list_pass = 0;
+	}
+
+	mutex_exit(&page_cleaner->mutex);
+
+	MONITOR_SET(MONITOR_FLUSH_ADAPTIVE_AVG_PASS,
+		    list_pass / page_cleaner->n_slots);
+	MONITOR_SET(MONITOR_LRU_BATCH_FLUSH_AVG_PASS,
+		    lru_pass / page_cleaner->n_slots);
+	MONITOR_SET(MONITOR_FLUSH_AVG_PASS, flush_pass);
+
+	/* Avoid dividing by zero. */
+	lru_pass = ut_max(lru_pass, 1);
+	list_pass = ut_max(list_pass, 1);
+	flush_pass = ut_max(flush_pass, 1);
+
+	MONITOR_SET(MONITOR_FLUSH_ADAPTIVE_AVG_TIME_SLOT,
+		    list_tm / list_pass);
+	MONITOR_SET(MONITOR_LRU_BATCH_FLUSH_AVG_TIME_SLOT,
+		    lru_tm / lru_pass);
+	MONITOR_SET(MONITOR_FLUSH_ADAPTIVE_AVG_TIME_THREAD,
+		    list_tm / (srv_n_page_cleaners * flush_pass));
+	MONITOR_SET(MONITOR_LRU_BATCH_FLUSH_AVG_TIME_THREAD,
+		    lru_tm / (srv_n_page_cleaners * flush_pass));
+	MONITOR_SET(MONITOR_FLUSH_AVG_TIME, flush_tm / flush_pass);
+}
+
 /*********************************************************************//**
 Calculates if flushing is required based on number of dirty pages in
 the buffer pool.
@@ -2102,9 +2595,10 @@ af_get_pct_for_lsn(
 
 /*********************************************************************//**
 This function is called approximately once every second by the
-page_cleaner thread. Based on various factors it decides if there is a
-need to do flushing. If flushing is needed it is performed and the
-number of pages flushed is returned.
+page_cleaner coordinator. It always flushes the tail of the LRU lists
+and, based on various factors, decides if there is a need to flush the
+flush_list as well. The flushing is performed by all the page_cleaner
+threads and the number of pages processed is returned.
 @return number of pages flushed */
 static
 ulint
@@ -2128,17 +2622,20 @@ page_cleaner_flush_pages_if_needed(void)
 	ulint			pct_for_lsn = 0;
 	ulint			pct_total = 0;
 	int			age_factor = 0;
+	ulint			n_flushed_lru = 0;
 
 	cur_lsn = log_get_lsn();
 
 	if (prev_lsn == 0) {
 		/* First time around. */
 		prev_lsn = cur_lsn;
-		return(0);
 	}
 
 	if (prev_lsn == cur_lsn) {
-		return(0);
+		/* Flush pages from end of LRU only */
+		page_cleaner_do_flush_batch(0, 0, true, &n_flushed_lru);
+
+		return(n_flushed_lru);
 	}
 
 	/* We update our variables every srv_flushing_avg_loops
@@ -2158,6 +2655,8 @@ page_cleaner_flush_pages_if_needed(void)
 		n_iterations = 0;
 
 		sum_pages = 0;
+
+		page_cleaner_update_stats();
 	}
 
 	oldest_lsn = buf_pool_get_oldest_modification();
@@ -2187,7 +2686,8 @@ page_cleaner_flush_pages_if_needed(void)
 
 	prev_pages = n_pages;
 	n_pages = page_cleaner_do_flush_batch(
-		n_pages, oldest_lsn + lsn_avg_rate * (age_factor + 1));
+		n_pages, oldest_lsn + lsn_avg_rate * (age_factor + 1),
+		true, &n_flushed_lru);
 
 	last_lsn= cur_lsn;
 	last_pages= n_pages + 1;
@@ -2207,7 +2707,7 @@ page_cleaner_flush_pages_if_needed(void)
 		sum_pages += n_pages;
 	}
 
-	return(n_pages);
+	return(n_pages + n_flushed_lru);
 }
 
 /*********************************************************************//**
@@ -2233,29 +2733,32 @@ page_cleaner_sleep_if_needed(
 }
 
 /******************************************************************//**
-page_cleaner thread tasked with flushing dirty pages from the buffer
-pools. As of now we'll have only one instance of this thread.
+page_cleaner coordinator thread tasked with flushing dirty pages from
+the buffer pools. It decides how much to flush, hands out the buffer pool
+instances to the page_cleaner worker threads and flushes its own share.
 @return a dummy parameter */
 extern "C" UNIV_INTERN
 os_thread_ret_t
-DECLARE_THREAD(buf_flush_page_cleaner_thread)(
-/*==========================================*/
+DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
+/*===============================================*/
 	void*	arg MY_ATTRIBUTE((unused)))
 			/*!< in: a dummy parameter required by
 			os_thread_create */
 {
 	ulint	next_loop_time = ut_time_ms() + 1000;
 	ulint	n_flushed = 0;
+	ulint	n_flushed_lru = 0;
 	ulint	last_activity = srv_get_activity_count();
 
 	ut_ad(!srv_read_only_mode);
+	ut_ad(page_cleaner != NULL);
 
 #ifdef UNIV_PFS_THREAD
 	pfs_register_thread(buf_page_cleaner_thread_key);
 #endif /* UNIV_PFS_THREAD */
 
 #ifdef UNIV_DEBUG_THREAD_CREATION
-	fprintf(stderr, "InnoDB: page_cleaner thread running, id %lu\n",
+	fprintf(stderr, "InnoDB: page_cleaner coordinator running, id %lu\n",
 		os_thread_pf(os_thread_get_curr_id()));
 #endif /* UNIV_DEBUG_THREAD_CREATION */
 
@@ -2277,15 +2780,15 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 		if (srv_check_activity(last_activity)) {
 			last_activity = srv_get_activity_count();
 
-			/* Flush pages from end of LRU if required */
-			n_flushed = buf_flush_LRU_tail();
-
-			/* Flush pages from flush_list if required */
-			n_flushed += page_cleaner_flush_pages_if_needed();
+			/* Flush pages from end of LRU and from
+			flush_list if required */
+			n_flushed = page_cleaner_flush_pages_if_needed();
 		} else {
 			n_flushed = page_cleaner_do_flush_batch(
 							PCT_IO(100),
-							LSN_MAX);
+							LSN_MAX,
+							false,
+							&n_flushed_lru);
 
 			if (n_flushed) {
 				MONITOR_INC_VALUE_CUMULATIVE(
@@ -2317,7 +2820,8 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 	dirtied until we enter SRV_SHUTDOWN_FLUSH_PHASE phase. */
 
 	do {
-		n_flushed = page_cleaner_do_flush_batch(PCT_IO(100), LSN_MAX);
+		n_flushed = page_cleaner_do_flush_batch(
+			PCT_IO(100), LSN_MAX, false, &n_flushed_lru);
 
 		/* We sleep only if there are no pages to flush */
 		if (n_flushed == 0) {
@@ -2360,6 +2864,19 @@ DECLARE_THREAD(buf_flush_page_cleaner_thread)(
 	/* We have lived our life. Time to die. */
 
 thread_exit:
+	/* Tell the workers to exit and wait for them before freeing
+	the shared state. No request is pending at this point. */
+	mutex_enter(&page_cleaner->mutex);
+	page_cleaner->is_running = false;
+	os_event_set(page_cleaner->is_requested);
+	mutex_exit(&page_cleaner->mutex);
+
+	while (page_cleaner->n_workers > 0) {
+		os_thread_sleep(10000);
+	}
+
+	buf_flush_page_cleaner_close();
+
 	buf_page_cleaner_is_active = FALSE;
 
 	/* We count the number of threads in os_thread_exit(). A created
@@ -2369,6 +2886,49 @@ thread_exit:
 	OS_THREAD_DUMMY_RETURN;
 }
 
+/******************************************************************//**
+page_cleaner worker thread. Waits for the coordinator to request a
+flush and flushes the buffer pool instances it picks up.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_flush_page_cleaner_worker)(
+/*==========================================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(page_cleaner != NULL);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(buf_page_cleaner_worker_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: page_cleaner worker running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	for (;;) {
+		os_event_wait(page_cleaner->is_requested);
+
+		if (!page_cleaner->is_running) {
+			break;
+		}
+
+		pc_flush_slot();
+	}
+
+	/* This must be the last access to the shared state, the
+	coordinator frees it as soon as n_workers drops to zero. */
+	os_atomic_decrement_ulint(&page_cleaner->n_workers, 1);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 
 /** Functor to validate the flush list. */
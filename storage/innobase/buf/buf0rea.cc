@@ -129,6 +129,7 @@ buf_read_page_low(
 	buf_page_t*	bpage;
 	ulint		wake_later;
 	ibool		ignore_nonexistent_pages;
+	bool		for_ibuf_merge;
 
 	*err = DB_SUCCESS;
 
@@ -138,6 +139,9 @@ buf_read_page_low(
 	ignore_nonexistent_pages = mode & BUF_READ_IGNORE_NONEXISTENT_PAGES;
 	mode &= ~BUF_READ_IGNORE_NONEXISTENT_PAGES;
 
+	for_ibuf_merge = (mode & BUF_READ_FOR_IBUF_MERGE) != 0;
+	mode &= ~BUF_READ_FOR_IBUF_MERGE;
+
 	if (space == TRX_SYS_SPACE && buf_dblwr_page_inside(offset)) {
 		ut_print_timestamp(stderr);
 		fprintf(stderr,
@@ -171,6 +175,8 @@ buf_read_page_low(
 		return(0);
 	}
 
+	bpage->read_for_ibuf_merge = for_ibuf_merge;
+
 #ifdef UNIV_DEBUG
 	if (buf_debug_prints) {
 		fprintf(stderr,
@@ -481,6 +487,135 @@ buf_read_page_async(
 	return(count > 0);
 }
 
+/********************************************************************//**
+Issues asynchronous read requests for a batch of pages of one tablespace.
+The tablespace is looked up only once for the whole batch, and the
+requests are queued and submitted together, like the linear read-ahead
+does, so that reads of adjacent pages can be merged. Pages that are
+already in the buffer pool are skipped.
+@return number of page read requests issued */
+static
+ulint
+buf_read_pages_async(
+/*=================*/
+	ulint		space,		/*!< in: space id */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					to read */
+	ulint		n_stored,	/*!< in: number of page numbers
+					in the array */
+	bool		read_ahead)	/*!< in: whether to count the
+					reads as read-ahead */
+{
+	ulint		zip_size;
+	ulint		space_size;
+	ib_int64_t	tablespace_version;
+	ulint		count = 0;
+	dberr_t		err;
+	ulint		i;
+
+	zip_size = fil_space_get_zip_size(space);
+
+	if (zip_size == ULINT_UNDEFINED) {
+		/* The tablespace was dropped */
+		return(0);
+	}
+
+	tablespace_version = fil_space_get_version(space);
+	space_size = fil_space_get_size(space);
+
+	for (i = 0; i < n_stored; i++) {
+		ulint	n;
+
+		if (page_nos[i] >= space_size) {
+			/* The tablespace was truncated. Unlike a
+			synchronous read, an asynchronous read of a
+			page beyond the end of the tablespace would
+			look up its ibuf bitmap page, so skip it
+			here. */
+			continue;
+		}
+
+		n = buf_read_page_low(
+			&err, false, BUF_READ_ANY_PAGE
+			| OS_AIO_SIMULATED_WAKE_LATER
+			| BUF_READ_IGNORE_NONEXISTENT_PAGES,
+			space, zip_size, FALSE,
+			tablespace_version, page_nos[i], true);
+
+		if (err == DB_TABLESPACE_DELETED) {
+			break;
+		}
+
+		if (n && read_ahead) {
+			buf_pool_get(space, page_nos[i])
+				->stat.n_ra_pages_read++;
+		}
+
+		count += n;
+	}
+#if defined(LINUX_NATIVE_AIO)
+	os_aio_linux_dispatch_read_array_submit();
+#endif
+
+	os_aio_simulated_wake_handler_threads();
+
+	return(count);
+}
+
+/********************************************************************//**
+Issues asynchronous read requests for a batch of pages of one tablespace
+during a buffer pool load.
+@return number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_load_pages(
+/*================*/
+	ulint		space,		/*!< in: space id */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					to read, in ascending order */
+	ulint		n_stored)	/*!< in: number of page numbers
+					in the array */
+{
+	ulint	count;
+
+	count = buf_read_pages_async(space, page_nos, n_stored, false);
+
+	srv_stats.buf_pool_reads.add(count);
+
+	/* As in buf_read_page_async(), these deliberate reads are not
+	counted in buf_LRU_stat_inc_io(). */
+
+	return(count);
+}
+
+/********************************************************************//**
+Issues asynchronous read requests for pages that a range scan is about to
+visit, as found from the node pointers above the scanned leaf page. Like
+the linear read-ahead, the calling thread must not wait for these reads.
+@return number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_pages(
+/*=================*/
+	ulint		space,		/*!< in: space id */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					to read */
+	ulint		n_stored)	/*!< in: number of page numbers
+					in the array */
+{
+	ulint	count;
+
+	count = buf_read_pages_async(space, page_nos, n_stored, true);
+
+	if (count) {
+		/* Read ahead is considered one I/O operation for
+		the purpose of LRU policy decision. */
+		buf_LRU_stat_inc_io();
+	}
+
+	return(count);
+}
+
 /********************************************************************//**
 Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
@@ -824,7 +959,8 @@ buf_read_ibuf_merge_pages(
 		}
 
 		buf_read_page_low(&err, sync && (i + 1 == n_stored),
-				  BUF_READ_ANY_PAGE, space_ids[i],
+				  BUF_READ_ANY_PAGE | BUF_READ_FOR_IBUF_MERGE,
+				  space_ids[i],
 				  zip_size, TRUE, space_versions[i],
 				  page_nos[i], false);
 
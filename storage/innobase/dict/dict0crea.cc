@@ -276,7 +276,16 @@ dict_build_table_def_step(
 			DICT_TF2_FLAG_UNSET(table,
 					    DICT_TF2_FTS_AUX_HEX_NAME););
 
-	if (use_tablespace) {
+	if (dict_table_is_temporary(table)
+	    && srv_tmp_space_id != ULINT_UNDEFINED
+	    && !(table->flags
+		 & ~(DICT_TF_COMPACT | DICT_TF_MASK_ATOMIC_BLOBS))) {
+		/* Temporary tables in ROW_FORMAT=REDUNDANT, COMPACT or
+		DYNAMIC are created in the shared temporary tablespace,
+		which has no per-table file to create or delete. */
+		table->space = (unsigned int) srv_tmp_space_id;
+		DICT_TF2_FLAG_UNSET(table, DICT_TF2_USE_TABLESPACE);
+	} else if (use_tablespace) {
 		/* This table will not use the system tablespace.
 		Get a new space id. */
 		dict_hdr_get_new_id(NULL, NULL, &space);
@@ -1697,7 +1697,8 @@ dict_table_rename_in_cache(
 
 		mem_free(filepath);
 
-	} else if (table->space != TRX_SYS_SPACE) {
+	} else if (table->space != TRX_SYS_SPACE
+		   && !fsp_is_system_temporary(table->space)) {
 		if (DICT_TF2_FLAG_IS_SET(table, DICT_TF2_TEMPORARY)) {
 			ut_print_timestamp(stderr);
 			fputs("  InnoDB: Error: trying to rename a"
@@ -2362,6 +2362,8 @@ err_exit:
 
 	if (table->space == 0) {
 		/* The system tablespace is always available. */
+	} else if (fsp_is_system_temporary(table->space)) {
+		/* So is the temporary tablespace of this instance. */
 	} else if (table->flags2 & DICT_TF2_DISCARDED) {
 
 		ib_logf(IB_LOG_LEVEL_WARN,
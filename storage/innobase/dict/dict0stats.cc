@@ -113,6 +113,10 @@ See REF01 for the implementation.
 The above describes how to calculate the cardinality of an index.
 This algorithm is executed for each n-prefix of a multi-column index
 where n=1..n_uniq.
+
+If innodb_stats_persistent_max_pages is set, A is reduced for a given index
+so that the level scans and the dives for all its n-prefixes, which read
+about A * (H + 1) * n_uniq pages, stay within that many pages.
 @} */
 
 /* names of the tables from the persistent statistics storage */
@@ -135,9 +139,9 @@ where n=1..n_uniq.
 		: srv_stats_persistent_sample_pages)
 
 /* number of distinct records on a given level that are required to stop
-descending to lower levels and fetch N_SAMPLE_PAGES(index) records
+descending to lower levels and fetch n_sample_pages records
 from that level */
-#define N_DIFF_REQUIRED(index)	(N_SAMPLE_PAGES(index) * 10)
+#define N_DIFF_REQUIRED(n_sample_pages)	((n_sample_pages) * 10)
 
 /* A dynamic array where we store the boundaries of each distinct group
 of keys. For example if a btree level is:
@@ -559,6 +563,7 @@ dict_stats_empty_table(
 	table->stat_sum_of_other_index_sizes
 		= UT_LIST_GET_LEN(table->indexes) - 1;
 	table->stat_modified_counter = 0;
+	table->stat_modified_since_sampling = 0;
 
 	dict_index_t*	index;
 
@@ -1893,6 +1898,7 @@ dict_stats_analyze_index(
 	bool		level_is_analyzed;
 	ulint		n_uniq;
 	ulint		n_prefix;
+	ib_uint64_t	n_sample_pages;
 	ib_uint64_t	total_recs;
 	ib_uint64_t	total_pages;
 	mtr_t		mtr;
@@ -1939,17 +1945,32 @@ dict_stats_analyze_index(
 
 	n_uniq = dict_index_get_n_unique(index);
 
+	n_sample_pages = N_SAMPLE_PAGES(index);
+
+	if (srv_stats_persistent_max_pages > 0) {
+		/* For each n-column prefix we scan up to n_sample_pages
+		pages of a non-leaf level and dive from that level to
+		n_sample_pages leaf pages */
+		ib_uint64_t	max_sample_pages
+			= srv_stats_persistent_max_pages
+			/ ((root_level + 1) * n_uniq);
+
+		n_sample_pages = std::min(
+			n_sample_pages,
+			std::max(max_sample_pages, (ib_uint64_t) 1));
+	}
+
 	/* If the tree has just one level (and one page) or if the user
 	has requested to sample too many pages then do full scan.
 
-	For each n-column prefix (for n=1..n_uniq) N_SAMPLE_PAGES(index)
-	will be sampled, so in total N_SAMPLE_PAGES(index) * n_uniq leaf
+	For each n-column prefix (for n=1..n_uniq) n_sample_pages
+	will be sampled, so in total n_sample_pages * n_uniq leaf
 	pages will be sampled. If that number is bigger than the total
 	number of leaf pages then do full scan of the leaf level instead
 	since it will be faster and will give better results. */
 
 	if (root_level == 0
-	    || N_SAMPLE_PAGES(index) * n_uniq > index->stat_n_leaf_pages) {
+	    || n_sample_pages * n_uniq > index->stat_n_leaf_pages) {
 
 		if (root_level == 0) {
 			DEBUG_PRINTF("  %s(): just one page, "
@@ -2014,7 +2035,7 @@ dict_stats_analyze_index(
 
 		DEBUG_PRINTF("  %s(): searching level with >=%llu "
 			     "distinct records, n_prefix=%lu\n",
-			     __func__, N_DIFF_REQUIRED(index), n_prefix);
+			     __func__, N_DIFF_REQUIRED(n_sample_pages), n_prefix);
 
 		/* Commit the mtr to release the tree S lock to allow
 		other threads to do some work too. */
@@ -2038,7 +2059,8 @@ dict_stats_analyze_index(
 		distinct records because we do not want to scan the
 		leaf level because it may contain too many records */
 		if (level_is_analyzed
-		    && (n_diff_on_level[n_prefix - 1] >= N_DIFF_REQUIRED(index)
+		    && (n_diff_on_level[n_prefix - 1]
+			>= N_DIFF_REQUIRED(n_sample_pages)
 			|| level == 1)) {
 
 			goto found_level;
@@ -2051,7 +2073,7 @@ dict_stats_analyze_index(
 			/* if this does not hold we should be on
 			"found_level" instead of here */
 			ut_ad(n_diff_on_level[n_prefix - 1]
-			      < N_DIFF_REQUIRED(index));
+			      < N_DIFF_REQUIRED(n_sample_pages));
 
 			level--;
 			level_is_analyzed = false;
@@ -2076,13 +2098,13 @@ dict_stats_analyze_index(
 			total_recs is left from the previous iteration when
 			we scanned one level upper or we have not scanned any
 			levels yet in which case total_recs is 1. */
-			if (total_recs > N_SAMPLE_PAGES(index)) {
+			if (total_recs > n_sample_pages) {
 
 				/* if the above cond is true then we are
 				not at the root level since on the root
 				level total_recs == 1 (set before we
 				enter the n-prefix loop) and cannot
-				be > N_SAMPLE_PAGES(index) */
+				be > n_sample_pages */
 				ut_a(level != root_level);
 
 				/* step one level back and be satisfied with
@@ -2105,7 +2127,7 @@ dict_stats_analyze_index(
 
 			if (level == 1
 			    || n_diff_on_level[n_prefix - 1]
-			    >= N_DIFF_REQUIRED(index)) {
+			    >= N_DIFF_REQUIRED(n_sample_pages)) {
 				/* we have reached the last level we could scan
 				or we found a good level with many distinct
 				records */
@@ -2135,7 +2157,7 @@ found_level:
 		ut_ad(total_recs > 0);
 		ut_ad(n_diff_on_level[n_prefix - 1] > 0);
 
-		ut_ad(N_SAMPLE_PAGES(index) > 0);
+		ut_ad(n_sample_pages > 0);
 
 		n_diff_data_t*	data = &n_diff_data[n_prefix - 1];
 
@@ -2146,7 +2168,7 @@ found_level:
 		data->n_diff_on_level = n_diff_on_level[n_prefix - 1];
 
 		data->n_leaf_pages_to_analyze = std::min(
-			N_SAMPLE_PAGES(index),
+			n_sample_pages,
 			n_diff_on_level[n_prefix - 1]);
 
 		/* pick some records from this level and dive below them for
@@ -2249,6 +2271,8 @@ dict_stats_update_persistent(
 
 	table->stat_modified_counter = 0;
 
+	table->stat_modified_since_sampling = 0;
+
 	table->stat_initialized = TRUE;
 
 	dict_stats_assert_initialized(table);
@@ -2258,6 +2282,119 @@ dict_stats_update_persistent(
 	return(DB_SUCCESS);
 }
 
+/*********************************************************************//**
+Updates the persistent statistics of a table without sampling its indexes.
+The index sizes are read from the B-trees and the numbers of distinct key
+values are scaled by the change of the number of rows, which is maintained
+on every insert and delete, since the indexes were last sampled. This
+function is quick.
+@return true if the statistics were updated, false if the indexes must
+be sampled */
+static
+bool
+dict_stats_update_incremental(
+/*==========================*/
+	dict_table_t*	table)		/*!< in/out: table */
+{
+	dict_index_t*	index;
+	mtr_t		mtr;
+
+	DEBUG_PRINTF("%s(table=%s)\n", __func__, table->name);
+
+	dict_table_stats_lock(table, RW_X_LATCH);
+
+	index = dict_table_get_first_index(table);
+
+	if (!table->stat_initialized
+	    || index == NULL
+	    || dict_index_is_corrupted(index)
+	    || !dict_index_is_clust(index)) {
+
+		dict_table_stats_unlock(table, RW_X_LATCH);
+
+		return(false);
+	}
+
+	/* The number of rows when the clustered index was last sampled */
+	ib_uint64_t	old_n_rows = index->stat_n_diff_key_vals[
+		dict_index_get_n_unique(index) - 1];
+	ib_uint64_t	new_n_rows = table->stat_n_rows;
+
+	if (old_n_rows == 0 || new_n_rows == 0) {
+
+		dict_table_stats_unlock(table, RW_X_LATCH);
+
+		return(false);
+	}
+
+	double		ratio = (double) new_n_rows / old_n_rows;
+
+	table->stat_sum_of_other_index_sizes = 0;
+
+	for (; index != NULL; index = dict_table_get_next_index(index)) {
+
+		ut_ad(!dict_index_is_univ(index));
+
+		if ((index->type & DICT_FTS)
+		    || dict_stats_should_ignore_index(index)) {
+			continue;
+		}
+
+		ulint	size;
+		ulint	n_leaf_pages = 0;
+
+		mtr_start(&mtr);
+
+		mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+		size = btr_get_size(index, BTR_TOTAL_SIZE, &mtr);
+
+		if (size != ULINT_UNDEFINED) {
+			n_leaf_pages = btr_get_size(
+				index, BTR_N_LEAF_PAGES, &mtr);
+		}
+
+		mtr_commit(&mtr);
+
+		if (size != ULINT_UNDEFINED) {
+			index->stat_index_size = size;
+			index->stat_n_leaf_pages = ut_max(n_leaf_pages, 1UL);
+		}
+
+		for (ulint i = 0; i < dict_index_get_n_unique(index); i++) {
+			ib_uint64_t	n_diff = static_cast<ib_uint64_t>(
+				index->stat_n_diff_key_vals[i] * ratio);
+
+			index->stat_n_diff_key_vals[i] = std::min(
+				std::max(n_diff, (ib_uint64_t) 1), new_n_rows);
+
+			index->stat_n_non_null_key_vals[i] = std::min(
+				static_cast<ib_uint64_t>(
+					index->stat_n_non_null_key_vals[i]
+					* ratio),
+				new_n_rows);
+		}
+
+		if (dict_index_is_clust(index)) {
+			table->stat_clustered_index_size
+				= index->stat_index_size;
+		} else {
+			table->stat_sum_of_other_index_sizes
+				+= index->stat_index_size;
+		}
+	}
+
+	table->stats_last_recalc = ut_time();
+
+	table->stat_modified_counter = 0;
+
+	dict_stats_assert_initialized(table);
+
+	dict_table_stats_unlock(table, RW_X_LATCH);
+
+	return(true);
+}
+
 #include "mysql_com.h"
 /** Save an individual index's statistic into the persistent statistics
 storage.
@@ -3103,6 +3240,22 @@ dict_stats_update(
 	}
 
 	switch (stats_upd_option) {
+	case DICT_STATS_RECALC_INCREMENTAL:
+
+		/* Incremental recalculation requested by the auto
+		recalculation background thread; the indexes are sampled
+		again once too many rows have been modified since they
+		were last sampled */
+		if (!srv_read_only_mode
+		    && table->stat_modified_since_sampling * 100
+		    < table->stat_n_rows * srv_stats_incremental_pct
+		    && dict_stats_persistent_storage_check(false)
+		    && dict_stats_update_incremental(table)) {
+
+			return(dict_stats_save(table, NULL));
+		}
+
+		/* fall through */
 	case DICT_STATS_RECALC_PERSISTENT:
 
 		if (srv_read_only_mode) {
@@ -39,9 +39,13 @@ Created Apr 25, 2012 Vasil Dimov
 
 #define SHUTTING_DOWN()		(srv_shutdown_state != SRV_SHUTDOWN_NONE)
 
-/** Event to wake up the stats thread */
+/** Event to wake up the stats threads */
 UNIV_INTERN os_event_t		dict_stats_event = NULL;
 
+/** Number of background stats threads that are running, decremented
+under recalc_pool_mutex */
+UNIV_INTERN ulint		dict_stats_n_threads_active = 0;
+
 /** This mutex protects the "recalc_pool" variable. */
 static ib_mutex_t		recalc_pool_mutex;
 #ifdef HAVE_PSI_INTERFACE
@@ -288,6 +292,17 @@ dict_stats_process_entry_from_recalc_pool()
 		return;
 	}
 
+	if (table->stats_bg_flag & BG_STAT_IN_PROGRESS) {
+		/* Another stats thread is working on this table, put it
+		back on the auto recalc list for later */
+		dict_stats_recalc_pool_add(table);
+		dict_table_close(table, TRUE, FALSE);
+		mutex_exit(&dict_sys->mutex);
+		return;
+	}
+
+	bool	recalc_full = table->stats_bg_flag & BG_STAT_RECALC_FULL;
+
 	table->stats_bg_flag = BG_STAT_IN_PROGRESS;
 
 	mutex_exit(&dict_sys->mutex);
@@ -299,7 +314,8 @@ dict_stats_process_entry_from_recalc_pool()
 	be replaced with something else, though a time interval is the natural
 	approach. */
 
-	if (ut_difftime(ut_time(), table->stats_last_recalc)
+	if (!recalc_full
+	    && ut_difftime(ut_time(), table->stats_last_recalc)
 	    < MIN_RECALC_INTERVAL) {
 
 		/* Stats were (re)calculated not long ago. To avoid
@@ -310,12 +326,17 @@ dict_stats_process_entry_from_recalc_pool()
 
 	} else {
 
-		dict_stats_update(table, DICT_STATS_RECALC_PERSISTENT);
+		dict_stats_update(table,
+				  recalc_full
+				  ? DICT_STATS_RECALC_PERSISTENT
+				  : DICT_STATS_RECALC_INCREMENTAL);
 	}
 
 	mutex_enter(&dict_sys->mutex);
 
-	table->stats_bg_flag = BG_STAT_NONE;
+	/* Keep BG_STAT_RECALC_FULL if ANALYZE TABLE queued the table
+	again meanwhile */
+	table->stats_bg_flag &= BG_STAT_RECALC_FULL;
 
 	dict_table_close(table, TRUE, FALSE);
 
@@ -325,7 +346,7 @@ dict_stats_process_entry_from_recalc_pool()
 /*****************************************************************//**
 This is the thread for background stats gathering. It pops tables, from
 the auto recalc list and proceeds them, eventually recalculating their
-statistics.
+statistics. innodb_stats_auto_recalc_threads of them share the list.
 @return this function does not return, it calls os_thread_exit() */
 extern "C" UNIV_INTERN
 os_thread_ret_t
@@ -336,8 +357,6 @@ DECLARE_THREAD(dict_stats_thread)(
 {
 	ut_a(!srv_read_only_mode);
 
-	srv_dict_stats_thread_active = TRUE;
-
 	while (!SHUTTING_DOWN()) {
 
 		/* Wake up periodically even if not signaled. This is
@@ -357,7 +376,15 @@ DECLARE_THREAD(dict_stats_thread)(
 		os_event_reset(dict_stats_event);
 	}
 
-	srv_dict_stats_thread_active = FALSE;
+	mutex_enter(&recalc_pool_mutex);
+
+	ut_a(dict_stats_n_threads_active > 0);
+
+	if (--dict_stats_n_threads_active == 0) {
+		srv_dict_stats_thread_active = FALSE;
+	}
+
+	mutex_exit(&recalc_pool_mutex);
 
 	/* We count the number of threads in os_thread_exit(). A created
 	thread should always use that to exit instead of return(). */
@@ -2675,6 +2675,82 @@ fil_close_tablespace(
 	return(err);
 }
 
+#ifndef UNIV_HOTBACKUP
+/*******************************************************************//**
+Truncates an UNDO tablespace to the given size. All pages of the
+tablespace are discarded from the buffer pool without writing them,
+and the data file is re-created filled with zeros. The caller must
+re-initialize the tablespace header and must make sure that the redo
+log written for the old pages is not applied in crash recovery.
+@return	true if success */
+UNIV_INTERN
+bool
+fil_truncate_tablespace(
+/*====================*/
+	ulint	id,	/*!< in: space id */
+	ulint	size)	/*!< in: new size of the tablespace in pages */
+{
+	char*		path = 0;
+	fil_space_t*	space = 0;
+	fil_node_t*	node;
+	bool		success;
+
+	ut_a(id != TRX_SYS_SPACE);
+	ut_ad(!srv_read_only_mode);
+
+	dberr_t		err = fil_check_pending_operations(id, &space, &path);
+
+	if (err != DB_SUCCESS) {
+		return(false);
+	}
+
+	ut_a(space);
+	ut_a(path != 0);
+	ut_a(fsp_flags_get_zip_size(space->flags) == 0);
+
+	/* Since space->stop_new_ops is set, no pages of the tablespace
+	can be read to the buffer pool. The old contents of the pages
+	are discarded, including any modifications not yet written. */
+
+	buf_LRU_flush_or_remove_pages(id, BUF_REMOVE_ALL_NO_WRITE, 0);
+
+	mutex_enter(&fil_system->mutex);
+
+	node = UT_LIST_GET_FIRST(space->chain);
+
+	success = fil_node_prepare_for_io(node, fil_system, space);
+
+	mutex_exit(&fil_system->mutex);
+
+	if (success) {
+		/* The file node cannot be closed while its n_pending
+		is non-zero. */
+		success = os_file_truncate(path, node->handle, 0)
+			&& os_file_set_size(
+				path, node->handle,
+				(os_offset_t) size * UNIV_PAGE_SIZE);
+
+		mutex_enter(&fil_system->mutex);
+
+		if (success) {
+			space->size = node->size = size;
+		}
+
+		fil_node_complete_io(node, fil_system, OS_FILE_WRITE);
+
+		mutex_exit(&fil_system->mutex);
+	}
+
+	mutex_enter(&fil_system->mutex);
+	space->stop_new_ops = FALSE;
+	mutex_exit(&fil_system->mutex);
+
+	mem_free(path);
+
+	return(success);
+}
+#endif /* !UNIV_HOTBACKUP */
+
 /*******************************************************************//**
 Deletes a single-table tablespace. The tablespace must be cached in the
 memory cache.
@@ -5573,6 +5649,7 @@ _fil_io(
 	ulint		wake_later;
 	os_offset_t	offset;
 	ibool		ignore_nonexistent_pages;
+	ulint		page_compression = 0;
 
 	is_log = type & OS_FILE_LOG;
 	type = type & ~OS_FILE_LOG;
@@ -5719,6 +5796,15 @@ _fil_io(
 		ut_error;
 	}
 
+	/* Full pages of single-table tablespaces may be stored with
+	transparent page compression */
+	if (!zip_size && !byte_offset && len == UNIV_PAGE_SIZE && !is_log
+	    && space->purpose == FIL_TABLESPACE
+	    && fil_is_user_tablespace_id(space->id)) {
+
+		page_compression = OS_AIO_PAGE_COMPRESSION;
+	}
+
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
@@ -5763,8 +5849,9 @@ _fil_io(
 	}
 #else
 	/* Queue the aio request */
-	ret = os_aio(type, mode | wake_later, node->name, node->handle, buf,
-		     offset, len, node, message, should_buffer);
+	ret = os_aio(type, mode | wake_later | page_compression, node->name,
+		     node->handle, buf, offset, len, node, message,
+		     should_buffer);
 #endif /* UNIV_HOTBACKUP */
 	ut_a(ret);
 
@@ -6312,6 +6399,15 @@ fil_iterate(
 		os_offset_t	page_off = offset;
 		ulint		n_pages_read = (ulint) n_bytes / iter.page_size;
 
+		/* Pages written with transparent page compression are
+		converted back to their normal format. */
+		if (callback.get_zip_size() == 0) {
+			for (ulint i = 0; i < n_pages_read; ++i) {
+				os_file_page_decompress(
+					io_buffer + i * iter.page_size, NULL);
+			}
+		}
+
 		for (ulint i = 0; i < n_pages_read; ++i) {
 
 			buf_block_set_file_page(block, space_id, page_no++);
@@ -668,6 +668,19 @@ fsp_header_init_fields(
 }
 
 #ifndef UNIV_HOTBACKUP
+/**********************************************************************//**
+Checks if a tablespace is the shared temporary tablespace. Changes to
+its pages are not redo logged and it is re-created at startup.
+@return	true if space is the shared temporary tablespace */
+UNIV_INTERN
+bool
+fsp_is_system_temporary(
+/*====================*/
+	ulint	space)		/*!< in: space id */
+{
+	return(space == srv_tmp_space_id);
+}
+
 /**********************************************************************//**
 Initializes the space header of a new created space and creates also the
 insert buffer tree root if space == 0. */
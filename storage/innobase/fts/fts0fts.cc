@@ -67,6 +67,14 @@ UNIV_INTERN ulong      fts_max_total_cache_size;
 a configurable variable */
 UNIV_INTERN ulong	fts_result_cache_limit;
 
+/** Memory used for caching the words that queries read from the
+FTS INDEX tables, for each table */
+UNIV_INTERN ulong	fts_word_cache_size;
+
+/** Number of threads that read the words of a query from the
+FTS INDEX tables */
+UNIV_INTERN ulong	fts_query_pll_degree;
+
 /** Variable specifying the maximum FTS max token size */
 UNIV_INTERN ulong	fts_max_token_size;
 
@@ -103,6 +111,7 @@ UNIV_INTERN mysql_pfs_key_t	fts_optimize_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	fts_bg_threads_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	fts_doc_id_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	fts_pll_tokenize_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	fts_word_cache_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
 /** variable to record innodb_fts_internal_tbl_name for information
@@ -283,6 +292,15 @@ fts_words_free(
 /*===========*/
 	ib_rbt_t*	words)		/*!< in: rb tree of words */
 	MY_ATTRIBUTE((nonnull));
+
+/** Free the word cache of an FTS index.
+@param[in,out]	cache		fts cache
+@param[in,out]	index_cache	index cache */
+static
+void
+fts_word_cache_free(
+	fts_cache_t*		cache,
+	fts_index_cache_t*	index_cache);
 #ifdef FTS_CACHE_SIZE_DEBUG
 /****************************************************************//**
 Read the max cache size parameter from the config table. */
@@ -644,6 +662,12 @@ fts_cache_create(
 	mutex_create(
 		fts_doc_id_mutex_key, &cache->doc_id_lock, SYNC_FTS_OPTIMIZE);
 
+	mutex_create(
+		fts_word_cache_mutex_key, &cache->word_cache_lock,
+		SYNC_FTS_OPTIMIZE);
+
+	UT_LIST_INIT(cache->word_cache_lru);
+
 	/* This is the heap used to create the cache itself. */
 	cache->self_heap = ib_heap_allocator_create(heap);
 
@@ -892,6 +916,8 @@ fts_drop_index(
 				rbt_free(index_cache->words);
 			}
 
+			fts_word_cache_free(cache, index_cache);
+
 			ib_vector_remove(cache->indexes, *(void**) index_cache);
 		}
 
@@ -1033,6 +1059,10 @@ fts_cache_index_cache_create(
 		mem_heap_zalloc(static_cast<mem_heap_t*>(
 			cache->self_heap->arg), n_bytes));
 
+	index_cache->cached_words = rbt_create_arg_cmp(
+		sizeof(fts_cached_word_t), innobase_fts_text_cmp,
+		index_cache->charset);
+
 	fts_index_cache_init(cache->sync_heap, index_cache);
 
 	if (cache->get_docs) {
@@ -1206,11 +1236,20 @@ fts_cache_destroy(
 /*==============*/
 	fts_cache_t*	cache)			/*!< in: cache*/
 {
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_word_cache_free(
+			cache, static_cast<fts_index_cache_t*>(
+				ib_vector_get(cache->indexes, i)));
+	}
+
+	ut_ad(UT_LIST_GET_LEN(cache->word_cache_lru) == 0);
+
 	rw_lock_free(&cache->lock);
 	rw_lock_free(&cache->init_lock);
 	mutex_free(&cache->optimize_lock);
 	mutex_free(&cache->deleted_lock);
 	mutex_free(&cache->doc_id_lock);
+	mutex_free(&cache->word_cache_lock);
 	os_event_free(cache->sync->event);
 
 	if (cache->stopword_info.cached_stopword) {
@@ -1224,6 +1263,238 @@ fts_cache_destroy(
 	mem_heap_free(cache->cache_heap);
 }
 
+/** Copy a word and its rows.
+@param[out]	dst	copy of the word, to be freed with fts_word_free()
+@param[in]	src	word to copy
+@return memory used by the copy */
+static
+ulint
+fts_word_copy(
+	fts_word_t*		dst,
+	const fts_word_t*	src)
+{
+	mem_heap_t*	heap;
+	ulint		n_nodes = ib_vector_size(src->nodes);
+
+	fts_word_init(dst, src->text.f_str, src->text.f_len);
+
+	heap = static_cast<mem_heap_t*>(dst->heap_alloc->arg);
+
+	for (ulint i = 0; i < n_nodes; ++i) {
+		const fts_node_t*	node;
+		fts_node_t*		copy;
+
+		node = static_cast<const fts_node_t*>(
+			ib_vector_get_const(src->nodes, i));
+
+		copy = static_cast<fts_node_t*>(
+			ib_vector_push(dst->nodes, node));
+
+		copy->ilist = static_cast<byte*>(
+			mem_heap_dup(heap, node->ilist, node->ilist_size));
+		copy->ilist_size_alloc = node->ilist_size;
+	}
+
+	return(mem_heap_get_size(heap));
+}
+
+/** Remove a word from the word cache.
+@param[in,out]	cache		fts cache
+@param[in]	cached		word to remove */
+static
+void
+fts_word_cache_remove(
+	fts_cache_t*		cache,
+	fts_cached_word_t*	cached)
+{
+	fts_word_t	word = cached->word;
+	ibool		deleted;
+
+	ut_ad(mutex_own(&cache->word_cache_lock));
+	ut_ad(cache->word_cache_size >= cached->size);
+
+	UT_LIST_REMOVE(lru, cache->word_cache_lru, cached);
+	cache->word_cache_size -= cached->size;
+
+	deleted = rbt_delete(cached->tree, &word.text);
+	ut_a(deleted);
+
+	fts_word_free(&word);
+}
+
+/** Free the word cache of an FTS index.
+@param[in,out]	cache		fts cache
+@param[in,out]	index_cache	index cache */
+static
+void
+fts_word_cache_free(
+	fts_cache_t*		cache,
+	fts_index_cache_t*	index_cache)
+{
+	const ib_rbt_node_t*	rbt_node;
+
+	mutex_enter(&cache->word_cache_lock);
+
+	while ((rbt_node = rbt_first(index_cache->cached_words)) != NULL) {
+		fts_word_cache_remove(
+			cache, rbt_value(fts_cached_word_t, rbt_node));
+	}
+
+	mutex_exit(&cache->word_cache_lock);
+
+	rbt_free(index_cache->cached_words);
+	index_cache->cached_words = NULL;
+}
+
+/** Invalidate the words that queries cached after reading them from
+the FTS INDEX tables. To be called after the INDEX tables changed.
+@param[in,out]	cache	fts cache */
+UNIV_INTERN
+void
+fts_word_cache_invalidate(
+	fts_cache_t*	cache)
+{
+	fts_cached_word_t*	cached;
+
+	mutex_enter(&cache->word_cache_lock);
+
+	++cache->word_cache_version;
+
+	while ((cached = UT_LIST_GET_FIRST(cache->word_cache_lru)) != NULL) {
+		fts_word_cache_remove(cache, cached);
+	}
+
+	ut_ad(cache->word_cache_size == 0);
+
+	mutex_exit(&cache->word_cache_lock);
+}
+
+/** Get the version of the word cache, to be passed to
+fts_word_cache_add() for the words read from the INDEX table after this.
+@param[in]	cache		fts cache
+@return version of the cached words */
+UNIV_INTERN
+ib_uint64_t
+fts_word_cache_get_version(
+	fts_cache_t*	cache)
+{
+	ib_uint64_t	version;
+
+	mutex_enter(&cache->word_cache_lock);
+	version = cache->word_cache_version;
+	mutex_exit(&cache->word_cache_lock);
+
+	return(version);
+}
+
+/** Look up a word in the word cache of an FTS index.
+@param[in,out]	cache		fts cache
+@param[in,out]	cached_words	fts_index_cache_t::cached_words
+@param[in]	text		word to look up
+@param[out]	word		copy of the word and its rows, to be
+				freed with fts_word_free()
+@return true if the word was found */
+UNIV_INTERN
+bool
+fts_word_cache_get(
+	fts_cache_t*		cache,
+	ib_rbt_t*		cached_words,
+	const fts_string_t*	text,
+	fts_word_t*		word)
+{
+	ib_rbt_bound_t		parent;
+	fts_cached_word_t*	cached;
+
+	if (fts_word_cache_size == 0) {
+		return(false);
+	}
+
+	mutex_enter(&cache->word_cache_lock);
+
+	if (rbt_search(cached_words, &parent, text) != 0) {
+		mutex_exit(&cache->word_cache_lock);
+
+		return(false);
+	}
+
+	cached = rbt_value(fts_cached_word_t, parent.last);
+
+	UT_LIST_REMOVE(lru, cache->word_cache_lru, cached);
+	UT_LIST_ADD_FIRST(lru, cache->word_cache_lru, cached);
+
+	fts_word_copy(word, &cached->word);
+
+	mutex_exit(&cache->word_cache_lock);
+
+	return(true);
+}
+
+/** Add a copy of a word read from an FTS INDEX table to the word cache
+of the index, unless the cache was invalidated since the word was read.
+@param[in,out]	cache		fts cache
+@param[in,out]	cached_words	fts_index_cache_t::cached_words
+@param[in]	version		fts_word_cache_get_version() before
+				the word was read
+@param[in]	word		the word and all its rows */
+UNIV_INTERN
+void
+fts_word_cache_add(
+	fts_cache_t*		cache,
+	ib_rbt_t*		cached_words,
+	ib_uint64_t		version,
+	const fts_word_t*	word)
+{
+	ib_rbt_bound_t		parent;
+	fts_cached_word_t	cached;
+	fts_cached_word_t*	last;
+	ulint			limit = fts_word_cache_size;
+
+	if (limit == 0) {
+		return;
+	}
+
+	mutex_enter(&cache->word_cache_lock);
+
+	if (version != cache->word_cache_version
+	    || rbt_search(cached_words, &parent, &word->text) == 0) {
+
+		mutex_exit(&cache->word_cache_lock);
+
+		return;
+	}
+
+	cached.size = fts_word_copy(&cached.word, word);
+	cached.tree = cached_words;
+
+	/* Do not let a single word take over the cache. */
+	if (cached.size > limit / 4) {
+		mutex_exit(&cache->word_cache_lock);
+
+		fts_word_free(&cached.word);
+
+		return;
+	}
+
+	/* Evict the least recently used words. This may change the
+place to insert the new word. */
+	while (cache->word_cache_size + cached.size > limit
+	       && (last = UT_LIST_GET_LAST(cache->word_cache_lru)) != NULL) {
+
+		fts_word_cache_remove(cache, last);
+	}
+
+	rbt_search(cached_words, &parent, &word->text);
+
+	parent.last = rbt_add_node(cached_words, &parent, &cached);
+
+	UT_LIST_ADD_FIRST(lru, cache->word_cache_lru,
+			  rbt_value(fts_cached_word_t, parent.last));
+
+	cache->word_cache_size += cached.size;
+
+	mutex_exit(&cache->word_cache_lock);
+}
+
 /**********************************************************************//**
 Find an existing word, or if not found, create one and return it.
 @return specified word token */
@@ -4460,6 +4731,21 @@ fts_sync_commit(
 			sync, cache->deleted_doc_ids);
 	}
 
+	if (error == DB_SUCCESS) {
+		for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+			fts_index_cache_t*	index_cache;
+
+			index_cache = static_cast<fts_index_cache_t*>(
+				ib_vector_get(cache->indexes, i));
+
+			/* Each SYNC appends another run of rows for the
+			words in the cache, that a merge has to combine. */
+			if (rbt_size(index_cache->words) > 0) {
+				++index_cache->n_sync_runs;
+			}
+		}
+	}
+
 	/* We need to do this within the deleted lock since fts_delete() can
 	attempt to add a deleted doc id to the cache deleted id array. */
 	fts_cache_clear(cache);
@@ -4471,6 +4757,9 @@ fts_sync_commit(
 
 		fts_sql_commit(trx);
 
+		/* The words moved from the cache to the INDEX tables. */
+		fts_word_cache_invalidate(cache);
+
 	} else if (error != DB_SUCCESS) {
 
 		fts_sql_rollback(trx);
@@ -4662,11 +4951,20 @@ end_sync:
 	lock for longer than is needed. */
 	mutex_enter(&cache->deleted_lock);
 
+	cache->merge_deleted += cache->deleted;
 	cache->added = 0;
 	cache->deleted = 0;
 
 	mutex_exit(&cache->deleted_lock);
 
+	/* Let the optimize thread merge the runs of the FTS indexes once
+	there are enough of them. */
+	if (error == DB_SUCCESS
+	    && fts_optimize_merge_needed(sync->table, true)) {
+
+		fts_optimize_do_table(sync->table);
+	}
+
 	return(error);
 }
 
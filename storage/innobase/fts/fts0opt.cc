@@ -48,6 +48,13 @@ static const ulint FTS_QUEUE_WAIT_IN_USECS = 5000000;
 /** Default optimize interval in secs. */
 static const ulint FTS_OPTIMIZE_INTERVAL_IN_SECS = 300;
 
+/** Interval in secs between the passes of a background merge. */
+static const ulint FTS_MERGE_INTERVAL_IN_SECS = 1;
+
+/** Percentage of the rows of a table that have to be deleted before
+the optimize thread merges its FTS indexes in the background. */
+static const ulint FTS_MERGE_DELETED_PCT = 10;
+
 /** Server is shutting down, so does we exiting the optimize thread */
 static bool fts_opt_start_shutdown = false;
 
@@ -175,6 +182,10 @@ struct fts_optimize_t {
 					been optimized */
 	ibool		del_list_regenerated;
 					/*!< BEING_DELETED list regenarated */
+
+	ulint		io_budget;	/*!< Number of FTS index rows that
+					may still be read and written, or
+					ULINT_UNDEFINED if there is no limit */
 };
 
 /** Used by the optimize, to keep state during compacting nodes. */
@@ -204,6 +215,9 @@ struct fts_slot_t {
 
 	ib_time_t	interval_time;	/*!< Minimum time to wait before
 					optimizing the table again. */
+
+	ibool		merging;	/*!< TRUE if a background merge of
+					the table is in progress */
 };
 
 /** A table remove message for the FTS optimize thread. */
@@ -234,6 +248,13 @@ struct fts_msg_t {
 /** The number of words to read and optimize in a single pass. */
 UNIV_INTERN ulong	fts_num_word_optimize;
 
+/** The number of SYNCs of an FTS index that trigger a background merge. */
+UNIV_INTERN ulong	fts_optimize_merge_runs;
+
+/** The number of FTS index rows per second a background merge may read
+and write. */
+UNIV_INTERN ulong	fts_optimize_io_budget;
+
 // FIXME
 UNIV_INTERN char	fts_enable_diag_print;
 
@@ -1586,6 +1607,17 @@ fts_optimize_compact(
 				FTS_LAST_OPTIMIZED_WORD, &word->text);
 		}
 
+		if (optim->io_budget != ULINT_UNDEFINED) {
+			ulint	n_rows = ib_vector_size(word->nodes)
+				+ ib_vector_size(nodes);
+
+			optim->io_budget -= ut_min(optim->io_budget, n_rows);
+
+			if (optim->io_budget == 0) {
+				optim->done = TRUE;
+			}
+		}
+
 		/* Free the word that was optimized. */
 		fts_word_free(word);
 
@@ -1622,6 +1654,8 @@ fts_optimize_create(
 
 	optim->table = table;
 
+	optim->io_budget = ULINT_UNDEFINED;
+
 	optim->trx = trx_allocate_for_background();
 
 	optim->fts_common_table.parent = table->name;
@@ -1804,7 +1838,10 @@ fts_optimize_words(
 	fetch.read_arg = optim->words;
 	fetch.read_record = fts_optimize_index_fetch_node;
 
-	fprintf(stderr, "%.*s\n", (int) word->f_len, word->f_str);
+	if (fts_enable_diag_print) {
+		fprintf(stderr, "FTS_OPTIMIZE: start at \"%.*s\"\n",
+			(int) word->f_len, word->f_str);
+	}
 
 	while(!optim->done) {
 		dberr_t	error;
@@ -1832,6 +1869,9 @@ fts_optimize_words(
 
 			if (error == DB_SUCCESS) {
 				fts_sql_commit(optim->trx);
+
+				fts_word_cache_invalidate(
+					optim->table->fts->cache);
 			} else {
 				fts_sql_rollback(optim->trx);
 			}
@@ -1908,6 +1948,41 @@ fts_optimize_set_next_word(
 	return(last);
 }
 
+/**********************************************************************//**
+Note the start or the completion of a merge of an FTS index in the
+SYNC run counter of the index cache. */
+static
+void
+fts_optimize_note_merge(
+/*====================*/
+	fts_optimize_t*	optim,		/*!< in: optimize instance */
+	dict_index_t*	index,		/*!< in: FTS index */
+	bool		completed)	/*!< in: true if the merge completed,
+					false if it starts */
+{
+	fts_cache_t*		cache = optim->table->fts->cache;
+	fts_index_cache_t*	index_cache;
+
+	rw_lock_x_lock(&cache->lock);
+
+	index_cache = fts_find_index_cache(cache, index);
+
+	if (index_cache == NULL) {
+		/* The index is being created or dropped. */
+	} else if (completed) {
+		/* The runs that were appended after the merge started
+		have been merged only partly, they still count. */
+		index_cache->n_sync_runs -= ut_min(
+			index_cache->n_sync_runs,
+			index_cache->merge_start_runs);
+		index_cache->merge_start_runs = 0;
+	} else {
+		index_cache->merge_start_runs = index_cache->n_sync_runs;
+	}
+
+	rw_lock_x_unlock(&cache->lock);
+}
+
 /**********************************************************************//**
 Optimize is complete. Set the completion time, and reset the optimize
 start string for this FTS index to "".
@@ -1942,6 +2017,8 @@ fts_optimize_index_completed(
 
 		fprintf(stderr, "InnoDB: Error: (%s) while "
 			"updating last optimized word!\n", ut_strerr(error));
+	} else {
+		fts_optimize_note_merge(optim, index, true);
 	}
 
 	return(error);
@@ -1978,6 +2055,13 @@ fts_optimize_index_read_words(
 		error = DB_SUCCESS;
 	}
 
+	/* A missing config value leaves the word empty but not its
+	length, both mean that a new merge starts from the top. */
+	if (error == DB_SUCCESS
+	    && (word->f_len == 0 || *word->f_str == '\0')) {
+		fts_optimize_note_merge(optim, index, false);
+	}
+
 	while (error == DB_SUCCESS) {
 
 		error = fts_index_fetch_words(
@@ -2020,6 +2104,12 @@ fts_optimize_index(
 	dberr_t		error;
 	byte		str[FTS_MAX_WORD_LEN + 1];
 
+	/* The I/O budget of this run has been used up by the
+	previous indexes. */
+	if (optim->io_budget == 0) {
+		return(DB_SUCCESS);
+	}
+
 	/* Set the current index that we have to optimize. */
 	optim->fts_index_table.index_id = index->id;
 	optim->fts_index_table.charset = fts_index_get_charset(index);
@@ -2225,7 +2315,16 @@ fts_optimize_create_deleted_doc_id_snapshot(
 	if (error != DB_SUCCESS) {
 		fts_sql_rollback(optim->trx);
 	} else {
+		fts_cache_t*	cache = optim->table->fts->cache;
+
 		fts_sql_commit(optim->trx);
+
+		/* Doc ids deleted from now on are purged by the next
+		merge of the table. */
+		mutex_enter(&cache->deleted_lock);
+		cache->deleted = 0;
+		cache->merge_deleted = 0;
+		mutex_exit(&cache->deleted_lock);
 	}
 
 	optim->del_list_regenerated = TRUE;
@@ -2363,6 +2462,9 @@ fts_optimize_purge_snapshot(
 
 	if (error == DB_SUCCESS) {
 		fts_sql_commit(optim->trx);
+
+		/* The cached words may still contain the purged doc ids. */
+		fts_word_cache_invalidate(optim->table->fts->cache);
 	} else {
 		fts_sql_rollback(optim->trx);
 	}
@@ -2409,62 +2511,38 @@ fts_optimize_reset_start_time(
 	return(error);
 }
 
-/*********************************************************************//**
-Run OPTIMIZE on the given table by a background thread.
-@return DB_SUCCESS if all OK */
-static MY_ATTRIBUTE((nonnull))
-dberr_t
-fts_optimize_table_bk(
-/*==================*/
-	fts_slot_t*	slot)	/*!< in: table to optimiza */
-{
-	dberr_t		error;
-	dict_table_t*	table = slot->table;
-	fts_t*		fts = table->fts;
-
-	/* Avoid optimizing tables that were optimized recently. */
-	if (slot->last_run > 0
-	    && (ut_time() - slot->last_run) < slot->interval_time) {
-
-		return(DB_SUCCESS);
-
-	} else if (fts && fts->cache
-		   && fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD) {
-
-		error = fts_optimize_table(table);
-
-		if (error == DB_SUCCESS) {
-			slot->state = FTS_STATE_DONE;
-			slot->last_run = 0;
-			slot->completed = ut_time();
-		}
-	} else {
-		error = DB_SUCCESS;
-	}
-
-	/* Note time this run completed. */
-	slot->last_run = ut_time();
-
-	return(error);
-}
 /*********************************************************************//**
 Run OPTIMIZE on the given table.
 @return DB_SUCCESS if all OK */
-UNIV_INTERN
+static MY_ATTRIBUTE((nonnull))
 dberr_t
-fts_optimize_table(
-/*===============*/
-	dict_table_t*	table)	/*!< in: table to optimiza */
+fts_optimize_table_low(
+/*===================*/
+	dict_table_t*	table,		/*!< in: table to optimiza */
+	ulint		io_budget,	/*!< in: number of FTS index rows
+					to read and write at most, or
+					ULINT_UNDEFINED for OPTIMIZE TABLE,
+					which only rewrites the words if
+					there are deleted doc ids to purge */
+	bool*		completed)	/*!< out: true if all the FTS
+					indexes have been optimized */
 {
 	dberr_t		error = DB_SUCCESS;
 	fts_optimize_t*	optim = NULL;
 	fts_t*		fts = table->fts;
+	bool		print = io_budget == ULINT_UNDEFINED
+				|| fts_enable_diag_print;
 
-	ut_print_timestamp(stderr);
-	fprintf(stderr, " InnoDB: FTS start optimize %s\n", table->name);
+	if (print) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, " InnoDB: FTS start optimize %s\n",
+			table->name);
+	}
 
 	optim = fts_optimize_create(table);
 
+	optim->io_budget = io_budget;
+
 	// FIXME: Call this only at the start of optimize, currently we
 	// rely on DB_DUPLICATE_KEY to handle corrupting the snapshot.
 
@@ -2495,9 +2573,18 @@ fts_optimize_table(
 			doc ids transaction. */
 			fts_sql_commit(optim->trx);
 
+			/* An empty snapshot has nothing to purge from the
+			words that were merged already, so the merge goes
+			on from the last optimized word. */
+			if (ib_vector_size(optim->to_delete->doc_ids) == 0) {
+				optim->del_list_regenerated = FALSE;
+			}
+
 			/* We would do optimization only if there
-			are deleted records to be cleaned up */
-			if (ib_vector_size(optim->to_delete->doc_ids) > 0) {
+			are deleted records to be cleaned up, or if
+			the runs of the words have to be merged */
+			if (ib_vector_size(optim->to_delete->doc_ids) > 0
+			    || io_budget != ULINT_UNDEFINED) {
 				error = fts_optimize_indexes(optim);
 			}
 
@@ -2533,14 +2620,161 @@ fts_optimize_table(
 		}
 	}
 
+	*completed = error == DB_SUCCESS
+		&& optim->n_completed == ib_vector_size(fts->indexes);
+
 	fts_optimize_free(optim);
 
-	ut_print_timestamp(stderr);
-	fprintf(stderr, " InnoDB: FTS end optimize %s\n", table->name);
+	if (print) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, " InnoDB: FTS end optimize %s\n",
+			table->name);
+	}
 
 	return(error);
 }
 
+/*********************************************************************//**
+Check whether the FTS indexes of a table are fragmented enough for the
+optimize thread to merge them in the background. Every SYNC appends
+another run of rows for its words to the INDEX tables, which the queries
+have to read and combine, and the rows keep the deleted doc ids until
+they are merged. As with the tiers of an LSM tree, the runs are merged
+once an index has fts_optimize_merge_runs of them (unless that is 0), or
+once enough of the documents of the table have been deleted.
+@return true if a background merge is due */
+UNIV_INTERN
+bool
+fts_optimize_merge_needed(
+/*======================*/
+	dict_table_t*	table,		/*!< in: table with FTS indexes */
+	bool		runs_only)	/*!< in: whether to only check
+					the number of SYNC runs */
+{
+	ulint		i;
+	ulint		deleted;
+	ulint		n_runs = 0;
+	fts_cache_t*	cache = table->fts->cache;
+
+	if (cache == NULL) {
+		return(false);
+	}
+
+	rw_lock_s_lock(&cache->lock);
+
+	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		const fts_index_cache_t*	index_cache;
+
+		index_cache = static_cast<const fts_index_cache_t*>(
+			ib_vector_get_const(cache->indexes, i));
+
+		n_runs = ut_max(n_runs, index_cache->n_sync_runs);
+	}
+
+	rw_lock_s_unlock(&cache->lock);
+
+	/* fts_optimize_merge_runs = 0 only disables the merges that the
+	SYNC runs trigger. */
+	if (fts_optimize_merge_runs > 0
+	    && n_runs >= fts_optimize_merge_runs) {
+
+		return(true);
+	} else if (runs_only) {
+		return(false);
+	}
+
+	mutex_enter(&cache->deleted_lock);
+	deleted = cache->deleted + cache->merge_deleted;
+	mutex_exit(&cache->deleted_lock);
+
+	return(deleted >= FTS_OPTIMIZE_THRESHOLD
+	       || (deleted > 0
+		   && (ib_uint64_t) deleted * 100
+		   >= table->stat_n_rows * FTS_MERGE_DELETED_PCT));
+}
+
+/*********************************************************************//**
+Run OPTIMIZE on the given table by a background thread. A merge is
+done in passes, each of which reads and writes at most the rows that
+fts_optimize_io_budget allows for the time since the previous pass.
+@return DB_SUCCESS if all OK */
+static MY_ATTRIBUTE((nonnull))
+dberr_t
+fts_optimize_table_bk(
+/*==================*/
+	fts_slot_t*	slot)	/*!< in: table to optimiza */
+{
+	dberr_t		error = DB_SUCCESS;
+	dict_table_t*	table = slot->table;
+	fts_t*		fts = table->fts;
+	ib_time_t	now = ut_time();
+
+	/* Avoid optimizing tables that were optimized recently. */
+	if (slot->last_run > 0
+	    && (now - slot->last_run) < slot->interval_time) {
+
+		return(DB_SUCCESS);
+
+	} else if (fts && fts->cache
+		   && (slot->merging
+		       || fts_optimize_merge_needed(table, false))) {
+
+		ulint	n_secs = FTS_QUEUE_WAIT_IN_USECS / 1000000;
+		bool	completed = false;
+
+		if (slot->last_run > 0
+		    && (ulint) (now - slot->last_run) < n_secs) {
+
+			n_secs = ut_max((ulint) (now - slot->last_run), 1);
+		}
+
+		/* Prevent DROP INDEX etc. from running while we are
+		merging, the pass is retried later if DDL is running. */
+		if (rw_lock_s_lock_nowait(
+			    &dict_operation_lock, __FILE__, __LINE__)) {
+
+			error = fts_optimize_table_low(
+				table, fts_optimize_io_budget * n_secs,
+				&completed);
+
+			rw_lock_s_unlock(&dict_operation_lock);
+
+			if (error == DB_SUCCESS && !completed) {
+				slot->merging = TRUE;
+				slot->interval_time =
+					FTS_MERGE_INTERVAL_IN_SECS;
+			} else {
+				slot->merging = FALSE;
+				slot->interval_time =
+					FTS_OPTIMIZE_INTERVAL_IN_SECS;
+			}
+
+			if (error == DB_SUCCESS && completed) {
+				slot->state = FTS_STATE_DONE;
+				slot->completed = ut_time();
+			}
+		}
+	}
+
+	/* Note time this run completed. */
+	slot->last_run = ut_time();
+
+	return(error);
+}
+/*********************************************************************//**
+Run OPTIMIZE on the given table.
+@return DB_SUCCESS if all OK */
+UNIV_INTERN
+dberr_t
+fts_optimize_table(
+/*===============*/
+	dict_table_t*	table)	/*!< in: table to optimiza */
+{
+	bool	completed;
+
+	return(fts_optimize_table_low(table, ULINT_UNDEFINED, &completed));
+}
+
 /********************************************************************//**
 Add the table to add to the OPTIMIZER's list.
 @return new message instance */
@@ -2599,7 +2833,7 @@ fts_optimize_do_table(
 	fts_msg_t*	msg;
 
 	/* Optimizer thread could be shutdown */
-	if (!fts_optimize_wq) {
+	if (!fts_optimize_wq || fts_opt_start_shutdown) {
 		return;
 	}
 
@@ -2703,7 +2937,8 @@ fts_optimize_find_slot(
 
 		slot = static_cast<fts_slot_t*>(ib_vector_get(tables, i));
 
-		if (slot->table->id == table->id) {
+		if (slot->state != FTS_STATE_EMPTY
+		    && slot->table->id == table->id) {
 			return(slot);
 		}
 	}
@@ -2728,7 +2963,8 @@ fts_optimize_start_table(
 		ut_print_timestamp(stderr);
 		fprintf(stderr, " InnoDB: Error: table %s not registered "
 			"with the optimize thread.\n", table->name);
-	} else {
+	} else if (!slot->merging) {
+		/* A merge in progress keeps to its I/O budget. */
 		slot->last_run = 0;
 		slot->completed = 0;
 	}
@@ -3069,6 +3305,9 @@ fts_optimize_thread(
 					fts_need_sync = true;
 				}
 
+				/* Pick up the merges that are due. */
+				n_optimize = fts_optimize_how_many(tables);
+
 				continue;
 			}
 
@@ -57,6 +57,11 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 /*Initial byte length for 'words' in fts_ranking_t */
 #define RANKING_WORDS_INIT_LEN	4
 
+/* Maximum size of the ilists of a word that a query reads into memory
+before evaluating it. The rows of bigger words are evaluated while they
+are read from the FTS INDEX table. */
+#define FTS_QUERY_WORD_MAX_SIZE	(4 * 1024 * 1024)
+
 // FIXME: Need to have a generic iterator that traverses the ilist.
 
 typedef std::vector<fts_string_t>	word_vector_t;
@@ -145,6 +150,14 @@ struct fts_query_t {
 					fts_word_freq_t */
 
 	bool		multi_exist;	/*!< multiple FTS_EXIST oper */
+
+	ib_rbt_t*	cached_words;	/*!< fts_index_cache_t::cached_words
+					of the FTS index */
+
+	ib_rbt_t*	fetched_words;	/*!< Words that were read from the
+					FTS INDEX table or the word cache
+					by this query, its elements are
+					of type fts_word_t */
 };
 
 /** For phrase matching, first we collect the documents and the positions
@@ -1125,6 +1138,358 @@ cont_search:
 	return(num_word);
 }
 
+/** Word being read into memory by fts_query_fetch_word() or
+fts_query_read_token() */
+struct fts_query_fetch_word_t {
+	fts_word_t*	word;		/*!< The word and the rows read */
+
+	ulint		max_size;	/*!< Maximum size of the ilists */
+};
+
+/*****************************************************************//**
+Callback function to read an FTS INDEX row into fts_word_t::nodes.
+@return FALSE if the ilists of the word are too big */
+static
+ibool
+fts_query_fetch_word_node(
+/*======================*/
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: pointer to fts_fetch_t */
+{
+	ulint			i;
+	sel_node_t*		sel_node = static_cast<sel_node_t*>(row);
+	fts_fetch_t*		fetch = static_cast<fts_fetch_t*>(user_arg);
+	fts_query_fetch_word_t*	arg = static_cast<fts_query_fetch_word_t*>(
+		fetch->read_arg);
+	fts_word_t*		word = arg->word;
+	mem_heap_t*		heap = static_cast<mem_heap_t*>(
+		word->heap_alloc->arg);
+	que_node_t*		exp;
+	fts_node_t*		node;
+
+	node = static_cast<fts_node_t*>(ib_vector_push(word->nodes, NULL));
+	memset(node, 0, sizeof(*node));
+
+	/* Skip the WORD column. Note: The column numbers below must
+	match the SELECT in fts_index_fetch_nodes(). */
+	exp = que_node_get_next(sel_node->select_list);
+
+	for (i = 1; exp; exp = que_node_get_next(exp), ++i) {
+		dfield_t*	dfield = que_node_get_val(exp);
+		byte*		data = static_cast<byte*>(
+			dfield_get_data(dfield));
+		ulint		len = dfield_get_len(dfield);
+
+		ut_a(len != UNIV_SQL_NULL);
+
+		switch (i) {
+		case 1: /* DOC_COUNT */
+			node->doc_count = mach_read_from_4(data);
+			break;
+
+		case 2: /* FIRST_DOC_ID */
+			node->first_doc_id = fts_read_doc_id(data);
+			break;
+
+		case 3: /* LAST_DOC_ID */
+			node->last_doc_id = fts_read_doc_id(data);
+			break;
+
+		case 4: /* ILIST */
+			node->ilist = static_cast<byte*>(
+				mem_heap_dup(heap, data, len));
+			node->ilist_size = len;
+			node->ilist_size_alloc = len;
+
+			fetch->total_memory += len;
+			break;
+
+		default:
+			ut_error;
+		}
+	}
+
+	ut_a(i == 5);
+
+	return(fetch->total_memory <= arg->max_size);
+}
+
+/*****************************************************************//**
+Read all the rows of a word from an FTS INDEX table.
+@return true if the word was read, false if it was too big or there
+was an error, the caller should then read the rows with
+fts_query_read_token() */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+bool
+fts_query_fetch_word(
+/*=================*/
+	trx_t*			trx,		/*!< in: transaction */
+	fts_table_t*		fts_table,	/*!< in/out: FTS INDEX
+						table */
+	const fts_string_t*	text,		/*!< in: word to read */
+	ulint			max_size,	/*!< in: maximum size of the
+						ilists of the word */
+	fts_word_t*		word)		/*!< out: the word and its
+						rows, to be freed with
+						fts_word_free() if true is
+						returned */
+{
+	fts_fetch_t		fetch;
+	fts_query_fetch_word_t	arg;
+	que_t*			graph = NULL;
+	dberr_t			error;
+
+	fts_word_init(word, text->f_str, text->f_len);
+
+	arg.word = word;
+	arg.max_size = max_size;
+
+	fetch.read_arg = &arg;
+	fetch.read_record = fts_query_fetch_word_node;
+	fetch.total_memory = 0;
+
+	error = fts_index_fetch_nodes(trx, &graph, fts_table, text, &fetch);
+
+	fts_que_graph_free(graph);
+
+	if (error != DB_SUCCESS || fetch.total_memory > max_size) {
+		fts_word_free(word);
+
+		return(false);
+	}
+
+	return(true);
+}
+
+/*****************************************************************//**
+Add a word that was read into memory to the words of the query.
+@return the word */
+static
+const fts_word_t*
+fts_query_add_fetched_word(
+/*=======================*/
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_word_t*	word)	/*!< in: word, owned by the query
+					after this */
+{
+	ib_rbt_bound_t		parent;
+
+	/* The word is looked up in query->fetched_words before
+	it is read. */
+	ut_a(rbt_search(query->fetched_words, &parent, &word->text) != 0);
+
+	return(rbt_value(fts_word_t,
+			 rbt_add_node(query->fetched_words, &parent, word)));
+}
+
+/*****************************************************************//**
+Get the rows of a word in the FTS INDEX table from the words already read
+by the query or from the word cache.
+@return the word and its rows, or NULL if the rows should be evaluated
+while they are read from the FTS INDEX table */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+const fts_word_t*
+fts_query_get_word(
+/*===============*/
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_string_t*	text)	/*!< in: word to look up */
+{
+	ib_rbt_bound_t		parent;
+	fts_word_t		word;
+	fts_cache_t*		cache = query->index->table->fts->cache;
+
+	if (rbt_search(query->fetched_words, &parent, text) == 0) {
+		return(rbt_value(fts_word_t, parent.last));
+	}
+
+	if (!fts_word_cache_get(cache, query->cached_words, text, &word)) {
+		return(NULL);
+	}
+
+	return(fts_query_add_fetched_word(query, &word));
+}
+
+/*****************************************************************//**
+Filter the doc ids of the rows of a word that were read into memory.
+@return DB_SUCCESS if all go well,
+or return DB_FTS_EXCEED_RESULT_CACHE_LIMIT */
+static MY_ATTRIBUTE((nonnull))
+dberr_t
+fts_query_filter_word(
+/*==================*/
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_string_t*	token,	/*!< in: the token searched */
+	const fts_word_t*	word)	/*!< in: the word and its rows */
+{
+	int			ret;
+	ib_rbt_bound_t		parent;
+	fts_word_freq_t*	word_freq;
+
+	/* Lookup the word in our rb tree, it must exist. */
+	ret = rbt_search(query->word_freqs, &parent, token);
+
+	ut_a(ret == 0);
+
+	word_freq = rbt_value(fts_word_freq_t, parent.last);
+
+	/* Same as fts_query_read_node() for each row. */
+	for (ulint i = 0;
+	     i < ib_vector_size(word->nodes) && query->error == DB_SUCCESS;
+	     ++i) {
+
+		const fts_node_t*	node;
+
+		node = static_cast<const fts_node_t*>(
+			ib_vector_get_const(word->nodes, i));
+
+		word_freq->doc_count += node->doc_count;
+
+		/* Skip nodes whose doc ids are out range. */
+		if (query->oper == FTS_EXIST
+		    && ((query->upper_doc_id > 0
+			 && node->first_doc_id > query->upper_doc_id)
+			|| (query->lower_doc_id > 0
+			    && node->last_doc_id < query->lower_doc_id))) {
+			continue;
+		}
+
+		query->error = fts_query_filter_doc_ids(
+			query, &word_freq->word, word_freq, node,
+			node->ilist, node->ilist_size, FALSE);
+	}
+
+	return(query->error);
+}
+
+/** Word whose rows are filtered by fts_query_read_token() while they are
+read from an FTS INDEX table */
+struct fts_query_read_word_t {
+	fts_query_t*	query;		/*!< Query instance */
+
+	fts_fetch_t	copy;		/*!< Copies the rows with
+					fts_query_fetch_word_node(),
+					read_arg is NULL when the word
+					is not kept in memory */
+};
+
+/*****************************************************************//**
+Callback function to filter the doc ids of an FTS INDEX row, and to copy
+the row while the word is small enough to be kept in memory.
+@return FALSE if the filtering failed */
+static
+ibool
+fts_query_read_word_node(
+/*=====================*/
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: pointer to fts_fetch_t */
+{
+	fts_fetch_t*		fetch = static_cast<fts_fetch_t*>(user_arg);
+	fts_query_read_word_t*	arg = static_cast<fts_query_read_word_t*>(
+		fetch->read_arg);
+	fts_fetch_t		filter;
+
+	if (arg->copy.read_arg != NULL
+	    && !fts_query_fetch_word_node(row, &arg->copy)) {
+
+		fts_query_fetch_word_t*	fetch_word =
+			static_cast<fts_query_fetch_word_t*>(
+				arg->copy.read_arg);
+
+		/* The word is too big, the rest of its rows are only
+		filtered. */
+		fts_word_free(fetch_word->word);
+		arg->copy.read_arg = NULL;
+	}
+
+	filter.read_arg = arg->query;
+
+	return(fts_query_index_fetch_nodes(row, &filter));
+}
+
+/*****************************************************************//**
+Read the rows of a token from the FTS INDEX table and filter their doc ids.
+The error is passed by 'query->error'. */
+static
+void
+fts_query_read_token(
+/*=================*/
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_string_t*	token)	/*!< in: token to search */
+{
+	fts_fetch_t		fetch;
+	que_t*			graph = NULL;
+	const fts_word_t*	word = NULL;
+	fts_word_t		copy;
+	fts_query_fetch_word_t	fetch_word;
+	fts_query_read_word_t	read_word;
+	ib_uint64_t		version = 0;
+	fts_cache_t*		cache = query->index->table->fts->cache;
+	dberr_t			error;
+
+	read_word.query = query;
+	read_word.copy.read_arg = NULL;
+
+	/* The rows of all the words that match a wildcard token are
+	not kept in memory. */
+	if (query->cur_node->type != FTS_AST_TERM
+	    || !query->cur_node->term.wildcard) {
+
+		word = fts_query_get_word(query, token);
+
+		if (word != NULL) {
+			/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by
+			'query->error' */
+			fts_query_filter_word(query, token, word);
+
+			return;
+		}
+
+		if (fts_word_cache_size > 0) {
+			/* Copy the rows while they are filtered, and keep
+			the copy unless the word turns out to be too big.
+			The rows are read only once either way. */
+			version = fts_word_cache_get_version(cache);
+
+			fts_word_init(&copy, token->f_str, token->f_len);
+
+			fetch_word.word = &copy;
+			fetch_word.max_size = ut_min(
+				fts_word_cache_size / 4,
+				FTS_QUERY_WORD_MAX_SIZE);
+
+			read_word.copy.read_arg = &fetch_word;
+			read_word.copy.total_memory = 0;
+		}
+	}
+
+	/* Setup the callback args for filtering and
+	consolidating the ilist. */
+	fetch.read_arg = &read_word;
+	fetch.read_record = fts_query_read_word_node;
+
+	/* Read the nodes from disk. */
+	error = fts_index_fetch_nodes(
+		query->trx, &graph, &query->fts_index_table, token, &fetch);
+
+	/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
+	ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
+	if (error != DB_SUCCESS) {
+		query->error = error;
+	}
+
+	fts_que_graph_free(graph);
+
+	if (read_word.copy.read_arg == NULL) {
+		/* The word was not kept in memory. */
+	} else if (query->error == DB_SUCCESS) {
+		fts_word_cache_add(cache, query->cached_words, version, &copy);
+
+		fts_query_add_fetched_word(query, &copy);
+	} else {
+		fts_word_free(&copy);
+	}
+}
+
 /*****************************************************************//**
 Set difference.
 @return DB_SUCCESS if all go well */
@@ -1136,7 +1501,6 @@ fts_query_difference(
 	const fts_string_t*	token)	/*!< in: token to search */
 {
 	ulint			n_doc_ids= 0;
-	trx_t*			trx = query->trx;
 	dict_table_t*		table = query->index->table;
 
 	ut_a(query->oper == FTS_IGNORE);
@@ -1153,12 +1517,9 @@ fts_query_difference(
 	/* There is nothing we can substract from an empty set. */
 	if (query->doc_ids && !rbt_empty(query->doc_ids)) {
 		ulint			i;
-		fts_fetch_t		fetch;
 		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
-		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
-		dberr_t			error;
 
 		rw_lock_x_lock(&cache->lock);
 
@@ -1194,21 +1555,7 @@ fts_query_difference(
 			return(query->error);
 		}
 
-		/* Setup the callback args for filtering and
-		consolidating the ilist. */
-		fetch.read_arg = query;
-		fetch.read_record = fts_query_index_fetch_nodes;
-
-		error = fts_index_fetch_nodes(
-			trx, &graph, &query->fts_index_table, token, &fetch);
-
-		/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-		ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-		if (error != DB_SUCCESS) {
-			query->error = error;
-		}
-
-		fts_que_graph_free(graph);
+		fts_query_read_token(query, token);
 	}
 
 	/* The size can't increase. */
@@ -1227,7 +1574,6 @@ fts_query_intersect(
 	fts_query_t*		query,	/*!< in: query instance */
 	const fts_string_t*	token)	/*!< in: the token to search */
 {
-	trx_t*			trx = query->trx;
 	dict_table_t*		table = query->index->table;
 
 	ut_a(query->oper == FTS_EXIST);
@@ -1242,12 +1588,9 @@ fts_query_intersect(
 	if (!(rbt_empty(query->doc_ids) && query->multi_exist)) {
 		ulint                   n_doc_ids = 0;
 		ulint			i;
-		fts_fetch_t		fetch;
 		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
-		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
-		dberr_t			error;
 
 		ut_a(!query->intersection);
 
@@ -1314,21 +1657,7 @@ fts_query_intersect(
 			return(query->error);
 		}
 
-		/* Setup the callback args for filtering and
-		consolidating the ilist. */
-		fetch.read_arg = query;
-		fetch.read_record = fts_query_index_fetch_nodes;
-
-		error = fts_index_fetch_nodes(
-			trx, &graph, &query->fts_index_table, token, &fetch);
-
-		/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-		ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-		if (error != DB_SUCCESS) {
-			query->error = error;
-		}
-
-		fts_que_graph_free(graph);
+		fts_query_read_token(query, token);
 
 		if (query->error == DB_SUCCESS) {
 			/* Make the intesection (rb tree) the current doc id
@@ -1405,11 +1734,7 @@ fts_query_union(
 	fts_query_t*		query,	/*!< in: query instance */
 	fts_string_t*		token)	/*!< in: token to search */
 {
-	fts_fetch_t		fetch;
 	ulint			n_doc_ids = 0;
-	trx_t*			trx = query->trx;
-	que_t*			graph = NULL;
-	dberr_t			error;
 
 	ut_a(query->oper == FTS_NONE || query->oper == FTS_DECR_RATING ||
 	     query->oper == FTS_NEGATE || query->oper == FTS_INCR_RATING);
@@ -1433,22 +1758,7 @@ fts_query_union(
 
 	fts_query_cache(query, token);
 
-	/* Setup the callback args for filtering and
-	consolidating the ilist. */
-	fetch.read_arg = query;
-	fetch.read_record = fts_query_index_fetch_nodes;
-
-	/* Read the nodes from disk. */
-	error = fts_index_fetch_nodes(
-		trx, &graph, &query->fts_index_table, token, &fetch);
-
-	/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-	ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-	if (error != DB_SUCCESS) {
-		query->error = error;
-	}
-
-	fts_que_graph_free(graph);
+	fts_query_read_token(query, token);
 
 	if (query->error == DB_SUCCESS) {
 
@@ -2601,12 +2911,8 @@ fts_query_phrase_search(
 	/* Ignore empty strings. */
 	if (num_token > 0) {
 		fts_string_t*	token;
-		fts_fetch_t	fetch;
-		trx_t*		trx = query->trx;
 		fts_ast_oper_t	oper = query->oper;
-		que_t*		graph = NULL;
 		ulint		i;
-		dberr_t		error;
 
 		/* Create the vector for storing matching document ids
 		and the positions of the first token of the phrase. */
@@ -2639,11 +2945,6 @@ fts_query_phrase_search(
 			}
 		}
 
-		/* Setup the callback args for filtering and consolidating
-		the ilist. */
-		fetch.read_arg = query;
-		fetch.read_record = fts_query_index_fetch_nodes;
-
 		for (i = 0; i < num_token; i++) {
 			/* Search for the first word from the phrase. */
 			token = static_cast<fts_string_t*>(
@@ -2654,18 +2955,7 @@ fts_query_phrase_search(
 				query->matched = query->match_array[i];
 			}
 
-			error = fts_index_fetch_nodes(
-				trx, &graph, &query->fts_index_table,
-				token, &fetch);
-
-			/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-			ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-			if (error != DB_SUCCESS) {
-				query->error = error;
-			}
-
-			fts_que_graph_free(graph);
-			graph = NULL;
+			fts_query_read_token(query, token);
 
 			fts_query_cache(query, token);
 
@@ -3658,6 +3948,23 @@ fts_query_free(
 
 	ut_a(!query->intersection);
 
+	if (query->fetched_words) {
+		const ib_rbt_node_t*	node;
+
+		for (node = rbt_first(query->fetched_words);
+		     node;
+		     node = rbt_next(query->fetched_words, node)) {
+
+			fts_word_t*	word;
+
+			word = rbt_value(fts_word_t, node);
+
+			fts_word_free(word);
+		}
+
+		rbt_free(query->fetched_words);
+	}
+
 	if (query->word_map) {
 		rbt_free(query->word_map);
 	}
@@ -3816,6 +4123,242 @@ fts_query_str_preprocess(
 	return(str_ptr);
 }
 
+/** A word of a query that is read by fts_query_read_ahead() */
+struct fts_query_read_t {
+	fts_string_t	text;		/*!< The word to read */
+
+	ulint		selected;	/*!< FTS INDEX table of the word */
+
+	ulint		reader;		/*!< The reader of the word */
+
+	fts_word_t	word;		/*!< The word and its rows */
+
+	bool		fetched;	/*!< true if the word was read */
+};
+
+/** Reader of the words of a query in fts_query_read_ahead() */
+struct fts_query_reader_t {
+	ulint			id;		/*!< Number of the reader */
+
+	fts_query_read_t*	reads;		/*!< Words of the query */
+
+	ulint			n_reads;	/*!< Number of words */
+
+	trx_t*			trx;		/*!< Transaction to read
+						the words with */
+
+	fts_table_t		fts_table;	/*!< FTS INDEX table */
+
+	os_event_t		done;		/*!< Set when the words were
+						read, NULL for the reader
+						in the query thread */
+};
+
+/*****************************************************************//**
+Read the words of a query that are assigned to a reader. */
+static
+void
+fts_query_read_words(
+/*=================*/
+	fts_query_reader_t*	reader)	/*!< in/out: reader */
+{
+	for (ulint i = 0; i < reader->n_reads; i++) {
+		fts_query_read_t*	read = &reader->reads[i];
+
+		if (read->reader == reader->id) {
+			read->fetched = fts_query_fetch_word(
+				reader->trx, &reader->fts_table, &read->text,
+				FTS_QUERY_WORD_MAX_SIZE, &read->word);
+		}
+	}
+}
+
+/*********************************************************************//**
+Thread reading the words of a query from some of the FTS INDEX tables,
+in parallel with the query thread.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(fts_query_read_thread)(
+/*==================================*/
+	void*	arg)	/*!< in: fts_query_reader_t* */
+{
+	fts_query_reader_t*	reader = static_cast<fts_query_reader_t*>(arg);
+
+	fts_query_read_words(reader);
+
+	os_event_set(reader->done);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*****************************************************************//**
+Collect the terms of a query that are not wildcards. */
+static
+void
+fts_query_collect_terms(
+/*====================*/
+	const fts_ast_node_t*	node,	/*!< in: the current sub tree */
+	word_vector_t*		terms)	/*!< in/out: the terms */
+{
+	for (; node != NULL; node = node->next) {
+		fts_string_t	term;
+
+		switch (node->type) {
+		case FTS_AST_TERM:
+			if (!node->term.wildcard) {
+				term.f_str = node->term.ptr->str;
+				term.f_len = node->term.ptr->len;
+				term.f_n_char = 0;
+
+				terms->push_back(term);
+			}
+			break;
+
+		case FTS_AST_LIST:
+		case FTS_AST_SUBEXP_LIST:
+			fts_query_collect_terms(node->list.head, terms);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/*****************************************************************//**
+Read the terms of a query that are in different FTS INDEX tables in up
+to fts_query_pll_degree threads, before the query is evaluated. The terms
+that could not be read are read again when they are evaluated, which
+reports any error. */
+static
+void
+fts_query_read_ahead(
+/*=================*/
+	fts_query_t*	query)		/*!< in/out: query instance */
+{
+	word_vector_t		terms;
+	fts_query_read_t*	reads;
+	fts_query_reader_t*	readers;
+	ulint			n_reads = 0;
+	ulint			n_tables = 0;
+	ulint			n_readers;
+	ib_uint64_t		version;
+	fts_cache_t*		cache = query->index->table->fts->cache;
+	CHARSET_INFO*		charset = query->fts_index_table.charset;
+
+	fts_query_collect_terms(query->root, &terms);
+
+	if (terms.size() < 2) {
+		return;
+	}
+
+	version = fts_word_cache_get_version(cache);
+
+	reads = static_cast<fts_query_read_t*>(
+		mem_heap_zalloc(query->heap, terms.size() * sizeof(*reads)));
+
+	for (ulint i = 0; i < terms.size(); i++) {
+		const fts_string_t*	text = &terms[i];
+		ib_rbt_bound_t		parent;
+		fts_word_t		word;
+		ulint			j;
+
+		if (rbt_search(query->fetched_words, &parent, text) == 0) {
+			continue;
+		}
+
+		for (j = 0; j < n_reads; j++) {
+			if (innobase_fts_text_cmp(
+				    charset, text, &reads[j].text) == 0) {
+				break;
+			}
+		}
+
+		if (j < n_reads) {
+			continue;
+		}
+
+		if (fts_word_cache_get(
+			    cache, query->cached_words, text, &word)) {
+
+			fts_query_add_fetched_word(query, &word);
+			continue;
+		}
+
+		reads[n_reads].text = *text;
+		reads[n_reads].selected = fts_select_index(
+			charset, text->f_str, text->f_len);
+
+		/* Number the FTS INDEX tables in the order they are
+		first seen. */
+		for (j = 0; j < n_reads; j++) {
+			if (reads[j].selected == reads[n_reads].selected) {
+				break;
+			}
+		}
+
+		reads[n_reads].reader = (j < n_reads)
+			? reads[j].reader : n_tables++;
+
+		n_reads++;
+	}
+
+	/* Each FTS INDEX table is read by one reader. */
+	n_readers = ut_min(n_tables, (ulint) fts_query_pll_degree);
+
+	if (n_readers < 2) {
+		return;
+	}
+
+	for (ulint i = 0; i < n_reads; i++) {
+		reads[i].reader %= n_readers;
+	}
+
+	readers = static_cast<fts_query_reader_t*>(
+		mem_heap_zalloc(query->heap, n_readers * sizeof(*readers)));
+
+	for (ulint i = 0; i < n_readers; i++) {
+		fts_query_reader_t*	reader = &readers[i];
+
+		reader->id = i;
+		reader->reads = reads;
+		reader->n_reads = n_reads;
+		reader->fts_table = query->fts_index_table;
+
+		if (i == 0) {
+			reader->trx = query->trx;
+			continue;
+		}
+
+		reader->trx = trx_allocate_for_background();
+		reader->trx->op_info = "FTS query";
+		reader->done = os_event_create();
+
+		os_thread_create(fts_query_read_thread, reader, NULL);
+	}
+
+	fts_query_read_words(&readers[0]);
+
+	for (ulint i = 1; i < n_readers; i++) {
+		os_event_wait(readers[i].done);
+		os_event_free(readers[i].done);
+
+		trx_free_for_background(readers[i].trx);
+	}
+
+	for (ulint i = 0; i < n_reads; i++) {
+		if (reads[i].fetched) {
+			fts_word_cache_add(cache, query->cached_words,
+					   version, &reads[i].word);
+
+			fts_query_add_fetched_word(query, &reads[i].word);
+		}
+	}
+}
+
 /*******************************************************************//**
 FTS Query entry point.
 @return DB_SUCCESS if successful otherwise error code */
@@ -3882,6 +4425,19 @@ fts_query(
 
 	query.total_size += SIZEOF_RBT_CREATE;
 
+	/* Setup the RB tree of the words that are read into memory. */
+	query.fetched_words = rbt_create_arg_cmp(
+		sizeof(fts_word_t), innobase_fts_text_cmp, charset);
+
+	query.total_size += SIZEOF_RBT_CREATE;
+
+	rw_lock_x_lock(&index->table->fts->cache->lock);
+
+	query.cached_words = fts_find_index_cache(
+		index->table->fts->cache, index)->cached_words;
+
+	rw_lock_x_unlock(&index->table->fts->cache->lock);
+
 	query.total_docs = dict_table_get_n_rows(index->table);
 
 #ifdef FTS_DOC_STATS_DEBUG
@@ -3960,6 +4516,10 @@ fts_query(
 		/* Optimize query to check if it's a single term */
 		fts_query_can_optimize(&query, flags);
 
+		if (fts_query_pll_degree > 1) {
+			fts_query_read_ahead(&query);
+		}
+
 		DBUG_EXECUTE_IF("fts_instrument_result_cache_limit",
 			        fts_result_cache_limit = 2048;
 		);
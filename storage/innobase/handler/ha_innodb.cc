@@ -140,10 +140,6 @@ static long long innobase_buffer_pool_size, innobase_log_file_size;
 Connected to buf_LRU_old_ratio. */
 static uint innobase_old_blocks_pct;
 
-/** Maximum on-disk size of change buffer in terms of percentage
-of the buffer pool. */
-static uint innobase_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
-
 /* The default values for the following char* start-up parameters
 are determined in innobase_init below: */
 
@@ -228,6 +224,24 @@ static TYPELIB innodb_checksum_algorithm_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_compression_strategy". */
+static const char* innodb_compression_strategy_names[] = {
+	"default",
+	"filtered",
+	"huffman_only",
+	"rle",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_compression_strategy. */
+static TYPELIB innodb_compression_strategy_typelib = {
+	array_elements(innodb_compression_strategy_names) - 1,
+	"innodb_compression_strategy_typelib",
+	innodb_compression_strategy_names,
+	NULL
+};
+
 /* The following counter is used to convey information to InnoDB
 about server activity: in case of normal DML ops it is not
 sensible to call srv_active_wake_master_thread after each
@@ -299,12 +313,15 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&fts_optimize_mutex_key, "fts_optimize_mutex", 0},
 	{&fts_doc_id_mutex_key, "fts_doc_id_mutex", 0},
 	{&fts_pll_tokenize_mutex_key, "fts_pll_tokenize_mutex", 0},
+	{&fts_word_cache_mutex_key, "fts_word_cache_mutex", 0},
 	{&log_flush_order_mutex_key, "log_flush_order_mutex", 0},
+	{&page_cleaner_mutex_key, "page_cleaner_mutex", 0},
 	{&hash_table_mutex_key, "hash_table_mutex", 0},
 	{&ibuf_bitmap_mutex_key, "ibuf_bitmap_mutex", 0},
 	{&ibuf_mutex_key, "ibuf_mutex", 0},
 	{&ibuf_pessimistic_insert_mutex_key,
 		 "ibuf_pessimistic_insert_mutex", 0},
+	{&ibuf_stat_per_index_mutex_key, "ibuf_stat_per_index_mutex", 0},
 #  ifndef HAVE_ATOMIC_BUILTINS
 	{&server_mutex_key, "server_mutex", 0},
 #  endif /* !HAVE_ATOMIC_BUILTINS */
@@ -317,6 +334,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&mutex_list_mutex_key, "mutex_list_mutex", 0},
 	{&page_zip_stat_per_index_mutex_key, "page_zip_stat_per_index_mutex", 0},
 	{&purge_sys_bh_mutex_key, "purge_sys_bh_mutex", 0},
+	{&purge_sys_table_stats_mutex_key, "purge_sys_table_stats_mutex", 0},
 	{&recv_sys_mutex_key, "recv_sys_mutex", 0},
 	{&recv_writer_mutex_key, "recv_writer_mutex", 0},
 	{&rseg_mutex_key, "rseg_mutex", 0},
@@ -333,9 +351,10 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&sync_thread_mutex_key, "sync_thread_mutex", 0},
 #  endif /* UNIV_SYNC_DEBUG */
 	{&buf_dblwr_mutex_key, "buf_dblwr_mutex", 0},
+	{&buf_dblwr_seg_mutex_key, "buf_dblwr_seg_mutex", 0},
 	{&trx_undo_mutex_key, "trx_undo_mutex", 0},
 	{&srv_sys_mutex_key, "srv_sys_mutex", 0},
-	{&lock_sys_mutex_key, "lock_mutex", 0},
+	{&lock_rec_shard_mutex_key, "lock_rec_shard_mutex", 0},
 	{&lock_sys_wait_mutex_key, "lock_wait_mutex", 0},
 	{&trx_mutex_key, "trx_mutex", 0},
 	{&srv_sys_tasks_mutex_key, "srv_threads_mutex", 0},
@@ -352,6 +371,8 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 #endif /* !HAVE_ATOMIC_BUILTINS_64 */
 	{&ut_list_mutex_key, "ut_list_mutex", 0},
 	{&trx_sys_mutex_key, "trx_sys_mutex", 0},
+	{&trx_sys_serial_mutex_key, "trx_sys_serial_mutex", 0},
+	{&trx_sys_rw_shard_mutex_key, "trx_sys_rw_shard_mutex", 0},
 	{&zip_pad_mutex_key, "zip_pad_mutex", 0},
 };
 # endif /* UNIV_PFS_MUTEX */
@@ -381,7 +402,8 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	{&index_tree_rw_lock_key, "index_tree_rw_lock", 0},
 	{&index_online_log_key, "index_online_log", 0},
 	{&dict_table_stats_key, "dict_table_stats", 0},
-	{&hash_table_rw_lock_key, "hash_table_locks", 0}
+	{&hash_table_rw_lock_key, "hash_table_locks", 0},
+	{&lock_sys_latch_key, "lock_sys_latch", 0}
 };
 # endif /* UNIV_PFS_RWLOCK */
 
@@ -398,7 +420,12 @@ static PSI_thread_info	all_innodb_threads[] = {
 	{&srv_master_thread_key, "srv_master_thread", 0},
 	{&srv_purge_thread_key, "srv_purge_thread", 0},
 	{&buf_page_cleaner_thread_key, "page_cleaner_thread", 0},
-	{&recv_writer_thread_key, "recv_writer_thread", 0}
+	{&buf_page_cleaner_worker_thread_key, "page_cleaner_worker_thread", 0},
+	{&ibuf_merge_thread_key, "ibuf_merge_thread", 0},
+	{&log_writer_thread_key, "log_writer_thread", 0},
+	{&log_flusher_thread_key, "log_flusher_thread", 0},
+	{&recv_writer_thread_key, "recv_writer_thread", 0},
+	{&recv_apply_thread_key, "recv_apply_thread", 0}
 };
 # endif /* UNIV_PFS_THREAD */
 
@@ -643,6 +670,27 @@ static MYSQL_THDVAR_ULONG(lock_wait_timeout, PLUGIN_VAR_RQCMDARG,
   "Timeout in seconds an InnoDB transaction may wait for a lock before being rolled back. Values above 100000000 disable the timeout.",
   NULL, NULL, 50, 1, 1024 * 1024 * 1024, 0);
 
+static MYSQL_THDVAR_BOOL(deadlock_detect, PLUGIN_VAR_OPCMDARG,
+  "Check lock waits for deadlocks when they are enqueued. When OFF, waits"
+  " are searched for deadlocks only after they have lasted a second, by the"
+  " lock wait timeout thread; useful when many sessions queue on hot rows.",
+  NULL, NULL, TRUE);
+
+static MYSQL_THDVAR_ULONG(scan_read_ahead_depth, PLUGIN_VAR_RQCMDARG,
+  "Number of leaf pages that an ascending range scan reads ahead"
+  " asynchronously, as found from the node pointers of the level above"
+  " the leaves. The pages are requested again when half of them have"
+  " been passed. 0 disables this read-ahead.",
+  NULL, NULL, 0, 0, MYSQL_READ_AHEAD_MAX_DEPTH, 0);
+
+static MYSQL_THDVAR_ULONG(clustered_prefetch_rows, PLUGIN_VAR_RQCMDARG,
+  "Number of following secondary index records whose clustered index leaf"
+  " pages an ascending secondary index scan reads ahead asynchronously,"
+  " in primary key order, when it must look up the clustered index"
+  " records. The pages are requested again when half of the records have"
+  " been passed. 0 disables this prefetch.",
+  NULL, NULL, 0, 0, MYSQL_CLUST_PREFETCH_MAX_ROWS, 0);
+
 static MYSQL_THDVAR_STR(ft_user_stopword_table,
   PLUGIN_VAR_OPCMDARG|PLUGIN_VAR_MEMALLOC,
   "User supplied stopword table name, effective in the session level.",
@@ -658,6 +706,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
   {"buffer_pool_load_status",
   (char*) &export_vars.innodb_buffer_pool_load_status,	  SHOW_CHAR},
+  {"buffer_pool_resize_status",
+  (char*) &export_vars.innodb_buffer_pool_resize_status,  SHOW_CHAR},
   {"buffer_pool_pages_data",
   (char*) &export_vars.innodb_buffer_pool_pages_data,	  SHOW_LONG},
   {"buffer_pool_bytes_data",
@@ -762,6 +812,12 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_available_undo_logs,        SHOW_LONG},
   {"buffered_aio_submitted",
   (char*) &export_vars.innodb_buffered_aio_submitted,    SHOW_LONG},
+  {"pages_page_compressed",
+  (char*) &export_vars.innodb_pages_page_compressed,      SHOW_LONG},
+  {"pages_page_decompressed",
+  (char*) &export_vars.innodb_pages_page_decompressed,    SHOW_LONG},
+  {"page_compression_saved",
+  (char*) &export_vars.innodb_page_compression_saved,     SHOW_LONG},
 #ifdef UNIV_DEBUG
   {"purge_trx_id_age",
   (char*) &export_vars.innodb_purge_trx_id_age,           SHOW_LONG},
@@ -2229,6 +2285,12 @@ innobase_trx_init(
 	trx->check_unique_secondary = !thd_test_options(
 		thd, OPTION_RELAXED_UNIQUE_CHECKS);
 
+	trx->deadlock_detect = THDVAR(thd, deadlock_detect);
+
+	trx->read_ahead_depth = THDVAR(thd, scan_read_ahead_depth);
+
+	trx->clust_prefetch_rows = THDVAR(thd, clustered_prefetch_rows);
+
 	DBUG_VOID_RETURN;
 }
 
@@ -3490,13 +3552,17 @@ innobase_change_buffering_inited_ok:
 		goto mem_free_and_error;
 	}
 
+	/* The buffer pool size may have been rounded up to a multiple
+	of the chunk size at startup. */
+	innobase_buffer_pool_size = static_cast<long long>(srv_buf_pool_size);
+
 	/* Adjust the innodb_undo_logs config object */
 	innobase_undo_logs_init_default_max();
 
 	innobase_old_blocks_pct = static_cast<uint>(
 		buf_LRU_old_ratio_update(innobase_old_blocks_pct, TRUE));
 
-	ibuf_max_size_update(innobase_change_buffer_max_size);
+	ibuf_max_size_update(srv_change_buffer_max_size);
 
 	innobase_open_tables = hash_create(200);
 	mysql_mutex_init(innobase_share_mutex_key,
@@ -11338,7 +11404,22 @@ ha_innobase::info_low(
 
 			if (dict_stats_is_persistent_enabled(ib_table)) {
 
-				if (is_analyze) {
+				if (is_analyze
+				    && srv_stats_analyze_in_background
+				    && !srv_read_only_mode
+				    && ib_table->stat_initialized) {
+					/* Let the background stats threads
+					sample the indexes and return the
+					current stats */
+					mutex_enter(&dict_sys->mutex);
+					ib_table->stats_bg_flag
+						|= BG_STAT_RECALC_FULL;
+					mutex_exit(&dict_sys->mutex);
+
+					dict_stats_recalc_pool_add(ib_table);
+
+					opt = DICT_STATS_FETCH_ONLY_IF_NOT_IN_MEMORY;
+				} else if (is_analyze) {
 					opt = DICT_STATS_RECALC_PERSISTENT;
 				} else {
 					/* This is e.g. 'SHOW INDEXES', fetch
@@ -14942,9 +15023,107 @@ innodb_change_buffer_max_size_update(
 	const void*			save)	/*!< in: immediate result
 						from check function */
 {
-	innobase_change_buffer_max_size =
+	srv_change_buffer_max_size =
 			(*static_cast<const uint*>(save));
-	ibuf_max_size_update(innobase_change_buffer_max_size);
+	ibuf_max_size_update(srv_change_buffer_max_size);
+}
+
+/*************************************************************//**
+Check whether the system variable innodb_buffer_pool_size can be set
+to the requested value, and round the value up to a multiple of
+innodb_buffer_pool_chunk_size * innodb_buffer_pool_instances.
+This function is registered as a callback with MySQL.
+@return	0 for valid size */
+static
+int
+innodb_buffer_pool_size_validate(
+/*=============================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to system
+						variable */
+	void*				save,	/*!< out: immediate result
+						for update function */
+	struct st_mysql_value*		value)	/*!< in: incoming value */
+{
+	longlong	intbuf;
+
+	value->val_int(value, &intbuf);
+
+	if (srv_read_only_mode) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Cannot update innodb_buffer_pool_size"
+				    " in read-only mode.");
+		return(1);
+	}
+
+	buf_pool_mutex_enter_all();
+
+	if (srv_buf_pool_old_size != srv_buf_pool_size) {
+		buf_pool_mutex_exit_all();
+		my_printf_error(ER_WRONG_ARGUMENTS,
+				"Another buffer pool resize is already"
+				" in progress.", MYF(0));
+		return(1);
+	}
+
+	if (intbuf < BUF_POOL_SIZE_MIN) {
+		intbuf = BUF_POOL_SIZE_MIN;
+	}
+
+	ulint	requested_buf_pool_size
+		= buf_pool_size_align(static_cast<ulint>(intbuf));
+
+	*static_cast<longlong*>(save) = requested_buf_pool_size;
+
+	if (requested_buf_pool_size != static_cast<ulint>(intbuf)) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_TRUNCATED_WRONG_VALUE,
+				    "innodb_buffer_pool_size was adjusted"
+				    " to %lu, a multiple of"
+				    " innodb_buffer_pool_chunk_size *"
+				    " innodb_buffer_pool_instances",
+				    requested_buf_pool_size);
+	}
+
+	/* The resize thread compares srv_buf_pool_size with
+	srv_buf_pool_old_size to see if there is work to do. */
+	srv_buf_pool_size = requested_buf_pool_size;
+
+	buf_pool_mutex_exit_all();
+
+	return(0);
+}
+
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_size using the "saved"
+value and wake up the buffer pool resize thread.
+This function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_size_update(
+/*===========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	longlong	in_val = *static_cast<const longlong*>(save);
+
+	ut_snprintf(export_vars.innodb_buffer_pool_resize_status,
+		    sizeof(export_vars.innodb_buffer_pool_resize_status),
+		    "Requested to resize buffer pool.");
+
+	os_event_set(srv_buf_resize_event);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Requested to resize buffer pool."
+		" (new size: " INT64PF " bytes)", (ib_int64_t) in_val);
+
+	*static_cast<longlong*>(var_ptr) = in_val;
 }
 
 #ifdef UNIV_DEBUG
@@ -16228,6 +16407,13 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   "Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(parallel_doublewrite, srv_parallel_doublewrite,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Doublewrite LRU and flush list batches of each buffer pool instance to "
+  "its own " BUF_DBLWR_FILE_PREFIX "<n> file instead of the shared "
+  "doublewrite buffer in the system tablespace (disabled by default).",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(io_capacity, srv_io_capacity,
   PLUGIN_VAR_RQCMDARG,
   "Number of IOPs the server can do. Tunes the background IO rate",
@@ -16343,6 +16529,13 @@ static MYSQL_SYSVAR_ULONG(flush_log_at_trx_commit, srv_flush_log_at_trx_commit,
   " or 2 (write at commit, flush once per second).",
   NULL, NULL, 1, 0, 2, 0);
 
+static MYSQL_SYSVAR_BOOL(log_writer_threads, srv_log_writer_threads,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Write and flush the redo log in dedicated log writer and log flusher"
+  " threads. Committing transactions wait for them instead of doing the"
+  " log I/O themselves (off by default).",
+  NULL, NULL, FALSE);
+
 /* when autoinc_persistent=on and autoinc_persistent_interval=1 the sever
    performance degradation less than 1% */
 static MYSQL_SYSVAR_BOOL(autoinc_persistent, srv_autoinc_persistent,
@@ -16480,6 +16673,36 @@ static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   "statistics (by ANALYZE, default 20)",
   NULL, NULL, 20, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONGLONG(stats_persistent_max_pages,
+  srv_stats_persistent_max_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "The maximum number of pages to read from an index when calculating "
+  "persistent statistics; fewer leaf pages are sampled to stay within it "
+  "(0 = no limit, default 0)",
+  NULL, NULL, 0, 0, ~0ULL, 0);
+
+static MYSQL_SYSVAR_ULONG(stats_incremental_pct, srv_stats_incremental_pct,
+  PLUGIN_VAR_RQCMDARG,
+  "While less than this percentage of the rows of a table has been modified "
+  "since its indexes were sampled, the automatic recalculation of persistent "
+  "statistics only scales them to the current number of rows and index "
+  "sizes (0 = always sample, default 0)",
+  NULL, NULL, 0, 0, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(stats_auto_recalc_threads,
+  srv_n_stats_auto_recalc_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of background threads that recalculate persistent statistics "
+  "(default 1)",
+  NULL, NULL, 1, 1, 32, 0);
+
+static MYSQL_SYSVAR_BOOL(stats_analyze_in_background,
+  srv_stats_analyze_in_background,
+  PLUGIN_VAR_OPCMDARG,
+  "ANALYZE TABLE queues the recalculation of persistent statistics for the "
+  "background statistics threads instead of waiting for it (off by default)",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default).  "
@@ -16505,6 +16728,16 @@ static MYSQL_SYSVAR_UINT(compression_level, page_zip_level,
   ", 1 is fastest, 9 is best compression and default is 6.",
   NULL, NULL, DEFAULT_COMPRESSION_LEVEL, 0, 9, 0);
 
+static MYSQL_SYSVAR_ENUM(compression_strategy, page_zip_strategy,
+  PLUGIN_VAR_RQCMDARG,
+  "The zlib strategy used for compressed row format. DEFAULT is the usual"
+  " deflate, FILTERED favours Huffman coding over short string matches,"
+  " HUFFMAN_ONLY does no string matching and RLE only matches runs of"
+  " equal bytes. HUFFMAN_ONLY and RLE use much less CPU but compress less."
+  " Pages compressed with any strategy can be read with any other.",
+  NULL, NULL, PAGE_ZIP_STRATEGY_DEFAULT,
+  &innodb_compression_strategy_typelib);
+
 static MYSQL_SYSVAR_BOOL(log_compressed_pages, page_zip_log_pages,
        PLUGIN_VAR_OPCMDARG,
   "Enables/disables the logging of entire compressed page images."
@@ -16528,9 +16761,18 @@ static MYSQL_SYSVAR_ULONG(autoextend_increment, srv_auto_extend_increment,
   NULL, NULL, 64L, 1L, 1000L, 0);
 
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
-  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  PLUGIN_VAR_RQCMDARG,
   "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
-  NULL, NULL, 128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+  innodb_buffer_pool_size_validate,
+  innodb_buffer_pool_size_update,
+  128*1024*1024L, BUF_POOL_SIZE_MIN, LONGLONG_MAX, 1024*1024L);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_chunk_size, srv_buf_pool_chunk_unit,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Size of a single memory chunk within each buffer pool instance."
+  " Online resizing of innodb_buffer_pool_size happens at this granularity.",
+  NULL, NULL,
+  128 * 1024 * 1024, 1024 * 1024, LONG_MAX, 1024 * 1024);
 
 #if defined UNIV_DEBUG || defined UNIV_PERF_DEBUG
 static MYSQL_SYSVAR_ULONG(page_hash_locks, srv_n_page_hash_locks,
@@ -16564,6 +16806,11 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_dump_at_shutdown, srv_buffer_pool_dump_at_s
   "Dump the buffer pool into a file named @@innodb_buffer_pool_filename",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump only the hottest N% of each buffer pool, defaults to 100",
+  NULL, NULL, 100, 1, 100, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   PLUGIN_VAR_RQCMDARG,
@@ -16587,6 +16834,16 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_st
   "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_buf_load_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads reading pages during a buffer pool load, from 1 to 64",
+  NULL, NULL, 4, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_io_capacity, srv_buf_load_io_capacity,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of pages read per second by a buffer pool load, 0 means no limit",
+  NULL, NULL, 0, 0, ~0UL, 0);
+
 static MYSQL_SYSVAR_ULONG(lru_scan_depth, srv_LRU_scan_depth,
   PLUGIN_VAR_RQCMDARG,
   "How deep to scan LRU to keep it clean",
@@ -16600,6 +16857,15 @@ static MYSQL_SYSVAR_ULONG(flush_neighbors, srv_flush_neighbors,
   " when flushing a block",
   NULL, NULL, 1, 0, 2, 0);
 
+static MYSQL_SYSVAR_ULONG(page_cleaners, srv_n_page_cleaners,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Page cleaner threads can be from 1 to 64, capped at"
+  " innodb_buffer_pool_instances. Default is 1.",
+  NULL, NULL,
+  1,			/* Default setting */
+  1,			/* Minimum value */
+  64, 0);		/* Maximum value */
+
 static MYSQL_SYSVAR_ULONG(commit_concurrency, innobase_commit_concurrency,
   PLUGIN_VAR_RQCMDARG,
   "Helps in performance tuning in heavily concurrent environments.",
@@ -16656,6 +16922,18 @@ static MYSQL_SYSVAR_ULONG(ft_result_cache_limit, fts_result_cache_limit,
   "InnoDB Fulltext search query result cache limit in bytes",
   NULL, NULL, 2000000000L, 1000000L, 4294967295UL, 0);
 
+static MYSQL_SYSVAR_ULONG(ft_word_cache_size, fts_word_cache_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Memory in bytes for caching, for each table, the words that InnoDB "
+  "Fulltext search queries read from the index. 0 disables the cache",
+  NULL, NULL, 1048576, 0, 1024 * 1024 * 1024, 0);
+
+static MYSQL_SYSVAR_ULONG(ft_query_pll_degree, fts_query_pll_degree,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the words of an InnoDB Fulltext search "
+  "query from the index in parallel. 1 reads them in the query thread",
+  NULL, NULL, 1, 1, 16, 0);
+
 static MYSQL_SYSVAR_ULONG(ft_min_token_size, fts_min_token_size,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "InnoDB Fulltext search minimum token size in characters",
@@ -16672,6 +16950,19 @@ static MYSQL_SYSVAR_ULONG(ft_num_word_optimize, fts_num_word_optimize,
   "InnoDB Fulltext search number of words to optimize for each optimize table call ",
   NULL, NULL, 2000, 1000, 10000, 0);
 
+static MYSQL_SYSVAR_ULONG(ft_optimize_merge_runs, fts_optimize_merge_runs,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of times the InnoDB Fulltext search cache of an index is synced "
+  "to the index tables before they are merged in the background. "
+  "0 disables this trigger, deleted documents still trigger merges",
+  NULL, NULL, 16, 0, 1024, 0);
+
+static MYSQL_SYSVAR_ULONG(ft_optimize_io_budget, fts_optimize_io_budget,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of InnoDB Fulltext search index rows per second that a "
+  "background merge reads and writes at most",
+  NULL, NULL, 10000, 1, 1024 * 1024 * 1024, 0);
+
 static MYSQL_SYSVAR_ULONG(ft_sort_pll_degree, fts_sort_pll_degree,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "InnoDB Fulltext search parallel sort degree, will round up to nearest power of 2 number",
@@ -16682,6 +16973,13 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(sort_threads, srv_sort_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads sorting and loading the indexes of one ALTER TABLE"
+  " in parallel, from 1 to 64. Each thread uses 3 * innodb_sort_buffer_size"
+  " bytes of memory.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -16714,6 +17012,12 @@ static MYSQL_SYSVAR_ULONG(force_recovery_crash, srv_force_recovery_crash,
   NULL, NULL, 0, 0, 10, 0);
 #endif /* !DBUG_OFF */
 
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads applying redo log records to pages during crash"
+  " recovery, from 1 to 64. 1 applies them from the recovery thread only.",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(page_size, srv_page_size,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
   "Page size to use for all InnoDB tablespaces.",
@@ -16820,6 +17124,32 @@ static MYSQL_SYSVAR_ULONG(undo_logs, srv_undo_logs,
   1,			/* Minimum value */
   TRX_SYS_N_RSEGS, 0);	/* Maximum value */
 
+static MYSQL_SYSVAR_BOOL(undo_log_truncate, srv_undo_log_truncate,
+  PLUGIN_VAR_OPCMDARG,
+  "Enable or Disable Truncate of UNDO tablespace. An undo tablespace that"
+  " grows larger than innodb_max_undo_log_size is no longer used for new"
+  " transactions, and truncated to its initial size once purged.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONGLONG(max_undo_log_size, srv_max_undo_log_size,
+  PLUGIN_VAR_OPCMDARG,
+  "Maximum size of an UNDO tablespace in bytes, above which it is"
+  " truncated when innodb_undo_log_truncate is enabled.",
+  NULL, NULL,
+  1024 * 1024 * 1024L,	/* Default setting */
+  10 * 1024 * 1024L,	/* Minimum value */
+  ~0ULL, 0);		/* Maximum value */
+
+static MYSQL_SYSVAR_ULONG(purge_rseg_truncate_frequency,
+  srv_purge_rseg_truncate_frequency,
+  PLUGIN_VAR_OPCMDARG,
+  "Every how many purge batches the purged history is removed from the"
+  " rollback segments. Undo tablespaces are only truncated at that time.",
+  NULL, NULL,
+  TRX_SYS_N_RSEGS,	/* Default setting */
+  1,			/* Minimum value */
+  TRX_SYS_N_RSEGS, 0);	/* Maximum value */
+
 /* Alias for innodb_undo_logs, this config variable is deprecated. */
 static MYSQL_SYSVAR_ULONG(rollback_segments, srv_undo_logs,
   PLUGIN_VAR_OPCMDARG,
@@ -16857,6 +17187,15 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(transparent_page_compression,
+  srv_transparent_page_compression,
+  PLUGIN_VAR_NOCMDARG,
+  "Compress full pages of single-table tablespaces when they are written"
+  " and punch a hole for the unused part of each page in the data file."
+  " Needs a file system that supports hole punching. Pages are"
+  " decompressed when read regardless of this setting.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -16903,13 +17242,28 @@ static MYSQL_SYSVAR_STR(change_buffering, innobase_change_buffering,
   innodb_change_buffering_update, "all");
 
 static MYSQL_SYSVAR_UINT(change_buffer_max_size,
-  innobase_change_buffer_max_size,
+  srv_change_buffer_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum on-disk size of change buffer in terms of percentage"
   " of the buffer pool.",
   NULL, innodb_change_buffer_max_size_update,
   CHANGE_BUFFER_DEFAULT_SIZE, 0, 50, 0);
 
+static MYSQL_SYSVAR_ULONG(change_buffer_merge_io_pct,
+  srv_change_buffer_merge_io_pct,
+  PLUGIN_VAR_RQCMDARG,
+  "Size of the background change buffer merge batch, in percent of"
+  " innodb_io_capacity. The batch grows with the size of the change"
+  " buffer and with the pages that had to be merged when they were read.",
+  NULL, NULL, 5, 1, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(change_buffer_merge_threads,
+  srv_n_change_buffer_merge_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that merge the change buffer in the background."
+  " 0 means that the master thread merges it.",
+  NULL, NULL, 0, 0, 32, 0);
+
 static MYSQL_SYSVAR_ENUM(stats_method, srv_innodb_stats_method,
    PLUGIN_VAR_RQCMDARG,
   "Specifies how InnoDB index statistics collection code should "
@@ -17055,8 +17409,9 @@ static MYSQL_SYSVAR_ULONG(rds_column_zip_threshold, column_zip_threshold,
 
 static MYSQL_SYSVAR_BOOL(rds_column_zip_mem_use_heap, column_zip_mem_use_heap,
   PLUGIN_VAR_OPCMDARG,
-  "alloc memory from prebuilt->compress_heap for zlib during compress/decompress "
-  "if true. Currently this opition is only used for testing purposes",
+  "alloc memory from an InnoDB memory heap for the zlib streams that a session "
+  "uses to compress/decompress columns if true, instead of malloc(). "
+  "Currently this opition is only used for testing purposes",
   NULL, NULL, FALSE);
 
 static MYSQL_SYSVAR_BOOL(rds_read_view_cache, srv_read_view_cache,
@@ -17070,18 +17425,23 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(api_bk_commit_interval),
   MYSQL_SYSVAR(autoextend_increment),
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_chunk_size),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(buffer_pool_filename),
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
+  MYSQL_SYSVAR(buffer_pool_dump_pct),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
   MYSQL_SYSVAR(buffer_pool_load_now),
   MYSQL_SYSVAR(buffer_pool_load_abort),
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
+  MYSQL_SYSVAR(buffer_pool_load_io_capacity),
   MYSQL_SYSVAR(lru_scan_depth),
   MYSQL_SYSVAR(flush_neighbors),
+  MYSQL_SYSVAR(page_cleaners),
   MYSQL_SYSVAR(checksum_algorithm),
   MYSQL_SYSVAR(checksums),
   MYSQL_SYSVAR(commit_concurrency),
@@ -17089,9 +17449,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(rds_adaptive_tickets_algo),
   MYSQL_SYSVAR(rds_min_concurrency_tickets),
   MYSQL_SYSVAR(compression_level),
+  MYSQL_SYSVAR(compression_strategy),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(parallel_doublewrite),
   MYSQL_SYSVAR(api_enable_binlog),
   MYSQL_SYSVAR(api_enable_mdl),
   MYSQL_SYSVAR(api_disable_rowlock),
@@ -17105,23 +17467,32 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(file_format_max),
   MYSQL_SYSVAR(flush_log_at_timeout),
   MYSQL_SYSVAR(flush_log_at_trx_commit),
+  MYSQL_SYSVAR(log_writer_threads),
   MYSQL_SYSVAR(flush_method),
   MYSQL_SYSVAR(force_recovery),
 #ifndef DBUG_OFF
   MYSQL_SYSVAR(force_recovery_crash),
 #endif /* !DBUG_OFF */
+  MYSQL_SYSVAR(recovery_apply_threads),
   MYSQL_SYSVAR(ft_cache_size),
   MYSQL_SYSVAR(ft_total_cache_size),
   MYSQL_SYSVAR(ft_result_cache_limit),
+  MYSQL_SYSVAR(ft_word_cache_size),
+  MYSQL_SYSVAR(ft_query_pll_degree),
   MYSQL_SYSVAR(ft_enable_stopword),
   MYSQL_SYSVAR(ft_max_token_size),
   MYSQL_SYSVAR(ft_min_token_size),
   MYSQL_SYSVAR(ft_num_word_optimize),
+  MYSQL_SYSVAR(ft_optimize_merge_runs),
+  MYSQL_SYSVAR(ft_optimize_io_budget),
   MYSQL_SYSVAR(ft_sort_pll_degree),
   MYSQL_SYSVAR(large_prefix),
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
   MYSQL_SYSVAR(lock_wait_timeout),
+  MYSQL_SYSVAR(deadlock_detect),
+  MYSQL_SYSVAR(scan_read_ahead_depth),
+  MYSQL_SYSVAR(clustered_prefetch_rows),
   MYSQL_SYSVAR(autoinc_persistent),
   MYSQL_SYSVAR(autoinc_persistent_interval),
 #ifdef UNIV_LOG_ARCHIVE
@@ -17157,6 +17528,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_transient_sample_pages),
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
+  MYSQL_SYSVAR(stats_persistent_max_pages),
+  MYSQL_SYSVAR(stats_incremental_pct),
+  MYSQL_SYSVAR(stats_auto_recalc_threads),
+  MYSQL_SYSVAR(stats_analyze_in_background),
   MYSQL_SYSVAR(stats_auto_recalc),
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(adaptive_hash_index_parts),
@@ -17166,6 +17541,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(sort_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -17179,11 +17555,14 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_sys_malloc),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(transparent_page_compression),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif // HAVE_LIBNUMA
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
+  MYSQL_SYSVAR(change_buffer_merge_io_pct),
+  MYSQL_SYSVAR(change_buffer_merge_threads),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffering_debug),
   MYSQL_SYSVAR(disable_background_merge),
@@ -17214,6 +17593,9 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(print_all_deadlocks),
   MYSQL_SYSVAR(cmp_per_index_enabled),
   MYSQL_SYSVAR(undo_logs),
+  MYSQL_SYSVAR(undo_log_truncate),
+  MYSQL_SYSVAR(max_undo_log_size),
+  MYSQL_SYSVAR(purge_rseg_truncate_frequency),
   MYSQL_SYSVAR(rollback_segments),
   MYSQL_SYSVAR(undo_directory),
   MYSQL_SYSVAR(undo_tablespaces),
@@ -17254,6 +17636,7 @@ mysql_declare_plugin(innobase)
   0,    /* flags */
 },
 i_s_innodb_rseg,
+i_s_innodb_purge_table_stats,
 i_s_innodb_trx,
 i_s_innodb_locks,
 i_s_innodb_lock_waits,
@@ -17263,6 +17646,7 @@ i_s_innodb_cmpmem,
 i_s_innodb_cmpmem_reset,
 i_s_innodb_cmp_per_index,
 i_s_innodb_cmp_per_index_reset,
+i_s_innodb_change_buffer_indexes,
 i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
 i_s_innodb_buffer_stats,
@@ -17273,6 +17657,7 @@ i_s_innodb_ft_being_deleted,
 i_s_innodb_ft_config,
 i_s_innodb_ft_index_cache,
 i_s_innodb_ft_index_table,
+i_s_innodb_ft_index_stats,
 i_s_innodb_sys_tables,
 i_s_innodb_sys_tablestats,
 i_s_innodb_sys_indexes,
@@ -51,12 +51,14 @@ Created July 18, 2007 Vasil Dimov
 #include "srv0mon.h"
 #include "fut0fut.h"
 #include "pars0pars.h"
+#include "row0sel.h"
 #include "fts0types.h"
 #include "fts0opt.h"
 #include "fts0priv.h"
 #include "btr0btr.h"
 #include "page0zip.h"
 #include "trx0rseg.h"
+#include "trx0purge.h"
 
 /** structure associates a name string with a file page type and/or buffer
 page state. */
@@ -931,6 +933,249 @@ UNIV_INTERN struct st_mysql_plugin i_s_innodb_rseg =
 	STRUCT_FLD(flags, 0UL),
 };
 
+/* Fields of the dynamic table information_schema.innodb_purge_table_stats */
+static ST_FIELD_INFO	i_s_innodb_purge_table_stats_fields_info[] =
+{
+#define PURGE_STATS_TABLE_ID		0
+	{STRUCT_FLD(field_name,		"table_id"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_STATS_DATABASE_NAME	1
+	{STRUCT_FLD(field_name,		"database_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_STATS_TABLE_NAME		2
+	{STRUCT_FLD(field_name,		"table_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_STATS_PURGED_RECORDS	3
+	{STRUCT_FLD(field_name,		"purged_records"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_STATS_BATCH_RECORDS	4
+	{STRUCT_FLD(field_name,		"batch_records"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_STATS_LAST_TRX_NO		5
+	{STRUCT_FLD(field_name,		"last_trx_no"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define PURGE_STATS_PURGE_LAG		6
+	{STRUCT_FLD(field_name,		"purge_lag"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill the dynamic table INFORMATION_SCHEMA.innodb_purge_table_stats.
+BATCH_RECORDS is the number of undo log records of the table in the most
+recent purge batch, and shows which tables the history list consists of.
+PURGE_LAG is the number of transactions that had started or committed
+after the last purged change of the table, at the time it was purged.
+@return	0 on success */
+static
+int
+i_s_innodb_purge_table_stats_fill(
+/*==============================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	Item*		)	/*!< in: condition (ignored) */
+{
+	TABLE*		table = tables->table;
+	Field**		fields = table->field;
+	ib_uint64_t	n_batches;
+	int		status = 0;
+
+	DBUG_ENTER("i_s_innodb_purge_table_stats_fill");
+
+	/* Deny access to user without PROCESS_ACL privilege */
+	if (check_global_access(thd, PROCESS_ACL)) {
+
+		DBUG_RETURN(0);
+	}
+
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
+
+	/* Create a snapshot of the stats so we do not bump into lock
+	order violations with dict_sys->mutex below. */
+	mutex_enter(&purge_sys->table_stats_mutex);
+	purge_table_stats_t	snap (*purge_sys->table_stats);
+	n_batches = purge_sys->n_batches;
+	mutex_exit(&purge_sys->table_stats_mutex);
+
+	mutex_enter(&dict_sys->mutex);
+
+	for (purge_table_stats_t::const_iterator iter = snap.begin();
+	     iter != snap.end();
+	     ++iter) {
+
+		const dict_table_t*	dict_table;
+
+		/* Only report the names of the tables in the cache. */
+		HASH_SEARCH(id_hash, dict_sys->table_id_hash,
+			    ut_fold_ull(iter->first),
+			    dict_table_t*, dict_table,
+			    ut_ad(dict_table->cached),
+			    dict_table->id == iter->first);
+
+		fields[PURGE_STATS_TABLE_ID]->store(iter->first, true);
+
+		if (dict_table == NULL) {
+			fields[PURGE_STATS_DATABASE_NAME]->set_null();
+			fields[PURGE_STATS_TABLE_NAME]->set_null();
+		} else if (strchr(dict_table->name, '/') == NULL) {
+			/* An internal table such as SYS_INDEXES */
+			fields[PURGE_STATS_DATABASE_NAME]->set_null();
+			field_store_string(
+				fields[PURGE_STATS_TABLE_NAME],
+				dict_table->name);
+		} else {
+			char	db_utf8[MAX_DB_UTF8_LEN];
+			char	table_utf8[MAX_TABLE_UTF8_LEN];
+
+			dict_fs2utf8(dict_table->name,
+				     db_utf8, sizeof(db_utf8),
+				     table_utf8, sizeof(table_utf8));
+
+			field_store_string(
+				fields[PURGE_STATS_DATABASE_NAME], db_utf8);
+			field_store_string(
+				fields[PURGE_STATS_TABLE_NAME], table_utf8);
+		}
+
+		fields[PURGE_STATS_PURGED_RECORDS]->store(
+			iter->second.n_recs, true);
+
+		fields[PURGE_STATS_BATCH_RECORDS]->store(
+			iter->second.batch_no == n_batches
+			? iter->second.n_batch_recs : 0, true);
+
+		fields[PURGE_STATS_LAST_TRX_NO]->store(
+			iter->second.last_trx_no, true);
+
+		fields[PURGE_STATS_PURGE_LAG]->store(
+			iter->second.lag, true);
+
+		if (schema_table_store_record(thd, table)) {
+			status = 1;
+			break;
+		}
+	}
+
+	mutex_exit(&dict_sys->mutex);
+
+	DBUG_RETURN(status);
+}
+
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.innodb_purge_table_stats
+@return	0 on success */
+static
+int
+innodb_purge_table_stats_init(
+/*==========================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	ST_SCHEMA_TABLE*	schema;
+
+	DBUG_ENTER("innodb_purge_table_stats_init");
+
+	schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = i_s_innodb_purge_table_stats_fields_info;
+	schema->fill_table = i_s_innodb_purge_table_stats_fill;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_mysql_plugin	i_s_innodb_purge_table_stats =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_PURGE_TABLE_STATS"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, "Aliyun"),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "InnoDB purge statistics per table"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, innodb_purge_table_stats_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
+
 UNIV_INTERN struct st_mysql_plugin	i_s_innodb_trx =
 {
 	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
@@ -2187,77 +2432,336 @@ UNIV_INTERN struct st_mysql_plugin	i_s_innodb_cmp_per_index_reset =
 	STRUCT_FLD(flags, 0UL),
 };
 
-/* Fields of the dynamic table information_schema.innodb_cmpmem. */
-static ST_FIELD_INFO	i_s_cmpmem_fields_info[] =
+/* Fields of the dynamic table
+information_schema.innodb_change_buffer_indexes. */
+static ST_FIELD_INFO	i_s_change_buffer_indexes_fields_info[] =
 {
-	{STRUCT_FLD(field_name,		"page_size"),
-	 STRUCT_FLD(field_length,	5),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+#define CB_DATABASE_NAME	0
+	{STRUCT_FLD(field_name,		"database_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
 	 STRUCT_FLD(value,		0),
 	 STRUCT_FLD(field_flags,	0),
-	 STRUCT_FLD(old_name,		"Buddy Block Size"),
+	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-	{STRUCT_FLD(field_name,		"buffer_pool_instance"),
-	STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
-	STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
-	STRUCT_FLD(value,		0),
-	STRUCT_FLD(field_flags,		0),
-	STRUCT_FLD(old_name,		"Buffer Pool Id"),
-	STRUCT_FLD(open_method,		SKIP_OPEN_TABLE)},
-
-	{STRUCT_FLD(field_name,		"pages_used"),
-	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+#define CB_TABLE_NAME		1
+	{STRUCT_FLD(field_name,		"table_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
 	 STRUCT_FLD(value,		0),
 	 STRUCT_FLD(field_flags,	0),
-	 STRUCT_FLD(old_name,		"Currently in Use"),
+	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-	{STRUCT_FLD(field_name,		"pages_free"),
-	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+#define CB_INDEX_NAME		2
+	{STRUCT_FLD(field_name,		"index_name"),
+	 STRUCT_FLD(field_length,	192),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
 	 STRUCT_FLD(value,		0),
 	 STRUCT_FLD(field_flags,	0),
-	 STRUCT_FLD(old_name,		"Currently Available"),
+	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-	{STRUCT_FLD(field_name,		"relocation_ops"),
+#define CB_SPACE		3
+	{STRUCT_FLD(field_name,		"space"),
 	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
 	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	0),
-	 STRUCT_FLD(old_name,		"Total Number of Relocations"),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-	{STRUCT_FLD(field_name,		"relocation_time"),
-	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+#define CB_INSERTS		4
+	{STRUCT_FLD(field_name,		"inserts"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
 	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	0),
-	 STRUCT_FLD(old_name,		"Total Duration of Relocations,"
-					" in Seconds"),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define CB_DELETE_MARKS		5
+	{STRUCT_FLD(field_name,		"delete_marks"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define CB_DELETES		6
+	{STRUCT_FLD(field_name,		"deletes"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define CB_MERGED_PAGES		7
+	{STRUCT_FLD(field_name,		"merged_pages"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define CB_READ_MERGES		8
+	{STRUCT_FLD(field_name,		"read_merges"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
 	END_OF_ST_FIELD_INFO
 };
 
 /*******************************************************************//**
-Fill the dynamic table information_schema.innodb_cmpmem or
-innodb_cmpmem_reset.
+Fill the dynamic table information_schema.innodb_change_buffer_indexes.
 @return	0 on success, 1 on failure */
 static
 int
-i_s_cmpmem_fill_low(
-/*================*/
+i_s_change_buffer_indexes_fill(
+/*===========================*/
 	THD*		thd,	/*!< in: thread */
 	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
-	Item*		,	/*!< in: condition (ignored) */
-	ibool		reset)	/*!< in: TRUE=reset cumulated counts */
+	Item*		)	/*!< in: condition (ignored) */
 {
-	int		status = 0;
-	TABLE*	table	= (TABLE*) tables->table;
-
+	TABLE*	table = tables->table;
+	Field**	fields = table->field;
+	int	status = 0;
+
+	DBUG_ENTER("i_s_change_buffer_indexes_fill");
+
+	/* deny access to non-superusers */
+	if (check_global_access(thd, PROCESS_ACL)) {
+
+		DBUG_RETURN(0);
+	}
+
+	RETURN_IF_INNODB_NOT_STARTED(tables->schema_table_name);
+
+	/* Create a snapshot of the stats so we do not bump into lock
+	order violations with dict_sys->mutex below. */
+	mutex_enter(&ibuf_stat_per_index_mutex);
+	ibuf_stat_per_index_t		snap (ibuf_stat_per_index);
+	mutex_exit(&ibuf_stat_per_index_mutex);
+
+	mutex_enter(&dict_sys->mutex);
+
+	ibuf_stat_per_index_t::iterator	iter;
+	ulint				i;
+
+	for (iter = snap.begin(), i = 0; iter != snap.end(); iter++, i++) {
+
+		char		name[192];
+		dict_index_t*	index = dict_index_find_on_id_low(iter->first);
+
+		if (index != NULL) {
+			char	db_utf8[MAX_DB_UTF8_LEN];
+			char	table_utf8[MAX_TABLE_UTF8_LEN];
+
+			dict_fs2utf8(index->table_name,
+				     db_utf8, sizeof(db_utf8),
+				     table_utf8, sizeof(table_utf8));
+
+			field_store_string(fields[CB_DATABASE_NAME], db_utf8);
+			field_store_string(fields[CB_TABLE_NAME], table_utf8);
+			field_store_index_name(fields[CB_INDEX_NAME],
+					       index->name);
+		} else {
+			/* index not found */
+			ut_snprintf(name, sizeof(name),
+				    "index_id:" IB_ID_FMT, iter->first);
+			field_store_string(fields[CB_DATABASE_NAME],
+					   "unknown");
+			field_store_string(fields[CB_TABLE_NAME],
+					   "unknown");
+			field_store_string(fields[CB_INDEX_NAME],
+					   name);
+		}
+
+		const ibuf_stat_t&	stat = iter->second;
+
+		fields[CB_SPACE]->store(stat.space, true);
+
+		fields[CB_INSERTS]->store(
+			stat.n_buffered[IBUF_OP_INSERT], true);
+
+		fields[CB_DELETE_MARKS]->store(
+			stat.n_buffered[IBUF_OP_DELETE_MARK], true);
+
+		fields[CB_DELETES]->store(
+			stat.n_buffered[IBUF_OP_DELETE], true);
+
+		fields[CB_MERGED_PAGES]->store(stat.n_merged_pages, true);
+
+		fields[CB_READ_MERGES]->store(stat.n_read_merges, true);
+
+		if (schema_table_store_record(thd, table)) {
+			status = 1;
+			break;
+		}
+
+		/* Release and reacquire the dict mutex to allow other
+		threads to proceed. */
+		if (i % 1000 == 0) {
+			mutex_exit(&dict_sys->mutex);
+			mutex_enter(&dict_sys->mutex);
+		}
+	}
+
+	mutex_exit(&dict_sys->mutex);
+
+	DBUG_RETURN(status);
+}
+
+/*******************************************************************//**
+Bind the dynamic table information_schema.innodb_change_buffer_indexes.
+@return	0 on success */
+static
+int
+i_s_change_buffer_indexes_init(
+/*===========================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	DBUG_ENTER("i_s_change_buffer_indexes_init");
+	ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = i_s_change_buffer_indexes_fields_info;
+	schema->fill_table = i_s_change_buffer_indexes_fill;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_mysql_plugin	i_s_innodb_change_buffer_indexes =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_CHANGE_BUFFER_INDEXES"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "Statistics for the InnoDB change buffer (per index)"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_change_buffer_indexes_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
+
+/* Fields of the dynamic table information_schema.innodb_cmpmem. */
+static ST_FIELD_INFO	i_s_cmpmem_fields_info[] =
+{
+	{STRUCT_FLD(field_name,		"page_size"),
+	 STRUCT_FLD(field_length,	5),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		"Buddy Block Size"),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	{STRUCT_FLD(field_name,		"buffer_pool_instance"),
+	STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	STRUCT_FLD(value,		0),
+	STRUCT_FLD(field_flags,		0),
+	STRUCT_FLD(old_name,		"Buffer Pool Id"),
+	STRUCT_FLD(open_method,		SKIP_OPEN_TABLE)},
+
+	{STRUCT_FLD(field_name,		"pages_used"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		"Currently in Use"),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	{STRUCT_FLD(field_name,		"pages_free"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		"Currently Available"),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	{STRUCT_FLD(field_name,		"relocation_ops"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		"Total Number of Relocations"),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	{STRUCT_FLD(field_name,		"relocation_time"),
+	 STRUCT_FLD(field_length,	MY_INT32_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	0),
+	 STRUCT_FLD(old_name,		"Total Duration of Relocations,"
+					" in Seconds"),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+	END_OF_ST_FIELD_INFO
+};
+
+/*******************************************************************//**
+Fill the dynamic table information_schema.innodb_cmpmem or
+innodb_cmpmem_reset.
+@return	0 on success, 1 on failure */
+static
+int
+i_s_cmpmem_fill_low(
+/*================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	Item*		,	/*!< in: condition (ignored) */
+	ibool		reset)	/*!< in: TRUE=reset cumulated counts */
+{
+	int		status = 0;
+	TABLE*	table	= (TABLE*) tables->table;
+
 	DBUG_ENTER("i_s_cmpmem_fill_low");
 
 	/* deny access to non-superusers */
@@ -4361,20 +4865,20 @@ UNIV_INTERN struct st_mysql_plugin	i_s_innodb_ft_config =
 	STRUCT_FLD(flags, 0UL),
 };
 
-/* Fields of the dynamic table INNODB_BUFFER_POOL_STATS. */
-static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_FT_INDEX_STATS */
+static ST_FIELD_INFO	i_s_fts_index_stats_fields_info[] =
 {
-#define IDX_BUF_STATS_POOL_ID		0
-	{STRUCT_FLD(field_name,		"POOL_ID"),
-	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+#define	FTS_INDEX_STATS_INDEX_NAME	0
+	{STRUCT_FLD(field_name,		"INDEX_NAME"),
+	 STRUCT_FLD(field_length,	NAME_LEN + 1),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_STRING),
 	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(field_flags,	0),
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_BUF_STATS_POOL_SIZE		1
-	{STRUCT_FLD(field_name,		"POOL_SIZE"),
+#define	FTS_INDEX_STATS_WORDS		1
+	{STRUCT_FLD(field_name,		"WORDS"),
 	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
 	 STRUCT_FLD(value,		0),
@@ -4382,8 +4886,8 @@ static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_BUF_STATS_FREE_BUFFERS	2
-	{STRUCT_FLD(field_name,		"FREE_BUFFERS"),
+#define	FTS_INDEX_STATS_NODES		2
+	{STRUCT_FLD(field_name,		"NODES"),
 	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
 	 STRUCT_FLD(value,		0),
@@ -4391,17 +4895,17 @@ static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_BUF_STATS_LRU_LEN		3
-	{STRUCT_FLD(field_name,		"DATABASE_PAGES"),
-	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+#define	FTS_INDEX_STATS_FRAGMENTATION	3
+	{STRUCT_FLD(field_name,		"FRAGMENTATION"),
+	 STRUCT_FLD(field_length,	MAX_FLOAT_STR_LENGTH),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_FLOAT),
 	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(field_flags,	0),
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_BUF_STATS_OLD_LRU_LEN	4
-	{STRUCT_FLD(field_name,		"OLD_DATABASE_PAGES"),
+#define	FTS_INDEX_STATS_SYNC_RUNS	4
+	{STRUCT_FLD(field_name,		"SYNC_RUNS"),
 	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
 	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
 	 STRUCT_FLD(value,		0),
@@ -4409,39 +4913,472 @@ static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
-#define IDX_BUF_STATS_FLUSH_LIST_LEN	5
-	{STRUCT_FLD(field_name,		"MODIFIED_DATABASE_PAGES"),
-	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
-	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
-	 STRUCT_FLD(old_name,		""),
-	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+	END_OF_ST_FIELD_INFO
+};
 
-#define IDX_BUF_STATS_PENDING_ZIP	6
-	{STRUCT_FLD(field_name,		"PENDING_DECOMPRESS"),
-	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
-	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
-	 STRUCT_FLD(old_name,		""),
-	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+/** Row counts of the auxiliary INDEX tables of an FTS index */
+struct i_s_fts_index_stats_t {
+	ulint		n_words;	/*!< Number of distinct words */
 
-#define IDX_BUF_STATS_PENDING_READ	7
-	{STRUCT_FLD(field_name,		"PENDING_READS"),
-	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
-	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
-	 STRUCT_FLD(old_name,		""),
-	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+	ulint		n_nodes;	/*!< Number of rows */
 
-#define IDX_BUF_STATS_FLUSH_LRU		8
-	{STRUCT_FLD(field_name,		"PENDING_FLUSH_LRU"),
-	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
-	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
-	 STRUCT_FLD(value,		0),
-	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	ulint		n_min_nodes;	/*!< Number of rows that would be
+					left after merging the rows of
+					each word */
+
+	ulint		word_nodes;	/*!< Number of rows of the current
+					word */
+
+	ulint		word_size;	/*!< Size of the ilists of the
+					current word */
+
+	ulint		word_len;	/*!< Length of the current word */
+
+	byte		word[FTS_MAX_WORD_LEN];
+					/*!< The current word */
+};
+
+/*******************************************************************//**
+Add the rows that the current word would have after a merge. A merge
+fills each row with FTS_ILIST_MAX_SIZE bytes of the ilist. */
+static
+void
+i_s_fts_index_stats_end_word(
+/*=========================*/
+	i_s_fts_index_stats_t*	stats)	/*!< in/out: row counts */
+{
+	if (stats->word_nodes > 0) {
+		ulint	n_nodes = 1;
+
+		if (stats->word_size > 0) {
+			n_nodes += (stats->word_size - 1)
+				/ FTS_ILIST_MAX_SIZE;
+		}
+
+		stats->n_min_nodes += ut_min(n_nodes, stats->word_nodes);
+	}
+
+	stats->word_nodes = 0;
+	stats->word_size = 0;
+}
+
+/*******************************************************************//**
+Count a row of an FTS auxiliary INDEX table. The rows are read in the
+order of the clustered index, the rows of a word are adjacent.
+@return always TRUE */
+static
+ibool
+i_s_fts_index_stats_fetch(
+/*======================*/
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: i_s_fts_index_stats_t* */
+{
+	sel_node_t*		sel_node = static_cast<sel_node_t*>(row);
+	i_s_fts_index_stats_t*	stats;
+	que_node_t*		exp = sel_node->select_list;
+	dfield_t*		dfield = que_node_get_val(exp);
+	ulint			len = dfield_get_len(dfield);
+	const byte*		data;
+
+	stats = static_cast<i_s_fts_index_stats_t*>(user_arg);
+	data = static_cast<const byte*>(dfield_get_data(dfield));
+
+	ut_a(len <= FTS_MAX_WORD_LEN);
+
+	if (stats->word_nodes == 0
+	    || len != stats->word_len
+	    || memcmp(data, stats->word, len) != 0) {
+
+		i_s_fts_index_stats_end_word(stats);
+
+		memcpy(stats->word, data, len);
+		stats->word_len = len;
+
+		++stats->n_words;
+	}
+
+	exp = que_node_get_next(exp);
+	dfield = que_node_get_val(exp);
+
+	stats->word_size += dfield_get_len(dfield);
+	++stats->word_nodes;
+	++stats->n_nodes;
+
+	return(TRUE);
+}
+
+/*******************************************************************//**
+Count the rows and the words of an FTS auxiliary INDEX table.
+@return	DB_SUCCESS on success, otherwise error code */
+static
+dberr_t
+i_s_fts_index_stats_fill_selected(
+/*==============================*/
+	trx_t*			trx,		/*!< in: transaction */
+	dict_index_t*		index,		/*!< in: FTS index */
+	ulint			selected,	/*!< in: selected FTS index */
+	i_s_fts_index_stats_t*	stats)		/*!< in/out: row counts */
+{
+	pars_info_t*		info;
+	fts_table_t		fts_table;
+	que_t*			graph;
+	dberr_t			error;
+	i_s_fts_index_stats_t	start = *stats;
+
+	info = pars_info_create();
+
+	pars_info_bind_function(
+		info, "my_func", i_s_fts_index_stats_fetch, stats);
+
+	FTS_INIT_INDEX_TABLE(&fts_table, fts_get_suffix(selected),
+			     FTS_INDEX_TABLE, index);
+
+	graph = fts_parse_sql(
+		&fts_table, info,
+		"DECLARE FUNCTION my_func;\n"
+		"DECLARE CURSOR c IS"
+		" SELECT word, ilist FROM \"%s\";\n"
+		"BEGIN\n"
+		"\n"
+		"OPEN c;\n"
+		"WHILE 1 = 1 LOOP\n"
+		"  FETCH c INTO my_func();\n"
+		"  IF c % NOTFOUND THEN\n"
+		"    EXIT;\n"
+		"  END IF;\n"
+		"END LOOP;\n"
+		"CLOSE c;");
+
+	for(;;) {
+		error = fts_eval_sql(trx, graph);
+
+		if (error == DB_SUCCESS) {
+			fts_sql_commit(trx);
+
+			break;
+		} else {
+			fts_sql_rollback(trx);
+
+			/* Count the rows again. */
+			*stats = start;
+
+			ut_print_timestamp(stderr);
+
+			if (error == DB_LOCK_WAIT_TIMEOUT) {
+				fprintf(stderr, "  InnoDB: Warning: "
+					"lock wait timeout reading "
+					"FTS index.  Retrying!\n");
+
+				trx->error_state = DB_SUCCESS;
+			} else {
+				fprintf(stderr, "  InnoDB: Error: %d "
+				"while reading FTS index.\n", error);
+				break;
+			}
+		}
+	}
+
+	fts_que_graph_free(graph);
+
+	return(error);
+}
+
+/*******************************************************************//**
+Fill the dynamic table INFORMATION_SCHEMA.INNODB_FT_INDEX_STATS with
+the row counts of an FTS index.
+@return	0 on success, 1 on failure */
+static
+int
+i_s_fts_index_stats_fill_one_index(
+/*===============================*/
+	dict_index_t*		index,		/*!< in: FTS index */
+	trx_t*			trx,		/*!< in: transaction */
+	THD*			thd,		/*!< in: thread */
+	TABLE_LIST*		tables)		/*!< in/out: tables to fill */
+{
+	i_s_fts_index_stats_t	stats;
+	Field**			fields = tables->table->field;
+	fts_cache_t*		cache = index->table->fts->cache;
+	ulint			n_sync_runs = 0;
+	double			fragmentation = 0;
+
+	DBUG_ENTER("i_s_fts_index_stats_fill_one_index");
+	DBUG_ASSERT(!dict_index_is_online_ddl(index));
+
+	memset(&stats, 0x0, sizeof(stats));
+
+	/* Iterate through each auxiliary table as described in
+	fts_index_selector */
+	for (ulint selected = 0; fts_index_selector[selected].value;
+	     selected++) {
+
+		if (i_s_fts_index_stats_fill_selected(
+			    trx, index, selected, &stats) != DB_SUCCESS) {
+
+			DBUG_RETURN(1);
+		}
+
+		i_s_fts_index_stats_end_word(&stats);
+	}
+
+	if (stats.n_nodes > 0) {
+		fragmentation = 100.0
+			* (double) (stats.n_nodes - stats.n_min_nodes)
+			/ (double) stats.n_nodes;
+	}
+
+	if (cache != NULL) {
+		rw_lock_s_lock(&cache->lock);
+
+		for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+			const fts_index_cache_t*	index_cache;
+
+			index_cache = static_cast<const fts_index_cache_t*>(
+				ib_vector_get_const(cache->indexes, i));
+
+			if (index_cache->index == index) {
+				n_sync_runs = index_cache->n_sync_runs;
+			}
+		}
+
+		rw_lock_s_unlock(&cache->lock);
+	}
+
+	OK(field_store_string(
+		fields[FTS_INDEX_STATS_INDEX_NAME], index->name));
+
+	OK(fields[FTS_INDEX_STATS_WORDS]->store(stats.n_words, true));
+
+	OK(fields[FTS_INDEX_STATS_NODES]->store(stats.n_nodes, true));
+
+	OK(fields[FTS_INDEX_STATS_FRAGMENTATION]->store(fragmentation));
+
+	OK(fields[FTS_INDEX_STATS_SYNC_RUNS]->store(n_sync_runs, true));
+
+	OK(schema_table_store_record(thd, tables->table));
+
+	DBUG_RETURN(0);
+}
+
+/*******************************************************************//**
+Fill the dynamic table INFORMATION_SCHEMA.INNODB_FT_INDEX_STATS
+@return	0 on success, 1 on failure */
+static
+int
+i_s_fts_index_stats_fill(
+/*=====================*/
+	THD*		thd,	/*!< in: thread */
+	TABLE_LIST*	tables,	/*!< in/out: tables to fill */
+	Item*		)	/*!< in: condition (ignored) */
+{
+	dict_table_t*		user_table;
+	dict_index_t*		index;
+	trx_t*			trx;
+	int			ret = 0;
+
+	DBUG_ENTER("i_s_fts_index_stats_fill");
+
+	/* deny access to non-superusers */
+	if (check_global_access(thd, PROCESS_ACL)) {
+		DBUG_RETURN(0);
+	}
+
+	if (!fts_internal_tbl_name) {
+		DBUG_RETURN(0);
+	}
+
+	/* Prevent DDL to drop fts aux tables. */
+	rw_lock_s_lock(&dict_operation_lock);
+
+	user_table = dict_table_open_on_name(
+		fts_internal_tbl_name, FALSE, FALSE, DICT_ERR_IGNORE_NONE);
+
+	if (!user_table) {
+		rw_lock_s_unlock(&dict_operation_lock);
+
+		DBUG_RETURN(0);
+	} else if (!dict_table_has_fts_index(user_table)) {
+		dict_table_close(user_table, FALSE, FALSE);
+
+		rw_lock_s_unlock(&dict_operation_lock);
+
+		DBUG_RETURN(0);
+	}
+
+	trx = trx_allocate_for_background();
+	trx->op_info = "Select for FTS INDEX STATS";
+
+	for (index = dict_table_get_first_index(user_table);
+	     index != NULL && ret == 0;
+	     index = dict_table_get_next_index(index)) {
+
+		if (index->type & DICT_FTS) {
+			ret = i_s_fts_index_stats_fill_one_index(
+				index, trx, thd, tables);
+		}
+	}
+
+	trx_free_for_background(trx);
+
+	dict_table_close(user_table, FALSE, FALSE);
+
+	rw_lock_s_unlock(&dict_operation_lock);
+
+	DBUG_RETURN(ret);
+}
+
+/*******************************************************************//**
+Bind the dynamic table INFORMATION_SCHEMA.INNODB_FT_INDEX_STATS
+@return	0 on success */
+static
+int
+i_s_fts_index_stats_init(
+/*=====================*/
+	void*	p)	/*!< in/out: table schema object */
+{
+	DBUG_ENTER("i_s_fts_index_stats_init");
+	ST_SCHEMA_TABLE* schema = (ST_SCHEMA_TABLE*) p;
+
+	schema->fields_info = i_s_fts_index_stats_fields_info;
+	schema->fill_table = i_s_fts_index_stats_fill;
+
+	DBUG_RETURN(0);
+}
+
+UNIV_INTERN struct st_mysql_plugin	i_s_innodb_ft_index_stats =
+{
+	/* the plugin type (a MYSQL_XXX_PLUGIN value) */
+	/* int */
+	STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+	/* pointer to type-specific plugin descriptor */
+	/* void* */
+	STRUCT_FLD(info, &i_s_info),
+
+	/* plugin name */
+	/* const char* */
+	STRUCT_FLD(name, "INNODB_FT_INDEX_STATS"),
+
+	/* plugin author (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(author, plugin_author),
+
+	/* general descriptive text (for SHOW PLUGINS) */
+	/* const char* */
+	STRUCT_FLD(descr, "INNODB AUXILIARY FTS INDEX STATISTICS"),
+
+	/* the plugin license (PLUGIN_LICENSE_XXX) */
+	/* int */
+	STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+	/* the function to invoke when plugin is loaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(init, i_s_fts_index_stats_init),
+
+	/* the function to invoke when plugin is unloaded */
+	/* int (*)(void*); */
+	STRUCT_FLD(deinit, i_s_common_deinit),
+
+	/* plugin version (for SHOW PLUGINS) */
+	/* unsigned int */
+	STRUCT_FLD(version, INNODB_VERSION_SHORT),
+
+	/* struct st_mysql_show_var* */
+	STRUCT_FLD(status_vars, NULL),
+
+	/* struct st_mysql_sys_var** */
+	STRUCT_FLD(system_vars, NULL),
+
+	/* reserved for dependency checking */
+	/* void* */
+	STRUCT_FLD(__reserved1, NULL),
+
+	/* Plugin flags */
+	/* unsigned long */
+	STRUCT_FLD(flags, 0UL),
+};
+
+/* Fields of the dynamic table INNODB_BUFFER_POOL_STATS. */
+static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
+{
+#define IDX_BUF_STATS_POOL_ID		0
+	{STRUCT_FLD(field_name,		"POOL_ID"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_POOL_SIZE		1
+	{STRUCT_FLD(field_name,		"POOL_SIZE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FREE_BUFFERS	2
+	{STRUCT_FLD(field_name,		"FREE_BUFFERS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_LRU_LEN		3
+	{STRUCT_FLD(field_name,		"DATABASE_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_OLD_LRU_LEN	4
+	{STRUCT_FLD(field_name,		"OLD_DATABASE_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FLUSH_LIST_LEN	5
+	{STRUCT_FLD(field_name,		"MODIFIED_DATABASE_PAGES"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_PENDING_ZIP	6
+	{STRUCT_FLD(field_name,		"PENDING_DECOMPRESS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_PENDING_READ	7
+	{STRUCT_FLD(field_name,		"PENDING_READS"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
+#define IDX_BUF_STATS_FLUSH_LRU		8
+	{STRUCT_FLD(field_name,		"PENDING_FLUSH_LRU"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
@@ -5443,22 +6380,33 @@ i_s_innodb_fill_buffer_pool(
 
 	heap = mem_heap_create(10000);
 
-	/* Go through each chunk of buffer pool. Currently, we only
-	have one single chunk for each buffer pool */
-	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
+	/* Go through each chunk of buffer pool. The chunks may be
+	freed or added by a buffer pool resize whenever we do not
+	hold buf_pool->mutex. */
+	for (ulint n = 0;; n++) {
 		const buf_block_t*	block;
 		ulint			n_blocks;
 		buf_page_info_t*	info_buffer;
 		ulint			num_page;
 		ulint			mem_size;
 		ulint			chunk_size;
+		ulint			curr_chunk_size;
 		ulint			num_to_process = 0;
 		ulint			block_id = 0;
 
-		/* Get buffer block of the nth chunk */
-		block = buf_get_nth_chunk_block(buf_pool, n, &chunk_size);
+		buf_pool_mutex_enter(buf_pool);
+
+		if (n >= buf_pool->n_chunks) {
+			buf_pool_mutex_exit(buf_pool);
+			break;
+		}
+
+		/* Get the number of blocks of the nth chunk */
+		buf_get_nth_chunk_block(buf_pool, n, &chunk_size);
 		num_page = 0;
 
+		buf_pool_mutex_exit(buf_pool);
+
 		while (chunk_size > 0) {
 			/* we cache maximum MAX_BUF_INFO_CACHED number of
 			buffer page info */
@@ -5479,6 +6427,23 @@ i_s_innodb_fill_buffer_pool(
 			release mutex periodically */
 			buf_pool_mutex_enter(buf_pool);
 
+			if (n >= buf_pool->n_chunks) {
+				/* The chunk was freed meanwhile. */
+				buf_pool_mutex_exit(buf_pool);
+				break;
+			}
+
+			block = buf_get_nth_chunk_block(
+				buf_pool, n, &curr_chunk_size);
+
+			if (block_id + num_to_process > curr_chunk_size) {
+				/* The chunk was replaced meanwhile. */
+				buf_pool_mutex_exit(buf_pool);
+				break;
+			}
+
+			block += block_id;
+
 			/* GO through each block in the chunk */
 			for (n_blocks = num_to_process; n_blocks--; block++) {
 				i_s_innodb_buffer_page_get_info(
@@ -29,6 +29,7 @@ Created July 18, 2007 Vasil Dimov
 const char plugin_author[] = "Oracle Corporation";
 
 extern struct st_mysql_plugin	i_s_innodb_rseg;
+extern struct st_mysql_plugin	i_s_innodb_purge_table_stats;
 extern struct st_mysql_plugin	i_s_innodb_trx;
 extern struct st_mysql_plugin	i_s_innodb_locks;
 extern struct st_mysql_plugin	i_s_innodb_lock_waits;
@@ -36,6 +37,7 @@ extern struct st_mysql_plugin	i_s_innodb_cmp;
 extern struct st_mysql_plugin	i_s_innodb_cmp_reset;
 extern struct st_mysql_plugin	i_s_innodb_cmp_per_index;
 extern struct st_mysql_plugin	i_s_innodb_cmp_per_index_reset;
+extern struct st_mysql_plugin	i_s_innodb_change_buffer_indexes;
 extern struct st_mysql_plugin	i_s_innodb_cmpmem;
 extern struct st_mysql_plugin	i_s_innodb_cmpmem_reset;
 extern struct st_mysql_plugin   i_s_innodb_metrics;
@@ -45,6 +47,7 @@ extern struct st_mysql_plugin	i_s_innodb_ft_being_deleted;
 extern struct st_mysql_plugin	i_s_innodb_ft_index_cache;
 extern struct st_mysql_plugin	i_s_innodb_ft_index_table;
 extern struct st_mysql_plugin	i_s_innodb_ft_config;
+extern struct st_mysql_plugin	i_s_innodb_ft_index_stats;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page_lru;
 extern struct st_mysql_plugin	i_s_innodb_buffer_stats;
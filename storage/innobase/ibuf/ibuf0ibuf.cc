@@ -204,12 +204,27 @@ UNIV_INTERN uint	ibuf_debug;
 /** The insert buffer control structure */
 UNIV_INTERN ibuf_t*	ibuf			= NULL;
 
+/** Change buffer statistics, indexed by dict_index_t::id */
+UNIV_INTERN ibuf_stat_per_index_t	ibuf_stat_per_index;
+/** Mutex protecting ibuf_stat_per_index */
+UNIV_INTERN ib_mutex_t		ibuf_stat_per_index_mutex;
+
+/** Event to wake up the change buffer merge threads */
+UNIV_INTERN os_event_t		ibuf_merge_event;
+/** Number of change buffer merge threads that are running */
+UNIV_INTERN ulint		ibuf_merge_n_threads_active;
+
 #ifdef UNIV_PFS_MUTEX
 UNIV_INTERN mysql_pfs_key_t	ibuf_pessimistic_insert_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	ibuf_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	ibuf_bitmap_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	ibuf_stat_per_index_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	ibuf_merge_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 #ifdef UNIV_IBUF_COUNT_DEBUG
 /** Number of tablespaces in the ibuf_counts array */
 #define IBUF_COUNT_N_SPACES	4
@@ -299,6 +314,32 @@ static ib_mutex_t	ibuf_mutex;
 /** The mutex protecting the insert buffer bitmaps */
 static ib_mutex_t	ibuf_bitmap_mutex;
 
+/** Number of recently read pages that the background merge looks
+at first */
+#define IBUF_MERGE_N_HOT	64
+
+/** State of the background merge, protected by ibuf_mutex */
+struct ibuf_merge_t {
+	ulint		n_pending;	/*!< number of pages that the
+					merge threads are yet to merge
+					in the current batch */
+	ulint		last_read_merges;
+					/*!< ibuf->n_read_merges when the
+					previous batch was sized */
+	ulint		hot_space[IBUF_MERGE_N_HOT];
+					/*!< space ids of pages that had to
+					be merged when they were read for
+					an access */
+	ulint		hot_page_no[IBUF_MERGE_N_HOT];
+					/*!< page numbers of those pages */
+	ulint		n_hot;		/*!< number of entries in
+					hot_space[] and hot_page_no[] */
+	ulint		hot_next;	/*!< slot for the next entry */
+};
+
+/** State of the background merge */
+static ibuf_merge_t	ibuf_merge_state;
+
 /** The area in pages from which contract looks for page numbers for merge */
 #define	IBUF_MERGE_AREA			8UL
 
@@ -474,6 +515,15 @@ ibuf_close(void)
 	mutex_free(&ibuf_bitmap_mutex);
 	memset(&ibuf_bitmap_mutex, 0x0, sizeof(ibuf_mutex));
 
+	mutex_free(&ibuf_stat_per_index_mutex);
+	memset(&ibuf_stat_per_index_mutex,
+	       0x0, sizeof(ibuf_stat_per_index_mutex));
+
+	ibuf_stat_per_index.clear();
+
+	os_event_free(ibuf_merge_event);
+	ibuf_merge_event = NULL;
+
 	mem_free(ibuf);
 	ibuf = NULL;
 }
@@ -536,6 +586,20 @@ ibuf_init_at_db_start(void)
 	mutex_create(ibuf_bitmap_mutex_key,
 		     &ibuf_bitmap_mutex, SYNC_IBUF_BITMAP_MUTEX);
 
+	/* ibuf_stat_per_index_mutex is acquired from:
+	1. ibuf_insert(), no other latches
+	2. ibuf_merge_or_delete_for_page() (where the page is latched)
+	3. ibuf_delete_for_discarded_space(), no other latches
+	4. i_s_innodb_change_buffer_indexes_fill() (where SYNC_DICT is
+	acquired)
+	since we do not acquire any other latches while holding this mutex,
+	it can have very low level. We pick SYNC_ANY_LATCH for it. */
+	mutex_create(ibuf_stat_per_index_mutex_key,
+		     &ibuf_stat_per_index_mutex, SYNC_ANY_LATCH);
+
+	memset(&ibuf_merge_state, 0x0, sizeof(ibuf_merge_state));
+	ibuf_merge_event = os_event_create();
+
 	mtr_start(&mtr);
 
 	mutex_enter(&ibuf_mutex);
@@ -2560,6 +2624,111 @@ ibuf_get_merge_pages(
 	return(volume);
 }
 
+/*********************************************************************//**
+Notes a page that had to be merged when it was read for an access. The
+background merge looks at the pages that follow it first, because the
+reads are likely to continue with them. */
+static
+void
+ibuf_merge_note_hot(
+/*================*/
+	ulint	space,	/*!< in: space id of the page */
+	ulint	page_no)/*!< in: page number of the page */
+{
+	mutex_enter(&ibuf_mutex);
+
+	ibuf_merge_state.hot_space[ibuf_merge_state.hot_next] = space;
+	ibuf_merge_state.hot_page_no[ibuf_merge_state.hot_next] = page_no;
+
+	ibuf_merge_state.hot_next
+		= (ibuf_merge_state.hot_next + 1) % IBUF_MERGE_N_HOT;
+
+	if (ibuf_merge_state.n_hot < IBUF_MERGE_N_HOT) {
+		ibuf_merge_state.n_hot++;
+	}
+
+	mutex_exit(&ibuf_mutex);
+}
+
+/*********************************************************************//**
+Takes the most recently noted page that had to be merged when it was
+read for an access.
+@return true if a page was noted */
+static
+bool
+ibuf_merge_get_hot(
+/*===============*/
+	ulint*	space,	/*!< out: space id of the page */
+	ulint*	page_no)/*!< out: page number of the page */
+{
+	bool	found = false;
+
+	mutex_enter(&ibuf_mutex);
+
+	if (ibuf_merge_state.n_hot > 0) {
+		ibuf_merge_state.n_hot--;
+
+		ibuf_merge_state.hot_next
+			= (ibuf_merge_state.hot_next + IBUF_MERGE_N_HOT - 1)
+			% IBUF_MERGE_N_HOT;
+
+		*space = ibuf_merge_state.hot_space[
+			ibuf_merge_state.hot_next];
+		*page_no = ibuf_merge_state.hot_page_no[
+			ibuf_merge_state.hot_next];
+
+		found = true;
+	}
+
+	mutex_exit(&ibuf_mutex);
+
+	return(found);
+}
+
+/*********************************************************************//**
+Reads the numbers of the pages that follow a page of a space in the
+ibuf tree.
+@return a lower limit for the combined volume of records which will be
+merged */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+ulint
+ibuf_get_merge_pages_after(
+/*=======================*/
+	ulint		space,	/*!< in: space id */
+	ulint		page_no,/*!< in: page number */
+	ulint*		pages,	/*!< out: pages read */
+	ulint*		spaces,	/*!< out: spaces read */
+	ib_int64_t*	versions,/*!< out: space versions read */
+	ulint*		n_pages)/*!< out: number of pages read */
+{
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+	mem_heap_t*	heap = mem_heap_create(512);
+	dtuple_t*	tuple = ibuf_search_tuple_build(space, page_no, heap);
+	ulint		sum_sizes = 0;
+
+	*n_pages = 0;
+
+	ibuf_mtr_start(&mtr);
+
+	btr_pcur_open(
+		ibuf->index, tuple, PAGE_CUR_GE, BTR_SEARCH_LEAF, &pcur,
+		&mtr);
+
+	mem_heap_free(heap);
+
+	if (!page_is_empty(btr_pcur_get_page(&pcur))) {
+		sum_sizes = ibuf_get_merge_pages(
+			&pcur, space, IBUF_MAX_N_PAGES_MERGED,
+			pages, spaces, versions, n_pages, &mtr);
+	}
+
+	ibuf_mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	return(sum_sizes);
+}
+
 /*********************************************************************//**
 Contracts insert buffer trees by reading pages to the buffer pool.
 @return a lower limit for the combined size in bytes of entries which
@@ -2580,9 +2749,29 @@ ibuf_merge_pages(
 	ulint		page_nos[IBUF_MAX_N_PAGES_MERGED];
 	ulint		space_ids[IBUF_MAX_N_PAGES_MERGED];
 	ib_int64_t	space_versions[IBUF_MAX_N_PAGES_MERGED];
+	ulint		hot_space;
+	ulint		hot_page_no;
 
 	*n_pages = 0;
 
+	/* Merge first the pages that follow the pages that had to be
+	merged when they were read for an access. */
+
+	while (ibuf_merge_get_hot(&hot_space, &hot_page_no)) {
+
+		sum_sizes = ibuf_get_merge_pages_after(
+			hot_space, hot_page_no,
+			page_nos, space_ids, space_versions, n_pages);
+
+		if (*n_pages > 0) {
+			buf_read_ibuf_merge_pages(
+				sync, space_ids, space_versions, page_nos,
+				*n_pages);
+
+			return(sum_sizes + 1);
+		}
+	}
+
 	ibuf_mtr_start(&mtr);
 
 	/* Open a cursor to a randomly chosen leaf of the tree, at a random
@@ -2785,14 +2974,17 @@ ibuf_merge_in_background(
 	}
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
 
+	mutex_enter(&ibuf_mutex);
+
 	if (full) {
 		/* Caller has requested a full batch */
 		n_pages = PCT_IO(100);
 	} else {
-		/* By default we do a batch of 5% of the io_capacity */
-		n_pages = PCT_IO(5);
+		ulint	n_read_merges = ibuf->n_read_merges;
 
-		mutex_enter(&ibuf_mutex);
+		/* By default we do a batch of
+		innodb_change_buffer_merge_io_pct of the io_capacity */
+		n_pages = PCT_IO(srv_change_buffer_merge_io_pct);
 
 		/* If the ibuf->size is more than half the max_size
 		then we make more agreesive contraction.
@@ -2803,9 +2995,30 @@ ibuf_merge_in_background(
 					   / (ibuf->max_size + 1));
 		}
 
+		/* Each page that had to be merged when it was read for
+		an access since the previous batch made that read wait.
+		Merge as many more pages in the background. */
+		n_pages += n_read_merges - ibuf_merge_state.last_read_merges;
+		ibuf_merge_state.last_read_merges = n_read_merges;
+
+		n_pages = ut_min(n_pages, PCT_IO(100));
+	}
+
+	if (srv_n_change_buffer_merge_threads > 0
+	    && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		/* Hand the batch over to the merge threads, a batch
+		that they did not finish is dropped. */
+		ibuf_merge_state.n_pending = n_pages;
+
 		mutex_exit(&ibuf_mutex);
+
+		os_event_set(ibuf_merge_event);
+
+		return(0);
 	}
 
+	mutex_exit(&ibuf_mutex);
+
 	while (sum_pages < n_pages) {
 		ulint	n_bytes;
 
@@ -2822,6 +3035,66 @@ ibuf_merge_in_background(
 	return(sum_bytes);
 }
 
+/******************************************************************//**
+Change buffer merge thread. Merges the batches that
+ibuf_merge_in_background() hands over to the merge threads.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(ibuf_merge_thread)(
+/*==============================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(ibuf_merge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: ibuf_merge_thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		ib_int64_t	sig_count = os_event_reset(ibuf_merge_event);
+		ulint		n_pending;
+		ulint		n_pages;
+
+		mutex_enter(&ibuf_mutex);
+		n_pending = ibuf_merge_state.n_pending;
+		mutex_exit(&ibuf_mutex);
+
+		if (n_pending == 0) {
+			os_event_wait_low(ibuf_merge_event, sig_count);
+			continue;
+		}
+
+		/* Wait for the read of the last page, so that the merge
+		threads issue reads at the pace they complete. */
+		if (ibuf_merge(&n_pages, true) == 0) {
+			/* The change buffer is empty */
+			n_pages = ULINT_MAX;
+		}
+
+		mutex_enter(&ibuf_mutex);
+		ibuf_merge_state.n_pending -= ut_min(
+			ibuf_merge_state.n_pending, ut_max(n_pages, 1));
+		mutex_exit(&ibuf_mutex);
+	}
+
+	mutex_enter(&ibuf_mutex);
+	ut_a(ibuf_merge_n_threads_active > 0);
+	ibuf_merge_n_threads_active--;
+	mutex_exit(&ibuf_mutex);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*********************************************************************//**
 Contract insert buffer trees after insert if they are too big. */
 UNIV_INLINE
@@ -3890,6 +4163,12 @@ skip_watch:
 		/* fprintf(stderr, "Ibuf insert for page no %lu of index %s\n",
 		page_no, index->name); */
 #endif
+		mutex_enter(&ibuf_stat_per_index_mutex);
+		ibuf_stat_t&	stat = ibuf_stat_per_index[index->id];
+		stat.space = space;
+		stat.n_buffered[op]++;
+		mutex_exit(&ibuf_stat_per_index_mutex);
+
 		DBUG_RETURN(TRUE);
 
 	} else {
@@ -4539,6 +4818,8 @@ ibuf_merge_or_delete_for_page(
 	ibool		tablespace_being_deleted = FALSE;
 	ibool		corruption_noticed	= FALSE;
 	mtr_t		mtr;
+	index_id_t	index_id		= 0;
+	bool		read_merge		= false;
 
 	/* Counts for merged & discarded operations. */
 	ulint		mops[IBUF_OP_COUNT];
@@ -4679,6 +4960,9 @@ ibuf_merge_or_delete_for_page(
 				(ulong)
 				fil_page_get_type(block->frame));
 			ut_ad(0);
+		} else {
+			index_id = btr_page_get_index_id(block->frame);
+			read_merge = !block->page.read_for_ibuf_merge;
 		}
 	}
 
@@ -4894,10 +5178,45 @@ reset_bit:
 	btr_pcur_close(&pcur);
 	mem_heap_free(heap);
 
+	if (index_id != 0) {
+		ibuf_stat_t*	stat;
+		ulint		n_ops = 0;
+
+		mutex_enter(&ibuf_stat_per_index_mutex);
+
+		stat = &ibuf_stat_per_index[index_id];
+		stat->space = space;
+
+		for (ulint i = 0; i < IBUF_OP_COUNT; i++) {
+			ulint	n = mops[i] + dops[i];
+
+			/* Operations buffered before the startup were
+			not counted. */
+			stat->n_buffered[i] -= ut_min(stat->n_buffered[i], n);
+			n_ops += n;
+		}
+
+		if (n_ops > 0) {
+			stat->n_merged_pages++;
+
+			if (read_merge) {
+				stat->n_read_merges++;
+			}
+		} else {
+			read_merge = false;
+		}
+
+		mutex_exit(&ibuf_stat_per_index_mutex);
+	}
+
 #ifdef HAVE_ATOMIC_BUILTINS
 	os_atomic_increment_ulint(&ibuf->n_merges, 1);
 	ibuf_add_ops(ibuf->n_merged_ops, mops);
 	ibuf_add_ops(ibuf->n_discarded_ops, dops);
+
+	if (read_merge) {
+		os_atomic_increment_ulint(&ibuf->n_read_merges, 1);
+	}
 #else /* HAVE_ATOMIC_BUILTINS */
 	/* Protect our statistics keeping from race conditions */
 	mutex_enter(&ibuf_mutex);
@@ -4906,9 +5225,17 @@ reset_bit:
 	ibuf_add_ops(ibuf->n_merged_ops, mops);
 	ibuf_add_ops(ibuf->n_discarded_ops, dops);
 
+	if (read_merge) {
+		ibuf->n_read_merges++;
+	}
+
 	mutex_exit(&ibuf_mutex);
 #endif /* HAVE_ATOMIC_BUILTINS */
 
+	if (read_merge) {
+		ibuf_merge_note_hot(space, page_no);
+	}
+
 	if (update_ibuf_bitmap && !tablespace_being_deleted) {
 
 		fil_decr_pending_ops(space);
@@ -5000,6 +5327,20 @@ leave_loop:
 	ibuf_mtr_commit(&mtr);
 	btr_pcur_close(&pcur);
 
+	mutex_enter(&ibuf_stat_per_index_mutex);
+
+	for (ibuf_stat_per_index_t::iterator it = ibuf_stat_per_index.begin();
+	     it != ibuf_stat_per_index.end();) {
+
+		if (it->second.space == space) {
+			ibuf_stat_per_index.erase(it++);
+		} else {
+			++it;
+		}
+	}
+
+	mutex_exit(&ibuf_stat_per_index_mutex);
+
 #ifdef HAVE_ATOMIC_BUILTINS
 	ibuf_add_ops(ibuf->n_discarded_ops, dops);
 #else /* HAVE_ATOMIC_BUILTINS */
@@ -47,6 +47,14 @@ UNIV_INTERN
 void
 btr_search_sys_free(void);
 /*=====================*/
+/*****************************************************************//**
+Resizes the hash tables of the adaptive search system after the buffer
+pool was resized. The adaptive hash index must be disabled. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
 
 /********************************************************************//**
 Disable the adaptive hash search system and empty the index. */
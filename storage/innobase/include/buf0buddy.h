@@ -70,6 +70,33 @@ buf_buddy_free(
 					up to UNIV_PAGE_SIZE */
 	MY_ATTRIBUTE((nonnull));
 
+/**********************************************************************//**
+Try to reallocate a block, to move it out of the chunks that are
+being withdrawn from the buffer pool.
+@return	true if succeeded or if failed because the block was fixed,
+false if failed because of no free blocks. */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	void*		buf,		/*!< in: block to be reallocated,
+					must be pointed to by the
+					buffer pool */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+	MY_ATTRIBUTE((nonnull));
+
+/**********************************************************************//**
+Combine all pairs of free buddies in the chunks that are being
+withdrawn from the buffer pool. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+	MY_ATTRIBUTE((nonnull));
+
 #ifndef UNIV_NONINL
 # include "buf0buddy.ic"
 #endif
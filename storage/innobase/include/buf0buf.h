@@ -81,6 +81,9 @@ Created 11/5/1995 Heikki Tuuri
 					buffer pool watches */
 #define MAX_PAGE_HASH_LOCKS	1024	/*!< The maximum number of
 					page_hash locks */
+#define BUF_POOL_SIZE_MIN	(5 * 1024 * 1024)
+					/*!< The minimum size of the
+					buffer pool in bytes */
 
 extern	buf_pool_t*	buf_pool_ptr;	/*!< The buffer pools
 					of the database */
@@ -91,6 +94,16 @@ extern ibool		buf_debug_prints;/*!< If this is set TRUE, the program
 #endif /* UNIV_DEBUG */
 extern ulint srv_buf_pool_instances;
 extern ulint srv_buf_pool_curr_size;
+extern ulong srv_buf_pool_chunk_unit;
+
+/** true when withdrawing buffer pool pages might cause page relocation */
+extern volatile bool	buf_pool_withdrawing;
+
+/** the clock is incremented every time a pointer to a page may become
+obsolete; if the withdraw clock has not changed, the pointer is still
+valid in buffer pool. if changed, the pointer might not be in buffer pool
+any more. */
+extern volatile ulint	buf_withdraw_clock;
 #else /* !UNIV_HOTBACKUP */
 extern buf_block_t*	back_block1;	/*!< first block, for --apply-log */
 extern buf_block_t*	back_block2;	/*!< second block, for page reorganize */
@@ -239,6 +252,38 @@ buf_pool_free(
 /*==========*/
 	ulint	n_instances);	/*!< in: numbere of instances to free */
 
+/********************************************************************//**
+Determines if a block is intended to be withdrawn. The caller must
+hold buf_pool->mutex and the buffer pool must be shrinking.
+@return	true if will be withdrawn */
+UNIV_INTERN
+bool
+buf_block_will_withdrawn(
+/*=====================*/
+	buf_pool_t*		buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block);		/*!< in: pointer to control
+						block */
+/********************************************************************//**
+Determines if a frame is intended to be withdrawn. The caller must
+hold buf_pool->mutex and the buffer pool must be shrinking.
+@return	true if will be withdrawn */
+UNIV_INTERN
+bool
+buf_frame_will_withdrawn(
+/*=====================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*	ptr);		/*!< in: pointer to a frame */
+/*****************************************************************//**
+This is the thread for resizing buffer pool. It waits for an event and
+when waked up either performs a resizing and sleeps again.
+@return	this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
+
 /********************************************************************//**
 Clears the adaptive hash index on all pages in the buffer pool. */
 UNIV_INTERN
@@ -273,6 +318,25 @@ UNIV_INLINE
 ulint
 buf_pool_get_n_pages(void);
 /*=======================*/
+/*********************************************************************//**
+Calculates aligned buffer pool size based on srv_buf_pool_chunk_unit,
+if needed.
+@return	aligned buffer pool size in bytes */
+UNIV_INLINE
+ulint
+buf_pool_size_align(
+/*================*/
+	ulint	size);	/*!< in: size in bytes */
+/*********************************************************************//**
+Verifies whether the pointers to buffer blocks stored at the given
+withdraw clock value might have become obsolete.
+@return	true if obsolete */
+UNIV_INLINE
+bool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock);	/*!< in: withdraw clock when the
+					pointer was stored */
 /********************************************************************//**
 Gets the smallest oldest_modification lsn for any page in the pool. Returns
 zero if all modified pages have been flushed to disk.
@@ -1608,6 +1672,12 @@ struct buf_page_t{
 					0 if the block was never accessed
 					in the buffer pool. Protected by
 					block mutex */
+	bool		read_for_ibuf_merge;
+					/*!< true if the page was read in
+					by a change buffer merge and not
+					for an access; set before the read
+					is posted, while the page is
+					io-fixed */
 # if defined UNIV_DEBUG_FILE_ACCESSES || defined UNIV_DEBUG
 	ibool		file_page_was_freed;
 					/*!< this is set to TRUE when
@@ -1643,6 +1713,8 @@ struct buf_block_t{
 	ibool		in_unzip_LRU_list;/*!< TRUE if the page is in the
 					decompressed LRU list;
 					used in debugging */
+	ibool		in_withdraw_list;/*!< TRUE if the block is in
+					buf_pool->withdraw */
 #endif /* UNIV_DEBUG */
 	ib_mutex_t	mutex;		/*!< mutex protecting this block:
 					state (also protected by the buffer
@@ -1977,8 +2049,17 @@ struct buf_pool_t{
 	ulint		mutex_exit_forbidden; /*!< Forbid release mutex */
 #endif
 	ulint		n_chunks;	/*!< number of buffer pool chunks */
+	ulint		n_chunks_new;	/*!< new number of buffer pool chunks,
+					while the pool is being resized */
+	ulint		n_chunks_alloc;	/*!< number of elements allocated
+					in chunks[] */
 	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
 	ulint		curr_size;	/*!< current pool size in pages */
+	ulint		old_size;	/*!< previous pool size in pages;
+					differs from curr_size only while
+					the pool is being resized */
+	ulint		withdraw_target;/*!< target length of withdraw
+					block list, when withdrawing */
 	hash_table_t*	page_hash;	/*!< hash table of buf_page_t or
 					buf_block_t file pages,
 					buf_page_in_file() == TRUE,
@@ -2080,6 +2161,13 @@ struct buf_pool_t{
 					/*!< base node of the free
 					block list */
 
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the withdraw
+					block list. It is only used while
+					shrinking the buffer pool, to keep
+					the blocks of the chunks to be
+					freed from being reused */
+
 	/** "hazard pointer" used during scan of LRU while doing
 	LRU list batch.  Protected by buf_pool::mutex */
 	LRUHp		lru_hp;
@@ -2179,6 +2267,13 @@ Use these instead of accessing buf_pool->mutex directly. */
 # define buf_page_hash_lock_get(b, f)			\
 	hash_get_lock(b->page_hash, f)
 
+/** If not appropriate page_hash_lock, relock until appropriate. */
+# define buf_page_hash_lock_s_confirm(hash_lock, b, f)	\
+	hash_lock_s_confirm(hash_lock, (b)->page_hash, f)
+
+# define buf_page_hash_lock_x_confirm(hash_lock, b, f)	\
+	hash_lock_x_confirm(hash_lock, (b)->page_hash, f)
+
 #ifdef UNIV_SYNC_DEBUG
 /** Test if page_hash lock is held in s-mode. */
 # define buf_page_hash_lock_held_s(b, p)		\
@@ -30,6 +30,8 @@ Created 2011/12/19 Inaam Rana
 #include "ut0byte.h"
 #include "log0log.h"
 #include "log0recv.h"
+#include "buf0types.h"
+#include "os0file.h"
 
 #ifndef UNIV_HOTBACKUP
 
@@ -38,6 +40,14 @@ extern buf_dblwr_t*	buf_dblwr;
 /** Set to TRUE when the doublewrite buffer is being created */
 extern ibool		buf_dblwr_being_created;
 
+/** Number of parallel doublewrite segments per buffer pool instance:
+one for LRU batches and one for flush list batches */
+#define BUF_DBLWR_SEGS_PER_POOL		2
+
+/** Prefix of the parallel doublewrite file names; the buffer pool
+instance number is appended */
+#define BUF_DBLWR_FILE_PREFIX		"ib_doublewrite_"
+
 /****************************************************************//**
 Creates the doublewrite buffer to a new InnoDB installation. The header of the
 doublewrite buffer is placed on the trx system header page. */
@@ -65,6 +75,16 @@ void
 buf_dblwr_process(void);
 /*===================*/
 
+/****************************************************************//**
+Removes the parallel doublewrite files that are no longer written to: all
+of them when innodb_parallel_doublewrite is disabled, otherwise those of
+buffer pool instances beyond innodb_buffer_pool_instances. Must be called
+after crash recovery restored the pages from them. */
+UNIV_INTERN
+void
+buf_dblwr_remove_stale_files(void);
+/*==============================*/
+
 /****************************************************************//**
 frees doublewrite buffer. */
 UNIV_INTERN
@@ -108,6 +128,18 @@ void
 buf_dblwr_flush_buffered_writes(void);
 /*=================================*/
 /********************************************************************//**
+Flushes the buffered writes of one flush batch of a buffer pool instance.
+With parallel doublewrite only the segment of that instance and flush
+type is written, so that batches of other instances are not serialized
+behind it; otherwise this is buf_dblwr_flush_buffered_writes(). */
+UNIV_INTERN
+void
+buf_dblwr_flush_batch(
+/*==================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_flush_t		flush_type);	/*!< in: BUF_FLUSH_LRU or
+						BUF_FLUSH_LIST */
+/********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
 for single page flushes. If all the buffers allocated for single page
@@ -122,6 +154,34 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
+/** Parallel doublewrite segment. Batches of one flush type from one
+buffer pool instance are written to their own area of the instance's
+doublewrite file and synced independently of other segments. */
+struct buf_dblwr_seg_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting first_free,
+				b_reserved and batch_running */
+	ulint		first_free;/*!< first free position in write_buf
+				measured in units of UNIV_PAGE_SIZE */
+	ulint		b_reserved;/*!< number of pages of the current
+				batch whose datafile write has not
+				completed yet */
+	os_event_t	b_event;/*!< event where threads wait for a
+				batch flush to end */
+	bool		batch_running;/*!< true if a batch is being
+				written from this segment */
+	os_file_t	file;	/*!< doublewrite file of the buffer
+				pool instance */
+	const char*	file_name;/*!< name of file */
+	os_offset_t	offset;	/*!< byte offset of this segment in
+				file */
+	byte*		write_buf;/*!< write buffer of
+				srv_doublewrite_batch_size pages, aligned
+				to UNIV_PAGE_SIZE */
+	byte*		write_buf_unaligned;/*!< pointer to write_buf,
+				but unaligned */
+	buf_page_t**	buf_block_arr;/*!< blocks cached to write_buf */
+};
+
 /** Doublewrite control struct */
 struct buf_dblwr_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
@@ -154,6 +214,17 @@ struct buf_dblwr_t{
 	buf_page_t**	buf_block_arr;/*!< array to store pointers to
 				the buffer blocks which have been
 				cached to write_buf */
+	buf_dblwr_seg_t* segs;	/*!< parallel doublewrite segments,
+				BUF_DBLWR_SEGS_PER_POOL per buffer pool
+				instance, or NULL if batch flushes use
+				the blocks in the system tablespace.
+				Single page flushes always use the
+				system tablespace. */
+	ulint		n_segs;	/*!< number of elements in segs */
+	os_file_t*	files;	/*!< parallel doublewrite files, one
+				per buffer pool instance */
+	char*		file_names;/*!< names of files, OS_FILE_MAX_PATH
+				bytes each */
 };
 
 
@@ -174,12 +174,29 @@ buf_flush_ready_for_replace(
 	buf_page_t*	bpage);	/*!< in: buffer control block, must be
 				buf_page_in_file(bpage) and in the LRU list */
 /******************************************************************//**
-page_cleaner thread tasked with flushing dirty pages from the buffer
-pools. As of now we'll have only one instance of this thread.
+Initialize the page_cleaner shared state. Must be called before the
+page_cleaner threads are created. */
+UNIV_INTERN
+void
+buf_flush_page_cleaner_init(void);
+/*=============================*/
+/******************************************************************//**
+page_cleaner coordinator thread tasked with flushing dirty pages from
+the buffer pools. There is exactly one instance of this thread.
 @return a dummy parameter */
 extern "C" UNIV_INTERN
 os_thread_ret_t
-DECLARE_THREAD(buf_flush_page_cleaner_thread)(
+DECLARE_THREAD(buf_flush_page_cleaner_coordinator)(
+/*===============================================*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
+/******************************************************************//**
+page_cleaner worker thread. There are innodb_page_cleaners - 1
+instances of this thread.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_flush_page_cleaner_worker)(
 /*==========================================*/
 	void*	arg);		/*!< in: a dummy parameter required by
 				os_thread_create */
@@ -195,6 +212,19 @@ ulint
 buf_flush_LRU_tail(void);
 /*====================*/
 /*********************************************************************//**
+Clears up tail of the LRU list of a single buffer pool instance:
+* Put replaceable pages at the tail of LRU to the free list
+* Flush dirty pages at the tail of LRU to the disk
+The depth to which we scan the buffer pool is controlled by dynamic
+config parameter innodb_LRU_scan_depth, and is extended by the number
+of blocks still to be withdrawn while the buffer pool is shrinking.
+@return total pages processed. */
+UNIV_INTERN
+ulint
+buf_flush_LRU_list(
+/*===============*/
+	buf_pool_t*	buf_pool);	/*!< in/out: buffer pool instance */
+/*********************************************************************//**
 Wait for any possible LRU flushes that are in progress to end. */
 UNIV_INTERN
 void
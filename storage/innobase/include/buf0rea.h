@@ -80,6 +80,35 @@ buf_read_ahead_random(
 	ibool	inside_ibuf);	/*!< in: TRUE if we are inside ibuf
 				routine */
 /********************************************************************//**
+Issues asynchronous read requests for a batch of pages of one tablespace
+during a buffer pool load. The tablespace is looked up only once for the
+whole batch, and the requests are queued and submitted together, like
+the linear read-ahead does, so that reads of adjacent pages can be merged.
+@return number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_load_pages(
+/*================*/
+	ulint		space,		/*!< in: space id */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					to read, in ascending order */
+	ulint		n_stored);	/*!< in: number of page numbers
+					in the array */
+/********************************************************************//**
+Issues asynchronous read requests for pages that a range scan is about to
+visit, as found from the node pointers above the scanned leaf page. Like
+the linear read-ahead, the calling thread must not wait for these reads.
+@return number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_pages(
+/*=================*/
+	ulint		space,		/*!< in: space id */
+	const ulint*	page_nos,	/*!< in: array of page numbers
+					to read */
+	ulint		n_stored);	/*!< in: number of page numbers
+					in the array */
+/********************************************************************//**
 Applies linear read-ahead if in the buf_pool the page is a border page of
 a linear read-ahead area and all the pages in the area have been accessed.
 Does not read any page if the read-ahead mechanism is not activated. Note
@@ -172,6 +201,9 @@ invoked */
 /** read any page, but ignore (return an error) if a page does not exist
 instead of crashing like BUF_READ_ANY_PAGE does */
 #define BUF_READ_IGNORE_NONEXISTENT_PAGES 1024
+/** flag ORed to the mode when the page is read only to merge the changes
+that are buffered for it, and not because it is accessed */
+#define BUF_READ_FOR_IBUF_MERGE		4096
 /* @} */
 
 #endif
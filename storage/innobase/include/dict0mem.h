@@ -1131,6 +1131,13 @@ struct dict_table_t{
 				calculation; this counter is not protected by
 				any latch, because this is only used for
 				heuristics */
+	ib_uint64_t	stat_modified_since_sampling;
+				/*!< like stat_modified_counter, but only
+				reset when the indexes are sampled for the
+				persistent statistics; decides whether the
+				background recalculation may update the
+				statistics incrementally; not protected by
+				any latch */
 #define BG_STAT_NONE		0
 #define BG_STAT_IN_PROGRESS	(1 << 0)
 				/*!< BG_STAT_IN_PROGRESS is set in
@@ -1144,6 +1151,13 @@ struct dict_table_t{
 				waiting on BG_STAT_IN_PROGRESS to be cleared,
 				the background stats thread will detect this
 				and will eventually quit sooner */
+#define BG_STAT_RECALC_FULL	(1 << 2)
+				/*!< BG_STAT_RECALC_FULL is set in
+				stats_bg_flag when ANALYZE TABLE has
+				queued the table for the background
+				stats threads, which will then sample
+				its indexes without waiting for
+				MIN_RECALC_INTERVAL */
 	byte		stats_bg_flag;
 				/*!< see BG_STAT_* above.
 				Writes are covered by dict_sys->mutex.
@@ -1212,7 +1226,10 @@ struct dict_table_t{
 				/*!< Count of the number of record locks on
 				this table. We use this to determine whether
 				we can evict the table from the dictionary
-				cache. It is protected by lock_sys->mutex. */
+				cache. It is incremented atomically under
+				lock_sys->latch in shared mode and otherwise
+				protected by lock_sys->latch in exclusive
+				mode. */
 	ulint		n_ref_count;
 				/*!< count of how many handles are opened
 				to this table; dropping of the table is
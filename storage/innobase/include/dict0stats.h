@@ -39,6 +39,14 @@ enum dict_stats_upd_option_t {
 				storage, if the persistent storage is
 				not present then emit a warning and
 				fall back to transient stats */
+	DICT_STATS_RECALC_INCREMENTAL,/* update the persistent
+				statistics from the number of rows and
+				the index sizes without sampling the
+				indexes, unless more than
+				srv_stats_incremental_pct percent of the
+				rows were modified since they were last
+				sampled; then do as
+				DICT_STATS_RECALC_PERSISTENT */
 	DICT_STATS_RECALC_TRANSIENT,/* (re) calculate the statistics
 				using an imprecise quick algo
 				without saving the results
@@ -32,9 +32,12 @@ Created Apr 26, 2012 Vasil Dimov
 #include "os0sync.h" /* os_event_t */
 #include "os0thread.h" /* DECLARE_THREAD */
 
-/** Event to wake up the stats thread */
+/** Event to wake up the stats threads */
 extern os_event_t	dict_stats_event;
 
+/** Number of background stats threads that are running */
+extern ulint		dict_stats_n_threads_active;
+
 /*****************************************************************//**
 Add a table to the recalc pool, which is processed by the
 background stats gathering thread. Only the table id is added to the
@@ -159,6 +159,9 @@ extern fil_addr_t	fil_addr_null;
 #define FIL_PAGE_TYPE_ZBLOB2	12	/*!< Subsequent compressed BLOB page */
 #define FIL_PAGE_TYPE_LAST	FIL_PAGE_TYPE_ZBLOB2
 					/*!< Last page type */
+#define FIL_PAGE_COMPRESSED	14	/*!< Page compressed by transparent
+					page compression; only found in data
+					files, never in the buffer pool */
 /* @} */
 
 /** Space types @{ */
@@ -470,6 +473,19 @@ fil_close_tablespace(
 	ulint	id);	/*!< in: space id */
 #ifndef UNIV_HOTBACKUP
 /*******************************************************************//**
+Truncates an UNDO tablespace to the given size. All pages of the
+tablespace are discarded from the buffer pool without writing them,
+and the data file is re-created filled with zeros. The caller must
+re-initialize the tablespace header and must make sure that the redo
+log written for the old pages is not applied in crash recovery.
+@return	true if success */
+UNIV_INTERN
+bool
+fil_truncate_tablespace(
+/*====================*/
+	ulint	id,	/*!< in: space id */
+	ulint	size);	/*!< in: new size of the tablespace in pages */
+/*******************************************************************//**
 Discards a single-table tablespace. The tablespace must be cached in the
 memory cache. Discarding is like deleting a tablespace, but
 
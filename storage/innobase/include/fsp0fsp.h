@@ -407,6 +407,15 @@ fsp_header_init(
 	ulint	size,		/*!< in: current size in blocks */
 	mtr_t*	mtr);		/*!< in/out: mini-transaction */
 /**********************************************************************//**
+Checks if a tablespace is the shared temporary tablespace. Changes to
+its pages are not redo logged and it is re-created at startup.
+@return	true if space is the shared temporary tablespace */
+UNIV_INTERN
+bool
+fsp_is_system_temporary(
+/*====================*/
+	ulint	space);		/*!< in: space id */
+/**********************************************************************//**
 Increases the space size field of a space. */
 UNIV_INTERN
 void
@@ -105,6 +105,15 @@ extern ulong		fts_sort_pll_degree;
 call */
 extern ulong		fts_num_word_optimize;
 
+/** Variable specifying the number of SYNCs of an FTS index after which the
+optimize thread merges the index in the background, 0 leaves only the
+merges that the deleted documents trigger */
+extern ulong		fts_optimize_merge_runs;
+
+/** Variable specifying the number of FTS index rows per second that a
+background merge may read and write */
+extern ulong		fts_optimize_io_budget;
+
 /** Variable specifying whether we do additional FTS diagnostic printout
 in the log */
 extern char		fts_enable_diag_print;
@@ -356,6 +365,14 @@ extern ulong		fts_max_total_cache_size;
 /** Variable specifying the FTS result cache limit for each query */
 extern ulong		fts_result_cache_limit;
 
+/** Variable specifying the memory used for caching the words that
+queries read from the FTS INDEX tables, for each table */
+extern ulong		fts_word_cache_size;
+
+/** Variable specifying the number of threads that read the words of
+a query from the FTS INDEX tables */
+extern ulong		fts_query_pll_degree;
+
 /** Variable specifying the maximum FTS max token size */
 extern ulong		fts_max_token_size;
 
@@ -790,6 +807,14 @@ void
 fts_cache_clear(
 	fts_cache_t*	cache);
 
+/** Invalidate the words that queries cached after reading them from
+the FTS INDEX tables. To be called after the INDEX tables changed.
+@param[in,out]	cache	fts cache */
+UNIV_INTERN
+void
+fts_word_cache_invalidate(
+	fts_cache_t*	cache);
+
 /*********************************************************************//**
 Initialize things in cache. */
 UNIV_INTERN
@@ -560,6 +560,45 @@ fts_find_index_cache(
 	const dict_index_t*
 			index)		/*!< in: index to search for */
 	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/** Get the version of the word cache, to be passed to
+fts_word_cache_add() for the words read from the INDEX table after this.
+@param[in]	cache		fts cache
+@return version of the cached words */
+UNIV_INTERN
+ib_uint64_t
+fts_word_cache_get_version(
+	fts_cache_t*	cache)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/** Look up a word in the word cache of an FTS index.
+@param[in,out]	cache		fts cache
+@param[in,out]	cached_words	fts_index_cache_t::cached_words
+@param[in]	text		word to look up
+@param[out]	word		copy of the word and its rows, to be
+				freed with fts_word_free()
+@return true if the word was found */
+UNIV_INTERN
+bool
+fts_word_cache_get(
+	fts_cache_t*		cache,
+	ib_rbt_t*		cached_words,
+	const fts_string_t*	text,
+	fts_word_t*		word)
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/** Add a copy of a word read from an FTS INDEX table to the word cache
+of the index, unless the cache was invalidated since the word was read.
+@param[in,out]	cache		fts cache
+@param[in,out]	cached_words	fts_index_cache_t::cached_words
+@param[in]	version		fts_word_cache_get_version() before
+				the word was read
+@param[in]	word		the word and all its rows */
+UNIV_INTERN
+void
+fts_word_cache_add(
+	fts_cache_t*		cache,
+	ib_rbt_t*		cached_words,
+	ib_uint64_t		version,
+	const fts_word_t*	word)
+	MY_ATTRIBUTE((nonnull));
 /******************************************************************//**
 Write the table id to the given buffer (including final NUL). Buffer must be
 at least FTS_AUX_MIN_TABLE_ID_LENGTH bytes long.
@@ -614,6 +653,18 @@ fts_optimize_do_table(
 	dict_table_t*	table)		/*!< in: table to optimize */
 	MY_ATTRIBUTE((nonnull));
 /******************************************************************//**
+Check whether the FTS indexes of a table are fragmented enough for the
+optimize thread to merge them in the background.
+@return true if a background merge is due */
+UNIV_INTERN
+bool
+fts_optimize_merge_needed(
+/*======================*/
+	dict_table_t*	table,		/*!< in: table with FTS indexes */
+	bool		runs_only)	/*!< in: whether to only check
+					the number of SYNC runs */
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/******************************************************************//**
 Construct the prefix name of an FTS table.
 @return own: table name, must be freed with mem_free() */
 UNIV_INTERN
@@ -36,6 +36,7 @@ Created 2007-03-27 Sunny Bains
 struct fts_que_t;
 struct fts_node_t;
 struct fts_utf8_str_t;
+struct fts_cached_word_t;
 
 /** Callbacks used within FTS. */
 typedef pars_user_func_cb_t fts_sql_callback;
@@ -77,6 +78,19 @@ struct fts_index_cache_t {
 
 	que_t**		sel_graph;	/*!< Select query graphs */
 	CHARSET_INFO*	charset;	/*!< charset */
+
+	ib_rbt_t*	cached_words;	/*!< Rows of the words that queries
+					read from the INDEX tables, cells
+					are fts_cached_word_t. Covered by
+					fts_cache_t::word_cache_lock */
+
+	ulint		n_sync_runs;	/*!< Number of SYNCs that appended
+					rows to the INDEX tables since the
+					last merge of the index completed.
+					Covered by fts_cache_t::lock */
+
+	ulint		merge_start_runs;/*!< n_sync_runs when the current
+					merge of the index started */
 };
 
 /** For supporting the tracking of updates on multiple FTS indexes we need
@@ -190,8 +204,31 @@ struct fts_cache_t {
 					optimized. This variable is covered by
 					the deleted lock */
 
+	ulint		merge_deleted;	/*!< Number of doc ids deleted since
+					the last merge of the table started,
+					not counting those in deleted. This
+					variable is covered by deleted_lock */
+
 	fts_stopword_t	stopword_info;	/*!< Cached stopwords for the FTS */
 	mem_heap_t*	cache_heap;	/*!< Cache Heap */
+
+	ib_mutex_t	word_cache_lock;/*!< Lock covering the cached_words
+					of the index caches and the word
+					cache fields below */
+
+	UT_LIST_BASE_NODE_T(fts_cached_word_t)
+			word_cache_lru;	/*!< The cached words of all the
+					FTS indexes, the most recently
+					used first */
+
+	ulint		word_cache_size;/*!< Memory used by the cached
+					words */
+
+	ib_uint64_t	word_cache_version;
+					/*!< Incremented whenever the
+					cached words are invalidated, a
+					query may only add the words it
+					read while this did not change */
 };
 
 /** Columns of the FTS auxiliary INDEX table */
@@ -234,6 +271,21 @@ struct fts_word_t {
 	ib_alloc_t*	heap_alloc;	/*!< For handling all allocations */
 };
 
+/** The rows of a word in an FTS INDEX table, kept in memory for the
+queries that search the word again. See fts_index_cache_t::cached_words */
+struct fts_cached_word_t {
+	fts_word_t	word;		/*!< The word and its rows. Must be
+					the first field, the words are
+					compared as fts_string_t */
+	ulint		size;		/*!< Memory used by the rows */
+
+	ib_rbt_t*	tree;		/*!< The cached_words tree of the
+					index cache that holds the word */
+
+	UT_LIST_NODE_T(fts_cached_word_t)
+			lru;		/*!< List of fts_cache_t */
+};
+
 /** Callback for reading and filtering nodes that are read from FTS index */
 struct fts_fetch_t {
 	void*		read_arg;	/*!< Arg for the sql_callback */
@@ -415,6 +415,30 @@ hash_get_lock(
 	hash_table_t*	table,	/*!< in: hash table */
 	ulint		fold);	/*!< in: fold */
 /************************************************************//**
+If not appropriate rw_lock for a fold value in a hash table,
+relock s-lock the another rw_lock until appropriate for a fold value.
+The number of cells of the table, and thus the lock covering a fold
+value, may change while the caller is waiting for the lock.
+@return	latched rw_lock */
+UNIV_INLINE
+rw_lock_t*
+hash_lock_s_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: s-latched rw_lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold value */
+/************************************************************//**
+If not appropriate rw_lock for a fold value in a hash table,
+relock x-lock the another rw_lock until appropriate for a fold value.
+@return	latched rw_lock */
+UNIV_INLINE
+rw_lock_t*
+hash_lock_x_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: x-latched rw_lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold value */
+/************************************************************//**
 Reserves the mutex for a fold value in a hash table. */
 UNIV_INTERN
 void
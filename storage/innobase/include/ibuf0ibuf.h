@@ -34,6 +34,10 @@ Created 7/19/1997 Heikki Tuuri
 
 #ifndef UNIV_HOTBACKUP
 # include "ibuf0types.h"
+# include "os0sync.h"
+# include "os0thread.h"
+
+# include <map>
 
 /** Default value for maximum on-disk size of change buffer in terms
 of percentage of the buffer pool. */
@@ -70,6 +74,44 @@ extern ibuf_use_t	ibuf_use;
 /** The insert buffer control structure */
 extern ibuf_t*		ibuf;
 
+/** Change buffer statistics of an index, counted since the startup */
+struct ibuf_stat_t {
+	/** Tablespace of the index */
+	ulint		space;
+	/** Number of buffered operations of each type that have not
+	been merged or discarded yet */
+	ulint		n_buffered[IBUF_OP_COUNT];
+	/** Number of pages of the index to which buffered operations
+	were merged */
+	ulint		n_merged_pages;
+	/** Number of those pages that were merged when they were read
+	for an access, and not by a background merge */
+	ulint		n_read_merges;
+	ibuf_stat_t() :
+		/* Initialize members to 0 so that when we do
+		stlmap[key].n_merged_pages++ and element with "key" does
+		not exist it gets inserted with zeroed members. */
+		space(ULINT_UNDEFINED),
+		n_merged_pages(0),
+		n_read_merges(0)
+	{
+		memset(n_buffered, 0, sizeof n_buffered);
+	}
+};
+
+/** Change buffer statistics types */
+typedef std::map<index_id_t, ibuf_stat_t>	ibuf_stat_per_index_t;
+
+/** Change buffer statistics, indexed by dict_index_t::id */
+extern ibuf_stat_per_index_t	ibuf_stat_per_index;
+/** Mutex protecting ibuf_stat_per_index */
+extern ib_mutex_t		ibuf_stat_per_index_mutex;
+
+/** Event to wake up the change buffer merge threads */
+extern os_event_t		ibuf_merge_event;
+/** Number of change buffer merge threads that are running */
+extern ulint			ibuf_merge_n_threads_active;
+
 /* The purpose of the insert buffer is to reduce random disk access.
 When we wish to insert a record into a non-unique secondary index and
 the B-tree leaf page where the record belongs to is not in the buffer
@@ -380,6 +422,17 @@ ibuf_merge_in_background(
 			batch is determined based on the
 			current size of the ibuf tree. */
 
+/******************************************************************//**
+Change buffer merge thread. Merges the batches that
+ibuf_merge_in_background() hands over to the merge threads.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(ibuf_merge_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /** Contracts insert buffer trees by reading pages referring to space_id
 to the buffer pool.
 @returns number of pages merged.*/
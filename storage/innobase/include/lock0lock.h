@@ -37,6 +37,8 @@ Created 5/7/1996 Heikki Tuuri
 #include "read0types.h"
 #include "hash0hash.h"
 #include "srv0srv.h"
+#include "srv0mon.h"
+#include "sync0rw.h"
 #include "ut0vec.h"
 
 #ifdef UNIV_DEBUG
@@ -907,10 +909,28 @@ struct lock_op_t{
 	enum lock_mode	mode;	/*!< lock mode */
 };
 
+/** Number of mutexes protecting the cells of lock_sys->rec_hash */
+#define LOCK_REC_N_SHARDS	64
+
 /** The lock system struct */
 struct lock_sys_t{
-	ib_mutex_t	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. It is held in exclusive
+						mode for table locks, lock
+						waits, deadlock detection and
+						any change of the record locks
+						that is not covered by the
+						shared mode below */
+	ib_mutex_t	rec_shard_mutexes[LOCK_REC_N_SHARDS];
+						/*!< Mutex i protects the
+						rec_hash cells whose index is
+						i modulo LOCK_REC_N_SHARDS.
+						A thread holding the latch in
+						shared mode and the shard mutex
+						of a page may look at the record
+						locks of the page and create or
+						extend record locks of its own
+						transaction that need no wait */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
 	ib_mutex_t	wait_mutex;		/*!< Mutex protecting the
@@ -943,20 +963,46 @@ struct lock_sys_t{
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
-#define lock_mutex_enter_nowait() mutex_enter_nowait(&lock_sys->mutex)
+/** Test if lock_sys->latch can be acquired in exclusive mode without
+waiting.
+@return 0 if the latch was acquired */
+#define lock_mutex_enter_nowait() (!rw_lock_x_lock_nowait(&lock_sys->latch))
 
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() mutex_own(&lock_sys->mutex)
+/** Test if lock_sys->latch is owned in exclusive mode. */
+#ifdef UNIV_SYNC_DEBUG
+# define lock_mutex_own() rw_lock_own(&lock_sys->latch, RW_LOCK_EX)
+#else
+# define lock_mutex_own()						\
+	(rw_lock_get_writer(&lock_sys->latch) == RW_LOCK_EX		\
+	 && os_thread_eq(lock_sys->latch.writer_thread,			\
+			 os_thread_get_curr_id()))
+#endif /* UNIV_SYNC_DEBUG */
 
-/** Acquire the lock_sys->mutex. */
-#define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+/** Acquire the lock_sys->latch in exclusive mode. */
+#define lock_mutex_enter() do {					\
+	if (!rw_lock_x_lock_nowait(&lock_sys->latch)) {		\
+		MONITOR_ATOMIC_INC(MONITOR_LOCK_SYS_LATCH_WAITS);	\
+		rw_lock_x_lock(&lock_sys->latch);		\
+	}							\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release the lock_sys->latch from exclusive mode. */
 #define lock_mutex_exit() do {			\
-	mutex_exit(&lock_sys->mutex);		\
+	rw_lock_x_unlock(&lock_sys->latch);	\
+} while (0)
+
+/** Acquire the lock_sys->latch in shared mode. */
+#define lock_sys_s_lock() do {					\
+	if (!rw_lock_s_lock_nowait(&lock_sys->latch,		\
+				   __FILE__, __LINE__)) {	\
+		MONITOR_ATOMIC_INC(MONITOR_LOCK_SYS_LATCH_WAITS);	\
+		rw_lock_s_lock(&lock_sys->latch);		\
+	}							\
+} while (0)
+
+/** Release the lock_sys->latch from shared mode. */
+#define lock_sys_s_unlock() do {		\
+	rw_lock_s_unlock(&lock_sys->latch);	\
 } while (0)
 
 /** Test if lock_sys->wait_mutex is owned. */
@@ -106,6 +106,18 @@ lock_cancel_waiting_and_release(
 /*============================*/
 	lock_t*	lock);	/*!< in/out: waiting lock request */
 
+/*********************************************************************//**
+Runs the deadlock check for a lock wait that was enqueued without one
+because deadlock detection was disabled for the transaction. If the
+transaction is chosen as the victim, its lock wait is cancelled and the
+suspended thread will return DB_DEADLOCK. Called by the lock wait timeout
+thread. */
+UNIV_INTERN
+void
+lock_deadlock_check_deferred(
+/*=========================*/
+	trx_t*	trx);	/*!< in/out: suspended transaction */
+
 /*********************************************************************//**
 Checks if some transaction has an implicit x-lock on a record in a clustered
 index.
@@ -129,6 +129,40 @@ log_write_low(
 	byte*	str,		/*!< in: string */
 	ulint	str_len);	/*!< in: string length */
 /************************************************************//**
+Reserves space for a string of the given length in the log buffer. The
+lsn is advanced and the log block headers are written as by log_write_low,
+but the string itself is not copied. It is assumed that the caller holds
+the log mutex. The string must then be copied with log_write_copy, possibly
+after releasing the log mutex, and the reservation ended with
+log_write_copy_complete.
+@return	offset of the reserved space in log_sys->buf */
+UNIV_INTERN
+ulint
+log_write_reserve_low(
+/*==================*/
+	ulint	str_len);	/*!< in: string length */
+/************************************************************//**
+Copies a string into the log buffer space reserved by
+log_write_reserve_low. The log mutex need not be held. A reservation may
+be filled by several consecutive calls.
+@return	offset in the log buffer following the copied string */
+UNIV_INTERN
+ulint
+log_write_copy(
+/*===========*/
+	byte*		buf,	/*!< in/out: log buffer at the time of
+				the reservation */
+	ulint		offset,	/*!< in: offset to copy to */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len);/*!< in: string length */
+/************************************************************//**
+Ends a reservation made by log_write_reserve_low after its string has
+been copied, so that the log buffer may be written up to it. */
+UNIV_INLINE
+void
+log_write_copy_complete(void);
+/*=========================*/
+/************************************************************//**
 Closes the log.
 @return	lsn */
 UNIV_INTERN
@@ -209,6 +243,42 @@ void
 log_buffer_flush_to_disk(void);
 /*==========================*/
 /****************************************************************//**
+Creates the log writer and log flusher threads. From then on,
+log_write_up_to() leaves the log writes and flushes to them and waits for
+its lsn to be written or flushed. */
+UNIV_INTERN
+void
+log_writer_threads_start(void);
+/*==========================*/
+/****************************************************************//**
+Stops the log writer and log flusher threads, if they were started, and
+waits for them to exit. Afterwards log_write_up_to() writes and flushes
+the log in the calling thread again. */
+UNIV_INTERN
+void
+log_writer_threads_stop(void);
+/*=========================*/
+/******************************************************************//**
+The log writer thread. It writes the log buffer to the log files whenever
+there is something to write.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+/******************************************************************//**
+The log flusher thread. It writes and flushes the log to disk when
+transactions wait for their commit to become durable.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(
+/*===============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+/****************************************************************//**
 This functions writes the log buffer to the log file and if 'flush'
 is set it forces a flush of the log file as well. This is meant to be
 called from background master thread only as it does not wait for
@@ -813,6 +883,12 @@ struct log_t{
 					groups */
 	volatile bool	is_extending;	/*!< this is set to true during extend
 					the log buffer size */
+	volatile ulint	n_pending_copies;/*!< number of log buffer
+					reservations whose string has not yet
+					been copied; new reservations need the
+					log mutex, thus a thread holding it can
+					wait for this to reach zero before it
+					writes or moves the log buffer */
 	lsn_t		write_lsn;	/*!< last written lsn */
 	lsn_t		current_flush_lsn;/*!< end lsn for the current running
 					write + flush operation */
@@ -830,6 +906,26 @@ struct log_t{
 					first FALSE and becomes TRUE
 					when one log group has been
 					written or flushed */
+	/* @} */
+
+	/** Fields involved in the log writer and log flusher threads @{ */
+	volatile bool	writer_threads_active;
+					/*!< TRUE while the log writer and
+					log flusher threads serve the
+					log_write_up_to() requests */
+	volatile ulint	n_writer_threads;/*!< number of log writer and
+					log flusher threads running */
+	os_event_t	writer_event;	/*!< set to wake up the log writer
+					thread */
+	os_event_t	flusher_event;	/*!< set to wake up the log flusher
+					thread */
+	os_event_t*	write_events;	/*!< LOG_N_WAIT_EVENTS events, the one
+					of the slot of an lsn is set when
+					write_lsn advances past it */
+	os_event_t*	flush_events;	/*!< LOG_N_WAIT_EVENTS events, the one
+					of the slot of an lsn is set when
+					flushed_to_disk_lsn advances past
+					it */
 	ulint		n_log_ios;	/*!< number of log i/os initiated thus
 					far */
 	ulint		n_log_ios_old;	/*!< number of log i/o's at the
@@ -444,6 +444,21 @@ struct recv_sys_t{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+	ulint		n_apply_threads;
+				/*!< number of threads applying the
+				running batch, the calling thread
+				included */
+	ulint		n_apply_threads_active;
+				/*!< number of recv_apply_thread
+				instances that have not yet finished
+				their share of the running batch */
+	ulint		apply_n_pages;
+				/*!< number of hashed file addresses
+				when the running batch started */
+	ulint		apply_progress;
+				/*!< progress in percent last printed
+				for the running batch, or
+				ULINT_UNDEFINED */
 
 	recv_dblwr_t	dblwr;
 };
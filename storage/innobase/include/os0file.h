@@ -188,6 +188,13 @@ enum os_file_create_t {
 				requests in a batch, and only after that
 				wake the i/o-handler thread; this has
 				effect only in simulated aio */
+#define OS_AIO_PAGE_COMPRESSION	2048 /*!< This can be ORed to mode
+				in the call of os_aio(...), if the
+				request is a full page of a single-table
+				tablespace: such pages are compressed on
+				write and decompressed on read when
+				innodb_transparent_page_compression is
+				used */
 /* @} */
 
 #define OS_WIN31	1	/*!< Microsoft Windows 3.x */
@@ -889,6 +896,19 @@ os_file_set_eof(
 /*============*/
 	FILE*		file);	/*!< in: file to be truncated */
 /***********************************************************************//**
+Truncates or extends a file to the given size. The contents of an
+extended part are undefined; use os_file_set_size() to write it.
+@return	TRUE if success */
+UNIV_INTERN
+ibool
+os_file_truncate(
+/*=============*/
+	const char*	name,	/*!< in: name of the file, used in
+				error messages */
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	size)	/*!< in: new file size */
+	MY_ATTRIBUTE((nonnull, warn_unused_result));
+/***********************************************************************//**
 NOTE! Use the corresponding macro os_file_flush(), not directly this function!
 Flushes the write buffers of a given file to the disk.
 @return	TRUE if success */
@@ -946,6 +966,20 @@ os_file_read_no_error_handling_func(
 	void*		buf,	/*!< in: buffer where to read */
 	os_offset_t	offset,	/*!< in: file offset where to read */
 	ulint		n);	/*!< in: number of bytes to read */
+#ifndef UNIV_HOTBACKUP
+/*******************************************************************//**
+Decompresses in place a page that was written by transparent page
+compression. Pages of any other type are left alone.
+@return	false if the page was compressed but could not be decompressed */
+UNIV_INTERN
+bool
+os_file_page_decompress(
+/*====================*/
+	byte*	page,	/*!< in/out: page of UNIV_PAGE_SIZE bytes
+			read from a data file */
+	byte*	tmp);	/*!< in: scratch buffer of UNIV_PAGE_SIZE
+			bytes, or NULL to allocate one */
+#endif /* !UNIV_HOTBACKUP */
 
 /*******************************************************************//**
 NOTE! Use the corresponding macro os_file_write(), not directly this
@@ -1298,10 +1332,15 @@ os_aio_linux_handle(
 				restart the operation. */
 	ulint*	type);		/*!< out: OS_FILE_WRITE or ..._READ */
 /*******************************************************************//**
-Submit buffered AIO requests on the given segment to the kernel. */
+Submit buffered AIO read requests to the kernel. */
 UNIV_INTERN
 void
 os_aio_linux_dispatch_read_array_submit();
+/*******************************************************************//**
+Submit buffered AIO write requests to the kernel. */
+UNIV_INTERN
+void
+os_aio_linux_dispatch_write_array_submit();
 #endif /* LINUX_NATIVE_AIO */
 
 #ifndef UNIV_NONINL
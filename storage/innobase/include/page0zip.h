@@ -46,6 +46,29 @@ extern uint	page_zip_level;
 /* Default compression level. */
 #define DEFAULT_COMPRESSION_LEVEL	6
 
+/** Alternatives for page_zip_strategy, which can be changed by setting
+innodb_compression_strategy. They select the zlib deflate() strategy;
+inflate() decompresses pages written with any of them. */
+enum page_zip_strategy_t {
+	PAGE_ZIP_STRATEGY_DEFAULT,	/*!< Z_DEFAULT_STRATEGY */
+	PAGE_ZIP_STRATEGY_FILTERED,	/*!< Z_FILTERED: favour Huffman
+					coding over short matches */
+	PAGE_ZIP_STRATEGY_HUFFMAN_ONLY,	/*!< Z_HUFFMAN_ONLY: no string
+					matching, fastest */
+	PAGE_ZIP_STRATEGY_RLE		/*!< Z_RLE: matches of distance
+					one only */
+};
+
+/* Compression strategy to be used by zlib. Settable by user. */
+extern ulong	page_zip_strategy;
+
+/** The level that is passed to page_zip_compress() and written to the
+redo log carries the compression strategy above the zlib compression
+level, so that recovery compresses pages the same way. The default
+strategy leaves the level unchanged. */
+#define PAGE_ZIP_LEVEL_MASK		15
+#define PAGE_ZIP_STRATEGY_SHIFT		4
+
 /* Whether or not to log compressed page images to avoid possible
 compression algorithm changes in zlib. */
 extern my_bool	page_zip_log_pages;
@@ -113,6 +136,22 @@ page_zip_set_alloc(
 	void*		stream,		/*!< in/out: zlib stream */
 	mem_heap_t*	heap);		/*!< in: memory heap to use */
 
+/**********************************************************************//**
+Get the compression level and strategy to compress pages with.
+@return page_zip_level, with page_zip_strategy above PAGE_ZIP_LEVEL_MASK */
+UNIV_INLINE
+ulint
+page_zip_level_get(void);
+/*====================*/
+/**********************************************************************//**
+Check a compression level that was read from the redo log.
+@return TRUE if the compression level and strategy are valid */
+UNIV_INLINE
+ibool
+page_zip_level_is_valid(
+/*====================*/
+	ulint	level);	/*!< in: compression level and strategy */
+
 /**********************************************************************//**
 Compress a page.
 @return TRUE on success, FALSE on failure; page_zip will be left
@@ -125,7 +164,8 @@ page_zip_compress(
 				m_start, m_end, m_nonempty */
 	const page_t*	page,	/*!< in: uncompressed page */
 	dict_index_t*	index,	/*!< in: index of the B-tree node */
-	ulint		level,	/*!< in: compression level */
+	ulint		level,	/*!< in: compression level and strategy,
+				see page_zip_level_get() */
 	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
 	MY_ATTRIBUTE((nonnull(1,2,3)));
 
@@ -480,7 +520,7 @@ UNIV_INLINE
 void
 page_zip_compress_write_log_no_data(
 /*================================*/
-	ulint		level,	/*!< in: compression level */
+	ulint		level,	/*!< in: compression level and strategy */
 	const page_t*	page,	/*!< in: page that is compressed */
 	dict_index_t*	index,	/*!< in: index */
 	mtr_t*		mtr);	/*!< in: mtr */
@@ -62,7 +62,9 @@ read_view_purge_open(
 	read_view_t*&	view);		/*!< in/out: pre-allocated view array or
 					NULL if a new one needs to be created */
 /*********************************************************************//**
-Remove a read view from the trx_sys->view_list. */
+Closes a read view. A normal view is kept in the trx_sys->view_list as
+cached if srv_read_view_cache is set, otherwise the view is removed from
+the list. */
 UNIV_INLINE
 void
 read_view_remove(
@@ -173,8 +175,9 @@ struct read_view_t{
 	trx_id_t	creator_trx_id;
 				/*!< trx id of creating transaction, or
 				0 used in purge */
-	bool		cached;	/*!< identify if read view of a finished
-				statement is cached in read view list. */
+	volatile ulint	state;	/*!< VIEW_STATE_OPEN, VIEW_STATE_CACHED
+				or VIEW_STATE_OPENING; only the owner
+				of the view changes it */
 	UT_LIST_NODE_T(read_view_t) view_list;
 				/*!< List of read views in trx_sys */
 };
@@ -191,6 +194,17 @@ struct read_view_t{
 					read view was created. */
 /* @} */
 
+/** Read view states @{ */
+#define VIEW_STATE_OPEN		1	/*!< The view is in use */
+#define VIEW_STATE_CACHED	2	/*!< The view was closed but stays in
+					trx_sys->view_list, so that its owner
+					can open it again without acquiring
+					trx_sys->mutex; purge ignores it */
+#define VIEW_STATE_OPENING	3	/*!< A cached view is being filled
+					without trx_sys->mutex; purge waits
+					until it is open again */
+/* @} */
+
 /** Implement InnoDB framework to support consistent read views in
 cursors. This struct holds both heap where consistent read view
 is allocated and pointer to a read view. */
@@ -117,6 +117,10 @@ struct row_merge_dup_t {
 					(index->table), or NULL if not
 					rebuilding table */
 	ulint			n_dup;	/*!< number of duplicates */
+	ulint*			reporter;/*!< in/out: NULL, or shared by
+					the indexes that are sorted in
+					parallel: the address of the index
+					whose duplicate was copied to table */
 };
 
 /*************************************************************//**
@@ -66,6 +66,13 @@ row_mysql_prebuilt_free_compress_heap(
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct of a
 					ha_innobase:: table handle */
 /*******************************************************************//**
+Frees the zlib streams that a session used for compressed columns. */
+UNIV_INTERN
+void
+row_mysql_column_zip_free(
+/*======================*/
+	trx_t*	trx);	/*!< in/out: transaction of the session */
+/*******************************************************************//**
 Uncompress blob/text/varchar column using zlib
 @return pointer to the uncompressed data */
 const byte*
@@ -687,6 +694,12 @@ struct mysql_row_templ_t {
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
+/* Maximum number of leaf pages that a range scan reads ahead of the
+page it is positioned on, see innodb_scan_read_ahead_depth */
+#define MYSQL_READ_AHEAD_MAX_DEPTH	256
+/* Maximum number of secondary index records whose clustered index pages
+a secondary index scan prefetches, see innodb_clustered_prefetch_rows */
+#define MYSQL_CLUST_PREFETCH_MAX_ROWS	256
 
 #define ROW_PREBUILT_ALLOCATED	78540783
 #define ROW_PREBUILT_FREED	26423527
@@ -876,6 +889,25 @@ struct row_prebuilt_t {
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
 					in fetch_cache */
+	ulint*		read_ahead_pages;/*!< NULL, or the leaf pages that
+					the last scan-driven read-ahead
+					found in key order, starting from
+					the page the cursor was on; see
+					row_sel_read_ahead() */
+	ulint		n_read_ahead_pages;/*!< number of pages in
+					read_ahead_pages */
+	bool		read_ahead_end;	/*!< whether read_ahead_pages
+					ends with the last leaf page */
+	mem_heap_t*	clust_prefetch_heap;/*!< NULL, or memory heap for
+					the clustered index references
+					collected by row_sel_prefetch_clust() */
+	const dtuple_t*	clust_prefetch_mid;/*!< NULL, or the secondary index
+					record, as a tuple, that the cursor
+					must reach before the clustered index
+					pages are prefetched again */
+	bool		clust_prefetch_end;/*!< whether the last prefetch
+					of clustered index pages reached the
+					end of the scanned range */
 	mem_heap_t*	blob_heap;	/*!< in SELECTS BLOB fields are copied
 					to this heap */
 	mem_heap_t*	compress_heap;  /*!< memory heap used to compress
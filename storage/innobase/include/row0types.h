@@ -49,6 +49,9 @@ struct row_ext_t;
 /** Buffer for logging modifications during online index creation */
 struct row_log_t;
 
+/** zlib streams that a session reuses for compressed columns */
+struct row_column_zip_t;
+
 /* MySQL data types */
 struct TABLE;
 
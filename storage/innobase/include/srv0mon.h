@@ -130,6 +130,10 @@ enum monitor_id_t {
 	MONITOR_MODULE_LOCK,
 	MONITOR_DEADLOCK,
 	MONITOR_TIMEOUT,
+	MONITOR_DEADLOCK_CHECKS,
+	MONITOR_DEADLOCK_CHECK_STEPS,
+	MONITOR_DEADLOCK_CHECK_TOO_DEEP,
+	MONITOR_DEADLOCK_CHECK_DEFERRED,
 	MONITOR_LOCKREC_WAIT,
 	MONITOR_TABLELOCK_WAIT,
 	MONITOR_NUM_RECLOCK_REQ,
@@ -144,6 +148,9 @@ enum monitor_id_t {
 	MONITOR_OVLD_LOCK_MAX_WAIT_TIME,
 	MONITOR_OVLD_ROW_LOCK_WAIT,
 	MONITOR_OVLD_LOCK_AVG_WAIT_TIME,
+	MONITOR_LOCK_SYS_LATCH_WAITS,
+	MONITOR_LOCK_REC_SHARD_WAITS,
+	MONITOR_RECLOCK_REQ_SHARED,
 
 	/* Buffer and I/O realted counters. */
 	MONITOR_MODULE_BUFFER,
@@ -176,6 +183,14 @@ enum monitor_id_t {
 	MONITOR_FLUSH_NEIGHBOR_COUNT,
 	MONITOR_FLUSH_NEIGHBOR_PAGES,
 	MONITOR_FLUSH_N_TO_FLUSH_REQUESTED,
+	MONITOR_FLUSH_ADAPTIVE_AVG_TIME_SLOT,
+	MONITOR_LRU_BATCH_FLUSH_AVG_TIME_SLOT,
+	MONITOR_FLUSH_ADAPTIVE_AVG_TIME_THREAD,
+	MONITOR_LRU_BATCH_FLUSH_AVG_TIME_THREAD,
+	MONITOR_FLUSH_AVG_TIME,
+	MONITOR_FLUSH_ADAPTIVE_AVG_PASS,
+	MONITOR_LRU_BATCH_FLUSH_AVG_PASS,
+	MONITOR_FLUSH_AVG_PASS,
 	MONITOR_FLUSH_AVG_PAGE_RATE,
 	MONITOR_FLUSH_LSN_AVG_RATE,
 	MONITOR_FLUSH_PCT_FOR_DIRTY,
@@ -128,6 +128,17 @@ struct srv_stats_t {
 
 	/** Number of buffered aio requests submitted */
 	ulint_ctr_64_t          n_aio_submitted;
+
+	/** Number of pages written compressed by transparent page
+	compression */
+	ulint_ctr_1_t		pages_page_compressed;
+
+	/** Number of pages decompressed after being read */
+	ulint_ctr_1_t		pages_page_decompressed;
+
+	/** Number of bytes that transparent page compression did not
+	have to write */
+	ulint_ctr_1_t		page_compression_saved;
 };
 
 extern const char*	srv_main_thread_op_info;
@@ -144,6 +155,9 @@ extern os_event_t	srv_error_event;
 /** The buffer pool dump/load thread waits on this event. */
 extern os_event_t	srv_buf_dump_event;
 
+/** The buffer pool resize thread waits on this event. */
+extern os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 #define SRV_BUF_DUMP_FILENAME_DEFAULT	"ib_buffer_pool"
 extern char*		srv_buf_dump_filename;
@@ -153,6 +167,17 @@ and/or load it during startup. */
 extern char		srv_buffer_pool_dump_at_shutdown;
 extern char		srv_buffer_pool_load_at_startup;
 
+/** Percentage of the hottest pages of each buffer pool instance that are
+written by a buffer pool dump */
+extern ulong		srv_buf_pool_dump_pct;
+
+/** Number of threads issuing reads during a buffer pool load */
+extern ulong		srv_buf_load_threads;
+
+/** Maximum number of pages per second read by a buffer pool load,
+0 means no limit */
+extern ulong		srv_buf_load_io_capacity;
+
 /* Whether to disable file system cache if it is defined */
 extern char		srv_disable_sort_file_cache;
 
@@ -215,6 +240,8 @@ extern ibool	srv_locks_unsafe_for_binlog;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads sorting and loading indexes in index creation */
+extern ulong	srv_sort_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -224,6 +251,11 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
 extern my_bool	srv_numa_interleave;
+
+/* If this flag is TRUE, then full pages of single-table tablespaces
+are compressed when they are written, and the unused tail of each page
+is released from the data file by punching a hole in it */
+extern my_bool	srv_transparent_page_compression;
 #ifdef __WIN__
 extern ibool	srv_use_native_conditions;
 #endif /* __WIN__ */
@@ -241,6 +273,21 @@ extern ulint	srv_undo_tablespaces_open;
 /* The number of undo segments to use */
 extern ulong	srv_undo_logs;
 
+/** Whether purge truncates undo tablespaces that grew larger than
+srv_max_undo_log_size */
+extern my_bool	srv_undo_log_truncate;
+
+/** Size in bytes above which an undo tablespace is truncated */
+extern unsigned long long	srv_max_undo_log_size;
+
+/** Every how many purge batches the purged history is removed from the
+rollback segments */
+extern ulong	srv_purge_rseg_truncate_frequency;
+
+/** Space id of the shared temporary tablespace, or ULINT_UNDEFINED
+if it has not been created */
+extern ulint	srv_tmp_space_id;
+
 extern ulint	srv_n_data_files;
 extern char**	srv_data_file_names;
 extern ulint*	srv_data_file_sizes;
@@ -262,6 +309,9 @@ extern ib_uint64_t	srv_log_file_size_requested;
 extern ulint	srv_log_buffer_size;
 extern ulong	srv_flush_log_at_trx_commit;
 extern uint	srv_flush_log_at_timeout;
+extern my_bool	srv_log_writer_threads;	/*!< if TRUE, the log is written
+					and flushed by dedicated log writer
+					and log flusher threads */
 extern char	srv_adaptive_flushing;
 extern char     srv_autoinc_persistent;
 extern ulong    srv_n_autoinc_interval;
@@ -281,14 +331,30 @@ extern ibool	srv_use_sys_malloc;
 #endif /* UNIV_HOTBACKUP */
 extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
+extern ulong	srv_buf_pool_chunk_unit;/*!< size of a buffer pool chunk,
+					the unit of online resizing */
 extern ulong	srv_n_page_hash_locks;	/*!< number of locks to
 					protect buf_pool->page_hash */
 extern ulong	srv_LRU_scan_depth;	/*!< Scan depth for LRU
 					flush batch */
 extern ulong	srv_flush_neighbors;	/*!< whether or not to flush
 					neighbors of a block */
+extern ulong	srv_n_page_cleaners;	/*!< number of page_cleaner
+					threads */
 extern ulint	srv_buf_pool_old_size;	/*!< previously requested size */
 extern ulint	srv_buf_pool_curr_size;	/*!< current size in bytes */
+extern uint	srv_change_buffer_max_size;
+					/*!< maximum size of the change
+					buffer, in percent of the buffer
+					pool */
+extern ulong	srv_change_buffer_merge_io_pct;
+					/*!< background change buffer
+					merge batch, in percent of
+					innodb_io_capacity */
+extern ulong	srv_n_change_buffer_merge_threads;
+					/*!< number of change buffer merge
+					threads, 0 if the master thread
+					merges */
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
 
@@ -338,6 +404,8 @@ extern ulong	srv_force_recovery;
 #ifndef DBUG_OFF
 extern ulong	srv_force_recovery_crash;
 #endif /* !DBUG_OFF */
+extern ulong	srv_n_recv_apply_threads;/*!< number of threads applying
+					redo log records during recovery */
 
 extern ulint	srv_fast_shutdown;	/*!< If this is 1, do not do a
 					purge and index buffer merge.
@@ -352,9 +420,14 @@ extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
+extern unsigned long long	srv_stats_persistent_max_pages;
+extern ulong			srv_stats_incremental_pct;
+extern ulong			srv_n_stats_auto_recalc_threads;
+extern my_bool			srv_stats_analyze_in_background;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+extern my_bool	srv_parallel_doublewrite;
 extern ulong	srv_checksum_algorithm;
 
 extern ulong	srv_max_buf_pool_modified_pct;
@@ -383,7 +456,10 @@ extern ibool	srv_error_monitor_active;
 /* TRUE during the lifetime of the buffer pool dump/load thread */
 extern ibool	srv_buf_dump_thread_active;
 
-/* TRUE during the lifetime of the stats thread */
+/* TRUE during the lifetime of the buffer pool resize thread */
+extern ibool	srv_buf_resize_thread_active;
+
+/* TRUE during the lifetime of the stats threads */
 extern ibool	srv_dict_stats_thread_active;
 
 extern ulong	srv_n_spin_wait_rounds;
@@ -469,6 +545,10 @@ extern srv_stats_t	srv_stats;
 # ifdef UNIV_PFS_THREAD
 /* Keys to register InnoDB threads with performance schema */
 extern mysql_pfs_key_t	buf_page_cleaner_thread_key;
+extern mysql_pfs_key_t	buf_page_cleaner_worker_thread_key;
+extern mysql_pfs_key_t	ibuf_merge_thread_key;
+extern mysql_pfs_key_t	log_writer_thread_key;
+extern mysql_pfs_key_t	log_flusher_thread_key;
 extern mysql_pfs_key_t	trx_rollback_clean_thread_key;
 extern mysql_pfs_key_t	io_handler_thread_key;
 extern mysql_pfs_key_t	srv_lock_timeout_thread_key;
@@ -477,6 +557,7 @@ extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 
 /* This macro register the current thread and its key with performance
 schema */
@@ -814,6 +895,8 @@ struct export_var_t{
 	ulint innodb_data_reads;		/*!< I/O read requests */
 	char  innodb_buffer_pool_dump_status[512];/*!< Buf pool dump status */
 	char  innodb_buffer_pool_load_status[512];/*!< Buf pool load status */
+	char  innodb_buffer_pool_resize_status[512];/*!< Buf pool resize
+						status */
 	ulint innodb_buffer_pool_pages_total;	/*!< Buffer pool size */
 	ulint innodb_buffer_pool_pages_data;	/*!< Data pages */
 	ulint innodb_buffer_pool_bytes_data;	/*!< File bytes used */
@@ -863,6 +946,9 @@ struct export_var_t{
 	ulint innodb_truncated_status_writes;	/*!< srv_truncated_status_writes */
 	ulint innodb_available_undo_logs;       /*!< srv_available_undo_logs */
 	ulint innodb_buffered_aio_submitted;
+	ulint innodb_pages_page_compressed;	/*!< srv_pages_page_compressed */
+	ulint innodb_pages_page_decompressed;	/*!< srv_pages_page_decompressed */
+	ulint innodb_page_compression_saved;	/*!< srv_page_compression_saved */
 	ulint innodb_read_views_memory;		/*!< srv_read_views_memory */
 	ulint innodb_descriptors_memory;	/*!< srv_descriptors_memory */
 
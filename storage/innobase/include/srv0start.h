@@ -118,6 +118,17 @@ srv_get_meta_data_filename(
 	ulint			max_len)	/*!< in: filename max length */
 	MY_ATTRIBUTE((nonnull));
 
+/********************************************************************
+Checks whether an UNDO tablespace was re-created at startup because its
+truncation was interrupted. The redo log records for such a tablespace
+must not be applied.
+@return true if the tablespace was re-created */
+UNIV_INTERN
+bool
+srv_is_undo_tablespace_truncated(
+/*=============================*/
+	ulint	space_id);	/*!< in: tablespace id */
+
 /** Log sequence number at shutdown */
 extern	lsn_t	srv_shutdown_lsn;
 /** Log sequence number immediately after startup */
@@ -161,6 +172,10 @@ SRV_SHUTDOWN_CLEANUP and then to SRV_SHUTDOWN_LAST_PHASE, and so on */
 extern	enum srv_shutdown_state	srv_shutdown_state;
 #endif /* !UNIV_HOTBACKUP */
 
+/** Default undo tablespace size in UNIV_PAGEs count (10MB). */
+static const ulint SRV_UNDO_TABLESPACE_SIZE_IN_PAGES =
+	((1024 * 1024) * 10) / UNIV_PAGE_SIZE_DEF;
+
 /** Log 'spaces' have id's >= this */
 #define SRV_LOG_SPACE_FIRST_ID		0xFFFFFFF0UL
 
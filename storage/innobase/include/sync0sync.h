@@ -74,13 +74,16 @@ extern mysql_pfs_key_t	fts_delete_mutex_key;
 extern mysql_pfs_key_t	fts_optimize_mutex_key;
 extern mysql_pfs_key_t	fts_doc_id_mutex_key;
 extern mysql_pfs_key_t	fts_pll_tokenize_mutex_key;
+extern mysql_pfs_key_t	fts_word_cache_mutex_key;
 extern mysql_pfs_key_t	hash_table_mutex_key;
 extern mysql_pfs_key_t	ibuf_bitmap_mutex_key;
 extern mysql_pfs_key_t	ibuf_mutex_key;
 extern mysql_pfs_key_t	ibuf_pessimistic_insert_mutex_key;
+extern mysql_pfs_key_t	ibuf_stat_per_index_mutex_key;
 extern mysql_pfs_key_t	log_sys_mutex_key;
 extern mysql_pfs_key_t	log_sys_w_mutex_key;
 extern mysql_pfs_key_t	log_flush_order_mutex_key;
+extern mysql_pfs_key_t	page_cleaner_mutex_key;
 # ifndef HAVE_ATOMIC_BUILTINS
 extern mysql_pfs_key_t	server_mutex_key;
 # endif /* !HAVE_ATOMIC_BUILTINS */
@@ -90,6 +93,7 @@ extern mysql_pfs_key_t	mem_hash_mutex_key;
 extern mysql_pfs_key_t	mem_pool_mutex_key;
 extern mysql_pfs_key_t	mutex_list_mutex_key;
 extern mysql_pfs_key_t	purge_sys_bh_mutex_key;
+extern mysql_pfs_key_t	purge_sys_table_stats_mutex_key;
 extern mysql_pfs_key_t	recv_sys_mutex_key;
 extern mysql_pfs_key_t	recv_writer_mutex_key;
 extern mysql_pfs_key_t	rseg_mutex_key;
@@ -107,11 +111,14 @@ extern mysql_pfs_key_t	srv_monitor_file_mutex_key;
 extern mysql_pfs_key_t	sync_thread_mutex_key;
 # endif /* UNIV_SYNC_DEBUG */
 extern mysql_pfs_key_t	buf_dblwr_mutex_key;
+extern mysql_pfs_key_t	buf_dblwr_seg_mutex_key;
 extern mysql_pfs_key_t	trx_undo_mutex_key;
 extern mysql_pfs_key_t	trx_mutex_key;
-extern mysql_pfs_key_t	lock_sys_mutex_key;
+extern mysql_pfs_key_t	lock_rec_shard_mutex_key;
 extern mysql_pfs_key_t	lock_sys_wait_mutex_key;
 extern mysql_pfs_key_t	trx_sys_mutex_key;
+extern mysql_pfs_key_t	trx_sys_serial_mutex_key;
+extern mysql_pfs_key_t	trx_sys_rw_shard_mutex_key;
 extern mysql_pfs_key_t	srv_sys_mutex_key;
 extern mysql_pfs_key_t	srv_sys_tasks_mutex_key;
 #ifndef HAVE_ATOMIC_BUILTINS
@@ -694,12 +701,19 @@ or row lock! */
 /*------------------------------------- MySQL query cache mutex */
 /*------------------------------------- MySQL binlog mutex */
 /*-------------------------------*/
+#define SYNC_TRX_SYS_SERIAL	301	/* trx_sys->serial_mutex; acquired
+					after rseg->mutex, before
+					trx_sys->mutex */
 #define SYNC_LOCK_WAIT_SYS	300
 #define SYNC_LOCK_SYS		299
 #define SYNC_TRX_SYS		298
 #define SYNC_TRX		297
+#define SYNC_LOCK_REC_SHARD	296	/* lock_sys->rec_shard_mutexes;
+					acquired after the trx->mutex of
+					the requesting transaction */
 #define SYNC_THREADS		295
 #define SYNC_REC_LOCK		294
+#define SYNC_TRX_SYS_RW_SHARD	293	/* trx_sys->rw_shards[].mutex */
 #define SYNC_TRX_SYS_HEADER	290
 #define	SYNC_PURGE_QUEUE	200
 #define SYNC_LOG		170
@@ -722,6 +736,9 @@ or row lock! */
 #define	SYNC_BUF_BLOCK		146	/* Block mutex */
 #define	SYNC_BUF_FLUSH_LIST	145	/* Buffer flush list mutex */
 #define SYNC_DOUBLEWRITE	140
+#define	SYNC_PAGE_CLEANER	137	/* page_cleaner_t::mutex; no
+					other latch is acquired while
+					holding it */
 #define	SYNC_ANY_LATCH		135
 #define	SYNC_MEM_HASH		131
 #define	SYNC_MEM_POOL		130
@@ -35,6 +35,8 @@ Created 3/26/1996 Heikki Tuuri
 #include "usr0sess.h"
 #include "fil0fil.h"
 
+#include <map>
+
 /** The global data structure coordinating a purge */
 extern trx_purge_t*	purge_sys;
 
@@ -62,6 +64,32 @@ trx_purge_sys_create(
 	ulint		n_purge_threads,/*!< in: number of purge threads */
 	ib_bh_t*	ib_bh);		/*!< in/own: UNDO log min binary heap*/
 /********************************************************************//**
+Creates the file which marks the truncation of an UNDO tablespace as
+in progress. If the file exists at startup, the tablespace is
+re-created and the redo log records for it are not applied.
+@return true if success */
+UNIV_INTERN
+bool
+trx_purge_undo_trunc_log_create(
+/*============================*/
+	ulint	space_id);	/*!< in: UNDO tablespace id */
+/********************************************************************//**
+Checks whether the truncation of an UNDO tablespace was in progress.
+@return true if the truncation log file of the tablespace exists */
+UNIV_INTERN
+bool
+trx_purge_undo_trunc_log_exists(
+/*============================*/
+	ulint	space_id);	/*!< in: UNDO tablespace id */
+/********************************************************************//**
+Deletes the file which marks the truncation of an UNDO tablespace as
+in progress. */
+UNIV_INTERN
+void
+trx_purge_undo_trunc_log_delete(
+/*============================*/
+	ulint	space_id);	/*!< in: UNDO tablespace id */
+/********************************************************************//**
 Frees the global purge system control structure. */
 UNIV_INTERN
 void
@@ -130,6 +158,35 @@ struct purge_iter_t {
 					whose undo number is less than this */
 };
 
+/** Purge statistics of a table, see trx_purge_t::table_stats */
+struct purge_table_stat_t {
+	/** Number of undo log records of the table handed to the
+	purge threads */
+	ib_uint64_t	n_recs;
+	/** Number of records of the table in batch batch_no */
+	ulint		n_batch_recs;
+	/** The last purge batch that had records of the table */
+	ib_uint64_t	batch_no;
+	/** Transaction number of the last record purged */
+	trx_id_t	last_trx_no;
+	/** Number of transaction ids and numbers assigned after
+	last_trx_no, at the time it was purged */
+	trx_id_t	lag;
+	purge_table_stat_t() :
+		/* Initialize members to 0 so that when we do
+		stlmap[key].n_recs++ and element with "key" does not
+		exist it gets inserted with zeroed members. */
+		n_recs(0),
+		n_batch_recs(0),
+		batch_no(0),
+		last_trx_no(0),
+		lag(0)
+	{ }
+};
+
+/** Purge statistics, indexed by dict_table_t::id */
+typedef std::map<table_id_t, purge_table_stat_t>	purge_table_stats_t;
+
 /** The control structure used in the purge operation */
 struct trx_purge_t{
 	sess_t*		sess;		/*!< System session running the purge
@@ -208,6 +265,23 @@ struct trx_purge_t{
 					rseg_queue_t::trx_no. It is protected
 					by the bh_mutex */
 	ib_mutex_t		bh_mutex;	/*!< Mutex protecting ib_bh */
+	/*-----------------------------*/
+	ib_uint64_t	n_batches;	/*!< Number of purge batches that
+					have been attached to the purge
+					threads */
+	purge_table_stats_t*
+			table_stats;	/*!< Per-table statistics of the
+					batches, for
+					INFORMATION_SCHEMA.INNODB_PURGE_TABLE_STATS */
+	ib_mutex_t	table_stats_mutex;/*!< Mutex protecting n_batches
+					and table_stats */
+	/*-----------------------------*/
+	ulint		undo_trunc_space;/*!< UNDO tablespace marked for
+					truncation, or ULINT_UNDEFINED; only
+					accessed by the purge coordinator */
+	ulint		undo_trunc_last;/*!< UNDO tablespace that was
+					marked last, for choosing the
+					tablespaces in round robin */
 };
 
 /** Info required to purge a record */
@@ -93,6 +93,19 @@ trx_rseg_get_on_id(
 /*===============*/
 	ulint	id);		/*!< in: rollback segment id */
 /****************************************************************//**
+Creates a rollback segment header without assigning it to a slot in the
+trx system header.
+@return	page number of the created segment, FIL_NULL if fail */
+UNIV_INTERN
+ulint
+trx_rseg_header_create_low(
+/*=======================*/
+	ulint	space,		/*!< in: space id */
+	ulint	zip_size,	/*!< in: compressed page size in bytes
+				or 0 for uncompressed pages */
+	ulint	max_size,	/*!< in: max size in pages */
+	mtr_t*	mtr);		/*!< in: mtr */
+/****************************************************************//**
 Creates a rollback segment header. This function is called only when
 a new rollback segment is created in the database.
 @return	page number of the created segment, FIL_NULL if fail */
@@ -106,6 +119,16 @@ trx_rseg_header_create(
 	ulint	max_size,	/*!< in: max size in pages */
 	ulint	rseg_slot_no,	/*!< in: rseg id == slot number in trx sys */
 	mtr_t*	mtr);		/*!< in: mtr */
+/****************************************************************//**
+Points the slot of a rollback segment in the trx system header to its
+header page, in a redo logged mini-transaction of its own. */
+UNIV_INTERN
+void
+trx_rseg_header_set_slot(
+/*=====================*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no,	/*!< in: page number of the header */
+	ulint	rseg_slot_no);	/*!< in: rseg id == slot number in trx sys */
 /*********************************************************************//**
 Creates the memory copies for rollback segments and initializes the
 rseg array in trx_sys at a database startup. */
@@ -124,6 +147,21 @@ trx_rseg_mem_free(
 /*==============*/
 	trx_rseg_t*	rseg);		/*!< in, own: instance to free */
 
+/***************************************************************************
+Re-creates the header of a rollback segment after its tablespace was
+truncated, and resets the memory object to an empty rollback segment.
+The rollback segment must not be in use and must be excluded from
+allocation to transactions. The slot of the rollback segment in the trx
+system header is not updated: mtr may not write redo log, and the caller
+must call trx_rseg_header_set_slot() after committing it. */
+UNIV_INTERN
+void
+trx_rseg_reinit(
+/*============*/
+	trx_rseg_t*	rseg,		/*!< in/out: rollback segment */
+	mtr_t*		mtr);		/*!< in/out: mtr holding an x-latch
+					on the tablespace */
+
 /*********************************************************************
 Creates a rollback segment. */
 UNIV_INTERN
@@ -189,6 +227,14 @@ struct trx_rseg_t{
 					yet purged log */
 	ibool		last_del_marks;	/*!< TRUE if the last not yet purged log
 					needs purging */
+	/*--------------------------------------------------------*/
+	ulint		trx_ref_count;	/*!< number of transactions that were
+					assigned this rollback segment and
+					have not committed yet */
+	bool		skip_allocation;/*!< TRUE if the tablespace of this
+					rollback segment is to be truncated:
+					it is not assigned to new
+					transactions */
 };
 
 /** For prioritising the rollback segments for purge. */
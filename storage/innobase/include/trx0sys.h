@@ -169,13 +169,30 @@ trx_sysf_rseg_set_page_no(
 					the slot is reset to unused */
 	mtr_t*		mtr);		/*!< in: mtr */
 /*****************************************************************//**
-Allocates a new transaction id.
+Checks if a trx id or trx number would be assigned again after a restart,
+unless it is written to the disk-based header first.
+@return true if trx_sys_flush_max_trx_id() must be called for id */
+UNIV_INLINE
+bool
+trx_sys_max_trx_id_needs_flush(
+/*===========================*/
+	trx_id_t	id);	/*!< in: assigned trx id or trx number */
+/*****************************************************************//**
+Allocates a new transaction id. The caller must own trx_sys->mutex.
 @return	new, allocated trx id */
 UNIV_INLINE
 trx_id_t
 trx_sys_get_new_trx_id(void);
 /*========================*/
 /*****************************************************************//**
+Allocates a new transaction number. The caller must own
+trx_sys->serial_mutex.
+@return	new, allocated trx number */
+UNIV_INLINE
+trx_id_t
+trx_sys_get_new_trx_no(void);
+/*========================*/
+/*****************************************************************//**
 Determines the maximum transaction id.
 @return maximum currently allocated trx id; will be stale after the
 next call to trx_sys_get_new_trx_id() */
@@ -184,6 +201,29 @@ trx_id_t
 trx_sys_get_max_trx_id(void);
 /*========================*/
 /*****************************************************************//**
+Returns the smallest trx number that a transaction which is active in a
+read view opened now has been or will be assigned. Read views must read
+it before the descriptors array.
+@return trx_sys->serial_min_no */
+UNIV_INLINE
+trx_id_t
+trx_sys_get_serial_min_no(void);
+/*===========================*/
+/*****************************************************************//**
+Marks the beginning of a change of the fields that read views copy
+without trx_sys->mutex: the trx ids assigned below max_trx_id and the
+descriptors array. */
+UNIV_INLINE
+void
+trx_sys_snapshot_change_start(void);
+/*===============================*/
+/*****************************************************************//**
+Marks the end of a change started with trx_sys_snapshot_change_start(). */
+UNIV_INLINE
+void
+trx_sys_snapshot_change_end(void);
+/*=============================*/
+/*****************************************************************//**
 Find a slot for a given trx ID in a descriptors array.
 @return slot pointer */
 UNIV_INLINE
@@ -220,6 +260,21 @@ trx_read_trx_id(
 /*============*/
 	const byte*	ptr);	/*!< in: pointer to memory from where to read */
 /****************************************************************//**
+Adds a transaction that has been assigned an id to its shard of
+trx_sys->rw_shards. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_add(
+/*===============*/
+	trx_t*		trx);	/*!< in: read-write transaction */
+/****************************************************************//**
+Removes a transaction from its shard of trx_sys->rw_shards. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_remove(
+/*==================*/
+	trx_t*		trx);	/*!< in: read-write transaction */
+/****************************************************************//**
 Looks for the trx instance with the given id in the rw trx_list.
 The caller must be holding trx_sys->mutex.
 @return	the trx handle or NULL if not found;
@@ -242,8 +297,8 @@ trx_rw_min_trx_id(void);
 /*===================*/
 /****************************************************************//**
 Returns pointer to a transaction instance if a rw transaction with the given id
-is active. Caller must hold trx_sys->mutex. If the caller is not holding
-lock_sys->mutex, the transaction may already have been committed.
+is active. If the caller is not holding lock_sys->mutex, the transaction may
+already have been committed.
 @return transaction instance if active, or NULL;
 the pointer must not be dereferenced unless lock_sys->mutex was
 acquired before calling this function and is still being held */
@@ -255,18 +310,6 @@ trx_rw_get_active_trx_by_id(
 	ibool*		corrupt);	/*!< in: NULL or pointer to a flag
 					that will be set if corrupt */
 /****************************************************************//**
-Checks if a rw transaction with the given id is active. Caller must hold
-trx_sys->mutex. If the caller is not holding lock_sys->mutex, the
-transaction may already have been committed.
-@return	true if a rw transaction with the given id is active. */
-UNIV_INLINE
-bool
-trx_rw_is_active_low(
-/*=================*/
-	trx_id_t	trx_id,		/*!< in: trx id of the transaction */
-	ibool*		corrupt);	/*!< in: NULL or pointer to a flag
-					that will be set if corrupt */
-/****************************************************************//**
 Checks if a rw transaction with the given id is active. If the caller is
 not holding lock_sys->mutex, the transaction may already have been
 committed.
@@ -609,7 +652,25 @@ identifier is added to this 64-bit constant. */
 
 #define TRX_DESCR_ARRAY_INITIAL_SIZE	1000
 
+/** Maximum number of descriptors arrays replaced by a bigger one. The size
+is doubled every time, this can never be exceeded. */
+#define TRX_DESCR_ARRAY_MAX_RETIRED	64
+
 #ifndef UNIV_HOTBACKUP
+/** Number of shards of the set of read-write transactions, see
+trx_sys_t::rw_shards */
+#define TRX_SYS_N_RW_SHARDS	64
+
+/** A shard of the set of read-write transactions */
+struct trx_rw_shard_t{
+	ib_mutex_t	mutex;		/*!< mutex protecting trx_list */
+	trx_list_t	trx_list;	/*!< Read-write transactions whose id
+					modulo TRX_SYS_N_RW_SHARDS is the index
+					of this shard, in no particular order */
+	char		pad[64];	/*!< Ensure shards do not share cache
+					line with each other */
+};
+
 /** The transaction system central memory data structure. */
 struct trx_sys_t{
 
@@ -628,19 +689,48 @@ struct trx_sys_t{
 					if such transactions exist. */
 	trx_id_t	max_trx_id;	/*!< The smallest number not yet
 					assigned as a transaction id or
-					transaction number */
+					transaction number. Incremented
+					atomically: ids are assigned under
+					the mutex and numbers under
+					serial_mutex. */
+	trx_id_t	max_trx_id_flushed;
+					/*!< The biggest value written to
+					TRX_SYS_TRX_ID_STORE; protected by the
+					mutex */
 	char		pad1[64];	/*!< Ensure max_trx_id does not share
 					cache line with other fields. */
-	trx_id_t*	descriptors;	/*!< Array of trx descriptors */
+	trx_id_t* volatile descriptors;	/*!< Array of trx descriptors */
 	ulint		descr_n_max;	/*!< The current size of the descriptors
 					array. */
+	trx_id_t*	descr_retired[TRX_DESCR_ARRAY_MAX_RETIRED];
+					/*!< Descriptors arrays replaced by a
+					bigger one; read views may still be
+					reading them without trx_sys->mutex,
+					they are freed in trx_sys_close() */
+	ulint		descr_n_retired;/*!< Number of used elements in
+					descr_retired */
 	char		pad2[64];	/*!< Ensure static descriptor fields
 					do not share cache line with
 					descr_n_used */
-	ulint		descr_n_used;	/*!< Number of used elements in the
+	volatile ulint	descr_n_used;	/*!< Number of used elements in the
 					descriptors array. */
 	char		pad3[64];	/*!< Ensure descriptors do not share
 					cache line with other fields */
+	volatile ulint	snapshot_version;
+					/*!< Incremented before and after
+					every assignment of a trx id and
+					change of the descriptors array, thus
+					odd while one is in progress. Read
+					views copy those fields without the
+					mutex and retry if the version was odd
+					or has changed meanwhile. */
+	volatile ulint	n_view_scans;	/*!< Number of threads looking for the
+					oldest read view on view_list; while
+					nonzero, cached views are not reopened
+					without the mutex */
+	char		pad_snapshot[64];/*!< Ensure the snapshot fields do
+					not share cache line with other
+					fields */
 #ifdef UNIV_DEBUG
 	trx_id_t	rw_max_trx_id;	/*!< Max trx id of read-write transactions
 					which exist or existed */
@@ -662,13 +752,29 @@ struct trx_sys_t{
 					started in InnoDB. */
 	char		pad6[64];	/*!< Ensure list base nodes do not
 					share cache line with other fields */
+	ib_mutex_t	serial_mutex;	/*!< mutex protecting the assignment of
+					trx numbers, trx_serial_list and
+					serial_min_no */
 	trx_list_t	trx_serial_list;
 					/*!< trx->no ordered list of
 					transactions in either TRX_PREPARED or
 					TRX_ACTIVE which have already been
-					assigned a serialization number */
+					assigned a serialization number. A
+					transaction is removed from it after
+					its descriptor has been released. */
+	volatile trx_id_t serial_min_no;/*!< trx->no of the first transaction
+					in trx_serial_list, or max_trx_id at
+					the time the list became empty: no
+					transaction that is active in a read
+					view opened after it has been read has
+					a smaller trx->no */
 	char		pad7[64];	/*!< Ensure list base nodes do not
 					share cache line with other fields */
+	trx_rw_shard_t	rw_shards[TRX_SYS_N_RW_SHARDS];
+					/*!< The transactions on rw_trx_list
+					hashed on their id, to look up an
+					active transaction by id without the
+					mutex */
 	trx_rseg_t*	const rseg_array[TRX_SYS_N_RSEGS];
 					/*!< Pointer array to rollback
 					segments; NULL if slot not in use;
@@ -681,8 +787,9 @@ struct trx_sys_t{
 					transactions), protected by
 					rseg->mutex */
 	UT_LIST_BASE_NODE_T(read_view_t) view_list;
-					/*!< List of read views sorted
-					on trx no, biggest first */
+					/*!< List of read views, including
+					the views cached for a reuse by their
+					transaction */
 };
 
 /** When a trx id which is zero modulo this number (which must be a power of
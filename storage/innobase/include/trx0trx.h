@@ -29,6 +29,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "univ.i"
 #include "trx0types.h"
 #include "dict0types.h"
+#include "row0types.h"
 #ifndef UNIV_HOTBACKUP
 #include "lock0types.h"
 #include "log0log.h"
@@ -641,6 +642,14 @@ struct trx_lock_t {
 					transaction as a victim in deadlock
 					resolution, it sets this to TRUE.
 					Protected by trx->mutex. */
+	ibool		deadlock_check_deferred;
+					/*!< TRUE if the current lock wait
+					was enqueued without a deadlock
+					check because trx->deadlock_detect
+					was FALSE; the lock wait timeout
+					thread will run the check once the
+					wait has lasted long enough.
+					Protected by lock_sys->mutex. */
 	time_t		wait_started;	/*!< lock wait started at this time,
 					protected only by lock_sys->mutex */
 
@@ -825,6 +834,24 @@ struct trx_t{
 					for secondary indexes when we decide
 					if we can use the insert buffer for
 					them, we set this FALSE */
+	ulint		deadlock_detect;/*!< normally TRUE, but for sessions
+					that queue on known hot rows
+					innodb_deadlock_detect can be set
+					to FALSE: lock waits are then not
+					checked for deadlocks when they are
+					enqueued, only later by the lock
+					wait timeout thread */
+	ulint		read_ahead_depth;/*!< innodb_scan_read_ahead_depth:
+					number of leaf pages that range
+					scans read ahead, or 0 */
+	ulint		clust_prefetch_rows;/*!< innodb_clustered_prefetch_rows:
+					number of secondary index records whose
+					clustered index pages secondary index
+					scans prefetch, or 0 */
+	row_column_zip_t*column_zip;	/*!< NULL, or the zlib streams that
+					the session reuses to compress and
+					decompress COLUMN_FORMAT COMPRESSED
+					columns, see row_compress_column() */
 	ulint		support_xa;	/*!< normally we do the XA two-phase
 					commit steps, but by setting this to
 					FALSE, one can save CPU time and about
@@ -931,6 +958,13 @@ struct trx_t{
 
 	ibool		in_rw_trx_list;	/*!< TRUE if in trx_sys->rw_trx_list */
 	/* @} */
+#endif /* UNIV_DEBUG */
+	UT_LIST_NODE_T(trx_t)
+			rw_shard_list;	/*!< list of transactions used for
+					trx_sys_t::rw_shards[]; protected by
+					the mutex of the shard */
+#ifdef UNIV_DEBUG
+	ibool		in_rw_shard;	/*!< TRUE if in trx_sys->rw_shards[] */
 #endif /* UNIV_DEBUG */
 	UT_LIST_NODE_T(trx_t)
 			mysql_trx_list;	/*!< list of transactions created for
@@ -385,11 +385,16 @@ static const ulint	lock_types = UT_ARR_SIZE(lock_compatibility_matrix);
 
 #ifdef UNIV_PFS_MUTEX
 /* Key to register mutex with performance schema */
-UNIV_INTERN mysql_pfs_key_t	lock_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	lock_rec_shard_mutex_key;
 /* Key to register mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	lock_sys_wait_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
+#ifdef UNIV_PFS_RWLOCK
+/* Key to register rwlock with performance schema */
+UNIV_INTERN mysql_pfs_key_t	lock_sys_latch_key;
+#endif /* UNIV_PFS_RWLOCK */
+
 #ifdef UNIV_DEBUG
 UNIV_INTERN ibool	lock_print_waits	= FALSE;
 
@@ -436,6 +441,18 @@ lock_deadlock_check_and_resolve(
 	const lock_t*	lock,	/*!< in: lock the transaction is requesting */
 	const trx_t*	trx);	/*!< in: transaction */
 
+/********************************************************************//**
+Checks a lock wait that the running transaction is enqueueing for
+deadlocks, or defers the check to the lock wait timeout thread if
+deadlock detection is disabled for the transaction.
+@return transaction chosen as victim or NULL */
+static
+const trx_t*
+lock_deadlock_check_enqueued(
+/*=========================*/
+	const lock_t*	lock,	/*!< in: lock the transaction is requesting */
+	trx_t*		trx);	/*!< in/out: transaction */
+
 /*********************************************************************//**
 Gets the nth bit of a record lock.
 @return	TRUE if bit set also if i == ULINT_UNDEFINED return FALSE*/
@@ -608,7 +625,13 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create(lock_sys_mutex_key, &lock_sys->mutex, SYNC_LOCK_SYS);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_REC_N_SHARDS; i++) {
+		mutex_create(lock_rec_shard_mutex_key,
+			     &lock_sys->rec_shard_mutexes[i],
+			     SYNC_LOCK_REC_SHARD);
+	}
 
 	mutex_create(lock_sys_wait_mutex_key,
 		     &lock_sys->wait_mutex, SYNC_LOCK_WAIT_SYS);
@@ -637,7 +660,11 @@ lock_sys_close(void)
 
 	hash_table_free(lock_sys->rec_hash);
 
-	mutex_free(&lock_sys->mutex);
+	rw_lock_free(&lock_sys->latch);
+
+	for (ulint i = 0; i < LOCK_REC_N_SHARDS; i++) {
+		mutex_free(&lock_sys->rec_shard_mutexes[i]);
+	}
 	mutex_free(&lock_sys->wait_mutex);
 
 	mem_free(lock_stack);
@@ -1148,6 +1175,51 @@ lock_rec_reset_nth_bit(
 	ut_ad(lock->trx->lock.n_rec_locks >= 0);
 }
 
+/*********************************************************************//**
+Gets the mutex of the lock_sys->rec_hash shard that holds the record locks
+of a page.
+@return	shard mutex */
+UNIV_INLINE
+ib_mutex_t*
+lock_rec_get_shard_mutex(
+/*=====================*/
+	ulint	hash)	/*!< in: lock_rec_hash() of the page */
+{
+	return(&lock_sys->rec_shard_mutexes[hash % LOCK_REC_N_SHARDS]);
+}
+
+/*********************************************************************//**
+Acquires the mutex of the lock_sys->rec_hash shard that holds the record
+locks of a page. The caller must hold lock_sys->latch in shared mode.
+@return	shard mutex */
+UNIV_INLINE
+ib_mutex_t*
+lock_rec_shard_enter(
+/*=================*/
+	ulint	hash)	/*!< in: lock_rec_hash() of the page */
+{
+	ib_mutex_t*	mutex = lock_rec_get_shard_mutex(hash);
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&lock_sys->latch, RW_LOCK_SHARED));
+#endif /* UNIV_SYNC_DEBUG */
+
+	if (mutex_enter_nowait(mutex)) {
+		MONITOR_ATOMIC_INC(MONITOR_LOCK_REC_SHARD_WAITS);
+		mutex_enter(mutex);
+	}
+
+	return(mutex);
+}
+
+#ifdef UNIV_DEBUG
+/** Test if the record locks of a page may be accessed: lock_sys->latch
+is held in exclusive mode, or the shard mutex of the page is held.
+@param hash	lock_rec_hash() of the page */
+# define lock_rec_page_own(hash)					\
+	(lock_mutex_own() || mutex_own(lock_rec_get_shard_mutex(hash)))
+#endif /* UNIV_DEBUG */
+
 /*********************************************************************//**
 Gets the first or next record lock on a page.
 @return	next lock, NULL if none exists */
@@ -1160,12 +1232,13 @@ lock_rec_get_next_on_page_const(
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
 
 	space = lock->un_member.rec_lock.space;
 	page_no = lock->un_member.rec_lock.page_no;
 
+	ut_ad(lock_rec_page_own(lock_rec_hash(space, page_no)));
+
 	for (;;) {
 		lock = static_cast<const lock_t*>(HASH_GET_NEXT(hash, lock));
 
@@ -1261,10 +1334,10 @@ lock_rec_get_first_on_page(
 	ulint	space	= buf_block_get_space(block);
 	ulint	page_no	= buf_block_get_page_no(block);
 
-	ut_ad(lock_mutex_own());
-
 	hash = buf_block_get_lock_hash_val(block);
 
+	ut_ad(lock_rec_page_own(hash));
+
 	for (lock = static_cast<lock_t*>(
 			HASH_GET_FIRST( lock_sys->rec_hash, hash));
 	     lock != NULL;
@@ -1290,8 +1363,6 @@ lock_rec_get_next(
 	ulint	heap_no,/*!< in: heap number of the record */
 	lock_t*	lock)	/*!< in: lock */
 {
-	ut_ad(lock_mutex_own());
-
 	do {
 		ut_ad(lock_get_type_low(lock) == LOCK_REC);
 		lock = lock_rec_get_next_on_page(lock);
@@ -1325,8 +1396,6 @@ lock_rec_get_first(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
-
 	for (lock = lock_rec_get_first_on_page(block); lock;
 	     lock = lock_rec_get_next_on_page(lock)) {
 		if (lock_rec_get_nth_bit(lock, heap_no)) {
@@ -1790,8 +1859,9 @@ lock_rec_create(
 	ulint		n_bytes;
 	const page_t*	page;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_page_own(buf_block_get_lock_hash_val(block)));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
+	ut_ad(lock_mutex_own() || caller_owns_trx_mutex);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
 #ifdef UNIV_DEBUG
@@ -1843,7 +1913,9 @@ lock_rec_create(
 	/* Set the bit corresponding to rec */
 	lock_rec_set_nth_bit(lock, heap_no);
 
-	index->table->n_rec_locks++;
+	/* Other transactions may be creating record locks on the table
+	under lock_sys->latch in shared mode. */
+	os_atomic_increment_ulint(&index->table->n_rec_locks, 1);
 
 	ut_ad(index->table->n_ref_count > 0 || !index->table->can_be_evicted);
 
@@ -1866,8 +1938,8 @@ lock_rec_create(
 		trx_mutex_exit(trx);
 	}
 
-	MONITOR_INC(MONITOR_RECLOCK_CREATED);
-	MONITOR_INC(MONITOR_NUM_RECLOCK);
+	MONITOR_ATOMIC_INC(MONITOR_RECLOCK_CREATED);
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK);
 
 	return(lock);
 }
@@ -1958,7 +2030,7 @@ lock_rec_enqueue_waiting(
 
 	trx_mutex_exit(trx);
 
-	victim_trx = lock_deadlock_check_and_resolve(lock, trx);
+	victim_trx = lock_deadlock_check_enqueued(lock, trx);
 
 	trx_mutex_enter(trx);
 
@@ -2120,7 +2192,9 @@ there are no explicit locks on the page, or there is just one lock, owned
 by this transaction, and of the right type_mode. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case of
-a page supremum record, a gap type lock.
+a page supremum record, a gap type lock. The caller must own the trx mutex
+and either lock_sys->latch in exclusive mode, or lock_sys->latch in shared
+mode and the shard mutex of the page.
 @return whether the locking succeeded */
 UNIV_INLINE
 enum lock_rec_req_status
@@ -2143,7 +2217,8 @@ lock_rec_lock_fast(
 	trx_t*			trx;
 	enum lock_rec_req_status status = LOCK_REC_SUCCESS;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_page_own(buf_block_get_lock_hash_val(block)));
+	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2163,15 +2238,13 @@ lock_rec_lock_fast(
 
 	if (lock == NULL) {
 		if (!impl) {
-			/* Note that we don't own the trx mutex. */
+			/* Note that we own the trx mutex. */
 			lock = lock_rec_create(
-				mode, block, heap_no, index, trx, FALSE);
+				mode, block, heap_no, index, trx, TRUE);
 
 		}
 		status = LOCK_REC_SUCCESS_CREATED;
 	} else {
-		trx_mutex_enter(trx);
-
 		if (lock_rec_get_next_on_page(lock)
 		     || lock->trx != trx
 		     || lock->type_mode != (mode | LOCK_REC)
@@ -2187,8 +2260,6 @@ lock_rec_lock_fast(
 				status = LOCK_REC_SUCCESS_CREATED;
 			}
 		}
-
-		trx_mutex_exit(trx);
 	}
 
 	return(status);
@@ -2275,7 +2346,8 @@ Tries to lock the specified record in the mode requested. If not immediately
 possible, enqueues a waiting lock request. This is a low-level function
 which does NOT look at implicit locks! Checks lock compatibility within
 explicit locks. This function sets a normal next-key lock, or in the case
-of a page supremum record, a gap type lock.
+of a page supremum record, a gap type lock. The common cases are handled
+with lock_sys->latch in shared mode, the caller must not hold the latch.
 @return	DB_SUCCESS, DB_SUCCESS_LOCKED_REC, DB_LOCK_WAIT, DB_DEADLOCK,
 or DB_QUE_THR_SUSPENDED */
 static
@@ -2295,11 +2367,16 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	trx_t*			trx = thr_get_trx(thr);
+	ib_mutex_t*		shard_mutex;
+	enum lock_rec_req_status status;
+	dberr_t			err;
+
+	ut_ad(!lock_mutex_own());
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
+	      || lock_table_has(trx, index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
+	      || lock_table_has(trx, index->table, LOCK_IX));
 	ut_ad((LOCK_MODE_MASK & mode) == LOCK_S
 	      || (LOCK_MODE_MASK & mode) == LOCK_X);
 	ut_ad(mode - (LOCK_MODE_MASK & mode) == LOCK_GAP
@@ -2308,19 +2385,41 @@ lock_rec_lock(
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
 	/* We try a simplified and faster subroutine for the most
-	common cases */
-	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	common cases. It only looks at the locks on this page and only
+	touches locks of this transaction, so that transactions locking
+	records on pages of different shards do not block each other. */
+	lock_sys_s_lock();
+	trx_mutex_enter(trx);
+	shard_mutex = lock_rec_shard_enter(buf_block_get_lock_hash_val(block));
+
+	status = lock_rec_lock_fast(impl, mode, block, heap_no, index, thr);
+
+	mutex_exit(shard_mutex);
+	trx_mutex_exit(trx);
+	lock_sys_s_unlock();
+
+	switch (status) {
 	case LOCK_REC_SUCCESS:
+		MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REQ_SHARED);
 		return(DB_SUCCESS);
 	case LOCK_REC_SUCCESS_CREATED:
+		MONITOR_ATOMIC_INC(MONITOR_RECLOCK_REQ_SHARED);
 		return(DB_SUCCESS_LOCKED_REC);
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+		break;
 	}
 
-	ut_error;
-	return(DB_ERROR);
+	/* The page has locks of other transactions or of other modes:
+	the queue must be checked and possibly waited for, which needs
+	the exclusive latch. The queue may have changed meanwhile,
+	lock_rec_lock_slow() looks at it from scratch. */
+	lock_mutex_enter();
+
+	err = lock_rec_lock_slow(impl, mode, block, heap_no, index, thr);
+
+	lock_mutex_exit();
+
+	return(err);
 }
 
 /*********************************************************************//**
@@ -4007,6 +4106,9 @@ lock_deadlock_check_and_resolve(
 
 		victim_trx = lock_deadlock_search(&ctx);
 
+		MONITOR_INC(MONITOR_DEADLOCK_CHECKS);
+		MONITOR_INC_VALUE(MONITOR_DEADLOCK_CHECK_STEPS, ctx.cost);
+
 		/* Search too deep, we rollback the joining transaction. */
 		if (ctx.too_deep) {
 
@@ -4017,6 +4119,7 @@ lock_deadlock_check_and_resolve(
 				lock_deadlock_joining_trx_print(trx, lock);
 			}
 
+			MONITOR_INC(MONITOR_DEADLOCK_CHECK_TOO_DEEP);
 			MONITOR_INC(MONITOR_DEADLOCK);
 
 		} else if (victim_trx != 0 && victim_trx != trx) {
@@ -4043,6 +4146,82 @@ lock_deadlock_check_and_resolve(
 	return(victim_trx);
 }
 
+/********************************************************************//**
+Checks a lock wait that the running transaction is enqueueing for
+deadlocks, or defers the check to the lock wait timeout thread if
+deadlock detection is disabled for the transaction. Skipping the search
+keeps sessions that queue on a hot row from walking the whole waits-for
+graph under lock_sys->mutex on every new wait.
+@return transaction chosen as victim or NULL */
+static
+const trx_t*
+lock_deadlock_check_enqueued(
+/*=========================*/
+	const lock_t*	lock,	/*!< in: lock the transaction is requesting */
+	trx_t*		trx)	/*!< in/out: transaction */
+{
+	ut_ad(lock_mutex_own());
+	ut_ad(lock_get_wait(lock));
+
+	if (trx->deadlock_detect) {
+		trx->lock.deadlock_check_deferred = FALSE;
+
+		return(lock_deadlock_check_and_resolve(lock, trx));
+	}
+
+	trx->lock.deadlock_check_deferred = TRUE;
+
+	MONITOR_INC(MONITOR_DEADLOCK_CHECK_DEFERRED);
+
+	return(NULL);
+}
+
+/*********************************************************************//**
+Runs the deadlock check for a lock wait that was enqueued without one
+because deadlock detection was disabled for the transaction. If the
+transaction is chosen as the victim, its lock wait is cancelled and the
+suspended thread will return DB_DEADLOCK. Called by the lock wait timeout
+thread. */
+UNIV_INTERN
+void
+lock_deadlock_check_deferred(
+/*=========================*/
+	trx_t*	trx)	/*!< in/out: suspended transaction */
+{
+	lock_mutex_enter();
+
+	if (trx->lock.deadlock_check_deferred
+	    && trx->lock.wait_lock != NULL) {
+
+		const trx_t*	victim_trx;
+
+		ut_a(trx->lock.que_state == TRX_QUE_LOCK_WAIT);
+
+		trx->lock.deadlock_check_deferred = FALSE;
+
+		victim_trx = lock_deadlock_check_and_resolve(
+			trx->lock.wait_lock, trx);
+
+		if (victim_trx != NULL) {
+			ut_a(victim_trx == trx);
+
+			/* Unlike a joining transaction, the victim is
+			already suspended: wake it up as if another
+			transaction had chosen it. */
+
+			trx_mutex_enter(trx);
+
+			trx->lock.was_chosen_as_deadlock_victim = TRUE;
+
+			lock_cancel_waiting_and_release(trx->lock.wait_lock);
+
+			trx_mutex_exit(trx);
+		}
+	}
+
+	lock_mutex_exit();
+}
+
 /*========================= TABLE LOCKS ==============================*/
 
 /*********************************************************************//**
@@ -4314,7 +4493,7 @@ lock_table_enqueue_waiting(
 
 	trx_mutex_exit(trx);
 
-	victim_trx = lock_deadlock_check_and_resolve(lock, trx);
+	victim_trx = lock_deadlock_check_enqueued(lock, trx);
 
 	trx_mutex_enter(trx);
 
@@ -5973,6 +6152,7 @@ lock_rec_insert_check_and_lock(
 	dberr_t		err;
 	ulint		next_rec_heap_no;
 	ibool		inherit_in = *inherit;
+	ib_mutex_t*	shard_mutex;
 
 	ut_ad(block->frame == page_align(rec));
 	ut_ad(!dict_index_is_online_ddl(index)
@@ -5988,7 +6168,6 @@ lock_rec_insert_check_and_lock(
 	next_rec = page_rec_get_next_const(rec);
 	next_rec_heap_no = page_rec_get_heap_no(next_rec);
 
-	lock_mutex_enter();
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -5998,13 +6177,30 @@ lock_rec_insert_check_and_lock(
 	BTR_NO_LOCKING_FLAG and skip the locking altogether. */
 	ut_ad(lock_table_has(trx, index->table, LOCK_IX));
 
+	/* In the simplest case there are no locks on the successor,
+	which can be checked with lock_sys->latch in shared mode. */
+	lock_sys_s_lock();
+	shard_mutex = lock_rec_shard_enter(buf_block_get_lock_hash_val(block));
+
 	lock = lock_rec_get_first(block, next_rec_heap_no);
 
+	mutex_exit(shard_mutex);
+	lock_sys_s_unlock();
+
+	if (lock != NULL) {
+		lock_mutex_enter();
+
+		/* The locks may have been released meanwhile. */
+		lock = lock_rec_get_first(block, next_rec_heap_no);
+
+		if (lock == NULL) {
+			lock_mutex_exit();
+		}
+	}
+
 	if (UNIV_LIKELY(lock == NULL)) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
-
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
 			page_update_max_trx_id(block,
@@ -6129,11 +6325,10 @@ lock_rec_convert_impl_to_expl(
 		lock_mutex_enter();
 
 		/* If the transaction is still active and has no
-		explicit x-lock set on the record, set one for it */
+		explicit x-lock set on the record, set one for it. The
+		lookup only latches a shard of the active transaction set. */
 
-		mutex_enter(&trx_sys->mutex);
 		impl_trx = trx_rw_get_active_trx_by_id(trx_id, NULL);
-		mutex_exit(&trx_sys->mutex);
 
 		/* impl_trx cannot be committed until lock_mutex_exit()
 		because lock_trx_release_locks() acquires lock_sys->mutex */
@@ -6195,16 +6390,12 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6255,16 +6446,12 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
-
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 #ifdef UNIV_DEBUG
 	{
@@ -6354,8 +6541,6 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6364,9 +6549,7 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6426,8 +6609,6 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
-
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 	ut_ad(mode != LOCK_S
@@ -6436,9 +6617,7 @@ lock_clust_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
-
-	lock_mutex_exit();
+	MONITOR_ATOMIC_INC(MONITOR_NUM_RECLOCK_REQ);
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -33,6 +33,12 @@ Created 25/5/2010 Sunny Bains
 #include "ha_prototypes.h"
 #include "lock0priv.h"
 
+/** A lock wait that was enqueued without a deadlock check is searched
+for deadlocks by the lock wait timeout thread once it has lasted this
+many seconds. Most waits on a hot row are granted sooner than that and
+are never searched. */
+#define LOCK_WAIT_DEADLOCK_CHECK_DELAY	1
+
 /*********************************************************************//**
 Print the contents of the lock_sys_t::waiting_threads array. */
 static
@@ -420,7 +426,8 @@ lock_wait_release_thread_if_suspended(
 
 /*********************************************************************//**
 Check if the thread lock wait has timed out. Release its locks if the
-wait has actually timed out. */
+wait has actually timed out. Otherwise run the deadlock check if it was
+skipped when the wait was enqueued. */
 static
 void
 lock_wait_check_and_cancel(
@@ -468,8 +475,15 @@ lock_wait_check_and_cancel(
 		lock_mutex_exit();
 
 		trx_mutex_exit(trx);
-	}
 
+	} else if (trx->lock.deadlock_check_deferred
+		   && wait_time >= LOCK_WAIT_DEADLOCK_CHECK_DELAY) {
+
+		/* The flag is read without the lock mutex; it is
+		checked again under it. */
+
+		lock_deadlock_check_deferred(trx);
+	}
 }
 
 /*********************************************************************//**
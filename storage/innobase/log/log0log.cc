@@ -93,6 +93,11 @@ UNIV_INTERN mysql_pfs_key_t	log_sys_w_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	log_flush_order_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	log_writer_thread_key;
+UNIV_INTERN mysql_pfs_key_t	log_flusher_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 #ifdef UNIV_DEBUG
 UNIV_INTERN ibool	log_do_write = TRUE;
 #endif /* UNIV_DEBUG */
@@ -133,6 +138,11 @@ should be bigger than LOG_POOL_PREFLUSH_RATIO_SYNC */
 the previous */
 #define LOG_POOL_PREFLUSH_RATIO_ASYNC	8
 
+/* Number of events that threads waiting in log_write_up_to() for their
+lsn to be written or flushed by the log writer and log flusher threads are
+spread over; an lsn waits on the slot of its log block */
+#define LOG_N_WAIT_EVENTS		512
+
 /* Extra margin, in addition to one log file, used in archiving */
 #define LOG_ARCHIVE_EXTRA_MARGIN	(4 * UNIV_PAGE_SIZE)
 
@@ -185,6 +195,28 @@ log_buf_pool_get_oldest_modification(void)
 	return(lsn);
 }
 
+/************************************************************//**
+Waits until the string of every log buffer reservation has been copied.
+The caller must hold the log mutex, so that no new space can be reserved
+meanwhile; the copies themselves do not need it. */
+static
+void
+log_wait_for_pending_copies(void)
+/*=============================*/
+{
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	for (ulint i = 0; log_sys->n_pending_copies > 0; i++) {
+		if (i < srv_n_spin_wait_rounds) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		} else {
+			os_thread_yield();
+		}
+	}
+
+	os_rmb;
+}
+
 /** Extends the log buffer.
 @param[in] len	requested minimum size in bytes */
 static
@@ -228,6 +260,9 @@ log_buffer_extend(
 		log_mutex_enter_all();;
 	}
 
+	/* The last block is moved to the new buffer below */
+	log_wait_for_pending_copies();
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -372,21 +407,28 @@ loop:
 }
 
 /************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
+Reserves space for a string of the given length in the log buffer. The
+lsn is advanced and the log block headers are written as by log_write_low,
+but the string itself is not copied. It is assumed that the caller holds
+the log mutex. The string must then be copied with log_write_copy, possibly
+after releasing the log mutex, and the reservation ended with
+log_write_copy_complete.
+@return	offset of the reserved space in log_sys->buf */
 UNIV_INTERN
-void
-log_write_low(
-/*==========*/
-	byte*	str,		/*!< in: string */
+ulint
+log_write_reserve_low(
+/*==================*/
 	ulint	str_len)	/*!< in: string length */
 {
 	log_t*	log	= log_sys;
+	ulint	start	= log->buf_free;
 	ulint	len;
 	ulint	data_len;
 	byte*	log_block;
 
 	ut_ad(mutex_own(&(log->mutex)));
+
+	os_atomic_increment_ulint(&log->n_pending_copies, 1);
 part_loop:
 	ut_ad(!recv_no_log_write);
 	/* Calculate a part length */
@@ -406,10 +448,7 @@ part_loop:
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
-
 	str_len -= len;
-	str = str + len;
 
 	log_block = static_cast<byte*>(
 		ut_align_down(
@@ -441,6 +480,74 @@ part_loop:
 	}
 
 	srv_stats.log_write_requests.inc();
+
+	return(start);
+}
+
+/************************************************************//**
+Copies a string into the log buffer space reserved by
+log_write_reserve_low. The log mutex need not be held. A reservation may
+be filled by several consecutive calls.
+@return	offset in the log buffer following the copied string */
+UNIV_INTERN
+ulint
+log_write_copy(
+/*===========*/
+	byte*		buf,	/*!< in/out: log buffer at the time of
+				the reservation */
+	ulint		offset,	/*!< in: offset to copy to */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len)/*!< in: string length */
+{
+	while (str_len > 0) {
+		ulint	len;
+
+		/* The reservation skipped the trailer of every block
+		it filled up and the header of the block following it,
+		the copy must skip them the same way. */
+		ut_ad(offset % OS_FILE_LOG_BLOCK_SIZE >= LOG_BLOCK_HDR_SIZE);
+		ut_ad(offset % OS_FILE_LOG_BLOCK_SIZE
+		      < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE);
+
+		len = ut_min(str_len,
+			     OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			     - offset % OS_FILE_LOG_BLOCK_SIZE);
+
+		ut_memcpy(buf + offset, str, len);
+
+		str += len;
+		str_len -= len;
+		offset += len;
+
+		if (offset % OS_FILE_LOG_BLOCK_SIZE
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+
+			offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+
+	return(offset);
+}
+
+/************************************************************//**
+Writes to the log the string given. It is assumed that the caller holds the
+log mutex. */
+UNIV_INTERN
+void
+log_write_low(
+/*==========*/
+	byte*	str,		/*!< in: string */
+	ulint	str_len)	/*!< in: string length */
+{
+	ulint	offset;
+
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	offset = log_write_reserve_low(str_len);
+
+	log_write_copy(log_sys->buf, offset, str, str_len);
+
+	log_write_copy_complete();
 }
 
 /************************************************************//**
@@ -884,6 +991,7 @@ log_init(void)
 
 	log_sys->buf_size = LOG_BUFFER_SIZE;
 	log_sys->is_extending = false;
+	log_sys->n_pending_copies = 0;
 
 	log_sys->max_buf_free = log_sys->buf_size / LOG_BUF_FLUSH_RATIO
 		- LOG_BUF_FLUSH_MARGIN;
@@ -906,6 +1014,11 @@ log_init(void)
 	log_sys->flush_event = os_event_create();
 	os_event_set(log_sys->flush_event);
 
+	log_sys->writer_threads_active = false;
+	log_sys->n_writer_threads = 0;
+	log_sys->write_events = NULL;
+	log_sys->flush_events = NULL;
+
 	/*----------------------------*/
 
 	log_sys->next_checkpoint_no = 0;
@@ -1298,14 +1411,45 @@ loop:
 }
 
 /******************************************************//**
-This function is called, e.g., when a transaction wants to commit. It checks
-that the log has been written to the log file up to the last log entry written
-by the transaction. If there is a flush running, it waits and checks if the
-flush flushed enough. If not, starts a new flush. */
-UNIV_INTERN
+Sets the events of the slots of the lsn range (old_lsn, new_lsn], which has
+just been written or flushed, to wake up the threads waiting for it. */
+static
 void
-log_write_up_to(
-/*============*/
+log_notify_waiters(
+/*===============*/
+	os_event_t*	events,		/*!< in: log_sys->write_events or
+					log_sys->flush_events */
+	lsn_t		old_lsn,	/*!< in: lsn before the write or
+					flush */
+	lsn_t		new_lsn)	/*!< in: lsn after the write or
+					flush */
+{
+	if (events == NULL || new_lsn <= old_lsn) {
+		return;
+	}
+
+	lsn_t	first = old_lsn / OS_FILE_LOG_BLOCK_SIZE;
+	lsn_t	last = new_lsn / OS_FILE_LOG_BLOCK_SIZE;
+
+	if (last - first >= LOG_N_WAIT_EVENTS) {
+		first = 0;
+		last = LOG_N_WAIT_EVENTS - 1;
+	}
+
+	for (lsn_t block = first; block <= last; ++block) {
+		os_event_set(events[block % LOG_N_WAIT_EVENTS]);
+	}
+}
+
+/******************************************************//**
+Writes the log buffer to the log files up to at least the given lsn in the
+calling thread, and flushes the log files to disk if requested. If there is
+a flush running, it waits and checks if the flush flushed enough. If not,
+starts a new flush. */
+static
+void
+log_write_up_to_low(
+/*================*/
 	lsn_t	lsn,	/*!< in: log sequence number up to which
 			the log should be written,
 			LSN_MAX if not specified */
@@ -1314,6 +1458,7 @@ log_write_up_to(
 			also to be flushed to disk */
 {
 	log_group_t*	group = UT_LIST_GET_FIRST(log_sys->log_groups);
+	lsn_t		old_lsn;
 	ulint		start_offset;
 	ulint		end_offset;
 	ulint		area_start;
@@ -1392,6 +1537,11 @@ loop:
 
 	mutex_enter(&(log_sys->mutex));
 
+	/* Mini-transactions copy their log records into the log
+	buffer after releasing the log mutex. The buffer may only be
+	written once all the space reserved in it has been filled. */
+	log_wait_for_pending_copies();
+
 	if (!flush_to_disk
 	    && log_sys->buf_free == log_sys->buf_next_to_write) {
 		/* Nothing to write and no flush to disk requested */
@@ -1464,15 +1614,21 @@ loop:
 			    start_offset - area_start);
 
 	log_group_set_fields(group, log_sys->write_lsn);
+	old_lsn = log_sys->write_lsn;
 	log_sys->write_lsn = write_lsn;
 
+	log_notify_waiters(log_sys->write_events, old_lsn, write_lsn);
+
 flush_op:
 	if (srv_unix_file_flush_method == SRV_UNIX_O_DSYNC) {
 		/* O_DSYNC means the OS did not buffer the log file at all:
 		so we have also flushed to disk what we have written */
 
+		old_lsn = log_sys->flushed_to_disk_lsn;
 		log_sys->flushed_to_disk_lsn = log_sys->write_lsn;
 
+		log_notify_waiters(log_sys->flush_events, old_lsn,
+				   log_sys->flushed_to_disk_lsn);
 	}
 
 	mutex_exit(&(log_sys->w_mutex));
@@ -1486,7 +1642,11 @@ flush_op:
 
 	if (srv_unix_file_flush_method != SRV_UNIX_O_DSYNC) {
 		fil_flush(group->space_id);
+		old_lsn = log_sys->flushed_to_disk_lsn;
 		log_sys->flushed_to_disk_lsn = log_sys->current_flush_lsn;
+
+		log_notify_waiters(log_sys->flush_events, old_lsn,
+				   log_sys->flushed_to_disk_lsn);
 	}
 
 	log_sys->n_pending_flushes--;
@@ -1495,6 +1655,78 @@ flush_op:
 	os_event_set(log_sys->flush_event);
 }
 
+/******************************************************//**
+This function is called, e.g., when a transaction wants to commit. It checks
+that the log has been written to the log file up to the last log entry written
+by the transaction. If the log writer and log flusher threads are running,
+they are woken up to do the write or the flush and the caller waits until its
+lsn is covered. Otherwise the write and flush are done by the caller. */
+UNIV_INTERN
+void
+log_write_up_to(
+/*============*/
+	lsn_t	lsn,	/*!< in: log sequence number up to which
+			the log should be written,
+			LSN_MAX if not specified */
+	ibool	flush_to_disk)
+			/*!< in: TRUE if we want the written log
+			also to be flushed to disk */
+{
+	ut_ad(!srv_read_only_mode);
+
+#if UNIV_WORD_SIZE > 7
+	/* The waits below do dirty reads of write_lsn and
+	flushed_to_disk_lsn. */
+	if (!log_sys->writer_threads_active || recv_no_ibuf_operations) {
+		log_write_up_to_low(lsn, flush_to_disk);
+		return;
+	}
+
+	ut_ad(!mutex_own(&(log_sys->w_mutex)));
+	ut_ad(!mutex_own(&(log_sys->mutex)));
+
+	if (lsn == LSN_MAX) {
+		lsn = log_get_lsn();
+	}
+
+	const volatile lsn_t*	done_lsn = flush_to_disk
+		? &log_sys->flushed_to_disk_lsn
+		: &log_sys->write_lsn;
+
+	if (*done_lsn >= lsn) {
+		return;
+	}
+
+	os_event_t	event = (flush_to_disk
+				 ? log_sys->flush_events
+				 : log_sys->write_events)[
+		(lsn / OS_FILE_LOG_BLOCK_SIZE) % LOG_N_WAIT_EVENTS];
+
+	for (;;) {
+		ib_int64_t	sig_count = os_event_reset(event);
+
+		if (*done_lsn >= lsn) {
+			break;
+		}
+
+		if (!log_sys->writer_threads_active) {
+			/* The threads are being stopped at shutdown */
+			log_write_up_to_low(lsn, flush_to_disk);
+			break;
+		}
+
+		os_event_set(flush_to_disk
+			     ? log_sys->flusher_event
+			     : log_sys->writer_event);
+
+		/* The timeout only guards against a missed wakeup */
+		os_event_wait_time_low(event, 100000, sig_count);
+	}
+#else /* UNIV_WORD_SIZE > 7 */
+	log_write_up_to_low(lsn, flush_to_disk);
+#endif /* UNIV_WORD_SIZE > 7 */
+}
+
 /****************************************************************//**
 Does a syncronous flush of the log buffer to disk. */
 UNIV_INTERN
@@ -1544,6 +1776,149 @@ log_buffer_sync_in_background(
 	log_write_up_to(lsn, flush);
 }
 
+/******************************************************************//**
+The log writer thread. It writes the log buffer to the log files whenever
+there is something to write.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(log_writer_thread)(
+/*==============================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_writer_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (log_sys->writer_threads_active) {
+		/* Waking up on a timeout too keeps the log written
+		continuously, so that less is left to write when a
+		transaction commits. */
+		os_event_wait_time(log_sys->writer_event, 10000);
+		os_event_reset(log_sys->writer_event);
+
+		/* The lsn is read after the reset: a request made
+		before it is covered by this write. */
+		lsn_t	lsn = log_get_lsn();
+
+		if (log_sys->write_lsn < lsn) {
+			log_write_up_to_low(lsn, FALSE);
+		}
+	}
+
+	os_atomic_decrement_ulint(&log_sys->n_writer_threads, 1);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/******************************************************************//**
+The log flusher thread. It writes and flushes the log to disk when
+transactions wait for their commit to become durable. All the log
+generated meanwhile is flushed by the same fsync.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(log_flusher_thread)(
+/*===============================*/
+	void*	arg MY_ATTRIBUTE((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(log_flusher_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	while (log_sys->writer_threads_active) {
+		os_event_wait(log_sys->flusher_event);
+		os_event_reset(log_sys->flusher_event);
+
+		/* The lsn is read after the reset: a request made
+		before it is covered by this flush. */
+		lsn_t	lsn = log_get_lsn();
+
+		if (log_sys->flushed_to_disk_lsn < lsn) {
+			log_write_up_to_low(lsn, TRUE);
+		}
+	}
+
+	os_atomic_decrement_ulint(&log_sys->n_writer_threads, 1);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/****************************************************************//**
+Creates the log writer and log flusher threads. From then on,
+log_write_up_to() leaves the log writes and flushes to them and waits for
+its lsn to be written or flushed. */
+UNIV_INTERN
+void
+log_writer_threads_start(void)
+/*==========================*/
+{
+	ut_ad(!srv_read_only_mode);
+	ut_ad(!log_sys->writer_threads_active);
+	ut_ad(log_sys->write_events == NULL);
+
+	log_sys->writer_event = os_event_create();
+	log_sys->flusher_event = os_event_create();
+
+	log_sys->write_events = static_cast<os_event_t*>(
+		mem_alloc(LOG_N_WAIT_EVENTS * sizeof(os_event_t)));
+	log_sys->flush_events = static_cast<os_event_t*>(
+		mem_alloc(LOG_N_WAIT_EVENTS * sizeof(os_event_t)));
+
+	for (ulint i = 0; i < LOG_N_WAIT_EVENTS; i++) {
+		log_sys->write_events[i] = os_event_create();
+		log_sys->flush_events[i] = os_event_create();
+	}
+
+	log_sys->n_writer_threads = 2;
+	log_sys->writer_threads_active = true;
+
+	os_thread_create(log_writer_thread, NULL, NULL);
+	os_thread_create(log_flusher_thread, NULL, NULL);
+}
+
+/****************************************************************//**
+Stops the log writer and log flusher threads, if they were started, and
+waits for them to exit. Afterwards log_write_up_to() writes and flushes
+the log in the calling thread again. */
+UNIV_INTERN
+void
+log_writer_threads_stop(void)
+/*=========================*/
+{
+	if (!log_sys->writer_threads_active) {
+		return;
+	}
+
+	log_sys->writer_threads_active = false;
+
+	while (log_sys->n_writer_threads > 0) {
+		os_event_set(log_sys->writer_event);
+		os_event_set(log_sys->flusher_event);
+		os_thread_sleep(10000);
+	}
+
+	/* Wake up the threads that are still waiting, they will do
+	their write or flush themselves. The events are freed only in
+	log_shutdown(). */
+	for (ulint i = 0; i < LOG_N_WAIT_EVENTS; i++) {
+		os_event_set(log_sys->write_events[i]);
+		os_event_set(log_sys->flush_events[i]);
+	}
+}
+
 /********************************************************************
 
 Tries to establish a big enough margin of free space in the log buffer, such
@@ -3171,6 +3546,10 @@ loop:
 		}
 	}
 
+	/* The remaining log writes and flushes are done by the
+	shutdown thread itself. */
+	log_writer_threads_stop();
+
 	mutex_enter(&log_sys->mutex);
 	server_busy = log_sys->n_pending_checkpoint_writes
 #ifdef UNIV_LOG_ARCHIVE
@@ -3555,6 +3934,23 @@ log_shutdown(void)
 
 	os_event_free(log_sys->flush_event);
 
+	if (log_sys->write_events != NULL) {
+		ut_ad(!log_sys->writer_threads_active);
+
+		for (ulint i = 0; i < LOG_N_WAIT_EVENTS; i++) {
+			os_event_free(log_sys->write_events[i]);
+			os_event_free(log_sys->flush_events[i]);
+		}
+
+		mem_free(log_sys->write_events);
+		mem_free(log_sys->flush_events);
+		log_sys->write_events = NULL;
+		log_sys->flush_events = NULL;
+
+		os_event_free(log_sys->writer_event);
+		os_event_free(log_sys->flusher_event);
+	}
+
 	rw_lock_free(&log_sys->checkpoint_lock);
 
 	mutex_free(&log_sys->mutex);
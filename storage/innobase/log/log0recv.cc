@@ -166,6 +166,7 @@ UNIV_INTERN mysql_pfs_key_t	recv_sys_mutex_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 UNIV_INTERN mysql_pfs_key_t	recv_writer_thread_key;
+UNIV_INTERN mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 # ifdef UNIV_PFS_MUTEX
@@ -1470,6 +1471,16 @@ recv_add_to_hash_table(
 		return;
 	}
 
+#ifndef UNIV_HOTBACKUP
+	if (srv_is_undo_tablespace_truncated(space)) {
+		/* The UNDO tablespace was re-created because its
+		truncation was interrupted: the log record is for the
+		old tablespace */
+
+		return;
+	}
+#endif /* !UNIV_HOTBACKUP */
+
 	len = rec_end - body;
 
 	recv = static_cast<recv_t*>(
@@ -1834,48 +1845,53 @@ recv_read_in_area(
 }
 
 /*******************************************************************//**
-Empties the hash table of stored log records, applying them to appropriate
-pages. */
-UNIV_INTERN
+Prints the progress of the running apply batch, in percent of the hashed
+file addresses of the batch that have been processed. */
+static
 void
-recv_apply_hashed_log_recs(
-/*=======================*/
-	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
-				allowed during the application; if FALSE,
-				no ibuf operations are allowed, and after
-				the application all file pages are flushed to
-				disk and invalidated in buffer pool: this
-				alternative means that no new log records
-				can be generated during the application;
-				the caller must in this case own the log
-				mutex */
+recv_apply_print_progress(void)
+/*===========================*/
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
-loop:
-	mutex_enter(&(recv_sys->mutex));
+	ulint	progress;
 
-	if (recv_sys->apply_batch_on) {
+	ut_ad(mutex_own(&recv_sys->mutex));
 
-		mutex_exit(&(recv_sys->mutex));
-
-		os_thread_sleep(500000);
+	if (recv_sys->apply_n_pages == 0) {
 
-		goto loop;
+		return;
 	}
 
-	ut_ad((!allow_ibuf) == mutex_own(&log_sys->mutex));
+	progress = (recv_sys->apply_n_pages - recv_sys->n_addrs) * 100
+		/ recv_sys->apply_n_pages;
 
-	if (!allow_ibuf) {
-		recv_no_ibuf_operations = TRUE;
+	if (progress != recv_sys->apply_progress && progress < 100) {
+
+		fprintf(stderr, "%lu ", (ulong) progress);
+
+		recv_sys->apply_progress = progress;
 	}
+}
 
-	recv_sys->apply_log_recs = TRUE;
-	recv_sys->apply_batch_on = TRUE;
+/*******************************************************************//**
+Applies the hashed log records of every step'th cell of the hash table,
+starting from the cell offset. The pages found in the buffer pool are
+recovered right away; the others are read in with asynchronous i/o and
+recovered by the i/o handler threads when the read completes. */
+static
+void
+recv_apply_hash_cells(
+/*==================*/
+	ulint	offset,	/*!< in: first hash cell to process */
+	ulint	step)	/*!< in: distance between the cells to process */
+{
+	recv_addr_t*	recv_addr;
+	ulint		i;
+	mtr_t		mtr;
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	mutex_enter(&(recv_sys->mutex));
+
+	for (i = offset; i < hash_get_n_cells(recv_sys->addr_hash);
+	     i += step) {
 
 		for (recv_addr = static_cast<recv_addr_t*>(
 				HASH_GET_FIRST(recv_sys->addr_hash, i));
@@ -1888,15 +1904,6 @@ loop:
 			ulint	page_no = recv_addr->page_no;
 
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ib_logf(IB_LOG_LEVEL_INFO,
-						"Starting an apply batch"
-						" of log records"
-						" to the database...");
-					fputs("InnoDB: Progress in percent: ",
-					      stderr);
-					has_printed = TRUE;
-				}
 
 				mutex_exit(&(recv_sys->mutex));
 
@@ -1922,26 +1929,132 @@ loop:
 			}
 		}
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
-
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
-		}
+		recv_apply_print_progress();
 	}
 
-	/* Wait until all the pages have been processed */
+	mutex_exit(&(recv_sys->mutex));
+}
+
+/******************************************************************//**
+recv_apply thread that applies the hashed log records of its share of
+the hash table cells, in parallel with the thread running the batch.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg)	/*!< in: first hash cell to process, cast to
+			void* */
+{
+	ulint	offset = reinterpret_cast<ulint>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	recv_apply_hash_cells(offset, recv_sys->n_apply_threads);
+
+	mutex_enter(&(recv_sys->mutex));
 
-	while (recv_sys->n_addrs != 0) {
+	ut_a(recv_sys->n_apply_threads_active > 0);
+	recv_sys->n_apply_threads_active--;
+
+	mutex_exit(&(recv_sys->mutex));
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Empties the hash table of stored log records, applying them to appropriate
+pages. The hash table cells, and thus the pages hashed by (space, page_no),
+are partitioned between srv_n_recv_apply_threads threads. */
+UNIV_INTERN
+void
+recv_apply_hashed_log_recs(
+/*=======================*/
+	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
+				allowed during the application; if FALSE,
+				no ibuf operations are allowed, and after
+				the application all file pages are flushed to
+				disk and invalidated in buffer pool: this
+				alternative means that no new log records
+				can be generated during the application;
+				the caller must in this case own the log
+				mutex */
+{
+	ulint		i;
+	ulint		n_threads;
+	ibool		has_printed	= FALSE;
+	ib_time_t	start_time	= ut_time();
+loop:
+	mutex_enter(&(recv_sys->mutex));
+
+	if (recv_sys->apply_batch_on) {
 
 		mutex_exit(&(recv_sys->mutex));
 
 		os_thread_sleep(500000);
 
+		goto loop;
+	}
+
+	ut_ad((!allow_ibuf) == mutex_own(&log_sys->mutex));
+
+	if (!allow_ibuf) {
+		recv_no_ibuf_operations = TRUE;
+	}
+
+	recv_sys->apply_log_recs = TRUE;
+	recv_sys->apply_batch_on = TRUE;
+
+	recv_sys->apply_n_pages = recv_sys->n_addrs;
+	recv_sys->apply_progress = ULINT_UNDEFINED;
+
+	/* There is no point in starting more threads than there
+	are pages to recover. */
+	n_threads = ut_min(srv_n_recv_apply_threads, recv_sys->n_addrs);
+	n_threads = ut_max(n_threads, 1);
+
+	recv_sys->n_apply_threads = n_threads;
+	recv_sys->n_apply_threads_active = n_threads - 1;
+
+	if (recv_sys->n_addrs != 0) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Starting an apply batch of log records"
+			" to the database...");
+		fputs("InnoDB: Progress in percent: ", stderr);
+		has_printed = TRUE;
+	}
+
+	mutex_exit(&(recv_sys->mutex));
+
+	for (i = 1; i < n_threads; i++) {
+		os_thread_create(recv_apply_thread,
+				 reinterpret_cast<void*>(i), NULL);
+	}
+
+	recv_apply_hash_cells(0, n_threads);
+
+	mutex_enter(&(recv_sys->mutex));
+
+	/* Wait until all the pages have been processed and the
+	recv_apply threads are done with the hash table */
+
+	while (recv_sys->n_addrs != 0
+	       || recv_sys->n_apply_threads_active != 0) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_thread_sleep(10000);
+
 		mutex_enter(&(recv_sys->mutex));
+
+		recv_apply_print_progress();
 	}
 
 	if (has_printed) {
@@ -1991,8 +2104,17 @@ loop:
 
 	if (has_printed) {
 		fprintf(stderr, "InnoDB: Apply batch completed\n");
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Applied log records to %lu pages in %.0f seconds"
+			" (apply threads: %lu)",
+			(ulong) recv_sys->apply_n_pages,
+			ut_difftime(ut_time(), start_time),
+			(ulong) n_threads);
 	}
 
+	recv_sys->apply_n_pages = 0;
+
 	mutex_exit(&(recv_sys->mutex));
 }
 #else /* !UNIV_HOTBACKUP */
@@ -34,6 +34,7 @@ Created 11/26/1995 Heikki Tuuri
 #include "page0types.h"
 #include "mtr0log.h"
 #include "log0log.h"
+#include "fsp0fsp.h"
 
 #ifndef UNIV_HOTBACKUP
 # include "log0recv.h"
@@ -229,6 +230,51 @@ mtr_add_dirtied_pages_to_flush_list(
 	}
 }
 
+/**********************************************************//**
+Checks if all the pages that a mini-transaction x-latched belong to the
+shared temporary tablespace. Such a mini-transaction need not be redo
+logged.
+@return true if the mtr x-latched pages of the temporary tablespace only */
+static
+bool
+mtr_memo_is_temporary(
+/*==================*/
+	const mtr_t*	mtr)	/*!< in: mtr */
+{
+	bool	found = false;
+
+	for (const dyn_block_t* block = dyn_array_get_first_block(&mtr->memo);
+	     block;
+	     block = dyn_array_get_next_block(&mtr->memo, block)) {
+		const mtr_memo_slot_t*	slot
+			= reinterpret_cast<const mtr_memo_slot_t*>(
+				dyn_block_get_data(block));
+		const mtr_memo_slot_t*	end
+			= reinterpret_cast<const mtr_memo_slot_t*>(
+				dyn_block_get_data(block)
+				+ dyn_block_get_used(block));
+
+		for (; slot != end; slot++) {
+			if (slot->object == NULL
+			    || slot->type != MTR_MEMO_PAGE_X_FIX) {
+				continue;
+			}
+
+			const buf_block_t*	page
+				= static_cast<const buf_block_t*>(
+					slot->object);
+
+			if (!fsp_is_system_temporary(page->page.space)) {
+				return(false);
+			}
+
+			found = true;
+		}
+	}
+
+	return(found);
+}
+
 /************************************************************//**
 Writes the contents of a mini-transaction log, if any, to the database log. */
 static
@@ -275,11 +321,14 @@ mtr_log_reserve_and_write(
 
 	data_size = dyn_array_get_data_size(mlog);
 
-	/* Open the database log for log_write_low */
-	mtr->start_lsn = log_reserve_and_open(data_size);
+	/* Open the database log for log_write_low. Nothing is written
+	for MTR_LOG_NO_REDO. */
+	mtr->start_lsn = log_reserve_and_open(
+		mtr->log_mode == MTR_LOG_NO_REDO ? 0 : data_size);
 
 	if (mtr->log_mode == MTR_LOG_ALL) {
-
+#ifdef UNIV_LOG_DEBUG
+		/* log_close() checks the records that were written */
 		for (dyn_block_t* block = mlog;
 		     block != 0;
 		     block = dyn_array_get_next_block(mlog, block)) {
@@ -288,7 +337,31 @@ mtr_log_reserve_and_write(
 				dyn_block_get_data(block),
 				dyn_block_get_used(block));
 		}
+#else /* UNIV_LOG_DEBUG */
+		/* Only reserve the space while holding the log mutex.
+		The records are copied after the mutex has been released,
+		concurrently with other mini-transactions. */
+		byte*	buf = log_sys->buf;
+		ulint	offset = log_write_reserve_low(data_size);
+
+		mtr->end_lsn = log_close();
+
+		mtr_add_dirtied_pages_to_flush_list(mtr);
+
+		for (dyn_block_t* block = mlog;
+		     block != 0;
+		     block = dyn_array_get_next_block(mlog, block)) {
 
+			offset = log_write_copy(
+				buf, offset,
+				dyn_block_get_data(block),
+				dyn_block_get_used(block));
+		}
+
+		log_write_copy_complete();
+
+		return;
+#endif /* UNIV_LOG_DEBUG */
 	} else {
 		ut_ad(mtr->log_mode == MTR_LOG_NONE
 		      || mtr->log_mode == MTR_LOG_NO_REDO);
@@ -321,6 +394,15 @@ mtr_commit(
 
 	if (mtr->modifications && mtr->n_log_recs) {
 		ut_ad(!srv_read_only_mode);
+
+		/* The temporary tablespace is re-created at startup:
+		its pages are never recovered. */
+		if (mtr->log_mode == MTR_LOG_ALL
+		    && srv_tmp_space_id != ULINT_UNDEFINED
+		    && mtr_memo_is_temporary(mtr)) {
+			mtr->log_mode = MTR_LOG_NO_REDO;
+		}
+
 		mtr_log_reserve_and_write(mtr);
 	}
 
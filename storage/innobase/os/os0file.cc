@@ -45,6 +45,8 @@ Created 10/21/1995 Heikki Tuuri
 #include "buf0buf.h"
 #include "btr0types.h"
 #include "srv0mon.h"
+#include "mach0data.h"
+#include "page0zip.h"
 #ifndef UNIV_HOTBACKUP
 # include "os0sync.h"
 # include "os0thread.h"
@@ -61,6 +63,13 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif
 
+#ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
+#include <fcntl.h>
+#include <linux/falloc.h>
+#endif /* HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE */
+
+#include "zlib.h"
+
 /** Insert buffer segment id */
 static const ulint IO_IBUF_SEGMENT = 0;
 
@@ -152,6 +161,13 @@ UNIV_INTERN mysql_pfs_key_t  innodb_file_log_key;
 UNIV_INTERN mysql_pfs_key_t  innodb_file_temp_key;
 #endif /* UNIV_PFS_IO */
 
+/** Number of buckets in the i/o latency histogram of an aio array */
+#define OS_AIO_LATENCY_N_BUCKETS	16
+
+/** Upper bound of the first bucket of the i/o latency histogram,
+in microseconds */
+#define OS_AIO_LATENCY_MIN_US		32
+
 /** The asynchronous i/o array slot structure */
 struct os_aio_slot_t{
 	ibool		is_read;	/*!< TRUE if a read operation */
@@ -159,6 +175,9 @@ struct os_aio_slot_t{
 					array */
 	ibool		reserved;	/*!< TRUE if this slot is reserved */
 	time_t		reservation_time;/*!< time when reserved */
+	ullint		reservation_us;	/*!< time when reserved, in
+					microseconds, for the latency
+					histogram of the array */
 	ulint		len;		/*!< length of the block to read or
 					write */
 	byte*		buf;		/*!< buffer used in i/o */
@@ -176,6 +195,14 @@ struct os_aio_slot_t{
 					and which can be used to identify
 					which pending aio operation was
 					completed */
+	bool		page_compression;/*!< true if the request is a full
+					page to which transparent page
+					compression applies */
+	byte*		page_buf;	/*!< aligned scratch buffer of
+					UNIV_PAGE_SIZE bytes for transparent
+					page compression, allocated on first
+					use */
+	byte*		page_buf_unaligned;/*!< memory block of page_buf */
 #ifdef WIN_ASYNC_IO
 	HANDLE		handle;		/*!< handle object we need in the
 					OVERLAPPED struct */
@@ -215,6 +242,19 @@ struct os_aio_array_t{
 				/*!< Number of reserved slots in the
 				aio array outside the ibuf segment */
 	os_aio_slot_t*	slots;	/*!< Pointer to the slots in the array */
+	ulint*		free_slots;
+				/*!< Positions of the free slots. The
+				array of length n_slots is divided into
+				n_segments parts, and each part is a
+				stack of the free slots of a segment */
+	ulint*		n_free;	/*!< Array of length n_segments: the
+				number of free slots on each segment */
+	ulint		latency[OS_AIO_LATENCY_N_BUCKETS];
+				/*!< Histogram of the time from slot
+				reservation to completion: bucket i counts
+				i/os that took at most
+				OS_AIO_LATENCY_MIN_US << i microseconds,
+				the last bucket the rest */
 #ifdef __WIN__
 	HANDLE*		handles;
 				/*!< Pointer to an array of OS native
@@ -245,6 +285,15 @@ struct os_aio_array_t{
 				/* Array of length n_segments. Each element
 				counts the number of not-submitted aio request
 				on that segment. */
+	os_aio_slot_t**		done;
+				/* Array to queue the completed requests
+				that io_getevents() returned. The array
+				length is n_slots. It is divided into
+				n_segments stacks, each one owned by the
+				i/o handler thread of its segment. */
+	ulint*			n_done;
+				/* Array of length n_segments: the number of
+				completed requests queued on each segment */
 #endif /* LINUX_NATIV_AIO */
 };
 
@@ -2215,6 +2264,41 @@ os_file_set_eof(
 #endif /* __WIN__ */
 }
 
+/***********************************************************************//**
+Truncates or extends a file to the given size. The contents of an
+extended part are undefined; use os_file_set_size() to write it.
+@return	TRUE if success */
+UNIV_INTERN
+ibool
+os_file_truncate(
+/*=============*/
+	const char*	name,	/*!< in: name of the file, used in
+				error messages */
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	size)	/*!< in: new file size */
+{
+#ifdef __WIN__
+	LARGE_INTEGER	length;
+
+	length.QuadPart = size;
+
+	if (SetFilePointerEx(file, length, NULL, FILE_BEGIN)
+	    && SetEndOfFile(file)) {
+
+		return(TRUE);
+	}
+#else /* __WIN__ */
+	if (!ftruncate(file, size)) {
+
+		return(TRUE);
+	}
+#endif /* __WIN__ */
+
+	os_file_handle_error_no_exit(name, "truncate", FALSE);
+
+	return(FALSE);
+}
+
 #ifndef __WIN__
 /***********************************************************************//**
 Wrapper to fsync(2) that retries the call on some errors.
@@ -3772,6 +3856,11 @@ os_aio_array_create(
 		ut_malloc(n * sizeof(*array->slots)));
 
 	memset(array->slots, 0x0, sizeof(n * sizeof(*array->slots)));
+
+	array->free_slots = static_cast<ulint*>(
+		ut_malloc(n * sizeof(*array->free_slots)));
+	array->n_free = static_cast<ulint*>(
+		ut_malloc(n_segments * sizeof(*array->n_free)));
 #ifdef __WIN__
 	array->handles = static_cast<HANDLE*>(ut_malloc(n * sizeof(HANDLE)));
 #endif /* __WIN__ */
@@ -3817,6 +3906,11 @@ os_aio_array_create(
 	array->count = static_cast<ulint *>(
 		ut_malloc(n_segments * sizeof(ulint)));
 	memset(array->count, 0x0, sizeof(ulint) * n_segments);
+	array->done = static_cast<os_aio_slot_t**>(
+		ut_malloc(n * sizeof(*array->done)));
+	array->n_done = static_cast<ulint*>(
+		ut_malloc(n_segments * sizeof(ulint)));
+	memset(array->n_done, 0x0, sizeof(ulint) * n_segments);
 
 skip_native_aio:
 #endif /* LINUX_NATIVE_AIO */
@@ -3827,6 +3921,8 @@ skip_native_aio:
 
 		slot->pos = i;
 		slot->reserved = FALSE;
+		slot->page_buf = NULL;
+		slot->page_buf_unaligned = NULL;
 #ifdef WIN_ASYNC_IO
 		slot->handle = CreateEvent(NULL,TRUE, FALSE, NULL);
 
@@ -3843,6 +3939,22 @@ skip_native_aio:
 #endif /* WIN_ASYNC_IO */
 	}
 
+	/* All slots are free. Stack them so that each segment hands out
+	its lowest slot first. */
+	ulint	slots_per_seg = n / n_segments;
+
+	for (ulint seg = 0; seg < n_segments; seg++) {
+		ulint*	stack = array->free_slots + seg * slots_per_seg;
+
+		for (ulint i = 0; i < slots_per_seg; i++) {
+			stack[i] = (seg + 1) * slots_per_seg - 1 - i;
+		}
+
+		array->n_free[seg] = slots_per_seg;
+	}
+
+	memset(array->latency, 0x0, sizeof(array->latency));
+
 	return(array);
 }
 
@@ -3866,6 +3978,12 @@ os_aio_array_free(
 #ifdef __WIN__
 	ut_free(array->handles);
 #endif /* __WIN__ */
+
+	for (ulint i = 0; i < array->n_slots; i++) {
+		os_aio_slot_t*	slot = os_aio_array_get_nth_slot(array, i);
+		ut_free(slot->page_buf_unaligned);
+	}
+
 	os_mutex_free(array->mutex);
 	os_event_free(array->not_full);
 	os_event_free(array->is_empty);
@@ -3876,9 +3994,13 @@ os_aio_array_free(
 		ut_free(array->aio_ctx);
 		ut_free(array->pending);
 		ut_free(array->count);
+		ut_free(array->done);
+		ut_free(array->n_done);
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+	ut_free(array->free_slots);
+	ut_free(array->n_free);
 	ut_free(array->slots);
 	ut_free(array);
 
@@ -4212,7 +4334,10 @@ os_aio_array_reserve_slot(
 	void*		buf,	/*!< in: buffer where to read or from which
 				to write */
 	os_offset_t	offset,	/*!< in: file offset */
-	ulint		len)	/*!< in: length of the block to read or write */
+	ulint		len,	/*!< in: length of the block to read or write */
+	bool		page_compression)
+				/*!< in: true if transparent page
+				compression applies to the block */
 {
 	os_aio_slot_t*	slot = NULL;
 #ifdef WIN_ASYNC_IO
@@ -4260,18 +4385,22 @@ loop:
 		goto loop;
 	}
 
-	/* We start our search for an available slot from our preferred
-	local segment and do a full scan of the array. We are
-	guaranteed to find a slot in full scan. */
-	for (i = local_seg * slots_per_seg, counter = 0;
-	     counter < array->n_slots;
+	/* We take a free slot of our preferred local segment, or else
+	of the next segment that has one. As the array is not full, we
+	are guaranteed to find one. */
+	for (i = local_seg, counter = 0;
+	     counter < array->n_segments;
 	     i++, counter++) {
 
-		i %= array->n_slots;
+		i %= array->n_segments;
 
-		slot = os_aio_array_get_nth_slot(array, i);
+		if (array->n_free[i] > 0) {
+			ulint	n_free = --array->n_free[i];
+
+			slot = os_aio_array_get_nth_slot(
+				array,
+				array->free_slots[i * slots_per_seg + n_free]);
 
-		if (slot->reserved == FALSE) {
 			goto found;
 		}
 	}
@@ -4293,6 +4422,7 @@ found:
 
 	slot->reserved = TRUE;
 	slot->reservation_time = ut_time();
+	slot->reservation_us = ut_time_us(NULL);
 	slot->message1 = message1;
 	slot->message2 = message2;
 	slot->file     = file;
@@ -4302,6 +4432,7 @@ found:
 	slot->buf      = static_cast<byte*>(buf);
 	slot->offset   = offset;
 	slot->io_already_done = FALSE;
+	slot->page_compression = page_compression;
 
 #ifdef WIN_ASYNC_IO
 	control = &slot->control;
@@ -4352,12 +4483,28 @@ os_aio_array_free_slot(
 	os_aio_array_t*	array,	/*!< in: aio array */
 	os_aio_slot_t*	slot)	/*!< in: pointer to slot */
 {
+	ulint	slots_per_seg = array->n_slots / array->n_segments;
+	ulint	seg = slot->pos / slots_per_seg;
+	ullint	latency = ut_time_us(NULL) - slot->reservation_us;
+	ulint	bucket = 0;
+
+	while (bucket < OS_AIO_LATENCY_N_BUCKETS - 1
+	       && latency > (ullint) OS_AIO_LATENCY_MIN_US << bucket) {
+		bucket++;
+	}
+
 	os_mutex_enter(array->mutex);
 
 	ut_ad(slot->reserved);
 
 	slot->reserved = FALSE;
 
+	array->free_slots[seg * slots_per_seg + array->n_free[seg]++]
+		= slot->pos;
+	ut_ad(array->n_free[seg] <= slots_per_seg);
+
+	array->latency[bucket]++;
+
 	array->n_reserved--;
 
 	if (array->n_reserved == array->n_slots - 1) {
@@ -4390,6 +4537,285 @@ os_aio_array_free_slot(
 	os_mutex_exit(array->mutex);
 }
 
+/** Transparent page compression keeps the FIL header of a compressed
+page, with FIL_PAGE_TYPE set to FIL_PAGE_COMPRESSED, and stores the rest
+of the page compressed with zlib right after it. The write is rounded up
+to OS_FILE_PUNCH_HOLE_SIZE and a hole is punched for the remainder of
+the page. The FIL_PAGE_FILE_FLUSH_LSN field, which is unused on these
+pages, describes the compressed page: @{ */
+#define OS_FILE_COMPRESSED_VERSION	FIL_PAGE_FILE_FLUSH_LSN
+					/*!< format version, 1 byte */
+#define OS_FILE_COMPRESSED_ALGORITHM	(FIL_PAGE_FILE_FLUSH_LSN + 1)
+					/*!< compression algorithm, 1 byte */
+#define OS_FILE_COMPRESSED_ORIG_TYPE	(FIL_PAGE_FILE_FLUSH_LSN + 2)
+					/*!< FIL_PAGE_TYPE of the page,
+					2 bytes */
+#define OS_FILE_COMPRESSED_LEN		(FIL_PAGE_FILE_FLUSH_LSN + 4)
+					/*!< length of the compressed data
+					after FIL_PAGE_DATA, 2 bytes */
+/* @} */
+
+/** Current format version of compressed pages */
+static const ulint OS_FILE_COMPRESSED_FORMAT_V1 = 1;
+
+/** Compression algorithm of compressed pages: zlib */
+static const ulint OS_FILE_COMPRESSED_ZLIB = 1;
+
+/** Granularity of hole punching; compressed pages are written in
+multiples of this size */
+static const ulint OS_FILE_PUNCH_HOLE_SIZE = 4096;
+
+/*******************************************************************//**
+Compresses a page for a write with transparent page compression. Only
+B-tree and BLOB pages are compressed, and only if that saves at least
+one OS_FILE_PUNCH_HOLE_SIZE block of the page.
+@return	number of bytes of dst to write, or 0 if the page must be
+written uncompressed */
+static
+ulint
+os_file_page_compress(
+/*==================*/
+	const byte*	src,	/*!< in: page to write */
+	byte*		dst)	/*!< out: compressed page; UNIV_PAGE_SIZE
+				bytes */
+{
+#ifndef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
+	/* Without hole punching a compressed page saves no space. */
+	return(0);
+#else
+	ulint	type;
+	uLongf	len;
+
+	if (!srv_transparent_page_compression
+	    || UNIV_PAGE_SIZE <= OS_FILE_PUNCH_HOLE_SIZE) {
+		return(0);
+	}
+
+	type = mach_read_from_2(src + FIL_PAGE_TYPE);
+
+	if ((type != FIL_PAGE_INDEX && type != FIL_PAGE_TYPE_BLOB)
+	    || mach_read_from_8(src + FIL_PAGE_FILE_FLUSH_LSN) != 0) {
+		return(0);
+	}
+
+	len = UNIV_PAGE_SIZE - OS_FILE_PUNCH_HOLE_SIZE - FIL_PAGE_DATA;
+
+	if (compress2(dst + FIL_PAGE_DATA, &len, src + FIL_PAGE_DATA,
+		      UNIV_PAGE_SIZE - FIL_PAGE_DATA,
+		      (int) page_zip_level) != Z_OK) {
+		/* The page does not compress well enough. */
+		return(0);
+	}
+
+	memcpy(dst, src, FIL_PAGE_DATA);
+
+	mach_write_to_2(dst + FIL_PAGE_TYPE, FIL_PAGE_COMPRESSED);
+	mach_write_to_1(dst + OS_FILE_COMPRESSED_VERSION,
+			OS_FILE_COMPRESSED_FORMAT_V1);
+	mach_write_to_1(dst + OS_FILE_COMPRESSED_ALGORITHM,
+			OS_FILE_COMPRESSED_ZLIB);
+	mach_write_to_2(dst + OS_FILE_COMPRESSED_ORIG_TYPE, type);
+	mach_write_to_2(dst + OS_FILE_COMPRESSED_LEN, len);
+
+	len += FIL_PAGE_DATA;
+
+	ulint	n = ut_calc_align(len, OS_FILE_PUNCH_HOLE_SIZE);
+
+	memset(dst + len, 0, n - len);
+
+	srv_stats.pages_page_compressed.inc();
+	srv_stats.page_compression_saved.add(UNIV_PAGE_SIZE - n);
+
+	return(n);
+#endif /* !HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE */
+}
+
+/*******************************************************************//**
+Releases the part of a page that a compressed page write did not cover
+by punching a hole in the file. Failures are reported once and otherwise
+ignored: the stale bytes in the hole are never read. */
+static
+void
+os_file_punch_hole(
+/*===============*/
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	offset,	/*!< in: file offset of the hole */
+	ulint		len)	/*!< in: length of the hole */
+{
+#ifdef HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE
+	static bool	warned = false;
+
+	if (fallocate(file, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+		      offset, len) != 0 && !warned) {
+
+		warned = true;
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"fallocate(FALLOC_FL_PUNCH_HOLE) failed with error"
+			" %d. Transparent page compression does not save"
+			" space on this file system.", errno);
+	}
+#endif /* HAVE_FALLOC_PUNCH_HOLE_AND_KEEP_SIZE */
+}
+
+/*******************************************************************//**
+Decompresses in place a page that was written by transparent page
+compression. Pages of any other type are left alone.
+@return	false if the page was compressed but could not be decompressed */
+UNIV_INTERN
+bool
+os_file_page_decompress(
+/*====================*/
+	byte*	page,	/*!< in/out: page of UNIV_PAGE_SIZE bytes
+			read from a data file */
+	byte*	tmp)	/*!< in: scratch buffer of UNIV_PAGE_SIZE
+			bytes, or NULL to allocate one */
+{
+	ulint	len;
+	uLongf	page_len;
+	byte*	buf;
+	int	err;
+
+	if (mach_read_from_2(page + FIL_PAGE_TYPE) != FIL_PAGE_COMPRESSED) {
+		return(true);
+	}
+
+	len = mach_read_from_2(page + OS_FILE_COMPRESSED_LEN);
+
+	if (mach_read_from_1(page + OS_FILE_COMPRESSED_VERSION)
+	    != OS_FILE_COMPRESSED_FORMAT_V1
+	    || mach_read_from_1(page + OS_FILE_COMPRESSED_ALGORITHM)
+	    != OS_FILE_COMPRESSED_ZLIB
+	    || len > UNIV_PAGE_SIZE - FIL_PAGE_DATA) {
+
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Page %lu of space %lu has an unknown transparent"
+			" page compression format.",
+			(ulong) mach_read_from_4(page + FIL_PAGE_OFFSET),
+			(ulong) mach_read_from_4(page + FIL_PAGE_SPACE_ID));
+
+		return(false);
+	}
+
+	buf = tmp != NULL
+		? tmp : static_cast<byte*>(ut_malloc(UNIV_PAGE_SIZE));
+
+	memcpy(buf, page + FIL_PAGE_DATA, len);
+
+	page_len = UNIV_PAGE_SIZE - FIL_PAGE_DATA;
+
+	err = uncompress(page + FIL_PAGE_DATA, &page_len, buf, len);
+
+	if (buf != tmp) {
+		ut_free(buf);
+	}
+
+	if (err != Z_OK || page_len != UNIV_PAGE_SIZE - FIL_PAGE_DATA) {
+
+		/* Leave FIL_PAGE_TYPE alone, so that the page is
+		reported as corrupted by the caller. */
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Decompressing page %lu of space %lu failed with"
+			" zlib error %d.",
+			(ulong) mach_read_from_4(page + FIL_PAGE_OFFSET),
+			(ulong) mach_read_from_4(page + FIL_PAGE_SPACE_ID),
+			err);
+
+		return(false);
+	}
+
+	mach_write_to_2(page + FIL_PAGE_TYPE,
+			mach_read_from_2(page + OS_FILE_COMPRESSED_ORIG_TYPE));
+	memset(page + FIL_PAGE_FILE_FLUSH_LSN, 0, 8);
+
+	srv_stats.pages_page_decompressed.inc();
+
+	return(true);
+}
+
+/*******************************************************************//**
+Gets the scratch buffer of an aio slot for transparent page compression,
+allocating it on first use. The slot must be reserved by the caller.
+@return	buffer of UNIV_PAGE_SIZE bytes, aligned for direct i/o */
+static
+byte*
+os_aio_slot_get_page_buf(
+/*=====================*/
+	os_aio_slot_t*	slot)	/*!< in/out: reserved slot */
+{
+	ut_ad(slot->reserved);
+
+	if (slot->page_buf == NULL) {
+		slot->page_buf_unaligned = static_cast<byte*>(
+			ut_malloc(2 * UNIV_PAGE_SIZE));
+		slot->page_buf = static_cast<byte*>(
+			ut_align(slot->page_buf_unaligned, UNIV_PAGE_SIZE));
+	}
+
+	return(slot->page_buf);
+}
+
+/*******************************************************************//**
+Does a synchronous write of a full page with transparent page
+compression.
+@return	TRUE if request was successful, FALSE if fail */
+static
+ibool
+os_file_write_page(
+/*===============*/
+	const char*	name,	/*!< in: name of the file or path as a
+				null-terminated string */
+	os_file_t	file,	/*!< in: handle to a file */
+	const void*	buf,	/*!< in: page to write */
+	os_offset_t	offset,	/*!< in: file offset where to write */
+	byte*		tmp)	/*!< in: scratch buffer of UNIV_PAGE_SIZE
+				bytes aligned for direct i/o, or NULL
+				to allocate one */
+{
+	byte*	unaligned = NULL;
+	byte*	page = tmp;
+	ulint	len;
+	ibool	ret;
+
+	if (page == NULL) {
+		unaligned = static_cast<byte*>(ut_malloc(2 * UNIV_PAGE_SIZE));
+		page = static_cast<byte*>(ut_align(unaligned, UNIV_PAGE_SIZE));
+	}
+
+	len = os_file_page_compress(static_cast<const byte*>(buf), page);
+
+	if (len == 0) {
+		ret = os_file_write_func(name, file, buf, offset,
+					 UNIV_PAGE_SIZE);
+	} else {
+		ret = os_file_write_func(name, file, page, offset, len);
+
+		if (ret) {
+			os_file_punch_hole(file, offset + len,
+					   UNIV_PAGE_SIZE - len);
+		}
+	}
+
+	ut_free(unaligned);
+
+	return(ret);
+}
+
+/*******************************************************************//**
+Checks if a simulated aio request is a write that transparent page
+compression applies to. Such writes are done one page at a time.
+@return	true if the page of the slot is compressed when written */
+static
+bool
+os_aio_simulated_compress(
+/*======================*/
+	const os_aio_slot_t*	slot)	/*!< in: reserved slot */
+{
+	return(slot->type == OS_FILE_WRITE
+	       && slot->page_compression
+	       && srv_transparent_page_compression);
+}
+
 /**********************************************************************//**
 Wakes up a simulated aio i/o-handler thread if it has something to do. */
 static
@@ -4497,12 +4923,14 @@ readahead requests. */
 
 #if defined(LINUX_NATIVE_AIO)
 /*******************************************************************//**
-Submit buffered AIO requests on the given segment to the kernel. */
-UNIV_INTERN
+Submit the buffered AIO requests of all segments of an array to the
+kernel, with one io_submit() call per segment. */
+static
 void
-os_aio_linux_dispatch_read_array_submit()
+os_aio_linux_dispatch_array_submit(
+/*===============================*/
+	os_aio_array_t*	array)	/*!< in: aio array */
 {
-	os_aio_array_t* array = os_aio_read_array;
 	ulint total_submitted = 0;
 	if (!srv_use_native_aio) {
 		return ;
@@ -4540,6 +4968,50 @@ os_aio_linux_dispatch_read_array_submit()
 
 	srv_stats.n_aio_submitted.add(total_submitted);
 }
+
+/*******************************************************************//**
+Submit buffered AIO read requests to the kernel. */
+UNIV_INTERN
+void
+os_aio_linux_dispatch_read_array_submit()
+{
+	os_aio_linux_dispatch_array_submit(os_aio_read_array);
+}
+
+/*******************************************************************//**
+Submit buffered AIO write requests to the kernel. */
+UNIV_INTERN
+void
+os_aio_linux_dispatch_write_array_submit()
+{
+	os_aio_linux_dispatch_array_submit(os_aio_write_array);
+}
+
+/*******************************************************************//**
+Compresses the page of a reserved write slot with transparent page
+compression and points the slot and its control block at the compressed
+page. The hole for the rest of the page is punched when the write
+completes, in os_aio_linux_handle(). */
+static
+void
+os_aio_linux_compress_slot(
+/*=======================*/
+	os_aio_slot_t*	slot)	/*!< in/out: reserved slot, not yet
+				dispatched */
+{
+	byte*	page = os_aio_slot_get_page_buf(slot);
+	ulint	len = os_file_page_compress(slot->buf, page);
+
+	if (len != 0) {
+		slot->buf = page;
+		slot->len = len;
+
+		io_prep_pwrite(&slot->control, slot->file, page, len,
+			       (off_t) slot->offset);
+		slot->control.data = slot;
+	}
+}
+
 /*******************************************************************//**
 Dispatch an AIO request to the kernel.
 @return	TRUE on success. */
@@ -4571,8 +5043,9 @@ os_aio_linux_dispatch(
 	iocb = &slot->control;
 	io_ctx_index = slot->pos / slots_per_segment;
 	if (should_buffer) {
-		/* only allowd read aio */
-		ut_ad(array == os_aio_read_array);
+		/* only allowed for normal reads and writes */
+		ut_ad(array == os_aio_read_array
+		      || array == os_aio_write_array);
 
 		ulint n;
 		ulint count;
@@ -4590,7 +5063,7 @@ os_aio_linux_dispatch(
 		count = array->count[io_ctx_index];
 		os_mutex_exit(array->mutex);
 		if (count == slots_per_segment) {
-			os_aio_linux_dispatch_read_array_submit();
+			os_aio_linux_dispatch_array_submit(array);
 		}
 		return (TRUE);
 	}
@@ -4670,6 +5143,7 @@ os_aio_func(
 	ulint		dummy_type;
 #endif /* WIN_ASYNC_IO */
 	ulint		wake_later;
+	bool		page_compression;
 
 	ut_ad(file);
 	ut_ad(buf);
@@ -4684,6 +5158,11 @@ os_aio_func(
 	wake_later = mode & OS_AIO_SIMULATED_WAKE_LATER;
 	mode = mode & (~OS_AIO_SIMULATED_WAKE_LATER);
 
+	page_compression = mode & OS_AIO_PAGE_COMPRESSION;
+	mode = mode & (~OS_AIO_PAGE_COMPRESSION);
+
+	ut_ad(!page_compression || n == UNIV_PAGE_SIZE);
+
 	if (mode == OS_AIO_SYNC
 #ifdef WIN_ASYNC_IO
 	    && !srv_use_native_aio
@@ -4703,12 +5182,26 @@ os_aio_func(
 		and os_file_write_func() */
 
 		if (type == OS_FILE_READ) {
-			return(os_file_read_func(file, buf, offset, n));
+			if (!os_file_read_func(file, buf, offset, n)) {
+				return(FALSE);
+			}
+
+			if (page_compression) {
+				os_file_page_decompress(
+					static_cast<byte*>(buf), NULL);
+			}
+
+			return(TRUE);
 		}
 
 		ut_ad(!srv_read_only_mode);
 		ut_a(type == OS_FILE_WRITE);
 
+		if (page_compression) {
+			return(os_file_write_page(name, file, buf, offset,
+						  NULL));
+		}
+
 		return(os_file_write_func(name, file, buf, offset, n));
 	}
 
@@ -4755,7 +5248,7 @@ try_again:
 	}
 
 	slot = os_aio_array_reserve_slot(type, array, message1, message2, file,
-					 name, buf, offset, n);
+					 name, buf, offset, n, page_compression);
 	if (type == OS_FILE_READ) {
 		if (srv_use_native_aio) {
 			os_n_file_reads++;
@@ -4785,7 +5278,12 @@ try_again:
 					&(slot->control));
 
 #elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot, false)) {
+			if (page_compression) {
+				os_aio_linux_compress_slot(slot);
+			}
+
+			if (!os_aio_linux_dispatch(array, slot,
+						   should_buffer)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -5074,6 +5572,12 @@ retry:
 	ret = io_getevents(io_ctx, 1, seg_size, events, &timeout);
 
 	if (ret > 0) {
+		os_aio_slot_t**	done = &array->done[start_pos];
+
+		/* Mark the whole batch completed at once. The error
+		handling will be done in the calling function. */
+		os_mutex_enter(array->mutex);
+
 		for (i = 0; i < ret; i++) {
 			os_aio_slot_t*	slot;
 			struct iocb*	control;
@@ -5101,14 +5605,16 @@ retry:
 			/* We have not overstepped to next segment. */
 			ut_a(slot->pos < end_pos);
 
-			/* Mark this request as completed. The error handling
-			will be done in the calling function. */
-			os_mutex_enter(array->mutex);
 			slot->n_bytes = events[i].res;
 			slot->ret = events[i].res2;
 			slot->io_already_done = TRUE;
-			os_mutex_exit(array->mutex);
+
+			ut_a(array->n_done[segment] < seg_size);
+			done[array->n_done[segment]++] = slot;
 		}
+
+		os_mutex_exit(array->mutex);
+
 		return;
 	}
 
@@ -5180,23 +5686,21 @@ os_aio_linux_handle(
 	segment = os_aio_get_array_and_local_segment(&array, global_seg);
 	n = array->n_slots / array->n_segments;
 
-	/* Loop until we have found a completed request. */
+	/* Loop until we have found a completed request. Only this thread
+	collects the completed requests of the segment, so the queue of
+	them needs no latching. */
 	for (;;) {
-		ibool	any_reserved = FALSE;
-		os_mutex_enter(array->mutex);
-		for (i = 0; i < n; ++i) {
-			slot = os_aio_array_get_nth_slot(
-				array, i + segment * n);
-			if (!slot->reserved) {
-				continue;
-			} else if (slot->io_already_done) {
-				/* Something for us to work on. */
-				goto found;
-			} else {
-				any_reserved = TRUE;
-			}
+		ibool	any_reserved;
+
+		if (array->n_done[segment] > 0) {
+			i = --array->n_done[segment];
+			slot = array->done[segment * n + i];
+			/* Something for us to work on. */
+			goto found;
 		}
 
+		os_mutex_enter(array->mutex);
+		any_reserved = array->n_free[segment] < n;
 		os_mutex_exit(array->mutex);
 
 		/* There is no completed request.
@@ -5220,9 +5724,8 @@ os_aio_linux_handle(
 
 found:
 	/* Note that it may be that there are more then one completed
-	IO requests. We process them one at a time. We may have a case
-	here to improve the performance slightly by dealing with all
-	requests in one sweep. */
+	IO requests. They stay queued for the following calls, which
+	return them without waiting. */
 	srv_set_io_thread_op_info(global_seg,
 				"processing completed aio requests");
 
@@ -5232,6 +5735,7 @@ found:
 	ut_ad(slot != NULL);
 	ut_ad(slot->reserved);
 	ut_ad(slot->io_already_done);
+	ut_a(slot->pos / n == segment);
 
 	*message1 = slot->message1;
 	*message2 = slot->message2;
@@ -5256,7 +5760,17 @@ found:
 		ret = FALSE;
 	}
 
-	os_mutex_exit(array->mutex);
+	/* No other thread uses the slot until it is freed. */
+	if (ret && slot->page_compression) {
+		if (slot->type == OS_FILE_READ) {
+			os_file_page_decompress(
+				slot->buf, os_aio_slot_get_page_buf(slot));
+		} else if (slot->len < UNIV_PAGE_SIZE) {
+			os_file_punch_hole(slot->file,
+					   slot->offset + slot->len,
+					   UNIV_PAGE_SIZE - slot->len);
+		}
+	}
 
 	os_aio_array_free_slot(array, slot);
 
@@ -5456,7 +5970,9 @@ consecutive_loop:
 		    && slot != aio_slot
 		    && slot->offset == aio_slot->offset + aio_slot->len
 		    && slot->type == aio_slot->type
-		    && slot->file == aio_slot->file) {
+		    && slot->file == aio_slot->file
+		    && !os_aio_simulated_compress(aio_slot)
+		    && !os_aio_simulated_compress(slot)) {
 
 			/* Found a consecutive i/o request */
 
@@ -5525,9 +6041,17 @@ consecutive_loop:
 	/* Do the i/o with ordinary, synchronous i/o functions: */
 	if (aio_slot->type == OS_FILE_WRITE) {
 		ut_ad(!srv_read_only_mode);
-		ret = os_file_write(
-			aio_slot->name, aio_slot->file, combined_buf,
-			aio_slot->offset, total_len);
+
+		if (n_consecutive == 1 && aio_slot->page_compression) {
+			ret = os_file_write_page(
+				aio_slot->name, aio_slot->file, combined_buf,
+				aio_slot->offset,
+				os_aio_slot_get_page_buf(aio_slot));
+		} else {
+			ret = os_file_write(
+				aio_slot->name, aio_slot->file, combined_buf,
+				aio_slot->offset, total_len);
+		}
 	} else {
 		ret = os_file_read(
 			aio_slot->file, combined_buf,
@@ -5553,6 +6077,18 @@ consecutive_loop:
 		ut_free(combined_buf2);
 	}
 
+	if (aio_slot->type == OS_FILE_READ) {
+		for (ulint i = 0; i < n_consecutive; i++) {
+			os_aio_slot_t*	slot = consecutive_ios[i];
+
+			if (slot->page_compression) {
+				os_file_page_decompress(
+					slot->buf,
+					os_aio_slot_get_page_buf(slot));
+			}
+		}
+	}
+
 	os_mutex_enter(array->mutex);
 
 	/* Mark the i/os done in slots */
@@ -5740,6 +6276,45 @@ os_aio_print_array(
 	os_mutex_exit(array->mutex);
 }
 
+/**********************************************************************//**
+Prints the latency histogram of an aio array: the number of completed
+i/os by the upper bound of their latency in microseconds. Empty buckets
+are skipped. */
+static
+void
+os_aio_print_latency(
+/*=================*/
+	FILE*		file,	/*!< in: file where to print */
+	const char*	name,	/*!< in: name of the array */
+	os_aio_array_t*	array)	/*!< in: aio array to print */
+{
+	ulint	latency[OS_AIO_LATENCY_N_BUCKETS];
+
+	os_mutex_enter(array->mutex);
+	memcpy(latency, array->latency, sizeof(latency));
+	os_mutex_exit(array->mutex);
+
+	fprintf(file, "%s latency (us):", name);
+
+	for (ulint i = 0; i < OS_AIO_LATENCY_N_BUCKETS; i++) {
+		if (latency[i] == 0) {
+			continue;
+		}
+
+		if (i < OS_AIO_LATENCY_N_BUCKETS - 1) {
+			fprintf(file, " <=%lu:%lu",
+				(ulong) OS_AIO_LATENCY_MIN_US << i,
+				(ulong) latency[i]);
+		} else {
+			fprintf(file, " >%lu:%lu",
+				(ulong) OS_AIO_LATENCY_MIN_US << (i - 1),
+				(ulong) latency[i]);
+		}
+	}
+
+	putc('\n', file);
+}
+
 /**********************************************************************//**
 Prints info of the aio arrays. */
 UNIV_INTERN
@@ -5792,6 +6367,21 @@ os_aio_print(
 	}
 
 	putc('\n', file);
+
+	os_aio_print_latency(file, "Normal aio read", os_aio_read_array);
+
+	if (os_aio_write_array != 0) {
+		os_aio_print_latency(file, "Normal aio write",
+				     os_aio_write_array);
+	}
+
+	if (os_aio_ibuf_array != 0) {
+		os_aio_print_latency(file, "Ibuf aio read", os_aio_ibuf_array);
+	}
+
+	if (os_aio_log_array != 0) {
+		os_aio_print_latency(file, "Log aio", os_aio_log_array);
+	}
 	current_time = ut_time();
 	time_elapsed = 0.001 + difftime(current_time, os_last_printout);
 
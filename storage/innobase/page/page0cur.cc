@@ -1262,7 +1262,7 @@ page_cur_insert_rec_zip(
 	    || reorg_before_insert) {
 		/* The values can change dynamically. */
 		bool	log_compressed	= page_zip_log_pages;
-		ulint	level		= page_zip_level;
+		ulint	level		= page_zip_level_get();
 #ifdef UNIV_DEBUG
 		rec_t*	cursor_rec	= page_cur_get_rec(cursor);
 #endif /* UNIV_DEBUG */
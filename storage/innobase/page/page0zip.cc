@@ -74,6 +74,9 @@ UNIV_INTERN mysql_pfs_key_t		page_zip_stat_per_index_mutex_key;
 /* Compression level to be used by zlib. Settable by user. */
 UNIV_INTERN uint	page_zip_level = DEFAULT_COMPRESSION_LEVEL;
 
+/* Compression strategy to be used by zlib. Settable by user. */
+UNIV_INTERN ulong	page_zip_strategy = PAGE_ZIP_STRATEGY_DEFAULT;
+
 /* Whether or not to log compressed page images to avoid possible
 compression algorithm changes in zlib. */
 UNIV_INTERN my_bool	page_zip_log_pages = true;
@@ -1206,11 +1209,13 @@ page_zip_compress(
 				m_start, m_end, m_nonempty */
 	const page_t*	page,	/*!< in: uncompressed page */
 	dict_index_t*	index,	/*!< in: index of the B-tree node */
-	ulint		level,	/*!< in: compression level */
+	ulint		level,	/*!< in: compression level and strategy,
+				see page_zip_level_get() */
 	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
 {
 	z_stream	c_stream;
 	int		err;
+	int		strategy;
 	ulint		n_fields;/* number of index fields needed */
 	byte*		fields;	/*!< index field information */
 	byte*		buf;	/*!< compressed payload of the page */
@@ -1330,9 +1335,26 @@ page_zip_compress(
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, static_cast<int>(level),
+	switch (level >> PAGE_ZIP_STRATEGY_SHIFT) {
+	case PAGE_ZIP_STRATEGY_FILTERED:
+		strategy = Z_FILTERED;
+		break;
+	case PAGE_ZIP_STRATEGY_HUFFMAN_ONLY:
+		strategy = Z_HUFFMAN_ONLY;
+		break;
+	case PAGE_ZIP_STRATEGY_RLE:
+		strategy = Z_RLE;
+		break;
+	default:
+		ut_ad(level >> PAGE_ZIP_STRATEGY_SHIFT
+		      == PAGE_ZIP_STRATEGY_DEFAULT);
+		strategy = Z_DEFAULT_STRATEGY;
+	}
+
+	err = deflateInit2(&c_stream,
+			   static_cast<int>(level & PAGE_ZIP_LEVEL_MASK),
 			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
-			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+			   MAX_MEM_LEVEL, strategy);
 	ut_a(err == Z_OK);
 
 	c_stream.next_out = buf;
@@ -4652,7 +4674,8 @@ page_zip_reorganize(
 	/* Restore logging. */
 	mtr_set_log_mode(mtr, log_mode);
 
-	if (!page_zip_compress(page_zip, page, index, page_zip_level, mtr)) {
+	if (!page_zip_compress(page_zip, page, index,
+			       page_zip_level_get(), mtr)) {
 
 #ifndef UNIV_HOTBACKUP
 		buf_block_free(temp_block);
@@ -134,12 +134,13 @@ FACT C: Purge does not remove any delete-marked row that is visible
 in any cursor read view.
 
 PROOF: We know that:
- 1: Currently active read views in trx_sys_t::view_list are ordered by
-    read_view_t::low_limit_no in descending order, that is,
-    newest read view first.
+ 1: Purge clones the open read view in trx_sys_t::view_list with the
+    smallest read_view_t::low_limit_no, that is, the oldest read view.
+    Cached views are skipped and cannot be reopened without
+    trx_sys_t::mutex meanwhile; a view being reopened is waited for.
 
- 2: Purge clones the oldest read view and uses that to determine whether there
-    are any active transactions that can see the to be purged records.
+ 2: Purge uses the clone to determine whether there are any active
+    transactions that can see the to be purged records.
 
 Therefore any joining or active transaction will not have a view older
 than the purge view, according to 1.
@@ -174,6 +175,32 @@ The order does not matter. No new transactions can be created and no running
 transaction can commit or rollback (or free views).
 */
 
+/*********************************************************************//**
+Makes sure that the descriptors array of a read view has room for n
+cells. */
+UNIV_INLINE
+void
+read_view_reserve_descr(
+/*====================*/
+	read_view_t*	view,	/*!< in/out: read view */
+	ulint		n)	/*!< in: number of cells in the descriptors array */
+{
+	if (UNIV_UNLIKELY(view->max_descr < n)) {
+
+		/* avoid frequent re-allocations by extending the array to the
+		desired size + 10% */
+		os_atomic_increment_ulint(&srv_read_views_memory,
+					  (n + n / 10 - view->max_descr) *
+					  sizeof(trx_id_t));
+
+		view->max_descr = n + n / 10;
+		view->descriptors = static_cast<trx_id_t*>(
+			ut_realloc(view->descriptors,
+				   view->max_descr *
+				   sizeof *view->descriptors));
+	}
+}
+
 /*********************************************************************//**
 Creates a read view object.
 @return	own: read view struct */
@@ -194,23 +221,10 @@ read_view_create_low(
 		view->descriptors = NULL;
 	}
 
-	if (UNIV_UNLIKELY(view->max_descr < n)) {
-
-		/* avoid frequent re-allocations by extending the array to the
-		desired size + 10% */
-		os_atomic_increment_ulint(&srv_read_views_memory,
-					  (n + n / 10 - view->max_descr) *
-					  sizeof(trx_id_t));
-
-		view->max_descr = n + n / 10;
-		view->descriptors = static_cast<trx_id_t*>(
-			ut_realloc(view->descriptors,
-				   view->max_descr *
-				   sizeof *view->descriptors));
-	}
+	read_view_reserve_descr(view, n);
 
 	view->n_descr = n;
-	view->cached = false;
+	view->state = VIEW_STATE_OPEN;
 
 	return(view);
 }
@@ -244,7 +258,7 @@ read_view_clone(
 
 	clone->descriptors = old_descriptors;
 	clone->max_descr = old_max_descr;
-	clone->cached = false;
+	clone->state = VIEW_STATE_OPEN;
 
 	if (view->n_descr) {
 		memcpy(clone->descriptors, view->descriptors,
@@ -255,33 +269,19 @@ read_view_clone(
 }
 
 /*********************************************************************//**
-Insert the view in the proper order into the trx_sys->view_list. The
-read view list is ordered by read_view_t::low_limit_no in descending order. */
+Adds the view to the trx_sys->view_list. The list is not ordered: cached
+views are reopened in place without trx_sys->mutex, read_view_purge_open()
+scans the whole list for the oldest view. */
 static
 void
 read_view_add(
 /*==========*/
 	read_view_t*	view)		/*!< in: view to add to */
 {
-	read_view_t*	elem;
-	read_view_t*	prev_elem;
-
 	ut_ad(mutex_own(&trx_sys->mutex));
 	ut_ad(read_view_validate(view));
 
-	/* Find the correct slot for insertion. */
-	for (elem = UT_LIST_GET_FIRST(trx_sys->view_list), prev_elem = NULL;
-	     elem != NULL && view->low_limit_no < elem->low_limit_no;
-	     prev_elem = elem, elem = UT_LIST_GET_NEXT(view_list, elem)) {
-		/* No op */
-	}
-
-	if (prev_elem == NULL) {
-		UT_LIST_ADD_FIRST(view_list, trx_sys->view_list, view);
-	} else {
-		UT_LIST_INSERT_AFTER(
-			view_list, trx_sys->view_list, prev_elem, view);
-	}
+	UT_LIST_ADD_FIRST(view_list, trx_sys->view_list, view);
 
 	ut_ad(read_view_list_validate());
 }
@@ -302,17 +302,22 @@ read_view_open_now_low(
 					thread or not */
 {
 	trx_id_t*	descr;
+	trx_id_t	serial_min_no;
 	ulint		i;
+	bool		on_list;
 
 	ut_ad(mutex_own(&trx_sys->mutex));
 
-	if (view && view->cached) {
-		read_view_remove(view, true);
-	}
+	/* This must be read before the descriptors are copied, see
+	trx_sys_t::serial_min_no. */
+	serial_min_no = trx_sys_get_serial_min_no();
 
-	view = read_view_create_low(trx_sys->descr_n_used, view);
+	/* A cached view is still on the list, it is reused in place. */
+	on_list = view != NULL && view->state == VIEW_STATE_CACHED;
 
-	ut_ad(!view->cached);
+	ut_ad(!on_list || !is_purge);
+
+	view = read_view_create_low(trx_sys->descr_n_used, view);
 
 	view->undo_no = 0;
 	view->type = VIEW_NORMAL;
@@ -356,14 +361,8 @@ read_view_open_now_low(
 	still be active, if it is in the middle of its commit! Note that when a
 	transaction starts, we initialize trx->no to IB_ULONGLONG_MAX. */
 
-	if (UT_LIST_GET_LEN(trx_sys->trx_serial_list) > 0) {
-		trx_id_t	trx_no;
-
-		trx_no = UT_LIST_GET_FIRST(trx_sys->trx_serial_list)->no;
-
-		if (trx_no < view->low_limit_no) {
-			view->low_limit_no = trx_no;
-		}
+	if (serial_min_no < view->low_limit_no) {
+		view->low_limit_no = serial_min_no;
 	}
 
 	if (UNIV_LIKELY(view->n_descr > 0)) {
@@ -374,13 +373,103 @@ read_view_open_now_low(
 	}
 
 	/* Purge views are not added to the view list. */
-	if (!is_purge > 0) {
+	if (!is_purge && !on_list) {
 		read_view_add(view);
 	}
 
 	return(view);
 }
 
+/*********************************************************************//**
+Copies the transactions that are active in trx_sys and the trx id and
+trx no limits into a read view without acquiring trx_sys->mutex. The
+copy is retried while a change of them is in progress or has completed
+in the meantime, see trx_sys_t::snapshot_version.
+@return	true on success, false if trx_sys kept changing */
+static
+bool
+read_view_snapshot_lock_free(
+/*=========================*/
+	trx_id_t	cr_trx_id,	/*!< in: trx_id of creating
+					transaction */
+	read_view_t*	view)		/*!< in/out: read view being opened */
+{
+	ut_ad(view->state == VIEW_STATE_OPENING);
+
+	for (ulint i = 0; i <= srv_n_spin_wait_rounds; i++) {
+		const volatile trx_id_t*	descr;
+		ulint				version;
+		ulint				n_used;
+		ulint				n;
+		trx_id_t			low_limit_id;
+		trx_id_t			low_limit_no;
+
+		/* This must be read before the descriptors are copied,
+		see trx_sys_t::serial_min_no. */
+		low_limit_no = trx_sys_get_serial_min_no();
+
+		version = trx_sys->snapshot_version;
+
+		if (version & 1) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+			continue;
+		}
+
+		os_rmb;
+
+		/* trx_reserve_descriptor() publishes a bigger array before
+		the number of used elements grows: read them in the reverse
+		order so that the copy never reads beyond the array. Retired
+		arrays are not freed while the server is running. */
+		n_used = trx_sys->descr_n_used;
+		os_rmb;
+		descr = trx_sys->descriptors;
+
+		read_view_reserve_descr(view, n_used);
+
+		n = 0;
+
+		for (ulint j = 0; j < n_used; j++) {
+			trx_id_t	id = descr[j];
+
+			/* trx_id belong to current trx should be excluded. */
+			if (id != cr_trx_id) {
+				view->descriptors[n++] = id;
+			}
+		}
+
+		low_limit_id = *(const volatile trx_id_t*)
+			&trx_sys->max_trx_id;
+
+		os_rmb;
+
+		if (trx_sys->snapshot_version != version) {
+			continue;
+		}
+
+		view->n_descr = n;
+		view->undo_no = 0;
+		view->type = VIEW_NORMAL;
+		view->creator_trx_id = cr_trx_id;
+		view->low_limit_id = low_limit_id;
+
+		/* A transaction in the middle of its commit has a trx
+		number < max_trx_id, see read_view_open_now_low(). */
+		view->low_limit_no = ut_min(low_limit_no, low_limit_id);
+
+		if (UNIV_LIKELY(n > 0)) {
+			/* The first active transaction has the smallest id: */
+			view->up_limit_id = view->descriptors[0];
+		} else {
+			view->up_limit_id = low_limit_id;
+		}
+
+		return(true);
+	}
+
+	return(false);
+}
+
 /*********************************************************************//**
 Opens a read view where exactly the transactions serialized before this
 point in time are seen in the view.
@@ -394,18 +483,27 @@ read_view_open_now(
 	read_view_t*&	view)		/*!< in/out: pre-allocated view array or
 					NULL if a new one needs to be created */
 {
-	/* Check if we can use the cached read view. */
-	if (view && view->cached
-	    && (cr_trx_id == 0) /* this is a read only transaction */
-	    && view->n_descr == 0) { /* no rw transaction when it's created  */
-		/* TODO: this can be optimized further. */
-		view->cached = false;
-
-		if (view->low_limit_id == trx_sys_get_max_trx_id()) {
-			return view;
-		} else {
-			view->cached = true;
+	/* A cached view is still on the trx_sys->view_list: reopen it
+	without acquiring trx_sys->mutex unless purge is looking for the
+	oldest view. The compare-and-swap is a full memory barrier, so that
+	either read_view_purge_open() waits for the view to become open or
+	this thread sees trx_sys->n_view_scans > 0. */
+	if (view != NULL
+	    && view->state == VIEW_STATE_CACHED
+	    && srv_read_view_cache
+	    && os_compare_and_swap_ulint(&view->state, VIEW_STATE_CACHED,
+					 VIEW_STATE_OPENING)) {
+
+		if (trx_sys->n_view_scans == 0
+		    && read_view_snapshot_lock_free(cr_trx_id, view)) {
+
+			os_compare_and_swap_ulint(&view->state,
+						  VIEW_STATE_OPENING,
+						  VIEW_STATE_OPEN);
+			return(view);
 		}
+
+		view->state = VIEW_STATE_CACHED;
 	}
 
 	mutex_enter(&trx_sys->mutex);
@@ -441,17 +539,43 @@ read_view_purge_open(
 
 	mutex_enter(&trx_sys->mutex);
 
-	oldest_view = UT_LIST_GET_LAST(trx_sys->view_list);
+	/* Keep the cached views from being reopened without the mutex
+	until the oldest view has been cloned. */
+	os_atomic_increment_ulint(&trx_sys->n_view_scans, 1);
+
+	oldest_view = NULL;
 
-	while (oldest_view && oldest_view->cached) {
-		/* skip the read view that's marked cached. */
-		oldest_view = UT_LIST_GET_PREV(view_list, oldest_view);
+	for (view = UT_LIST_GET_FIRST(trx_sys->view_list);
+	     view != NULL;
+	     view = UT_LIST_GET_NEXT(view_list, view)) {
+
+		ulint	state;
+
+		/* A view being reopened will be open shortly; its owner
+		does not need trx_sys->mutex for that. */
+		while ((state = view->state) == VIEW_STATE_OPENING) {
+			os_thread_yield();
+		}
+
+		if (state == VIEW_STATE_CACHED) {
+			/* skip the read view that's marked cached. */
+			continue;
+		}
+
+		if (oldest_view == NULL
+		    || view->low_limit_no < oldest_view->low_limit_no) {
+			oldest_view = view;
+		}
 	}
 
+	os_rmb;
+
 	if (oldest_view == NULL) {
 
 		view = read_view_open_now_low(0, prebuilt_view, true);
 
+		os_atomic_decrement_ulint(&trx_sys->n_view_scans, 1);
+
 		mutex_exit(&trx_sys->mutex);
 
 		return(view);
@@ -463,6 +587,8 @@ read_view_purge_open(
 
 	ut_ad(read_view_validate(oldest_view));
 
+	os_atomic_decrement_ulint(&trx_sys->n_view_scans, 1);
+
 	mutex_exit(&trx_sys->mutex);
 
 	creator_trx_id = oldest_view->creator_trx_id;
@@ -508,7 +634,7 @@ read_view_purge_open(
 	}
 
 	ut_a(view->up_limit_id <= view->low_limit_id);
-	ut_ad(!view->cached);
+	ut_ad(view->state == VIEW_STATE_OPEN);
 
 	return(view);
 }
@@ -524,17 +650,7 @@ read_view_close_for_mysql(
 {
 	ut_a(trx->global_read_view);
 
-	if (trx->id == 0
-	    && trx->global_read_view
-	    && trx->global_read_view->n_descr == 0) { /* TODO: this can be optimized. */
-		/* Let's cache the read view if this is a read-only
-		transaction. */
-		read_view_remove(trx->global_read_view, false);
-	} else {
-		mutex_enter(&trx_sys->mutex);
-		read_view_remove(trx->global_read_view, true);
-		mutex_exit(&trx_sys->mutex);
-	}
+	read_view_remove(trx->global_read_view, false);
 
 	trx->read_view = NULL;
 	trx->global_read_view = NULL;
@@ -592,9 +708,10 @@ read_view_free(
 		return;
 	}
 
-	if (view->cached) {
+	if (view->state == VIEW_STATE_CACHED) {
 		mutex_enter(&trx_sys->mutex);
-		read_view_remove(view, true);
+		UT_LIST_REMOVE(view_list, trx_sys->view_list, view);
+		ut_ad(read_view_list_validate());
 		mutex_exit(&trx_sys->mutex);
 	}
 
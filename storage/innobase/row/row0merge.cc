@@ -26,6 +26,9 @@ Completed by Sunny Bains and Marko Makela
 
 #include "row0merge.h"
 #include "row0ext.h"
+#include "btr0btr.h"
+#include "fsp0fsp.h"
+#include "ibuf0ibuf.h"
 #include "row0log.h"
 #include "row0ins.h"
 #include "row0sel.h"
@@ -632,9 +635,15 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (!dup->n_dup++
+	    && (dup->reporter == NULL
+		|| os_compare_and_swap_ulint(
+			dup->reporter, 0,
+			reinterpret_cast<ulint>(dup->index)))) {
 		/* Only report the first duplicate record,
-		but count all duplicate records. */
+		but count all duplicate records. When indexes
+		are sorted in parallel, only the first index
+		to find a duplicate may copy it to table. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
 	}
 }
@@ -1796,7 +1805,8 @@ write_buffers:
 			if (buf->n_tuples) {
 				if (dict_index_is_unique(buf->index)) {
 					row_merge_dup_t	dup = {
-						buf->index, table, col_map, 0};
+						buf->index, table, col_map, 0,
+						NULL};
 
 					row_merge_buf_sort(buf, &dup);
 
@@ -2660,6 +2670,716 @@ err_exit:
 	DBUG_RETURN(error);
 }
 
+/** Page of one B-tree level that row_merge_bulk_insert() is appending
+records to */
+struct row_merge_bulk_level_t {
+	ulint		page_no;	/*!< page being filled */
+	buf_block_t*	block;		/*!< page_no, latched in the
+					mini-transaction of the current
+					batch */
+	page_cur_t	cur;		/*!< positioned on the last
+					record of block */
+};
+
+/** State of a bottom-up build of an index from sorted entries. The
+pages of each level are filled from left to right, and the node pointer
+to a page is inserted in the level above when the page is full. The
+inserts of a batch of records are done in one mini-transaction, which
+x-latches the index and the last page of each level. */
+struct row_merge_bulk_t {
+	dict_index_t*	index;		/*!< index being built */
+	trx_id_t	trx_id;		/*!< transaction creating the
+					index */
+	ulint		zip_size;	/*!< compressed page size, or 0 */
+	ulint		fill_limit;	/*!< maximum data size of a
+					leaf page that has records,
+					to leave room for later inserts */
+	ulint		n_levels;	/*!< number of levels built */
+	bool		leaf_full;	/*!< whether a leaf page was
+					completed in the current batch */
+	mtr_t		mtr;		/*!< mini-transaction of the
+					current batch */
+	mem_heap_t*	heap;		/*!< heap for the node pointers
+					and offsets of a batch */
+	ulint*		offsets;	/*!< offsets of inserted records */
+	row_merge_bulk_level_t	levels[BTR_MAX_LEVELS];
+					/*!< last page of each level */
+};
+
+/*********************************************************************//**
+Starts a batch of row_merge_bulk_insert() calls. X-latches the index and
+the last page of each level. */
+static
+void
+row_merge_bulk_batch_start(
+/*=======================*/
+	row_merge_bulk_t*	bulk)	/*!< in/out: bulk load */
+{
+	mtr_start(&bulk->mtr);
+	mtr_x_lock(dict_index_get_lock(bulk->index), &bulk->mtr);
+
+	for (ulint level = 0; level < bulk->n_levels; level++) {
+		row_merge_bulk_level_t*	lvl = &bulk->levels[level];
+		page_t*			page;
+
+		lvl->block = btr_block_get(
+			dict_index_get_space(bulk->index), bulk->zip_size,
+			lvl->page_no, RW_X_LATCH, bulk->index, &bulk->mtr);
+		page = buf_block_get_frame(lvl->block);
+
+		page_cur_position(
+			page_rec_get_prev(page_get_supremum_rec(page)),
+			lvl->block, &lvl->cur);
+	}
+
+	bulk->leaf_full = false;
+}
+
+/*********************************************************************//**
+Commits a batch of row_merge_bulk_insert() calls. */
+static
+void
+row_merge_bulk_batch_commit(
+/*========================*/
+	row_merge_bulk_t*	bulk)	/*!< in/out: bulk load */
+{
+	mtr_commit(&bulk->mtr);
+
+	for (ulint level = 0; level < bulk->n_levels; level++) {
+		bulk->levels[level].block = NULL;
+	}
+
+	bulk->offsets = NULL;
+	mem_heap_empty(bulk->heap);
+}
+
+/*********************************************************************//**
+Allocates and creates the next page of a level, and links it after the
+current last page of the level, if there is one.
+@return DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+row_merge_bulk_page_create(
+/*=======================*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	ulint			level)	/*!< in: B-tree level */
+{
+	row_merge_bulk_level_t*	lvl = &bulk->levels[level];
+	dict_index_t*		index = bulk->index;
+	buf_block_t*		prev_block;
+	buf_block_t*		block;
+	page_zip_des_t*		page_zip;
+	page_t*			page;
+	mtr_t			alloc_mtr;
+	ulint			n_reserved;
+
+	prev_block = level < bulk->n_levels ? lvl->block : NULL;
+
+	/* The page is allocated in a mini-transaction of its own, so
+	that the file space latch is not held until the end of the
+	batch, but it is x-latched and initialized in the batch. */
+	mtr_start(&alloc_mtr);
+
+	if (!fsp_reserve_free_extents(&n_reserved, dict_index_get_space(index),
+				      1, FSP_NORMAL, &alloc_mtr)) {
+		mtr_commit(&alloc_mtr);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	block = btr_page_alloc(index,
+			       prev_block != NULL
+			       ? buf_block_get_page_no(prev_block) + 1 : 0,
+			       FSP_UP, level, &alloc_mtr, &bulk->mtr);
+
+	fil_space_release_free_extents(dict_index_get_space(index),
+				       n_reserved);
+	mtr_commit(&alloc_mtr);
+
+	if (block == NULL) {
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	page = buf_block_get_frame(block);
+	page_zip = buf_block_get_page_zip(block);
+
+	btr_page_create(block, page_zip, index, level, &bulk->mtr);
+	btr_page_set_next(page, page_zip, FIL_NULL, &bulk->mtr);
+
+	if (prev_block != NULL) {
+		btr_page_set_prev(page, page_zip,
+				  buf_block_get_page_no(prev_block),
+				  &bulk->mtr);
+		btr_page_set_next(buf_block_get_frame(prev_block),
+				  buf_block_get_page_zip(prev_block),
+				  buf_block_get_page_no(block), &bulk->mtr);
+	} else {
+		btr_page_set_prev(page, page_zip, FIL_NULL, &bulk->mtr);
+	}
+
+	if (level == 0 && !dict_index_is_clust(index)) {
+		page_update_max_trx_id(block, page_zip, bulk->trx_id,
+				       &bulk->mtr);
+		/* The free bits of a previous use of the page
+		must not be trusted. */
+		ibuf_reset_free_bits(block);
+	}
+
+	lvl->page_no = buf_block_get_page_no(block);
+	lvl->block = block;
+	page_cur_set_before_first(block, &lvl->cur);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Appends a record to the last page of a level. If the record does not fit,
+the node pointer to the full page is inserted in the level above and the
+record is inserted in a new page.
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+row_merge_bulk_insert(
+/*==================*/
+	row_merge_bulk_t*	bulk,	/*!< in/out: bulk load */
+	ulint			level,	/*!< in: B-tree level */
+	dtuple_t*		tuple,	/*!< in: record to append */
+	ulint			n_ext)	/*!< in: number of externally
+					stored columns */
+{
+	row_merge_bulk_level_t*	lvl = &bulk->levels[level];
+	dict_index_t*		index = bulk->index;
+	page_t*			page;
+	rec_t*			rec = NULL;
+	dberr_t			error;
+
+	if (level == bulk->n_levels) {
+		if (level == BTR_MAX_LEVELS) {
+			return(DB_CORRUPTION);
+		}
+
+		error = row_merge_bulk_page_create(bulk, level);
+
+		if (error != DB_SUCCESS) {
+			return(error);
+		}
+
+		bulk->n_levels++;
+
+		if (level > 0) {
+			/* This is the node pointer to the leftmost
+			page of the level below. It must be marked
+			as the predefined minimum record, as there is
+			no lower limit to the records in that page. */
+			dtuple_set_info_bits(
+				tuple, dtuple_get_info_bits(tuple)
+				| REC_INFO_MIN_REC_FLAG);
+		}
+	}
+
+	page = buf_block_get_frame(lvl->block);
+
+	if (level > 0 || page_is_empty(page)
+	    || page_get_data_size(page)
+	    + rec_get_converted_size(index, tuple, n_ext)
+	    <= bulk->fill_limit) {
+
+		rec = page_cur_tuple_insert(&lvl->cur, tuple, index,
+					    &bulk->offsets, &bulk->heap,
+					    n_ext, &bulk->mtr);
+	}
+
+	if (rec == NULL) {
+		const rec_t*	first_rec;
+		dtuple_t*	node_ptr;
+
+		if (page_is_empty(page)) {
+			return(DB_TOO_BIG_RECORD);
+		}
+
+		/* The page is full. Point to it from the level
+		above. The node pointer refers to the first record
+		of the page, which stays latched until the end of
+		the batch. */
+		first_rec = page_rec_get_next_const(
+			page_get_infimum_rec(page));
+		node_ptr = dict_index_build_node_ptr(
+			index, first_rec, buf_block_get_page_no(lvl->block),
+			bulk->heap, level);
+
+		error = row_merge_bulk_page_create(bulk, level);
+
+		if (error != DB_SUCCESS) {
+			return(error);
+		}
+
+		error = row_merge_bulk_insert(bulk, level + 1, node_ptr, 0);
+
+		if (error != DB_SUCCESS) {
+			return(error);
+		}
+
+		if (level == 0) {
+			bulk->leaf_full = true;
+		}
+
+		rec = page_cur_tuple_insert(&lvl->cur, tuple, index,
+					    &bulk->offsets, &bulk->heap,
+					    n_ext, &bulk->mtr);
+
+		if (rec == NULL) {
+			return(DB_TOO_BIG_RECORD);
+		}
+	}
+
+	/* page_cur_tuple_insert() does not move the cursor */
+	page_cur_position(rec, lvl->block, &lvl->cur);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Completes a bulk load within the last batch: inserts the node pointers
+to the last page of each level, and moves the records of the single page
+of the top level to the root page, which was created empty with the
+index.
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+row_merge_bulk_finish(
+/*==================*/
+	row_merge_bulk_t*	bulk)	/*!< in/out: bulk load */
+{
+	dict_index_t*	index = bulk->index;
+	buf_block_t*	root_block;
+	buf_block_t*	top_block;
+	ulint		top;
+	dberr_t		error;
+
+	if (bulk->n_levels == 0) {
+		/* No records: the empty root page is the index */
+		return(DB_SUCCESS);
+	}
+
+	/* The number of levels may grow while the node pointers
+	are inserted. */
+	for (ulint level = 0; level + 1 < bulk->n_levels; level++) {
+		buf_block_t*	block = bulk->levels[level].block;
+		const page_t*	page = buf_block_get_frame(block);
+		dtuple_t*	node_ptr;
+
+		node_ptr = dict_index_build_node_ptr(
+			index,
+			page_rec_get_next_const(page_get_infimum_rec(page)),
+			buf_block_get_page_no(block), bulk->heap, level);
+
+		error = row_merge_bulk_insert(bulk, level + 1, node_ptr, 0);
+
+		if (error != DB_SUCCESS) {
+			return(error);
+		}
+	}
+
+	top = bulk->n_levels - 1;
+	top_block = bulk->levels[top].block;
+
+	root_block = btr_block_get(
+		dict_index_get_space(index), bulk->zip_size,
+		dict_index_get_page(index), RW_X_LATCH, index, &bulk->mtr);
+
+	ut_ad(page_is_empty(buf_block_get_frame(root_block)));
+
+	btr_page_set_level(buf_block_get_frame(root_block),
+			   buf_block_get_page_zip(root_block), top,
+			   &bulk->mtr);
+
+	if (!page_copy_rec_list_end(
+		    root_block, top_block,
+		    page_get_infimum_rec(buf_block_get_frame(top_block)),
+		    index, &bulk->mtr)) {
+		/* The records of the top page should always fit in
+		the root page, which has the same size. */
+		return(DB_CORRUPTION);
+	}
+
+	if (top == 0 && !dict_index_is_clust(index)) {
+		ibuf_reset_free_bits(root_block);
+	}
+
+	btr_page_free(index, top_block, &bulk->mtr);
+
+	bulk->levels[top].block = NULL;
+	bulk->n_levels--;
+
+	return(DB_SUCCESS);
+}
+
+/********************************************************************//**
+Reads a sorted file containing index data tuples and builds the index from
+them bottom-up, filling its pages from left to right. This is used instead
+of row_merge_insert_index_tuples() for secondary indexes, which can have no
+externally stored columns and are not accessed by other threads until they
+have been built.
+@return	DB_SUCCESS or error number */
+static MY_ATTRIBUTE((nonnull, warn_unused_result))
+dberr_t
+row_merge_bulk_load(
+/*================*/
+	trx_id_t		trx_id,	/*!< in: transaction identifier */
+	dict_index_t*		index,	/*!< in: index */
+	int			fd,	/*!< in: file descriptor */
+	row_merge_block_t*	block)	/*!< in/out: file buffer */
+{
+	const byte*		b;
+	mem_heap_t*		heap;
+	mem_heap_t*		tuple_heap;
+	dberr_t			error = DB_SUCCESS;
+	ulint			foffs = 0;
+	ulint*			offsets;
+	mrec_buf_t*		buf;
+	row_merge_bulk_t*	bulk;
+	DBUG_ENTER("row_merge_bulk_load");
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(!dict_index_is_clust(index));
+	ut_ad(!(index->type & DICT_FTS));
+	ut_ad(trx_id);
+
+	tuple_heap = mem_heap_create(1000);
+
+	{
+		ulint i	= 1 + REC_OFFS_HEADER_SIZE
+			+ dict_index_get_n_fields(index);
+		heap = mem_heap_create(sizeof *buf + i * sizeof *offsets
+				       + sizeof *bulk);
+		offsets = static_cast<ulint*>(
+			mem_heap_alloc(heap, i * sizeof *offsets));
+		offsets[0] = i;
+		offsets[1] = dict_index_get_n_fields(index);
+	}
+
+	bulk = static_cast<row_merge_bulk_t*>(
+		mem_heap_zalloc(heap, sizeof *bulk));
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->zip_size = dict_table_zip_size(index->table);
+	/* Leave 1/16 of each leaf page free for later inserts */
+	bulk->fill_limit = page_get_free_space_of_empty(
+		dict_table_is_comp(index->table)) / 16 * 15;
+	bulk->heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	b = block;
+
+	if (!row_merge_read(fd, foffs, block)) {
+		error = DB_CORRUPTION;
+		goto func_exit;
+	}
+
+	buf = static_cast<mrec_buf_t*>(mem_heap_alloc(heap, sizeof *buf));
+
+	row_merge_bulk_batch_start(bulk);
+
+	for (;;) {
+		const mrec_t*	mrec;
+		dtuple_t*	dtuple;
+		ulint		n_ext;
+
+		b = row_merge_read_rec(block, buf, b, index,
+				       fd, &foffs, &mrec, offsets);
+		if (UNIV_UNLIKELY(!b)) {
+			/* End of list, or I/O error */
+			if (mrec) {
+				error = DB_CORRUPTION;
+			}
+			break;
+		}
+
+		dtuple = row_rec_to_index_entry_low(
+			mrec, index, offsets, &n_ext, tuple_heap);
+		ut_ad(!n_ext);
+
+		if (dict_index_need_comfort(index)) {
+			ut_ad(!(dtuple_get_info_bits(dtuple)
+				& REC_INFO_REC_COMFORT_FLAG));
+			dtuple_set_info_bits(dtuple,
+				(dtuple_get_info_bits(dtuple)
+				| REC_INFO_REC_COMFORT_FLAG));
+		}
+
+		ut_ad(dtuple_validate(dtuple));
+
+		error = row_merge_bulk_insert(bulk, 0, dtuple, n_ext);
+
+		mem_heap_empty(tuple_heap);
+
+		if (error != DB_SUCCESS) {
+			break;
+		}
+
+		if (bulk->leaf_full) {
+			/* Release the latches once per leaf page,
+			so that the redo log can be checkpointed. */
+			row_merge_bulk_batch_commit(bulk);
+			log_free_check();
+			row_merge_bulk_batch_start(bulk);
+		}
+	}
+
+	if (error == DB_SUCCESS) {
+		error = row_merge_bulk_finish(bulk);
+	}
+
+	row_merge_bulk_batch_commit(bulk);
+
+func_exit:
+	mem_heap_free(bulk->heap);
+	mem_heap_free(tuple_heap);
+	mem_heap_free(heap);
+
+	DBUG_RETURN(error);
+}
+
+/** Indexes of one row_merge_build_indexes() call that are sorted and
+loaded in parallel, after the clustered index has been scanned */
+struct row_merge_sort_work_t {
+	trx_t*			trx;		/*!< transaction */
+	const dict_table_t*	old_table;	/*!< table where rows
+						were read from */
+	dict_index_t**		indexes;	/*!< indexes being created */
+	merge_file_t*		files;		/*!< sort files of indexes */
+	ulint			n_indexes;	/*!< size of indexes[] */
+	struct TABLE*		table;		/*!< MySQL table, for
+						reporting duplicates */
+	const ulint*		col_map;	/*!< mapping of old column
+						numbers to new ones, or NULL */
+	dberr_t*		errors;		/*!< outcome of each index */
+	ulint			next;		/*!< next index to process;
+						incremented atomically */
+	ulint			reporter;	/*!< 0, or the address of the
+						index whose duplicate was
+						copied to table */
+	ulint			n_active;	/*!< number of running
+						row_merge_sort_thread()
+						threads */
+};
+
+/** Resources of one thread sorting and loading indexes */
+struct row_merge_sort_slot_t {
+	row_merge_sort_work_t*	work;		/*!< shared work */
+	row_merge_block_t*	block;		/*!< 3 buffers */
+	ulint			block_size;	/*!< size of block */
+	int			tmpfd;		/*!< temporary file */
+};
+
+/*********************************************************************//**
+Sorts the files of the indexes that are not yet taken by other threads,
+and loads the indexes from them. */
+static
+void
+row_merge_sort_indexes(
+/*===================*/
+	row_merge_sort_slot_t*	slot)	/*!< in/out: thread resources */
+{
+	row_merge_sort_work_t*	work = slot->work;
+
+	for (;;) {
+		ulint		i;
+		dict_index_t*	index;
+		dberr_t		error;
+
+		i = os_atomic_increment_ulint(&work->next, 1) - 1;
+
+		if (i >= work->n_indexes) {
+			break;
+		}
+
+		index = work->indexes[i];
+
+		if ((index->type & DICT_FTS) || work->files[i].fd == -1) {
+			continue;
+		}
+
+		row_merge_dup_t	dup = {
+			index, work->table, work->col_map, 0,
+			&work->reporter};
+
+		error = row_merge_sort(
+			work->trx, &dup, &work->files[i],
+			slot->block, &slot->tmpfd);
+
+		if (error != DB_SUCCESS) {
+			/* Do not load the index. */
+		} else if (dict_index_is_clust(index)) {
+			/* Clustered index records may have
+			externally stored columns, which
+			row_merge_bulk_load() does not handle. */
+			error = row_merge_insert_index_tuples(
+				work->trx->id, index, work->old_table,
+				work->files[i].fd, slot->block);
+		} else {
+			error = row_merge_bulk_load(
+				work->trx->id, index,
+				work->files[i].fd, slot->block);
+		}
+
+		work->errors[i] = error;
+
+		/* Close the temporary file to free up space. */
+		row_merge_file_destroy(&work->files[i]);
+	}
+}
+
+/*********************************************************************//**
+Thread sorting and loading indexes in parallel with the thread that
+scanned the clustered index.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_merge_sort_thread)(
+/*==================================*/
+	void*	arg)	/*!< in: row_merge_sort_slot_t* */
+{
+	row_merge_sort_slot_t*	slot
+		= static_cast<row_merge_sort_slot_t*>(arg);
+
+	row_merge_sort_indexes(slot);
+
+	os_atomic_decrement_ulint(&slot->work->n_active, 1);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Sorts the files of the indexes and loads the indexes from them, in up to
+srv_sort_threads threads, each working on one index at a time. Full-text
+indexes are skipped; they are built by the caller.
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((nonnull(1,2,3,4,7,8,10,11), warn_unused_result))
+dberr_t
+row_merge_sort_and_load(
+/*====================*/
+	trx_t*			trx,		/*!< in: transaction */
+	const dict_table_t*	old_table,	/*!< in: table where rows
+						were read from */
+	dict_index_t**		indexes,	/*!< in: indexes to be
+						created */
+	merge_file_t*		files,		/*!< in/out: sort files */
+	const ulint*		col_map,	/*!< in: mapping of old column
+						numbers to new ones, or NULL */
+	ulint			n_indexes,	/*!< in: size of indexes[] */
+	struct TABLE*		table,		/*!< in/out: MySQL table, for
+						reporting duplicates */
+	row_merge_block_t*	block,		/*!< in/out: 3 buffers */
+	ulint			block_size,	/*!< in: size of block */
+	int*			tmpfd,		/*!< in/out: temporary file */
+	ulint*			err_index)	/*!< out: position of the
+						failed index in indexes[] */
+{
+	row_merge_sort_work_t	work;
+	row_merge_sort_slot_t*	slots;
+	ulint			n_threads = 0;
+	dberr_t			error = DB_SUCCESS;
+	const char*		path = thd_innodb_tmpdir(trx->mysql_thd);
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		if (!(indexes[i]->type & DICT_FTS) && files[i].fd != -1) {
+			n_threads++;
+		}
+	}
+
+	n_threads = ut_max(ut_min(n_threads, srv_sort_threads), 1);
+
+	memset(&work, 0, sizeof work);
+	work.trx = trx;
+	work.old_table = old_table;
+	work.indexes = indexes;
+	work.files = files;
+	work.n_indexes = n_indexes;
+	work.table = table;
+	work.col_map = col_map;
+	work.errors = static_cast<dberr_t*>(
+		mem_alloc(n_indexes * sizeof *work.errors));
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		work.errors[i] = DB_SUCCESS;
+	}
+
+	slots = static_cast<row_merge_sort_slot_t*>(
+		mem_alloc(n_threads * sizeof *slots));
+
+	/* The calling thread works with its own buffers. The
+	buffers of the other threads are allocated here; if
+	that fails, fewer threads are used. */
+	slots[0].work = &work;
+	slots[0].block = block;
+	slots[0].block_size = block_size;
+	slots[0].tmpfd = *tmpfd;
+
+	for (ulint i = 1; i < n_threads; i++) {
+		row_merge_sort_slot_t*	slot = &slots[i];
+
+		slot->work = &work;
+		slot->block_size = 3 * srv_sort_buf_size;
+		slot->block = static_cast<row_merge_block_t*>(
+			os_mem_alloc_large(&slot->block_size));
+
+		if (slot->block == NULL) {
+			n_threads = i;
+			break;
+		}
+
+		slot->tmpfd = row_merge_file_create_low(path);
+
+		if (slot->tmpfd < 0) {
+			os_mem_free_large(slot->block, slot->block_size);
+			n_threads = i;
+			break;
+		}
+	}
+
+	work.n_active = n_threads - 1;
+
+	for (ulint i = 1; i < n_threads; i++) {
+		os_thread_create(row_merge_sort_thread, &slots[i], NULL);
+	}
+
+	row_merge_sort_indexes(&slots[0]);
+
+	while (work.n_active != 0) {
+		os_thread_sleep(10000);
+	}
+
+	*tmpfd = slots[0].tmpfd;
+
+	for (ulint i = 1; i < n_threads; i++) {
+		row_merge_file_destroy_low(slots[i].tmpfd);
+		os_mem_free_large(slots[i].block, slots[i].block_size);
+	}
+
+	/* Report the index whose duplicate was copied to table,
+	or else the first failed index. */
+	for (ulint i = 0; i < n_indexes; i++) {
+		if (work.errors[i] == DB_SUCCESS) {
+		} else if (work.reporter == 0) {
+			if (error == DB_SUCCESS) {
+				error = work.errors[i];
+				*err_index = i;
+			}
+		} else if (work.reporter == reinterpret_cast<ulint>(
+				   indexes[i])) {
+			error = work.errors[i];
+			*err_index = i;
+			break;
+		}
+	}
+
+	mem_free(slots);
+	mem_free(work.errors);
+
+	return(error);
+}
+
 /*********************************************************************//**
 Sets an exclusive lock on a table, for the duration of creating indexes.
 @return	error code or DB_SUCCESS */
@@ -3402,6 +4122,7 @@ row_merge_rename_tables_dict(
 	table is in a non-system tablespace where space > 0. */
 	if (err == DB_SUCCESS
 	    && old_table->space != TRX_SYS_SPACE
+	    && !fsp_is_system_temporary(old_table->space)
 	    && !old_table->ibd_file_missing) {
 		/* Make pathname to update SYS_DATAFILES. */
 		char* tmp_path = row_make_new_pathname(old_table, tmp_name);
@@ -3429,7 +4150,8 @@ row_merge_rename_tables_dict(
 
 	/* Update SYS_TABLESPACES and SYS_DATAFILES if the new
 	table is in a non-system tablespace where space > 0. */
-	if (err == DB_SUCCESS && new_table->space != TRX_SYS_SPACE) {
+	if (err == DB_SUCCESS && new_table->space != TRX_SYS_SPACE
+	    && !fsp_is_system_temporary(new_table->space)) {
 		/* Make pathname to update SYS_DATAFILES. */
 		char* old_path = row_make_new_pathname(
 			new_table, old_table->name);
@@ -3696,6 +4418,7 @@ row_merge_build_indexes(
 			dup->table = table;
 			dup->col_map = col_map;
 			dup->n_dup = 0;
+			dup->reporter = NULL;
 
 			row_fts_psort_info_init(
 				trx, dup, new_table, opt_doc_id_size,
@@ -3730,6 +4453,15 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	error = row_merge_sort_and_load(
+		trx, old_table, indexes, merge_files, col_map, n_indexes,
+		table, block, block_size, &tmpfd, &i);
+
+	if (error != DB_SUCCESS) {
+		trx->error_key_num = key_numbers[i];
+		goto func_exit;
+	}
+
 	for (i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -3799,19 +4531,6 @@ wait_again:
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
-		} else if (merge_files[i].fd != -1) {
-			row_merge_dup_t	dup = {
-				sort_idx, table, col_map, 0};
-
-			error = row_merge_sort(
-				trx, &dup, &merge_files[i],
-				block, &tmpfd);
-
-			if (error == DB_SUCCESS) {
-				error = row_merge_insert_index_tuples(
-					trx->id, sort_idx, old_table,
-					merge_files[i].fd, block);
-			}
 		}
 
 		/* Close the temporary file to free up space. */
@@ -291,17 +291,18 @@ column_zip_free(
 }
 
 /**********************************************************************//**
-Configure the zlib allocator to use the given memory heap. */
+Configure the zlib allocator to use the given memory heap, or malloc()
+if it is NULL. */
 UNIV_INTERN
 void
 column_zip_set_alloc(
 /*===============*/
 	void*           stream,  /*!< in/out: zlib stream */
-	mem_heap_t*     heap)   /*!< in: memory heap to use */
+	mem_heap_t*     heap)   /*!< in: memory heap to use, or NULL */
 {
 	z_stream*       strm = static_cast<z_stream*>(stream);
 
-	if (column_zip_mem_use_heap) {
+	if (heap != NULL) {
 		strm->zalloc = column_zip_zalloc;
 		strm->zfree = column_zip_free;
 		strm->opaque = heap;
@@ -312,6 +313,171 @@ column_zip_set_alloc(
 	}
 }
 
+/** zlib streams that a session keeps between the columns that it
+compresses and decompresses. Setting up a deflate() stream allocates and
+clears about 256 kilobytes, so the streams are only reset between
+columns, and set up again only when the stream parameters change. */
+struct row_column_zip_t {
+	z_stream	c_stream;	/*!< deflate() stream */
+	mem_heap_t*	c_heap;		/*!< NULL, or the heap that
+					c_stream allocates from */
+	bool		c_init;		/*!< whether c_stream is set up */
+	int		c_level;	/*!< compression level of c_stream */
+	int		c_strategy;	/*!< strategy of c_stream */
+	int		c_window_bits;	/*!< window bits of c_stream */
+	z_stream	d_stream;	/*!< inflate() stream */
+	mem_heap_t*	d_heap;		/*!< NULL, or the heap that
+					d_stream allocates from */
+	bool		d_init;		/*!< whether d_stream is set up */
+	int		d_window_bits;	/*!< window bits of d_stream */
+};
+
+/*******************************************************************//**
+Gets the zlib streams of a session, creating them if needed.
+@return zlib streams */
+static
+row_column_zip_t*
+row_column_zip_get(
+/*===============*/
+	trx_t*	trx)	/*!< in/out: transaction of the session */
+{
+	if (trx->column_zip == NULL) {
+		trx->column_zip = static_cast<row_column_zip_t*>(
+			mem_zalloc(sizeof *trx->column_zip));
+	}
+
+	return(trx->column_zip);
+}
+
+/*******************************************************************//**
+Gets a deflate() stream of the session for compressing a column. The
+stream is reset if it was set up with the same parameters before.
+@return deflate() stream */
+static
+z_stream*
+row_column_zip_deflate(
+/*===================*/
+	trx_t*	trx,		/*!< in/out: transaction of the session */
+	int	level,		/*!< in: compression level */
+	int	strategy,	/*!< in: compression strategy */
+	int	window_bits)	/*!< in: window bits */
+{
+	row_column_zip_t*	zip = row_column_zip_get(trx);
+	int			err;
+
+	if (zip->c_init) {
+		if (zip->c_level == level
+		    && zip->c_strategy == strategy
+		    && zip->c_window_bits == window_bits
+		    && deflateReset(&zip->c_stream) == Z_OK) {
+
+			return(&zip->c_stream);
+		}
+
+		deflateEnd(&zip->c_stream);
+		zip->c_init = false;
+	}
+
+	if (zip->c_heap != NULL) {
+		mem_heap_free(zip->c_heap);
+		zip->c_heap = NULL;
+	}
+
+	if (column_zip_mem_use_heap) {
+		zip->c_heap = mem_heap_create(UNIV_PAGE_SIZE);
+	}
+
+	column_zip_set_alloc(&zip->c_stream, zip->c_heap);
+
+	err = deflateInit2(&zip->c_stream, level, Z_DEFLATED,
+			   window_bits, DEF_MEM_LEVEL, strategy);
+	ut_a(err == Z_OK);
+
+	zip->c_init = true;
+	zip->c_level = level;
+	zip->c_strategy = strategy;
+	zip->c_window_bits = window_bits;
+
+	return(&zip->c_stream);
+}
+
+/*******************************************************************//**
+Gets an inflate() stream of the session for decompressing a column. The
+stream is reset if it was set up with the same parameters before.
+@return inflate() stream */
+static
+z_stream*
+row_column_zip_inflate(
+/*===================*/
+	trx_t*	trx,		/*!< in/out: transaction of the session */
+	int	window_bits)	/*!< in: window bits */
+{
+	row_column_zip_t*	zip = row_column_zip_get(trx);
+	int			err;
+
+	if (zip->d_init) {
+		if (zip->d_window_bits == window_bits
+		    && inflateReset(&zip->d_stream) == Z_OK) {
+
+			return(&zip->d_stream);
+		}
+
+		inflateEnd(&zip->d_stream);
+		zip->d_init = false;
+	}
+
+	if (zip->d_heap != NULL) {
+		mem_heap_free(zip->d_heap);
+		zip->d_heap = NULL;
+	}
+
+	if (column_zip_mem_use_heap) {
+		zip->d_heap = mem_heap_create(UNIV_PAGE_SIZE);
+	}
+
+	zip->d_stream.next_in = Z_NULL;
+	zip->d_stream.avail_in = 0;
+	column_zip_set_alloc(&zip->d_stream, zip->d_heap);
+
+	err = inflateInit2(&zip->d_stream, window_bits);
+	ut_a(err == Z_OK);
+
+	zip->d_init = true;
+	zip->d_window_bits = window_bits;
+
+	return(&zip->d_stream);
+}
+
+/*******************************************************************//**
+Frees the zlib streams that a session used for compressed columns. */
+UNIV_INTERN
+void
+row_mysql_column_zip_free(
+/*======================*/
+	trx_t*	trx)	/*!< in/out: transaction of the session */
+{
+	row_column_zip_t*	zip = trx->column_zip;
+
+	if (zip->c_init) {
+		deflateEnd(&zip->c_stream);
+	}
+
+	if (zip->c_heap != NULL) {
+		mem_heap_free(zip->c_heap);
+	}
+
+	if (zip->d_init) {
+		inflateEnd(&zip->d_stream);
+	}
+
+	if (zip->d_heap != NULL) {
+		mem_heap_free(zip->d_heap);
+	}
+
+	mem_free(zip);
+	trx->column_zip = NULL;
+}
+
 /*******************************************************************//**
 Compress column data using zlib
 @return pointer to the compressed data */
@@ -327,7 +493,7 @@ row_compress_column(
 	ulint buf_len = *len+COLUMN_COMPRESS_PREFIX_MAX_LEN;
 	byte* buf;
 	byte* ptr;
-	z_stream        c_stream;
+	z_stream*	c_stream;
 	my_bool wrap = column_zip_zlib_wrap;
 
 	int window_bits = wrap ? MAX_WBITS : -MAX_WBITS;
@@ -338,7 +504,7 @@ row_compress_column(
 			mem_heap_create(max(UNIV_PAGE_SIZE, buf_len));
 	}
 
-	buf = static_cast<byte*>(mem_heap_zalloc(
+	buf = static_cast<byte*>(mem_heap_alloc(
 			   prebuilt->compress_heap,buf_len));
 
 	if (*len < column_zip_threshold ||
@@ -347,26 +513,23 @@ row_compress_column(
 
 	ptr = buf + COLUMN_COMPRESS_HEADER_LEN + lenlen;
 
-	/*init deflate object*/
-	c_stream.next_in = (Bytef*)data;
-	c_stream.avail_in = *len;
-	c_stream.next_out = ptr;
-	c_stream.avail_out = comp_len;
+	/* get the deflate object of the session */
+	c_stream = row_column_zip_deflate(prebuilt->trx, column_zip_level,
+					  column_zip_zlib_strategy,
+					  window_bits);
 
-	column_zip_set_alloc(&c_stream, prebuilt->compress_heap);
+	c_stream->next_in = (Bytef*)data;
+	c_stream->avail_in = *len;
+	c_stream->next_out = ptr;
+	c_stream->avail_out = comp_len;
 
-	err = deflateInit2(&c_stream, column_zip_level,
-			   Z_DEFLATED, window_bits, DEF_MEM_LEVEL, column_zip_zlib_strategy);
-	ut_a(err == Z_OK);
-
-	err = deflate(&c_stream, Z_FINISH);
+	err = deflate(c_stream, Z_FINISH);
 	if (err != Z_STREAM_END) {
-		deflateEnd(&c_stream);
 		if (err == Z_OK)
 			err = Z_BUF_ERROR;
 	} else {
-		comp_len = c_stream.total_out;
-		err = deflateEnd(&c_stream);
+		comp_len = c_stream->total_out;
+		err = Z_OK;
 	}
 
 	switch(err) {
@@ -430,7 +593,7 @@ row_decompress_column(
 	byte* buf;
 	int err = 0;
 	int window_bits = 0;
-	z_stream d_stream;
+	z_stream* d_stream;
 	srv_column_decompressed++;
 	my_bool is_compress = 0;
 	my_bool wrap = 0;
@@ -479,30 +642,26 @@ row_decompress_column(
 	}
 
 	buf_len = uncomp_len;
-	buf = static_cast<byte*>(mem_heap_zalloc(
+	buf = static_cast<byte*>(mem_heap_alloc(
 				 prebuilt->compress_heap, buf_len));
 
-	/* init d_stream */
-	d_stream.next_in = (Bytef *)data;
-	d_stream.avail_in = comp_len;
-	d_stream.next_out = buf;
-	d_stream.avail_out = buf_len;
-
-	column_zip_set_alloc(&d_stream, prebuilt->compress_heap);
-
+	/* get the inflate object of the session */
 	window_bits = wrap ? MAX_WBITS : -MAX_WBITS;
-	err = inflateInit2(&d_stream, window_bits);
-	ut_a(err == Z_OK);
+	d_stream = row_column_zip_inflate(prebuilt->trx, window_bits);
+
+	d_stream->next_in = (Bytef *)data;
+	d_stream->avail_in = comp_len;
+	d_stream->next_out = buf;
+	d_stream->avail_out = buf_len;
 
-	err = inflate(&d_stream, Z_FINISH);
+	err = inflate(d_stream, Z_FINISH);
 
 	if (err != Z_STREAM_END) {
-		inflateEnd(&d_stream);
-		if (err == Z_BUF_ERROR && d_stream.avail_in == 0)
+		if (err == Z_BUF_ERROR && d_stream->avail_in == 0)
 			err = Z_DATA_ERROR;
 	} else {
-		buf_len = d_stream.total_out;
-		err = inflateEnd(&d_stream);
+		buf_len = d_stream->total_out;
+		err = Z_OK;
 	}
 
 	switch(err) {
@@ -1273,6 +1432,10 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->compress_heap);
 	}
 
+	if (prebuilt->clust_prefetch_heap) {
+		mem_heap_free(prebuilt->clust_prefetch_heap);
+	}
+
 	if (prebuilt->old_vers_heap) {
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
@@ -1468,6 +1631,8 @@ row_update_statistics_if_needed(
 	n_rows = dict_table_get_n_rows(table);
 
 	if (dict_stats_is_persistent_enabled(table)) {
+		table->stat_modified_since_sampling++;
+
 		if (counter > n_rows / 10 /* 10% */
 		    && dict_stats_auto_recalc_is_enabled(table)) {
 
@@ -2682,7 +2847,8 @@ err_exit:
 
 	err = trx->error_state;
 
-	if (table->space != TRX_SYS_SPACE) {
+	if (table->space != TRX_SYS_SPACE
+	    && !fsp_is_system_temporary(table->space)) {
 		ut_a(DICT_TF2_FLAG_IS_SET(table, DICT_TF2_USE_TABLESPACE));
 
 		/* Update SYS_TABLESPACES and SYS_DATAFILES if a new
@@ -2744,6 +2910,7 @@ err_exit:
 		/* We already have .ibd file here. it should be deleted. */
 
 		if (table->space
+		    && !fsp_is_system_temporary(table->space)
 		    && fil_delete_tablespace(
 			    table->space,
 			    BUF_REMOVE_FLUSH_NO_WRITE)
@@ -3418,6 +3585,10 @@ row_discard_tablespace(
 
 		dict_table_change_id_in_cache(table, new_id);
 
+		if (table->fts != NULL && table->fts->cache != NULL) {
+			fts_word_cache_invalidate(table->fts->cache);
+		}
+
 		/* Reset the root page numbers. */
 
 		for (dict_index_t* index = UT_LIST_GET_FIRST(table->indexes);
@@ -4062,6 +4233,10 @@ next_rec:
 			fts_cache_init(table->fts->cache);
 			table->fts->fts_status &= ~TABLE_DICT_LOCKED;
 		}
+
+		if (table->fts != NULL && table->fts->cache != NULL) {
+			fts_word_cache_invalidate(table->fts->cache);
+		}
 	}
 
 	/* Reset auto-increment. */
@@ -4576,6 +4751,12 @@ row_drop_table_for_mysql(
 			space_id = 0;
 		}
 
+		if (fsp_is_system_temporary(space_id)) {
+			/* The index trees were freed above. The shared
+			temporary tablespace stays in place. */
+			space_id = 0;
+		}
+
 		/* We do not allow temporary tables with a remote path. */
 		ut_a(!(is_temp && DICT_TF_HAS_DATA_DIR(table->flags)));
 
@@ -5271,6 +5452,7 @@ row_rename_table_for_mysql(
 	which have space IDs > 0. */
 	if (err == DB_SUCCESS
 	    && table->space != TRX_SYS_SPACE
+	    && !fsp_is_system_temporary(table->space)
 	    && !table->ibd_file_missing) {
 		/* Make a new pathname to update SYS_DATAFILES. */
 		char*	new_path = row_make_new_pathname(table, new_name);
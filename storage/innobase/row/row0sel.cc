@@ -56,6 +56,8 @@ Created 12/19/1997 Heikki Tuuri
 #include "row0mysql.h"
 #include "read0read.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
+#include "ut0sort.h"
 #include "ha_prototypes.h"
 #include "m_string.h" /* for my_sys.h */
 #include "my_sys.h" /* DEBUG_SYNC_C */
@@ -3634,6 +3636,410 @@ row_search_idx_cond_check(
 	return(result);
 }
 
+/********************************************************************//**
+Reads ahead the leaf pages that an ascending range scan is about to visit.
+The leaf page that the cursor is on is looked up in the level above, and
+the pages that the following node pointers point to are requested
+asynchronously, up to trx->read_ahead_depth of them. Nothing is done as
+long as more than half of the pages requested by the previous call are
+still ahead of the cursor, or if they reach the end of the index. The
+caller must not hold any latches. */
+static
+void
+row_sel_read_ahead(
+/*===============*/
+	row_prebuilt_t*		prebuilt,	/*!< in/out: prebuilt struct */
+	const btr_pcur_t*	pcur,		/*!< in: cursor whose position
+						was stored on the leaf page */
+	ulint			page_no)	/*!< in: leaf page the cursor
+						is on */
+{
+	dict_index_t*	index = prebuilt->index;
+	ulint		depth = prebuilt->trx->read_ahead_depth;
+	ulint*		pages = prebuilt->read_ahead_pages;
+	ulint		n_pages = 0;
+	ulint		i;
+	mtr_t		mtr;
+	mem_heap_t*	heap;
+	dtuple_t*	tuple;
+	btr_cur_t	cursor;
+	ulint*		offsets = NULL;
+	const rec_t*	rec;
+
+	ut_ad(depth > 0);
+	ut_ad(depth <= MYSQL_READ_AHEAD_MAX_DEPTH);
+
+	if (pages == NULL) {
+		pages = prebuilt->read_ahead_pages = static_cast<ulint*>(
+			mem_heap_alloc(prebuilt->heap,
+				       (MYSQL_READ_AHEAD_MAX_DEPTH + 1)
+				       * sizeof *pages));
+		prebuilt->n_read_ahead_pages = 0;
+	}
+
+	for (i = 0; i < prebuilt->n_read_ahead_pages; i++) {
+		if (pages[i] == page_no) {
+			if (prebuilt->read_ahead_end
+			    || prebuilt->n_read_ahead_pages - i - 1
+			    > depth / 2) {
+				return;
+			}
+
+			break;
+		}
+	}
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	if (btr_height_get(index, &mtr) == 0) {
+		mtr_commit(&mtr);
+		pages[0] = page_no;
+		prebuilt->n_read_ahead_pages = 1;
+		prebuilt->read_ahead_end = true;
+		return;
+	}
+
+	heap = mem_heap_create(256);
+
+	tuple = dict_index_build_data_tuple(
+		index, pcur->old_rec, pcur->old_n_fields, heap);
+
+	btr_cur_search_to_nth_level(
+		index, 1, tuple, PAGE_CUR_LE,
+		BTR_SEARCH_LEAF | BTR_ALREADY_S_LATCHED,
+		&cursor, 0, __FILE__, __LINE__, &mtr);
+
+	rec = btr_cur_get_rec(&cursor);
+
+	if (page_rec_is_infimum(rec)) {
+		rec = page_rec_get_next_const(rec);
+	}
+
+	/* Collect the child page of the node pointer of the current
+	leaf page, and of the depth node pointers following it, moving
+	to the next page of the level if needed. The index lock
+	prevents the node pointers from changing meanwhile. */
+	prebuilt->read_ahead_end = false;
+
+	while (n_pages <= depth) {
+		if (page_rec_is_supremum(rec)) {
+			const page_t*	page = page_align(rec);
+			ulint		next = btr_page_get_next(page, &mtr);
+			buf_block_t*	block;
+
+			if (next == FIL_NULL) {
+				prebuilt->read_ahead_end = true;
+				break;
+			}
+
+			block = btr_block_get(
+				dict_index_get_space(index),
+				dict_table_zip_size(index->table),
+				next, RW_S_LATCH, index, &mtr);
+
+			rec = page_rec_get_next_const(page_get_infimum_rec(
+				buf_block_get_frame(block)));
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+		pages[n_pages++] = btr_node_ptr_get_child_page_no(
+			rec, offsets);
+
+		rec = page_rec_get_next_const(rec);
+	}
+
+	mtr_commit(&mtr);
+	mem_heap_free(heap);
+
+	prebuilt->n_read_ahead_pages = n_pages;
+
+	/* The first page is the current one; read the pages after it */
+	if (n_pages > 1) {
+		buf_read_ahead_pages(dict_index_get_space(index),
+				     pages + 1, n_pages - 1);
+	}
+}
+
+/*****************************************************************//**
+Compares two clustered index references for sorting them.
+@return 1, 0, -1 if ref1 is greater, equal, less than ref2 */
+static
+int
+row_sel_clust_ref_cmp(
+/*==================*/
+	const dtuple_t*	ref1,	/*!< in: reference */
+	const dtuple_t*	ref2)	/*!< in: reference */
+{
+	return(dtuple_coll_cmp(ref1, ref2));
+}
+
+/*****************************************************************//**
+Sorts clustered index references in key order. */
+static
+void
+row_sel_clust_ref_sort(
+/*===================*/
+	dtuple_t**	refs,	/*!< in/out: references to sort */
+	dtuple_t**	aux,	/*!< in/out: temp storage */
+	ulint		low,	/*!< in: lowest index (inclusive) */
+	ulint		high)	/*!< in: highest index (non-inclusive) */
+{
+	UT_SORT_FUNCTION_BODY(row_sel_clust_ref_sort, refs, aux, low, high,
+			      row_sel_clust_ref_cmp);
+}
+
+/********************************************************************//**
+Reads ahead the clustered index leaf pages of a batch of references. The
+references are sorted, so that each one is looked up in the level above
+the leaves by moving right from the node pointer of the previous one;
+the tree is only searched again when a reference is past the end of the
+current page. The leaf pages are requested asynchronously in ascending
+page number order. The caller must not hold any latches. */
+static
+void
+row_sel_prefetch_clust_pages(
+/*=========================*/
+	dict_index_t*	clust_index,	/*!< in: clustered index */
+	dtuple_t**	refs,		/*!< in/out: references; sorted
+					on return */
+	ulint		n_refs,		/*!< in: number of references */
+	mem_heap_t*	heap)		/*!< in: memory heap */
+{
+	dtuple_t**	aux;
+	ulint*		pages;
+	ulint*		aux_pages;
+	ulint		n_pages = 0;
+	ulint		i;
+	ulint		j;
+	mtr_t		mtr;
+	btr_cur_t	cursor;
+	const rec_t*	rec = NULL;
+	ulint*		offsets = NULL;
+
+	ut_ad(n_refs > 0);
+
+	aux = static_cast<dtuple_t**>(
+		mem_heap_alloc(heap, n_refs * sizeof *aux));
+	pages = static_cast<ulint*>(
+		mem_heap_alloc(heap, 2 * n_refs * sizeof *pages));
+	aux_pages = pages + n_refs;
+
+	row_sel_clust_ref_sort(refs, aux, 0, n_refs);
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(clust_index), &mtr);
+
+	if (btr_height_get(clust_index, &mtr) == 0) {
+		/* The only leaf page is the root, which was just
+		accessed */
+		mtr_commit(&mtr);
+		return;
+	}
+
+	/* The index lock prevents the node pointers from changing
+	while we look them up. */
+	for (i = 0; i < n_refs; i++) {
+		while (rec != NULL) {
+			const rec_t*	next = page_rec_get_next_const(rec);
+
+			if (page_rec_is_supremum(next)) {
+				/* The reference may belong to a node
+				pointer of a following page */
+				rec = NULL;
+				break;
+			}
+
+			offsets = rec_get_offsets(next, clust_index, offsets,
+						  ULINT_UNDEFINED, &heap);
+
+			if (cmp_dtuple_rec(refs[i], next, offsets) < 0) {
+				break;
+			}
+
+			rec = next;
+		}
+
+		if (rec == NULL) {
+			btr_cur_search_to_nth_level(
+				clust_index, 1, refs[i], PAGE_CUR_LE,
+				BTR_SEARCH_LEAF | BTR_ALREADY_S_LATCHED,
+				&cursor, 0, __FILE__, __LINE__, &mtr);
+
+			rec = btr_cur_get_rec(&cursor);
+
+			if (page_rec_is_infimum(rec)) {
+				rec = page_rec_get_next_const(rec);
+			}
+		}
+
+		offsets = rec_get_offsets(rec, clust_index, offsets,
+					  ULINT_UNDEFINED, &heap);
+		pages[n_pages++] = btr_node_ptr_get_child_page_no(
+			rec, offsets);
+	}
+
+	mtr_commit(&mtr);
+
+	/* Request each page once, in ascending order so that reads of
+	adjacent pages can be merged */
+	ut_ulint_sort(pages, aux_pages, 0, n_pages);
+
+	for (i = 1, j = 0; i < n_pages; i++) {
+		if (pages[i] != pages[j]) {
+			pages[++j] = pages[i];
+		}
+	}
+
+	buf_read_ahead_pages(dict_index_get_space(clust_index),
+			     pages, j + 1);
+}
+
+/********************************************************************//**
+Prefetches the clustered index pages that an ascending scan of a secondary
+index is about to look up. The references of the records that follow the
+cursor in the scanned range, up to trx->clust_prefetch_rows of them, are
+collected from the secondary index, and their clustered index leaf pages
+are read ahead with row_sel_prefetch_clust_pages(). The rows are still
+returned in secondary index order. Nothing is done until the cursor
+reaches the middle of the records collected by the previous call, or if
+they reach the end of the range. Ranges that are not a prefix match are
+only bounded by the number of records. The caller must not hold any
+latches. */
+static
+void
+row_sel_prefetch_clust(
+/*===================*/
+	row_prebuilt_t*		prebuilt,	/*!< in/out: prebuilt struct */
+	btr_pcur_t*		pcur,		/*!< in: cursor whose position
+						was stored on a user record
+						of the secondary index */
+	const dtuple_t*		search_tuple,	/*!< in: search tuple */
+	ulint			match_mode)	/*!< in: 0, ROW_SEL_EXACT or
+						ROW_SEL_EXACT_PREFIX */
+{
+	dict_index_t*	index = prebuilt->index;
+	ulint		n_rows = prebuilt->trx->clust_prefetch_rows;
+	ulint		n_recs = 0;
+	ulint		n_refs = 0;
+	ibool		comp = dict_table_is_comp(index->table);
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets = offsets_;
+	dtuple_t**	refs;
+	btr_pcur_t	cursor;
+	mtr_t		mtr;
+
+	rec_offs_init(offsets_);
+
+	ut_ad(n_rows > 0);
+	ut_ad(n_rows <= MYSQL_CLUST_PREFETCH_MAX_ROWS);
+	ut_ad(!dict_index_is_clust(index));
+
+	if (prebuilt->clust_prefetch_end) {
+		return;
+	}
+
+	if (prebuilt->clust_prefetch_mid != NULL) {
+		int	cmp;
+
+		offsets = rec_get_offsets(pcur->old_rec, index, offsets,
+					  pcur->old_n_fields, &heap);
+		cmp = cmp_dtuple_rec(prebuilt->clust_prefetch_mid,
+				     pcur->old_rec, offsets);
+
+		if (UNIV_LIKELY_NULL(heap)) {
+			mem_heap_free(heap);
+			heap = NULL;
+			offsets = offsets_;
+		}
+
+		if (cmp > 0) {
+			return;
+		}
+	}
+
+	if (prebuilt->clust_prefetch_heap == NULL) {
+		prebuilt->clust_prefetch_heap = mem_heap_create(1024);
+	} else {
+		mem_heap_empty(prebuilt->clust_prefetch_heap);
+	}
+
+	prebuilt->clust_prefetch_mid = NULL;
+
+	refs = static_cast<dtuple_t**>(
+		mem_heap_alloc(prebuilt->clust_prefetch_heap,
+			       n_rows * sizeof *refs));
+
+	btr_pcur_init(&cursor);
+	btr_pcur_copy_stored_position(&cursor, pcur);
+
+	mtr_start(&mtr);
+
+	btr_pcur_restore_position(BTR_SEARCH_LEAF, &cursor, &mtr);
+
+	while (n_recs < n_rows) {
+		const rec_t*	rec;
+
+		if (!btr_pcur_move_to_next(&cursor, &mtr)) {
+			prebuilt->clust_prefetch_end = true;
+			break;
+		}
+
+		rec = btr_pcur_get_rec(&cursor);
+
+		if (!page_rec_is_user_rec(rec)) {
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+
+		if (match_mode == ROW_SEL_EXACT
+		    ? cmp_dtuple_rec(search_tuple, rec, offsets) != 0
+		    : match_mode == ROW_SEL_EXACT_PREFIX
+		    && !cmp_dtuple_is_prefix_of_rec(search_tuple, rec,
+						     offsets)) {
+			prebuilt->clust_prefetch_end = true;
+			break;
+		}
+
+		if (!rec_get_deleted_flag(rec, comp)) {
+			refs[n_refs++] = row_build_row_ref(
+				ROW_COPY_DATA, index, rec,
+				prebuilt->clust_prefetch_heap);
+		}
+
+		if (++n_recs == (n_rows + 1) / 2) {
+			rec_t*	copy = rec_copy(
+				mem_heap_alloc(prebuilt->clust_prefetch_heap,
+					       rec_offs_size(offsets)),
+				rec, offsets);
+
+			prebuilt->clust_prefetch_mid =
+				dict_index_build_data_tuple(
+					index, copy,
+					dict_index_get_n_unique_in_tree(index),
+					prebuilt->clust_prefetch_heap);
+		}
+	}
+
+	btr_pcur_commit_specify_mtr(&cursor, &mtr);
+	btr_pcur_close(&cursor);
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	if (n_refs > 0) {
+		row_sel_prefetch_clust_pages(
+			dict_table_get_first_index(index->table),
+			refs, n_refs, prebuilt->clust_prefetch_heap);
+	}
+}
+
 /********************************************************************//**
 Searches for rows in the database. This is used in the interface to
 MySQL. This function opens a cursor, and also implements fetch next
@@ -3678,6 +4084,7 @@ row_search_for_mysql(
 	ibool		unique_search			= FALSE;
 	ibool		mtr_has_extra_clust_latch	= FALSE;
 	ibool		moves_up			= FALSE;
+	ulint		read_ahead_page_no		= FIL_NULL;
 	ibool		set_also_gap_locks		= TRUE;
 	/* if the query is a plain locking SELECT, and the isolation level
 	is <= TRX_ISO_READ_COMMITTED, then this is set to FALSE */
@@ -3787,6 +4194,9 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->n_read_ahead_pages = 0;
+		prebuilt->clust_prefetch_mid = NULL;
+		prebuilt->clust_prefetch_end = false;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -5115,8 +5525,44 @@ normal_return:
 	/*-------------------------------------------------------------*/
 	que_thr_stop_for_mysql_no_error(thr, trx);
 
+	if (trx->read_ahead_depth > 0
+	    && err == DB_SUCCESS
+	    && moves_up
+	    && !unique_search
+	    && !dict_index_is_ibuf(index)
+	    && pcur->old_stored == BTR_PCUR_OLD_STORED
+	    && pcur->pos_state == BTR_PCUR_IS_POSITIONED
+	    && pcur->block_when_stored == btr_pcur_get_block(pcur)
+	    && (pcur->rel_pos == BTR_PCUR_ON
+		|| pcur->rel_pos == BTR_PCUR_BEFORE
+		|| pcur->rel_pos == BTR_PCUR_AFTER)) {
+
+		/* Read ahead once the mini-transaction has
+		released the leaf page. */
+		read_ahead_page_no = buf_block_get_page_no(
+			btr_pcur_get_block(pcur));
+	}
+
 	mtr_commit(&mtr);
 
+	if (read_ahead_page_no != FIL_NULL) {
+		row_sel_read_ahead(prebuilt, pcur, read_ahead_page_no);
+	}
+
+	if (trx->clust_prefetch_rows > 0
+	    && err == DB_SUCCESS
+	    && index != clust_index
+	    && prebuilt->need_to_access_clustered
+	    && moves_up
+	    && !unique_search
+	    && !dict_index_is_ibuf(index)
+	    && pcur->old_stored == BTR_PCUR_OLD_STORED
+	    && pcur->rel_pos == BTR_PCUR_ON) {
+
+		row_sel_prefetch_clust(prebuilt, pcur, search_tuple,
+				       match_mode);
+	}
+
 	if (prebuilt->idx_cond != 0) {
 
 		/* When ICP is active we don't write to the MySQL buffer
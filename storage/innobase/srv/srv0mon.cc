@@ -108,6 +108,28 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DEFAULT_ON,
 	 MONITOR_DEFAULT_START, MONITOR_TIMEOUT},
 
+	{"lock_deadlock_checks", "lock",
+	 "Number of searches of the waits-for graph for deadlocks",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECKS},
+
+	{"lock_deadlock_check_steps", "lock",
+	 "Number of waiting transactions visited by deadlock searches",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECK_STEPS},
+
+	{"lock_deadlock_checks_too_deep", "lock",
+	 "Number of deadlock searches aborted because the waits-for"
+	 " graph was too deep or too long",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECK_TOO_DEEP},
+
+	{"lock_deadlock_checks_deferred", "lock",
+	 "Number of lock waits enqueued without a deadlock check"
+	 " (innodb_deadlock_detect=OFF)",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_DEADLOCK_CHECK_DEFERRED},
+
 	{"lock_rec_lock_waits", "lock",
 	 "Number of times enqueued into record lock wait queue",
 	 MONITOR_NONE,
@@ -186,6 +208,23 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_EXISTING | MONITOR_DISPLAY_CURRENT | MONITOR_DEFAULT_ON),
 	 MONITOR_DEFAULT_START, MONITOR_OVLD_LOCK_AVG_WAIT_TIME},
 
+	{"lock_sys_latch_waits", "lock",
+	 "Number of times the lock system latch had to be waited for",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOCK_SYS_LATCH_WAITS},
+
+	{"lock_rec_shard_waits", "lock",
+	 "Number of times a record lock hash shard mutex had to be"
+	 " waited for",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LOCK_REC_SHARD_WAITS},
+
+	{"lock_rec_lock_requests_shared", "lock",
+	 "Number of record lock requests handled with the lock system"
+	 " latch in shared mode",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_RECLOCK_REQ_SHARED},
+
 	/* ========== Counters for Buffer Manager and I/O ========== */
 	{"module_buffer", "buffer", "Buffer Manager Module",
 	 MONITOR_MODULE,
@@ -362,6 +401,46 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_FLUSH_N_TO_FLUSH_REQUESTED},
 
+	{"buffer_flush_adaptive_avg_time_slot", "buffer",
+	 "Avg time (ms) spent for adaptive flushing recently per slot.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_ADAPTIVE_AVG_TIME_SLOT},
+
+	{"buffer_LRU_batch_flush_avg_time_slot", "buffer",
+	 "Avg time (ms) spent for LRU batch flushing recently per slot.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_BATCH_FLUSH_AVG_TIME_SLOT},
+
+	{"buffer_flush_adaptive_avg_time_thread", "buffer",
+	 "Avg time (ms) spent for adaptive flushing recently per thread.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_ADAPTIVE_AVG_TIME_THREAD},
+
+	{"buffer_LRU_batch_flush_avg_time_thread", "buffer",
+	 "Avg time (ms) spent for LRU batch flushing recently per thread.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_BATCH_FLUSH_AVG_TIME_THREAD},
+
+	{"buffer_flush_avg_time", "buffer",
+	 "Avg time (ms) spent for flushing recently.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_AVG_TIME},
+
+	{"buffer_flush_adaptive_avg_pass", "buffer",
+	 "Number of adaptive flushes passed during the recent Avg period.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_ADAPTIVE_AVG_PASS},
+
+	{"buffer_LRU_batch_flush_avg_pass", "buffer",
+	 "Number of LRU batch flushes passed during the recent Avg period.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_LRU_BATCH_FLUSH_AVG_PASS},
+
+	{"buffer_flush_avg_pass", "buffer",
+	 "Number of flushes passed during the recent Avg period.",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_FLUSH_AVG_PASS},
+
 	{"buffer_flush_avg_page_rate", "buffer",
 	 "Average number of pages at which flushing is happening",
 	 MONITOR_NONE,
@@ -83,6 +83,8 @@ UNIV_INTERN ibool	srv_error_monitor_active = FALSE;
 
 UNIV_INTERN ibool	srv_buf_dump_thread_active = FALSE;
 
+UNIV_INTERN ibool	srv_buf_resize_thread_active = FALSE;
+
 UNIV_INTERN ibool	srv_dict_stats_thread_active = FALSE;
 
 UNIV_INTERN const char*	srv_main_thread_op_info = "";
@@ -109,6 +111,21 @@ UNIV_INTERN ulint	srv_undo_tablespaces_open = 8;
 /* The number of rollback segments to use */
 UNIV_INTERN ulong	srv_undo_logs = 1;
 
+/** Whether purge truncates undo tablespaces that grew larger than
+srv_max_undo_log_size */
+UNIV_INTERN my_bool	srv_undo_log_truncate = FALSE;
+
+/** Size in bytes above which an undo tablespace is truncated */
+UNIV_INTERN unsigned long long	srv_max_undo_log_size;
+
+/** Every how many purge batches the purged history is removed from the
+rollback segments */
+UNIV_INTERN ulong	srv_purge_rseg_truncate_frequency = TRX_SYS_N_RSEGS;
+
+/** Space id of the shared temporary tablespace, or ULINT_UNDEFINED
+if it has not been created */
+UNIV_INTERN ulint	srv_tmp_space_id = ULINT_UNDEFINED;
+
 #ifdef UNIV_LOG_ARCHIVE
 UNIV_INTERN char*	srv_arch_dir	= NULL;
 #endif /* UNIV_LOG_ARCHIVE */
@@ -139,6 +156,8 @@ on duplicate key checking and foreign key checking */
 UNIV_INTERN ibool	srv_locks_unsafe_for_binlog = FALSE;
 /** Sort buffer size in index creation */
 UNIV_INTERN ulong	srv_sort_buf_size = 1048576;
+/** Number of threads sorting and loading indexes in index creation */
+UNIV_INTERN ulong	srv_sort_threads = 4;
 /** Maximum modification log file size for online index creation */
 UNIV_INTERN unsigned long long	srv_online_max_size;
 
@@ -148,6 +167,7 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 UNIV_INTERN my_bool	srv_use_native_aio = TRUE;
 UNIV_INTERN my_bool	srv_numa_interleave = FALSE;
+UNIV_INTERN my_bool	srv_transparent_page_compression = FALSE;
 
 #ifdef __WIN__
 /* Windows native condition variables. We use runtime loading / function
@@ -194,6 +214,7 @@ UNIV_INTERN ib_uint64_t	srv_log_file_size_requested;
 UNIV_INTERN ulint	srv_log_buffer_size	= ULINT_MAX;
 UNIV_INTERN ulong	srv_flush_log_at_trx_commit = 1;
 UNIV_INTERN uint	srv_flush_log_at_timeout = 1;
+UNIV_INTERN my_bool	srv_log_writer_threads	= FALSE;
 UNIV_INTERN char        srv_autoinc_persistent  = FALSE;
 UNIV_INTERN ulong       srv_n_autoinc_interval  = 1;
 UNIV_INTERN ulong	srv_page_size		= UNIV_PAGE_SIZE_DEF;
@@ -223,16 +244,26 @@ UNIV_INTERN my_bool	srv_use_sys_malloc	= TRUE;
 UNIV_INTERN ulint	srv_buf_pool_size	= ULINT_MAX;
 /* requested number of buffer pool instances */
 UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
+/* size of a buffer pool chunk in bytes */
+UNIV_INTERN ulong	srv_buf_pool_chunk_unit	= 128 * 1024 * 1024;
 /* number of locks to protect buf_pool->page_hash */
 UNIV_INTERN ulong	srv_n_page_hash_locks = 16;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
 UNIV_INTERN ulong	srv_LRU_scan_depth	= 1024;
 /** whether or not to flush neighbors of a block */
 UNIV_INTERN ulong	srv_flush_neighbors	= 1;
+/** number of page_cleaner threads, the coordinator included */
+UNIV_INTERN ulong	srv_n_page_cleaners	= 1;
 /* previously requested size */
 UNIV_INTERN ulint	srv_buf_pool_old_size;
 /* current size in kilobytes */
 UNIV_INTERN ulint	srv_buf_pool_curr_size	= 0;
+/* maximum size of the change buffer, in percent of the buffer pool */
+UNIV_INTERN uint	srv_change_buffer_max_size = CHANGE_BUFFER_DEFAULT_SIZE;
+/* background change buffer merge batch, in percent of the io_capacity */
+UNIV_INTERN ulong	srv_change_buffer_merge_io_pct = 5;
+/* number of change buffer merge threads, 0 if the master thread merges */
+UNIV_INTERN ulong	srv_n_change_buffer_merge_threads = 0;
 /* size in bytes */
 UNIV_INTERN ulint	srv_mem_pool_size	= ULINT_MAX;
 UNIV_INTERN ulint	srv_lock_table_size	= ULINT_MAX;
@@ -317,6 +348,9 @@ UNIV_INTERN ulong	srv_force_recovery;
 This is for testing and debugging only. */
 UNIV_INTERN ulong	srv_force_recovery_crash;
 #endif /* !DBUG_OFF */
+/** Number of threads that apply the hashed redo log records to pages
+during crash recovery, the thread running the recovery included */
+UNIV_INTERN ulong	srv_n_recv_apply_threads = 4;
 
 /** Print all user-level transactions deadlocks to mysqld stderr */
 
@@ -344,6 +378,18 @@ UNIV_INTERN unsigned long long	srv_stats_transient_sample_pages = 8;
 UNIV_INTERN my_bool		srv_stats_persistent = TRUE;
 UNIV_INTERN unsigned long long	srv_stats_persistent_sample_pages = 20;
 UNIV_INTERN my_bool		srv_stats_auto_recalc = TRUE;
+/* The maximum number of pages to read per index when sampling it for
+the persistent stats, 0 if not limited */
+UNIV_INTERN unsigned long long	srv_stats_persistent_max_pages = 0;
+/* The automatic recalculation of the persistent stats only scales them
+to the current number of rows and index sizes while less than this
+percentage of the rows were modified since the indexes were sampled */
+UNIV_INTERN ulong		srv_stats_incremental_pct = 0;
+/* Number of threads that recalculate the persistent stats */
+UNIV_INTERN ulong		srv_n_stats_auto_recalc_threads = 1;
+/* Whether ANALYZE TABLE leaves the recalculation of the persistent stats
+to the background stats threads */
+UNIV_INTERN my_bool		srv_stats_analyze_in_background = FALSE;
 
 UNIV_INTERN ibool	srv_use_doublewrite_buf	= TRUE;
 
@@ -353,6 +399,11 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 UNIV_INTERN ulong	srv_doublewrite_batch_size	= 120;
 
+/** If TRUE, LRU and flush list batches of each buffer pool instance are
+doublewritten to their own segment of a per-instance file instead of the
+shared blocks in the system tablespace. */
+UNIV_INTERN my_bool	srv_parallel_doublewrite	= FALSE;
+
 UNIV_INTERN ulong	srv_replication_delay		= 0;
 
 /*-------------------------------------------*/
@@ -610,6 +661,9 @@ UNIV_INTERN os_event_t	srv_error_event;
 /** Event to signal the buffer pool dump/load thread */
 UNIV_INTERN os_event_t	srv_buf_dump_event;
 
+/** Event to signal the buffer pool resize thread */
+UNIV_INTERN os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 UNIV_INTERN char*	srv_buf_dump_filename;
 
@@ -618,6 +672,17 @@ and/or load it during startup. */
 UNIV_INTERN char	srv_buffer_pool_dump_at_shutdown = FALSE;
 UNIV_INTERN char	srv_buffer_pool_load_at_startup = FALSE;
 
+/** Percentage of the hottest pages of each buffer pool instance that are
+written by a buffer pool dump */
+UNIV_INTERN ulong	srv_buf_pool_dump_pct = 100;
+
+/** Number of threads issuing reads during a buffer pool load */
+UNIV_INTERN ulong	srv_buf_load_threads = 4;
+
+/** Maximum number of pages per second read by a buffer pool load,
+0 means no limit */
+UNIV_INTERN ulong	srv_buf_load_io_capacity = 0;
+
 /** Slot index in the srv_sys->sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -974,6 +1039,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create();
 
+		srv_buf_resize_event = os_event_create();
+
 		UT_LIST_INIT(srv_sys->tasks);
 	}
 
@@ -1022,6 +1089,9 @@ srv_free(void)
 	if (!srv_read_only_mode) {
 		os_event_free(srv_buf_dump_event);
 		srv_buf_dump_event = NULL;
+
+		os_event_free(srv_buf_resize_event);
+		srv_buf_resize_event = NULL;
 	}
 }
 
@@ -1526,6 +1596,12 @@ srv_export_innodb_status(void)
 	}
 #endif /* UNIV_DEBUG */
 	export_vars.innodb_buffered_aio_submitted = srv_stats.n_aio_submitted;
+	export_vars.innodb_pages_page_compressed =
+		srv_stats.pages_page_compressed;
+	export_vars.innodb_pages_page_decompressed =
+		srv_stats.pages_page_decompressed;
+	export_vars.innodb_page_compression_saved =
+		srv_stats.page_compression_saved;
 
 	mutex_exit(&srv_innodb_monitor_mutex);
 }
@@ -1895,15 +1971,21 @@ srv_any_background_threads_are_active(void)
 		thread_active = "srv_monitor_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_active = "buf_dump_thread";
+	} else if (srv_buf_resize_thread_active) {
+		thread_active = "buf_resize_thread";
 	} else if (srv_dict_stats_thread_active) {
 		thread_active = "dict_stats_thread";
+	} else if (ibuf_merge_n_threads_active > 0) {
+		thread_active = "ibuf_merge_thread";
 	}
 
 	os_event_set(srv_error_event);
 	os_event_set(srv_monitor_event);
 	os_event_set(srv_buf_dump_event);
+	os_event_set(srv_buf_resize_event);
 	os_event_set(lock_sys->timeout_event);
 	os_event_set(dict_stats_event);
+	os_event_set(ibuf_merge_event);
 
 	return(thread_active);
 }
@@ -2628,7 +2710,7 @@ srv_do_purge(
 
 		n_pages_purged = trx_purge(
 			n_use_threads, srv_purge_batch_size,
-			(++count % TRX_SYS_N_RSEGS) == 0);
+			(++count % srv_purge_rseg_truncate_frequency) == 0);
 
 		*n_total_purged += n_pages_purged;
 
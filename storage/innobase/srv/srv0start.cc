@@ -109,6 +109,10 @@ UNIV_INTERN ibool	srv_have_fullfsync = FALSE;
 /** TRUE if a raw partition is in use */
 UNIV_INTERN ibool	srv_start_raw_disk_in_use = FALSE;
 
+/** UNDO tablespaces that were re-created at startup because their
+truncation was interrupted, indexed by space id */
+static bool	srv_undo_space_truncated[TRX_SYS_N_RSEGS + 1];
+
 /** TRUE if the server is being started, before rolling back any
 incomplete transactions */
 UNIV_INTERN ibool	srv_startup_is_before_trx_rollback_phase = FALSE;
@@ -139,10 +143,6 @@ static os_fast_mutex_t	srv_os_test_mutex;
 static char*	srv_monitor_file_name;
 #endif /* !UNIV_HOTBACKUP */
 
-/** Default undo tablespace size in UNIV_PAGEs count (10MB). */
-static const ulint SRV_UNDO_TABLESPACE_SIZE_IN_PAGES =
-	((1024 * 1024) * 10) / UNIV_PAGE_SIZE_DEF;
-
 /** */
 #define SRV_N_PENDING_IOS_PER_THREAD	OS_AIO_N_PENDING_IOS_PER_THREAD
 #define SRV_MAX_N_PENDING_SYNC_IOS	100
@@ -1391,6 +1391,40 @@ srv_undo_tablespaces_init(
 		ut_a(undo_tablespace_ids[i] != 0);
 		ut_a(undo_tablespace_ids[i] != ULINT_UNDEFINED);
 
+		/* If the truncation of the tablespace was interrupted,
+		re-create it. The redo log records of the old tablespace
+		are not applied, and its headers are re-created by
+		srv_undo_tablespaces_fixup(). */
+
+		if (!create_new_db
+		    && trx_purge_undo_trunc_log_exists(
+			    undo_tablespace_ids[i])) {
+
+			if (srv_read_only_mode) {
+				ib_logf(IB_LOG_LEVEL_ERROR,
+					"Cannot complete the truncation of "
+					"undo tablespace '%s' in read-only "
+					"mode.", name);
+
+				return(DB_READ_ONLY);
+			}
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Truncation of undo tablespace '%s' was "
+				"interrupted, re-creating it.", name);
+
+			os_file_delete_if_exists(innodb_file_data_key, name);
+
+			err = srv_undo_tablespace_create(
+				name, SRV_UNDO_TABLESPACE_SIZE_IN_PAGES);
+
+			if (err != DB_SUCCESS) {
+				return(err);
+			}
+
+			srv_undo_space_truncated[undo_tablespace_ids[i]] = true;
+		}
+
 		/* Undo space ids start from 1. */
 
 		err = srv_undo_tablespace_open(name, undo_tablespace_ids[i]);
@@ -1488,6 +1522,229 @@ srv_undo_tablespaces_init(
 	return(DB_SUCCESS);
 }
 
+/********************************************************************
+Re-creates the headers of the UNDO tablespaces that were re-created
+by srv_undo_tablespaces_init(), and the headers of their rollback
+segments. This is not redo logged: srv_undo_tablespaces_fixup_complete()
+makes a checkpoint before the truncation logs are deleted. Only the
+slots of the rollback segments in the trx system header are updated
+in redo logged mini-transactions. */
+static
+void
+srv_undo_tablespaces_fixup(void)
+/*============================*/
+{
+	for (ulint space_id = 1; space_id <= TRX_SYS_N_RSEGS; ++space_id) {
+		mtr_t		mtr;
+		trx_sysf_t*	sys_header;
+		ulint		page_nos[TRX_SYS_N_RSEGS];
+		bool		moved = false;
+
+		if (!srv_undo_space_truncated[space_id]) {
+			continue;
+		}
+
+		mtr_start(&mtr);
+		mtr_set_log_mode(&mtr, MTR_LOG_NO_REDO);
+		mtr_x_lock(fil_space_get_latch(space_id, NULL), &mtr);
+
+		fsp_header_init(
+			space_id, SRV_UNDO_TABLESPACE_SIZE_IN_PAGES, &mtr);
+
+		sys_header = trx_sysf_get(&mtr);
+
+		for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+			ulint	page_no;
+
+			page_no = trx_sysf_rseg_get_page_no(
+				sys_header, i, &mtr);
+
+			page_nos[i] = FIL_NULL;
+
+			if (page_no != FIL_NULL
+			    && trx_sysf_rseg_get_space(sys_header, i, &mtr)
+			    == space_id) {
+
+				page_nos[i] = trx_rseg_header_create_low(
+					space_id, 0, ULINT_MAX, &mtr);
+
+				ut_a(page_nos[i] != FIL_NULL);
+
+				moved = moved || page_nos[i] != page_no;
+			}
+		}
+
+		mtr_commit(&mtr);
+
+		/* The slots still point to the old headers if the server
+		was killed before the truncation updated them. */
+		for (ulint i = 0; moved && i < TRX_SYS_N_RSEGS; ++i) {
+			if (page_nos[i] != FIL_NULL) {
+				trx_rseg_header_set_slot(
+					space_id, page_nos[i], i);
+			}
+		}
+	}
+}
+
+/********************************************************************
+Makes the UNDO tablespaces re-created at startup durable and deletes
+their truncation logs. */
+static
+void
+srv_undo_tablespaces_fixup_complete(void)
+/*=====================================*/
+{
+	bool	checkpoint_made = false;
+
+	for (ulint space_id = 1; space_id <= TRX_SYS_N_RSEGS; ++space_id) {
+
+		if (!srv_undo_space_truncated[space_id]) {
+			continue;
+		}
+
+		if (!checkpoint_made) {
+			log_make_checkpoint_at(LSN_MAX, TRUE);
+			checkpoint_made = true;
+		}
+
+		trx_purge_undo_trunc_log_delete(space_id);
+
+		srv_undo_space_truncated[space_id] = false;
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Completed truncation of undo tablespace %lu",
+			space_id);
+	}
+}
+
+/** File name of the shared temporary tablespace in srv_data_home */
+static const char	srv_tmp_space_file_name[] = "ibtmp1";
+
+/** Initial size of the shared temporary tablespace in pages (12MB) */
+static const ulint	SRV_TMP_SPACE_SIZE_IN_PAGES =
+	((1024 * 1024) * 12) / UNIV_PAGE_SIZE_DEF;
+
+/********************************************************************
+Builds the path of the shared temporary tablespace file. */
+static
+void
+srv_tmp_space_get_path(
+/*===================*/
+	char*	name)	/*!< out: file path, OS_FILE_MAX_PATH bytes */
+{
+	ulint	dirnamelen = strlen(srv_data_home);
+
+	ut_a(dirnamelen + sizeof srv_tmp_space_file_name
+	     < OS_FILE_MAX_PATH - 1);
+
+	memcpy(name, srv_data_home, dirnamelen);
+
+	/* Add a path separator if needed. */
+	if (dirnamelen && name[dirnamelen - 1] != SRV_PATH_SEPARATOR) {
+		name[dirnamelen++] = SRV_PATH_SEPARATOR;
+	}
+
+	strcpy(name + dirnamelen, srv_tmp_space_file_name);
+}
+
+/********************************************************************
+Creates the shared temporary tablespace. The file left by the previous
+instance is deleted first: temporary tables do not survive a restart.
+The tablespace gets a new space id at each startup so that the log
+records and the temporary tables of the previous instance never refer
+to it.
+@return	DB_SUCCESS or error code */
+static
+dberr_t
+srv_tmp_space_create(void)
+/*======================*/
+{
+	char		name[OS_FILE_MAX_PATH];
+	os_file_t	fh;
+	ibool		ret;
+	ulint		space_id = 0;
+	mtr_t		mtr;
+
+	ut_ad(!srv_read_only_mode);
+	ut_ad(srv_tmp_space_id == ULINT_UNDEFINED);
+
+	srv_tmp_space_get_path(name);
+
+	os_file_delete_if_exists(innodb_file_data_key, name);
+
+	fh = os_file_create(
+		innodb_file_data_key, name, OS_FILE_CREATE,
+		OS_FILE_NORMAL, OS_DATA_FILE, &ret);
+
+	if (!ret) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Can't create temporary tablespace %s", name);
+
+		return(DB_ERROR);
+	}
+
+	ret = os_file_set_size(
+		name, fh, SRV_TMP_SPACE_SIZE_IN_PAGES << UNIV_PAGE_SIZE_SHIFT);
+
+	os_file_close(fh);
+
+	if (!ret) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Error in creating %s: probably out of disk space",
+			name);
+
+		return(DB_ERROR);
+	}
+
+	dict_hdr_get_new_id(NULL, NULL, &space_id);
+
+	if (space_id == ULINT_UNDEFINED
+	    || !fil_space_create(
+		    name, space_id, fsp_flags_set_page_size(0, UNIV_PAGE_SIZE),
+		    FIL_TABLESPACE)
+	    || !fil_node_create(
+		    name, SRV_TMP_SPACE_SIZE_IN_PAGES, space_id, FALSE)) {
+
+		return(DB_ERROR);
+	}
+
+	/* From now on the changes to the pages of the tablespace,
+	including the initialization of its header, are not redo
+	logged. */
+	srv_tmp_space_id = space_id;
+
+	mtr_start(&mtr);
+
+	mtr_x_lock(fil_space_get_latch(space_id, NULL), &mtr);
+
+	fsp_header_init(space_id, SRV_TMP_SPACE_SIZE_IN_PAGES, &mtr);
+
+	mtr_commit(&mtr);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Created temporary tablespace %s, space id %lu",
+		name, space_id);
+
+	return(DB_SUCCESS);
+}
+
+/********************************************************************
+Checks whether an UNDO tablespace was re-created at startup because its
+truncation was interrupted. The redo log records for such a tablespace
+must not be applied.
+@return true if the tablespace was re-created */
+UNIV_INTERN
+bool
+srv_is_undo_tablespace_truncated(
+/*=============================*/
+	ulint	space_id)	/*!< in: tablespace id */
+{
+	return(space_id > 0
+	       && space_id <= TRX_SYS_N_RSEGS
+	       && srv_undo_space_truncated[space_id]);
+}
+
 /********************************************************************
 Wait for the purge thread(s) to start up. */
 static
@@ -1828,10 +2085,11 @@ innobase_start_or_create_for_mysql(void)
 			    + 1 /* srv_master_thread */
 			    + 1 /* srv_purge_coordinator_thread */
 			    + 1 /* buf_dump_thread */
-			    + 1 /* dict_stats_thread */
+			    + 1 /* buf_resize_thread */
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
-			    + 1 /* buf_flush_page_cleaner_thread */
+			    + 1 /* buf_flush_page_cleaner_coordinator */
+			    + 2 /* log_writer_thread, log_flusher_thread */
 			    + 1 /* trx_rollback_or_clean_all_recovered */
 			    + 128 /* added as margin, for use of
 				  InnoDB Memcached etc. */
@@ -1839,6 +2097,10 @@ innobase_start_or_create_for_mysql(void)
 			    + srv_n_read_io_threads
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
+			    + srv_n_page_cleaners
+			    + srv_n_change_buffer_merge_threads
+			    + srv_n_stats_auto_recalc_threads
+			    + srv_n_recv_apply_threads
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
 			      * max_connections;
@@ -1849,6 +2111,25 @@ innobase_start_or_create_for_mysql(void)
 		srv_buf_pool_instances = 1;
 	}
 
+	if (srv_buf_pool_chunk_unit * srv_buf_pool_instances
+	    > srv_buf_pool_size) {
+		/* The chunk would be larger than a whole instance;
+		shrink it so that every instance has one chunk. */
+		srv_buf_pool_chunk_unit = static_cast<ulong>(
+			ut_uint64_align_up(
+				srv_buf_pool_size / srv_buf_pool_instances,
+				1024 * 1024));
+	}
+
+	/* Every instance consists of whole chunks. */
+	srv_buf_pool_size = buf_pool_size_align(srv_buf_pool_size);
+
+	/* Each page_cleaner thread works on whole buffer pool
+	instances, any thread beyond their number would be idle. */
+	if (srv_n_page_cleaners > srv_buf_pool_instances) {
+		srv_n_page_cleaners = srv_buf_pool_instances;
+	}
+
 	srv_boot();
 
 	ib_logf(IB_LOG_LEVEL_INFO,
@@ -2452,6 +2733,9 @@ files_checked:
 			return(err);
 		}
 
+		/* The rollback segment headers are read below. */
+		srv_undo_tablespaces_fixup();
+
 		ib_bh = trx_sys_init_at_db_start();
 		n_recovered_trx = UT_LIST_GET_LEN(trx_sys->rw_trx_list);
 
@@ -2635,6 +2919,8 @@ files_checked:
 		buf_dblwr_create();
 	}
 
+	buf_dblwr_remove_stale_files();
+
 	/* Here the double write buffer has already been created and so
 	any new rollback segments will be allocated after the double
 	write buffer. The default segment should already exist.
@@ -2664,6 +2950,16 @@ files_checked:
 		srv_undo_logs = ULONG_UNDEFINED;
 	}
 
+	srv_undo_tablespaces_fixup_complete();
+
+	if (!srv_read_only_mode) {
+		err = srv_tmp_space_create();
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
 	if (!srv_read_only_mode) {
 		/* Create the thread which watches the timeouts
 		for lock waits */
@@ -2732,7 +3028,19 @@ files_checked:
 	}
 
 	if (!srv_read_only_mode) {
-		os_thread_create(buf_flush_page_cleaner_thread, NULL, NULL);
+		buf_flush_page_cleaner_init();
+
+		os_thread_create(buf_flush_page_cleaner_coordinator,
+				 NULL, NULL);
+
+		for (i = 1; i < srv_n_page_cleaners; ++i) {
+			os_thread_create(buf_flush_page_cleaner_worker,
+					 NULL, NULL);
+		}
+
+		if (srv_log_writer_threads) {
+			log_writer_threads_start();
+		}
 	}
 
 #ifdef UNIV_DEBUG
@@ -2879,8 +3187,23 @@ files_checked:
 		/* Create the buffer pool dump/load thread */
 		os_thread_create(buf_dump_thread, NULL, NULL);
 
-		/* Create the dict stats gathering thread */
-		os_thread_create(dict_stats_thread, NULL, NULL);
+		/* Create the buffer pool resize thread */
+		os_thread_create(buf_resize_thread, NULL, NULL);
+
+		/* Create the dict stats gathering threads */
+		srv_dict_stats_thread_active = TRUE;
+		dict_stats_n_threads_active = srv_n_stats_auto_recalc_threads;
+
+		for (i = 0; i < srv_n_stats_auto_recalc_threads; ++i) {
+			os_thread_create(dict_stats_thread, NULL, NULL);
+		}
+
+		/* Create the change buffer merge threads */
+		ibuf_merge_n_threads_active = srv_n_change_buffer_merge_threads;
+
+		for (i = 0; i < srv_n_change_buffer_merge_threads; ++i) {
+			os_thread_create(ibuf_merge_thread, NULL, NULL);
+		}
 
 		/* Create the thread that will optimize the FTS sub-system. */
 		fts_optimize_init();
@@ -3069,6 +3392,16 @@ innobase_shutdown_for_mysql(void)
 		}
 	}
 
+	if (srv_tmp_space_id != ULINT_UNDEFINED) {
+		char	name[OS_FILE_MAX_PATH];
+
+		/* The files were closed in
+		logs_empty_and_mark_files_at_shutdown(). */
+		srv_tmp_space_get_path(name);
+		os_file_delete_if_exists(innodb_file_data_key, name);
+		srv_tmp_space_id = ULINT_UNDEFINED;
+	}
+
 	if (srv_dict_tmpfile) {
 		fclose(srv_dict_tmpfile);
 		srv_dict_tmpfile = 0;
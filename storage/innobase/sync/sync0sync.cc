@@ -1149,10 +1149,14 @@ sync_thread_add_level(
 	case SYNC_ANY_LATCH:
 	case SYNC_FILE_FORMAT_TAG:
 	case SYNC_DOUBLEWRITE:
+	case SYNC_PAGE_CLEANER:
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
+	case SYNC_LOCK_REC_SHARD:
 	case SYNC_LOCK_WAIT_SYS:
 	case SYNC_TRX_SYS:
+	case SYNC_TRX_SYS_SERIAL:
+	case SYNC_TRX_SYS_RW_SHARD:
 	case SYNC_IBUF_BITMAP_MUTEX:
 	case SYNC_RSEG:
 	case SYNC_TRX_UNDO:
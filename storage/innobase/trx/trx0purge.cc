@@ -45,6 +45,8 @@ Created 3/26/1996 Heikki Tuuri
 #include "os0thread.h"
 #include "srv0mon.h"
 #include "mtr0log.h"
+#include "log0log.h"
+#include "os0file.h"
 
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 UNIV_INTERN ulong		srv_max_purge_lag = 0;
@@ -67,8 +69,27 @@ UNIV_INTERN mysql_pfs_key_t	trx_purge_latch_key;
 #ifdef UNIV_PFS_MUTEX
 /* Key to register purge_sys_bh_mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	purge_sys_bh_mutex_key;
+/* Key to register purge_sys_table_stats_mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	purge_sys_table_stats_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
+/** Maximum number of tables in purge_sys->table_stats. When it is
+exceeded, the table whose records were purged the longest time ago is
+removed. */
+#define PURGE_TABLE_STATS_MAX	1024
+
+/** A table that has undo log records in a purge batch */
+struct purge_batch_table_t {
+	que_thr_t*	thr;		/*!< query thread whose purge node
+					the records are attached to */
+	ulint		n_recs;		/*!< number of records */
+	trx_id_t	last_trx_no;	/*!< transaction number of the
+					last record */
+};
+
+/** The tables of a purge batch, indexed by dict_table_t::id */
+typedef std::map<table_id_t, purge_batch_table_t>	purge_batch_tables_t;
+
 #ifdef UNIV_DEBUG
 UNIV_INTERN my_bool		srv_purge_view_update_only_debug;
 #endif /* UNIV_DEBUG */
@@ -119,6 +140,7 @@ trx_purge_sys_create(
 	purge_sys = static_cast<trx_purge_t*>(mem_zalloc(sizeof(*purge_sys)));
 
 	purge_sys->state = PURGE_STATE_INIT;
+	purge_sys->undo_trunc_space = ULINT_UNDEFINED;
 	purge_sys->event = os_event_create();
 
 	/* Take ownership of ib_bh, we are responsible for freeing it. */
@@ -133,6 +155,12 @@ trx_purge_sys_create(
 
 	purge_sys->heap = mem_heap_create(256);
 
+	mutex_create(
+		purge_sys_table_stats_mutex_key,
+		&purge_sys->table_stats_mutex, SYNC_ANY_LATCH);
+
+	purge_sys->table_stats = new purge_table_stats_t();
+
 	ut_a(n_purge_threads > 0);
 
 	purge_sys->sess = sess_open();
@@ -184,6 +212,9 @@ trx_purge_sys_close(void)
 
 	mem_heap_free(purge_sys->heap);
 
+	delete purge_sys->table_stats;
+	mutex_free(&purge_sys->table_stats_mutex);
+
 	ib_bh_free(purge_sys->ib_bh);
 
 	os_event_free(purge_sys->event);
@@ -533,6 +564,329 @@ trx_purge_truncate_history(
 	}
 }
 
+/********************************************************************//**
+Builds the name of the truncation log file of an UNDO tablespace. */
+static
+void
+trx_purge_undo_trunc_log_name(
+/*==========================*/
+	char*	name,		/*!< out: file name */
+	ulint	len,		/*!< in: size of name in bytes */
+	ulint	space_id)	/*!< in: UNDO tablespace id */
+{
+	ut_snprintf(name, len, "%s%cundo_%03lu_trunc.log",
+		    srv_undo_dir, SRV_PATH_SEPARATOR, space_id);
+}
+
+/********************************************************************//**
+Creates the file which marks the truncation of an UNDO tablespace as
+in progress. If the file exists at startup, the tablespace is
+re-created and the redo log records for it are not applied.
+@return true if success */
+UNIV_INTERN
+bool
+trx_purge_undo_trunc_log_create(
+/*============================*/
+	ulint	space_id)	/*!< in: UNDO tablespace id */
+{
+	char		name[OS_FILE_MAX_PATH];
+	os_file_t	fh;
+	ibool		ret;
+
+	trx_purge_undo_trunc_log_name(name, sizeof(name), space_id);
+
+	fh = os_file_create_simple_no_error_handling(
+		innodb_file_data_key, name, OS_FILE_CREATE,
+		OS_FILE_READ_WRITE, &ret);
+
+	if (!ret) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Could not create the undo truncation log %s", name);
+		return(false);
+	}
+
+	ret = os_file_flush(fh);
+
+	os_file_close(fh);
+
+	return(ret == TRUE);
+}
+
+/********************************************************************//**
+Checks whether the truncation of an UNDO tablespace was in progress.
+@return true if the truncation log file of the tablespace exists */
+UNIV_INTERN
+bool
+trx_purge_undo_trunc_log_exists(
+/*============================*/
+	ulint	space_id)	/*!< in: UNDO tablespace id */
+{
+	char		name[OS_FILE_MAX_PATH];
+	ibool		exists;
+	os_file_type_t	type;
+
+	trx_purge_undo_trunc_log_name(name, sizeof(name), space_id);
+
+	return(os_file_status(name, &exists, &type) && exists);
+}
+
+/********************************************************************//**
+Deletes the file which marks the truncation of an UNDO tablespace as
+in progress. */
+UNIV_INTERN
+void
+trx_purge_undo_trunc_log_delete(
+/*============================*/
+	ulint	space_id)	/*!< in: UNDO tablespace id */
+{
+	char	name[OS_FILE_MAX_PATH];
+
+	trx_purge_undo_trunc_log_name(name, sizeof(name), space_id);
+
+	os_file_delete_if_exists(innodb_file_data_key, name);
+}
+
+/********************************************************************//**
+Sets or clears the flag that keeps the rollback segments of an UNDO
+tablespace from being assigned to new transactions. */
+static
+void
+trx_purge_undo_space_skip_allocation(
+/*=================================*/
+	ulint	space_id,	/*!< in: UNDO tablespace id */
+	bool	skip)		/*!< in: true to exclude the rollback
+				segments from allocation */
+{
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg != NULL && rseg->space == space_id) {
+			mutex_enter(&rseg->mutex);
+			rseg->skip_allocation = skip;
+			mutex_exit(&rseg->mutex);
+		}
+	}
+}
+
+/********************************************************************//**
+Marks an UNDO tablespace for truncation if one has grown larger than
+innodb_max_undo_log_size. The tablespaces are checked in round robin
+order. A tablespace is only marked if the rollback segments of another
+UNDO tablespace remain available to transactions. */
+static
+void
+trx_purge_mark_undo_for_truncate(void)
+/*==================================*/
+{
+	ulint	n_spaces = srv_undo_tablespaces_open;
+
+	if (purge_sys->undo_trunc_space != ULINT_UNDEFINED
+	    || !srv_undo_log_truncate
+	    || n_spaces < 2) {
+
+		return;
+	}
+
+	for (ulint i = 0; i < n_spaces; ++i) {
+		/* UNDO tablespace ids are contiguous and start from 1. */
+		ulint	space_id = (purge_sys->undo_trunc_last + i)
+			% n_spaces + 1;
+		bool	has_rseg = false;
+		bool	other_rseg = false;
+
+		for (ulint j = 0; j < TRX_SYS_N_RSEGS; ++j) {
+			const trx_rseg_t*	rseg = trx_sys->rseg_array[j];
+
+			if (rseg == NULL || rseg->space == TRX_SYS_SPACE) {
+				continue;
+			} else if (rseg->space == space_id) {
+				has_rseg = true;
+			} else {
+				other_rseg = true;
+			}
+		}
+
+		if (!has_rseg || !other_rseg
+		    || (ib_uint64_t) fil_space_get_size(space_id)
+		    * UNIV_PAGE_SIZE <= srv_max_undo_log_size) {
+
+			continue;
+		}
+
+		trx_purge_undo_space_skip_allocation(space_id, true);
+
+		purge_sys->undo_trunc_space = space_id;
+		purge_sys->undo_trunc_last = space_id;
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Undo tablespace %lu is marked for truncation",
+			space_id);
+
+		return;
+	}
+}
+
+/********************************************************************//**
+Truncates the UNDO tablespace that is marked for truncation once none
+of its rollback segments holds undo logs: all transactions that were
+assigned them have committed and their history has been purged. */
+static
+void
+trx_purge_truncate_marked_undo(
+/*===========================*/
+	const purge_iter_t*	limit)	/*!< in: history truncation limit */
+{
+	ulint	space_id = purge_sys->undo_trunc_space;
+	ulint	n_removed_logs = 0;
+	mtr_t	mtr;
+
+	if (space_id == ULINT_UNDEFINED) {
+		return;
+	} else if (!srv_undo_log_truncate) {
+		trx_purge_undo_space_skip_allocation(space_id, false);
+		purge_sys->undo_trunc_space = ULINT_UNDEFINED;
+		return;
+	}
+
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+		bool		in_use;
+
+		if (rseg == NULL || rseg->space != space_id) {
+			continue;
+		}
+
+		mutex_enter(&rseg->mutex);
+
+		in_use = rseg->trx_ref_count > 0
+			|| UT_LIST_GET_LEN(rseg->update_undo_list) > 0
+			|| UT_LIST_GET_LEN(rseg->insert_undo_list) > 0
+			|| rseg->last_page_no != FIL_NULL;
+
+		mutex_exit(&rseg->mutex);
+
+		if (in_use) {
+			return;
+		}
+
+		/* The history is only truncated up to a log that was not
+		purged yet. Logs that were purged may remain at its start
+		when no later logs were added to the rollback segment. */
+
+		trx_rsegf_t*	rseg_hdr;
+		ulint		hist_len;
+
+		mtr_start(&mtr);
+
+		rseg_hdr = trx_rsegf_get(
+			rseg->space, rseg->zip_size, rseg->page_no, &mtr);
+
+		hist_len = flst_get_len(rseg_hdr + TRX_RSEG_HISTORY, &mtr);
+
+		if (hist_len > 0) {
+			fil_addr_t	hdr_addr;
+			page_t*		undo_page;
+
+			hdr_addr = trx_purge_get_log_from_hist(
+				flst_get_first(rseg_hdr + TRX_RSEG_HISTORY,
+					       &mtr));
+
+			undo_page = trx_undo_page_get(
+				rseg->space, rseg->zip_size, hdr_addr.page,
+				&mtr);
+
+			in_use = mach_read_from_8(
+				undo_page + hdr_addr.boffset + TRX_UNDO_TRX_NO)
+				>= limit->trx_no;
+		}
+
+		mtr_commit(&mtr);
+
+		if (in_use) {
+			return;
+		}
+
+		n_removed_logs += hist_len;
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Truncating undo tablespace %lu", space_id);
+
+	if (!trx_purge_undo_trunc_log_create(space_id)) {
+		trx_purge_undo_space_skip_allocation(space_id, false);
+		purge_sys->undo_trunc_space = ULINT_UNDEFINED;
+		return;
+	}
+
+	if (!fil_truncate_tablespace(
+		    space_id, SRV_UNDO_TABLESPACE_SIZE_IN_PAGES)) {
+
+		/* The tablespace is re-created at the next startup
+		because the truncation log exists. */
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Could not truncate undo tablespace %lu", space_id);
+	}
+
+	/* The old pages of the tablespace were discarded. Instead of
+	logging the re-created pages, a checkpoint is made below before
+	the truncation log is deleted: until then, crash recovery
+	re-creates the tablespace in the same way. */
+
+	mtr_start(&mtr);
+	mtr_set_log_mode(&mtr, MTR_LOG_NO_REDO);
+	mtr_x_lock(fil_space_get_latch(space_id, NULL), &mtr);
+
+	fsp_header_init(space_id, SRV_UNDO_TABLESPACE_SIZE_IN_PAGES, &mtr);
+
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg != NULL && rseg->space == space_id) {
+			trx_rseg_reinit(rseg, &mtr);
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	/* The rollback segment headers may have moved to other pages.
+	The trx system header is in the system tablespace, which is
+	recovered from the redo log like any other page of it, so its
+	slots must be updated in redo logged mini-transactions. */
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg != NULL && rseg->space == space_id) {
+			trx_rseg_header_set_slot(
+				rseg->space, rseg->page_no, rseg->id);
+		}
+	}
+
+	/* The purged logs that remained in the history lists were
+	discarded with the rollback segment headers. */
+#ifdef HAVE_ATOMIC_BUILTINS
+	os_atomic_decrement_ulint(&trx_sys->rseg_history_len, n_removed_logs);
+#else
+	mutex_enter(&trx_sys->mutex);
+	trx_sys->rseg_history_len -= n_removed_logs;
+	mutex_exit(&trx_sys->mutex);
+#endif /* HAVE_ATOMIC_BUILTINS */
+
+	DBUG_EXECUTE_IF("ib_undo_trunc_before_checkpoint",
+			log_buffer_flush_to_disk();
+			DBUG_SUICIDE(););
+
+	log_make_checkpoint_at(LSN_MAX, TRUE);
+
+	trx_purge_undo_trunc_log_delete(space_id);
+
+	trx_purge_undo_space_skip_allocation(space_id, false);
+
+	purge_sys->undo_trunc_space = ULINT_UNDEFINED;
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Completed truncation of undo tablespace %lu", space_id);
+}
+
 /***********************************************************************//**
 Updates the last not yet purged history log info in rseg when we have purged
 a whole undo log. Advances also purge_sys->purge_trx_no past the purged log. */
@@ -960,7 +1314,60 @@ trx_purge_fetch_next_rec(
 }
 
 /*******************************************************************//**
-This function runs a purge batch.
+Adds the tables of a purge batch to purge_sys->table_stats. */
+static
+void
+trx_purge_update_table_stats(
+/*=========================*/
+	const purge_batch_tables_t&	tables)	/*!< in: tables of the batch */
+{
+	trx_id_t	max_trx_id = trx_sys_get_max_trx_id();
+
+	mutex_enter(&purge_sys->table_stats_mutex);
+
+	++purge_sys->n_batches;
+
+	for (purge_batch_tables_t::const_iterator it = tables.begin();
+	     it != tables.end();
+	     ++it) {
+
+		purge_table_stat_t&	stat = (*purge_sys->table_stats)[
+			it->first];
+
+		stat.n_recs += it->second.n_recs;
+		stat.n_batch_recs = it->second.n_recs;
+		stat.batch_no = purge_sys->n_batches;
+		stat.last_trx_no = it->second.last_trx_no;
+		stat.lag = max_trx_id > stat.last_trx_no
+			? max_trx_id - stat.last_trx_no : 0;
+	}
+
+	while (purge_sys->table_stats->size() > PURGE_TABLE_STATS_MAX) {
+		purge_table_stats_t::iterator	oldest;
+
+		oldest = purge_sys->table_stats->begin();
+
+		for (purge_table_stats_t::iterator it = oldest;
+		     it != purge_sys->table_stats->end();
+		     ++it) {
+
+			if (it->second.batch_no < oldest->second.batch_no) {
+				oldest = it;
+			}
+		}
+
+		purge_sys->table_stats->erase(oldest);
+	}
+
+	mutex_exit(&purge_sys->table_stats_mutex);
+}
+
+/*******************************************************************//**
+This function runs a purge batch. The undo log records are partitioned by
+table: all records of a table are attached to the same purge node, and the
+tables are distributed round-robin over the purge nodes in the order they
+appear in the batch. This way the purge threads do not contend for the
+index pages and the records of one table.
 @return	number of undo log pages handled in the batch */
 static
 ulint
@@ -971,10 +1378,11 @@ trx_purge_attach_undo_recs(
 	purge_iter_t*	limit,		/*!< out: records read up to */
 	ulint		batch_size)	/*!< in: no. of pages to purge */
 {
-	que_thr_t*	thr;
-	ulint		i = 0;
-	ulint		n_pages_handled = 0;
-	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
+	que_thr_t*		thr;
+	ulint			i = 0;
+	ulint			n_pages_handled = 0;
+	ulint			n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
+	purge_batch_tables_t	tables;
 
 	ut_a(n_purge_threads > 0);
 
@@ -1012,16 +1420,13 @@ trx_purge_attach_undo_recs(
 
 	for (;;) {
 		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_purge_rec_t		purge_rec;
+		trx_id_t		trx_no;
+		ulint			type;
+		ulint			cmpl_info;
+		bool			updated_extern;
+		undo_no_t		undo_no;
+		table_id_t		table_id;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1033,42 +1438,88 @@ trx_purge_attach_undo_recs(
 			*limit = purge_sys->iter;
 		}
 
-		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
+		trx_no = purge_sys->iter.trx_no;
 
-		if (purge_rec->undo_rec != NULL) {
+		/* Fetch the next record, and advance the purge_sys->iter.
+		The copy can be attached to any purge node: it is kept
+		in purge_sys->heap until the batch has completed. */
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled,
+			purge_sys->heap);
 
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		if (purge_rec.undo_rec == NULL) {
 
-			ib_vector_push(node->undo_recs, purge_rec);
+			break;
+		} else if (purge_rec.undo_rec == &trx_purge_dummy_rec) {
 
+			/* A whole undo log that needs no purge. */
 			if (n_pages_handled >= batch_size) {
 
 				break;
 			}
-		} else {
-			break;
+
+			continue;
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		trx_undo_rec_get_pars(
+			purge_rec.undo_rec, &type, &cmpl_info,
+			&updated_extern, &undo_no, &table_id);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+		purge_batch_tables_t::iterator	it = tables.find(table_id);
+
+		if (it == tables.end()) {
+			purge_batch_table_t	batch_table;
+
+			/* Attach the table to the next purge node. */
+			batch_table.thr = thr;
+			batch_table.n_recs = 0;
+
+			it = tables.insert(
+				purge_batch_tables_t::value_type(
+					table_id, batch_table)).first;
+
+			thr = UT_LIST_GET_NEXT(thrs, thr);
+
+			if (!(++i % n_purge_threads)) {
+				thr = UT_LIST_GET_FIRST(
+					purge_sys->query->thrs);
+			}
+
+			ut_a(thr != NULL);
 		}
 
-		ut_a(thr != NULL);
+		++it->second.n_recs;
+		it->second.last_trx_no = trx_no;
+
+		ut_a(!it->second.thr->is_active);
+
+		/* Get the purge node. */
+		node = (purge_node_t*) it->second.thr->child;
+		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
+
+		if (node->undo_recs == NULL) {
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
+		} else {
+			ut_a(!ib_vector_is_empty(node->undo_recs));
+		}
+
+		ib_vector_push(node->undo_recs, &purge_rec);
+
+		if (n_pages_handled >= batch_size) {
+
+			break;
+		}
 	}
 
 	ut_ad(trx_purge_check_limit());
 
+	if (!tables.empty()) {
+		trx_purge_update_table_stats(tables);
+	}
+
 	return(n_pages_handled);
 }
 
@@ -1166,13 +1617,21 @@ void
 trx_purge_truncate(void)
 /*====================*/
 {
+	purge_iter_t*	limit;
+
 	ut_ad(trx_purge_check_limit());
 
 	if (purge_sys->limit.trx_no == 0) {
-		trx_purge_truncate_history(&purge_sys->iter, purge_sys->view);
+		limit = &purge_sys->iter;
 	} else {
-		trx_purge_truncate_history(&purge_sys->limit, purge_sys->view);
+		limit = &purge_sys->limit;
 	}
+
+	trx_purge_truncate_history(limit, purge_sys->view);
+
+	trx_purge_mark_undo_for_truncate();
+
+	trx_purge_truncate_marked_undo(limit);
 }
 
 /*******************************************************************//**
@@ -42,23 +42,21 @@ UNIV_INTERN mysql_pfs_key_t	rseg_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
 /****************************************************************//**
-Creates a rollback segment header. This function is called only when
-a new rollback segment is created in the database.
+Creates a rollback segment header without assigning it to a slot in the
+trx system header.
 @return	page number of the created segment, FIL_NULL if fail */
 UNIV_INTERN
 ulint
-trx_rseg_header_create(
-/*===================*/
+trx_rseg_header_create_low(
+/*=======================*/
 	ulint	space,		/*!< in: space id */
 	ulint	zip_size,	/*!< in: compressed page size in bytes
 				or 0 for uncompressed pages */
 	ulint	max_size,	/*!< in: max size in pages */
-	ulint	rseg_slot_no,	/*!< in: rseg id == slot number in trx sys */
 	mtr_t*	mtr)		/*!< in: mtr */
 {
 	ulint		page_no;
 	trx_rsegf_t*	rsegf;
-	trx_sysf_t*	sys_header;
 	ulint		i;
 	buf_block_t*	block;
 
@@ -97,6 +95,35 @@ trx_rseg_header_create(
 		trx_rsegf_set_nth_undo(rsegf, i, FIL_NULL, mtr);
 	}
 
+	return(page_no);
+}
+
+/****************************************************************//**
+Creates a rollback segment header. This function is called only when
+a new rollback segment is created in the database.
+@return	page number of the created segment, FIL_NULL if fail */
+UNIV_INTERN
+ulint
+trx_rseg_header_create(
+/*===================*/
+	ulint	space,		/*!< in: space id */
+	ulint	zip_size,	/*!< in: compressed page size in bytes
+				or 0 for uncompressed pages */
+	ulint	max_size,	/*!< in: max size in pages */
+	ulint	rseg_slot_no,	/*!< in: rseg id == slot number in trx sys */
+	mtr_t*	mtr)		/*!< in: mtr */
+{
+	ulint		page_no;
+	trx_sysf_t*	sys_header;
+
+	page_no = trx_rseg_header_create_low(space, zip_size, max_size, mtr);
+
+	if (page_no == FIL_NULL) {
+		/* No space left */
+
+		return(FIL_NULL);
+	}
+
 	/* Add the rollback segment info to the free slot in
 	the trx system header */
 
@@ -108,22 +135,41 @@ trx_rseg_header_create(
 	return(page_no);
 }
 
-/***********************************************************************//**
-Free's an instance of the rollback segment in memory. */
+/****************************************************************//**
+Points the slot of a rollback segment in the trx system header to its
+header page, in a redo logged mini-transaction of its own. */
 UNIV_INTERN
 void
-trx_rseg_mem_free(
-/*==============*/
-	trx_rseg_t*	rseg)	/* in, own: instance to free */
+trx_rseg_header_set_slot(
+/*=====================*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no,	/*!< in: page number of the header */
+	ulint	rseg_slot_no)	/*!< in: rseg id == slot number in trx sys */
 {
-	trx_undo_t*	undo;
-	trx_undo_t*	next_undo;
+	mtr_t		mtr;
+	trx_sysf_t*	sys_header;
 
-	mutex_free(&rseg->mutex);
+	mtr_start(&mtr);
 
-	/* There can't be any active transactions. */
-	ut_a(UT_LIST_GET_LEN(rseg->update_undo_list) == 0);
-	ut_a(UT_LIST_GET_LEN(rseg->insert_undo_list) == 0);
+	sys_header = trx_sysf_get(&mtr);
+
+	trx_sysf_rseg_set_space(sys_header, rseg_slot_no, space, &mtr);
+	trx_sysf_rseg_set_page_no(sys_header, rseg_slot_no, page_no, &mtr);
+
+	mtr_commit(&mtr);
+}
+
+/***********************************************************************//**
+Frees the memory objects of the cached undo log segments of a rollback
+segment. */
+static
+void
+trx_rseg_free_cached_undos(
+/*=======================*/
+	trx_rseg_t*	rseg)	/*!< in/out: rollback segment */
+{
+	trx_undo_t*	undo;
+	trx_undo_t*	next_undo;
 
 	for (undo = UT_LIST_GET_FIRST(rseg->update_undo_cached);
 	     undo != NULL;
@@ -150,6 +196,23 @@ trx_rseg_mem_free(
 
 		trx_undo_mem_free(undo);
 	}
+}
+
+/***********************************************************************//**
+Free's an instance of the rollback segment in memory. */
+UNIV_INTERN
+void
+trx_rseg_mem_free(
+/*==============*/
+	trx_rseg_t*	rseg)	/* in, own: instance to free */
+{
+	mutex_free(&rseg->mutex);
+
+	/* There can't be any active transactions. */
+	ut_a(UT_LIST_GET_LEN(rseg->update_undo_list) == 0);
+	ut_a(UT_LIST_GET_LEN(rseg->insert_undo_list) == 0);
+
+	trx_rseg_free_cached_undos(rseg);
 
 	/* const_cast<trx_rseg_t*>() because this function is
 	like a destructor.  */
@@ -293,6 +356,55 @@ trx_rseg_create_instance(
 	}
 }
 
+/***************************************************************************
+Re-creates the header of a rollback segment after its tablespace was
+truncated, and resets the memory object to an empty rollback segment.
+The rollback segment must not be in use. The slot in the trx system
+header is left to the caller. */
+UNIV_INTERN
+void
+trx_rseg_reinit(
+/*============*/
+	trx_rseg_t*	rseg,		/*!< in/out: rollback segment */
+	mtr_t*		mtr)		/*!< in/out: mtr holding an x-latch
+					on the tablespace */
+{
+	ulint		page_no;
+	trx_rsegf_t*	rseg_header;
+
+	/* The rseg->mutex cannot be acquired here because the caller
+	holds the tablespace x-latch, which is lower in the latching
+	order. The rollback segment is not assigned to transactions
+	while rseg->skip_allocation is set, and purge is the caller. */
+	ut_ad(rseg->skip_allocation);
+	ut_a(rseg->trx_ref_count == 0);
+	ut_a(UT_LIST_GET_LEN(rseg->update_undo_list) == 0);
+	ut_a(UT_LIST_GET_LEN(rseg->insert_undo_list) == 0);
+	ut_a(rseg->last_page_no == FIL_NULL);
+
+	/* The slot in the trx system header is not written here: the
+	caller does not write redo log in mtr, and updates the slot with
+	trx_rseg_header_set_slot() after committing mtr. */
+	page_no = trx_rseg_header_create_low(
+		rseg->space, rseg->zip_size, ULINT_MAX, mtr);
+
+	ut_a(page_no != FIL_NULL);
+
+	trx_rseg_free_cached_undos(rseg);
+
+	rseg_header = trx_rsegf_get_new(
+		rseg->space, rseg->zip_size, page_no, mtr);
+
+	rseg->page_no = page_no;
+	rseg->max_size = mtr_read_ulint(
+		rseg_header + TRX_RSEG_MAX_SIZE, MLOG_4BYTES, mtr);
+	rseg->curr_size = 1;
+	rseg->last_page_no = FIL_NULL;
+	rseg->last_offset = 0;
+	rseg->last_trx_no = 0;
+	rseg->last_del_marks = FALSE;
+}
+
 /*********************************************************************
 Creates a rollback segment.
 @return pointer to new rollback segment if create successful */
@@ -119,6 +119,8 @@ static const ulint	FILE_FORMAT_NAME_N
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	file_format_max_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	trx_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	trx_sys_serial_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	trx_sys_rw_shard_mutex_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 #ifndef UNIV_HOTBACKUP
@@ -133,28 +135,41 @@ or create a table. */
 static	file_format_t	file_format_max;
 
 /*****************************************************************//**
-Writes the value of max_trx_id to the file based trx system header. */
+Writes a trx id or trx number that has been assigned to the file based trx
+system header, unless a bigger one has already been written. */
 UNIV_INTERN
 void
-trx_sys_flush_max_trx_id(void)
-/*==========================*/
+trx_sys_flush_max_trx_id(
+/*=====================*/
+	trx_id_t	id)	/*!< in: assigned trx id or trx number */
 {
 	mtr_t		mtr;
 	trx_sysf_t*	sys_header;
 
 	ut_ad(mutex_own(&trx_sys->mutex));
 
+	/* Ids and numbers are assigned concurrently: another thread may
+	have written a bigger value meanwhile. */
+	if (!trx_sys_max_trx_id_needs_flush(id)) {
+
+		return;
+	}
+
 	if (!srv_read_only_mode) {
 		mtr_start(&mtr);
 
 		sys_header = trx_sysf_get(&mtr);
 
 		mlog_write_ull(
-			sys_header + TRX_SYS_TRX_ID_STORE,
-			trx_sys->max_trx_id, &mtr);
+			sys_header + TRX_SYS_TRX_ID_STORE, id, &mtr);
 
 		mtr_commit(&mtr);
 	}
+
+	/* Publish the value only after the mini-transaction has been
+	committed, so that the redo log of any use of a trx id or trx
+	number below the new limit comes after it. */
+	trx_sys->max_trx_id_flushed = id;
 }
 
 /*****************************************************************//**
@@ -480,6 +495,9 @@ trx_sys_init_at_db_start(void)
 			  TRX_DESCR_ARRAY_INITIAL_SIZE));
 	trx_sys->descr_n_max = TRX_DESCR_ARRAY_INITIAL_SIZE;
 	trx_sys->descr_n_used = 0;
+	trx_sys->descr_n_retired = 0;
+	trx_sys->snapshot_version = 0;
+	trx_sys->n_view_scans = 0;
 	srv_descriptors_memory = TRX_DESCR_ARRAY_INITIAL_SIZE *
 		sizeof(trx_id_t);
 
@@ -496,11 +514,15 @@ trx_sys_init_at_db_start(void)
 	to the disk-based header! Thus trx id values will not overlap when
 	the database is repeatedly started! */
 
+	trx_sys->max_trx_id_flushed = mach_read_from_8(
+		sys_header + TRX_SYS_TRX_ID_STORE);
+
 	trx_sys->max_trx_id = 2 * TRX_SYS_TRX_ID_WRITE_MARGIN
-		+ ut_uint64_align_up(mach_read_from_8(sys_header
-						   + TRX_SYS_TRX_ID_STORE),
+		+ ut_uint64_align_up(trx_sys->max_trx_id_flushed,
 				     TRX_SYS_TRX_ID_WRITE_MARGIN);
 
+	trx_sys->serial_min_no = trx_sys->max_trx_id;
+
 	ut_d(trx_sys->rw_max_trx_id = trx_sys->max_trx_id);
 
 	UT_LIST_INIT(trx_sys->mysql_trx_list);
@@ -567,6 +589,61 @@ trx_sys_create(void)
 	trx_sys = static_cast<trx_sys_t*>(mem_zalloc(sizeof(*trx_sys)));
 
 	mutex_create(trx_sys_mutex_key, &trx_sys->mutex, SYNC_TRX_SYS);
+
+	mutex_create(trx_sys_serial_mutex_key, &trx_sys->serial_mutex,
+		     SYNC_TRX_SYS_SERIAL);
+
+	for (ulint i = 0; i < TRX_SYS_N_RW_SHARDS; i++) {
+		mutex_create(trx_sys_rw_shard_mutex_key,
+			     &trx_sys->rw_shards[i].mutex,
+			     SYNC_TRX_SYS_RW_SHARD);
+	}
+}
+
+/****************************************************************//**
+Adds a transaction that has been assigned an id to its shard of
+trx_sys->rw_shards. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_add(
+/*===============*/
+	trx_t*		trx)	/*!< in: read-write transaction */
+{
+	trx_rw_shard_t*	shard;
+
+	ut_ad(trx->id != 0);
+	ut_ad(!trx->in_rw_shard);
+
+	shard = &trx_sys->rw_shards[trx->id % TRX_SYS_N_RW_SHARDS];
+
+	mutex_enter(&shard->mutex);
+
+	UT_LIST_ADD_FIRST(rw_shard_list, shard->trx_list, trx);
+	ut_d(trx->in_rw_shard = TRUE);
+
+	mutex_exit(&shard->mutex);
+}
+
+/****************************************************************//**
+Removes a transaction from its shard of trx_sys->rw_shards. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_remove(
+/*==================*/
+	trx_t*		trx)	/*!< in: read-write transaction */
+{
+	trx_rw_shard_t*	shard;
+
+	ut_ad(trx->in_rw_shard);
+
+	shard = &trx_sys->rw_shards[trx->id % TRX_SYS_N_RW_SHARDS];
+
+	mutex_enter(&shard->mutex);
+
+	UT_LIST_REMOVE(rw_shard_list, shard->trx_list, trx);
+	ut_d(trx->in_rw_shard = FALSE);
+
+	mutex_exit(&shard->mutex);
 }
 
 /*****************************************************************//**
@@ -1192,12 +1269,23 @@ trx_sys_close(void)
 	ut_a(UT_LIST_GET_LEN(trx_sys->view_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->rw_trx_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->mysql_trx_list) == 0);
+	ut_a(UT_LIST_GET_LEN(trx_sys->trx_serial_list) == 0);
 
+	for (i = 0; i < TRX_SYS_N_RW_SHARDS; i++) {
+		ut_a(UT_LIST_GET_LEN(trx_sys->rw_shards[i].trx_list) == 0);
+		mutex_free(&trx_sys->rw_shards[i].mutex);
+	}
+
+	mutex_free(&trx_sys->serial_mutex);
 	mutex_free(&trx_sys->mutex);
 
 	ut_ad(trx_sys->descr_n_used == 0);
 	ut_free(trx_sys->descriptors);
 
+	for (ulint i = 0; i < trx_sys->descr_n_retired; i++) {
+		ut_free(trx_sys->descr_retired[i]);
+	}
+
 	mem_free(trx_sys);
 
 	trx_sys = NULL;
@@ -36,6 +36,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "que0que.h"
 #include "lock0lock.h"
 #include "trx0roll.h"
+#include "row0mysql.h"
 #include "usr0sess.h"
 #include "read0read.h"
 #include "srv0srv.h"
@@ -110,6 +111,23 @@ trx_descr_cmp(
 	return 0;
 }
 
+/*************************************************************//**
+Sets trx_sys->serial_min_no from the head of trx_sys->trx_serial_list, or
+from trx_sys->max_trx_id if the list is empty: trx numbers assigned later
+are not smaller. */
+UNIV_INLINE
+void
+trx_sys_update_serial_min_no(void)
+/*==============================*/
+{
+	const trx_t*	trx = UT_LIST_GET_FIRST(trx_sys->trx_serial_list);
+
+	ut_ad(mutex_own(&trx_sys->serial_mutex));
+
+	trx_sys->serial_min_no = trx != NULL
+		? trx->no : trx_sys->max_trx_id;
+}
+
 /*************************************************************//**
 Reserve a slot for a given trx in the global descriptors array. */
 UNIV_INLINE
@@ -138,14 +156,25 @@ trx_reserve_descriptor(
 #else
 	if (UNIV_UNLIKELY(n_used > n_max)) {
 #endif
+		trx_id_t*	old_descr = trx_sys->descriptors;
+
 		n_max = n_max * 2;
 
-		trx_sys->descriptors = static_cast<trx_id_t*>(
-			ut_realloc(trx_sys->descriptors,
-				   n_max * sizeof(trx_id_t)));
+		/* Read views copy the array without trx_sys->mutex, so the
+		old array cannot be freed or reallocated in place. Publish
+		the new array before the new number of used elements. */
+		descr = static_cast<trx_id_t*>(
+			ut_malloc(n_max * sizeof(trx_id_t)));
+		memcpy(descr, old_descr, (n_used - 1) * sizeof(trx_id_t));
 
+		trx_sys->descriptors = descr;
+		os_wmb;
+
+		ut_a(trx_sys->descr_n_retired < TRX_DESCR_ARRAY_MAX_RETIRED);
+		trx_sys->descr_retired[trx_sys->descr_n_retired++] = old_descr;
+
+		srv_descriptors_memory += n_max * sizeof(trx_id_t);
 		trx_sys->descr_n_max = n_max;
-		srv_descriptors_memory = n_max * sizeof(trx_id_t);
 	}
 
 	descr = trx_sys->descriptors + n_used - 1;
@@ -193,31 +222,52 @@ trx_release_descriptor(
 
 	ut_ad(mutex_own(&trx_sys->mutex));
 
-	if (UNIV_LIKELY(trx->in_trx_serial_list)) {
-
-		UT_LIST_REMOVE(trx_serial_list, trx_sys->trx_serial_list,
-			       trx);
-		trx->in_trx_serial_list = 0;
-	}
+	trx_sys_snapshot_change_start();
 
 	descr = trx_find_descriptor(trx_sys->descriptors,
 				    trx_sys->descr_n_used,
 				    trx->id);
 
-	if (UNIV_UNLIKELY(descr == NULL)) {
+	if (UNIV_LIKELY(descr != NULL)) {
 
-		return;
+		size = (trx_sys->descriptors + trx_sys->descr_n_used - 1
+			- descr) * sizeof(trx_id_t);
+
+		if (UNIV_LIKELY(size > 0)) {
+
+			ut_memmove(descr, descr + 1, size);
+		}
+
+		trx_sys->descr_n_used--;
 	}
 
-	size = (trx_sys->descriptors + trx_sys->descr_n_used - 1 - descr) *
-		sizeof(trx_id_t);
+	trx_sys_snapshot_change_end();
+}
 
-	if (UNIV_LIKELY(size > 0)) {
+/*************************************************************//**
+Removes a transaction from trx_sys->trx_serial_list. This must be done
+after its descriptor has been released, see trx_sys_t::serial_min_no. */
+static
+void
+trx_serial_list_remove(
+/*===================*/
+	trx_t*	trx)	/*!< in/out: transaction */
+{
+	/* Only the thread committing or freeing the transaction
+	changes this flag. */
+	if (!trx->in_trx_serial_list) {
 
-		ut_memmove(descr, descr + 1, size);
+		return;
 	}
 
-	trx_sys->descr_n_used--;
+	mutex_enter(&trx_sys->serial_mutex);
+
+	UT_LIST_REMOVE(trx_serial_list, trx_sys->trx_serial_list, trx);
+	trx->in_trx_serial_list = 0;
+
+	trx_sys_update_serial_min_no();
+
+	mutex_exit(&trx_sys->serial_mutex);
 }
 
 /****************************************************************//**
@@ -252,6 +302,9 @@ trx_create(void)
 
 	trx->check_foreigns = TRUE;
 	trx->check_unique_secondary = TRUE;
+	trx->deadlock_detect = TRUE;
+	trx->read_ahead_depth = 0;
+	trx->clust_prefetch_rows = 0;
 
 	trx->dict_operation = TRX_DICT_OP_NONE;
 
@@ -385,6 +438,10 @@ trx_free_low(
 
 	read_view_free(trx->prebuilt_view);
 
+	if (trx->column_zip != NULL) {
+		row_mysql_column_zip_free(trx);
+	}
+
 	mem_free(trx);
 }
 
@@ -400,6 +457,8 @@ trx_free(
 	trx_release_descriptor(trx);
 	mutex_exit(&trx_sys->mutex);
 
+	trx_serial_list_remove(trx);
+
 	trx_free_low(trx);
 }
 
@@ -469,6 +528,8 @@ trx_free_prepared(
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
 
+	trx_sys_rw_trx_remove(trx);
+
 	/* Undo trx_resurrect_table_locks(). */
 	UT_LIST_INIT(trx->lock.trx_locks);
 
@@ -476,6 +537,8 @@ trx_free_prepared(
 	trx_release_descriptor(trx);
 	mutex_exit(&trx_sys->mutex);
 
+	trx_serial_list_remove(trx);
+
 	trx_free_low(trx);
 }
 
@@ -557,6 +620,8 @@ trx_list_rw_insert_ordered(
 
 	ut_ad(!trx->in_rw_trx_list);
 	ut_d(trx->in_rw_trx_list = TRUE);
+
+	trx_sys_rw_trx_add(trx);
 }
 
 /****************************************************************//**
@@ -948,18 +1013,36 @@ trx_assign_rseg_low(
 
 	/* Skip the system tablespace if we have more than one tablespace
 	defined for rollback segments. We want all UNDO records to be in
-	the non-system tablespaces. */
+	the non-system tablespaces. Also skip the rollback segments of
+	an UNDO tablespace that is about to be truncated; purge only marks
+	a tablespace when the rollback segments of another one remain. */
 
-	do {
-		rseg = trx_sys->rseg_array[i];
-		ut_a(rseg == NULL || i == rseg->id);
+	for (;;) {
+		do {
+			rseg = trx_sys->rseg_array[i];
+			ut_a(rseg == NULL || i == rseg->id);
+
+			i = (rseg == NULL || i + 1 == TRX_SYS_N_RSEGS)
+				? 0 : i + 1;
 
-		i = (rseg == NULL) ? 0 : i + 1;
+		} while (rseg == NULL
+			 || rseg->skip_allocation
+			 || (rseg->space == 0
+			     && n_tablespaces > 0
+			     && trx_sys->rseg_array[1] != NULL));
 
-	} while (rseg == NULL
-		 || (rseg->space == 0
-		     && n_tablespaces > 0
-		     && trx_sys->rseg_array[1] != NULL));
+		mutex_enter(&rseg->mutex);
+
+		if (!rseg->skip_allocation) {
+			rseg->trx_ref_count++;
+			mutex_exit(&rseg->mutex);
+			break;
+		}
+
+		/* The tablespace was marked for truncation after
+		the check above. */
+		mutex_exit(&rseg->mutex);
+	}
 
 	return(rseg);
 }
@@ -983,8 +1066,10 @@ trx_assign_rseg(
 
 	if (trx->id == 0) {
 		mutex_enter(&trx_sys->mutex);
+		trx_sys_snapshot_change_start();
 		trx->id = trx_sys_get_new_trx_id();
 		trx_reserve_descriptor(trx);
+		trx_sys_snapshot_change_end();
 		UT_LIST_ADD_FIRST(trx_list, trx_sys->rw_trx_list, trx);
 		ut_d(trx->in_rw_trx_list = TRUE);
 		ut_ad(trx_sys_validate_trx_list());
@@ -995,6 +1080,7 @@ trx_assign_rseg(
 #endif /* UNIV_DEBUG */
 		mutex_exit(&trx_sys->mutex);
 
+		trx_sys_rw_trx_add(trx);
 	}
 }
 
@@ -1068,12 +1154,16 @@ trx_start_low(
 
 		trx->state = TRX_STATE_ACTIVE;
 
+		trx_sys_snapshot_change_start();
+
 		trx->id = trx_sys_get_new_trx_id();
 
 		UT_LIST_ADD_FIRST(trx_list, trx_sys->rw_trx_list, trx);
 
 		trx_reserve_descriptor(trx);
 
+		trx_sys_snapshot_change_end();
+
 		ut_ad(trx->rseg != 0
 		      || srv_read_only_mode
 		      || srv_force_recovery >= SRV_FORCE_NO_TRX_UNDO);
@@ -1087,6 +1177,8 @@ trx_start_low(
 		}
 #endif /* UNIV_DEBUG */
 		mutex_exit(&trx_sys->mutex);
+
+		trx_sys_rw_trx_add(trx);
 	} else {
 		trx->id = 0;
 		trx->state = TRX_STATE_ACTIVE;
@@ -1111,9 +1203,16 @@ trx_serialisation_number_get(
 
 	ut_ad(mutex_own(&rseg->mutex));
 
-	mutex_enter(&trx_sys->mutex);
+	/* The transaction number is assigned and the transaction is
+	linked to trx_serial_list under trx_sys->serial_mutex only, so
+	that commits do not contend on trx_sys->mutex. Read views get
+	trx_sys->serial_min_no before copying the descriptors, and
+	trx_release_descriptor() is called before the transaction is
+	removed from the list, see trx_sys_t::serial_min_no. */
+
+	mutex_enter(&trx_sys->serial_mutex);
 
-	trx->no = trx_sys_get_new_trx_id();
+	trx->no = trx_sys_get_new_trx_no();
 
 	if (UNIV_LIKELY(trx->in_trx_serial_list == 0)) {
 
@@ -1123,6 +1222,8 @@ trx_serialisation_number_get(
 		trx->in_trx_serial_list = 1;
 	}
 
+	trx_sys_update_serial_min_no();
+
 	/* If the rollack segment is not empty then the
 	new trx_t::no can't be less than any trx_t::no
 	already in the rollback segment. User threads only
@@ -1137,19 +1238,19 @@ trx_serialisation_number_get(
 
 		mutex_enter(&purge_sys->bh_mutex);
 
-		/* This is to reduce the pressure on the trx_sys_t::mutex
-		though in reality it should make very little (read no)
-		difference because this code path is only taken when the
-		rbs is empty. */
+		/* This is to reduce the pressure on the
+		trx_sys_t::serial_mutex though in reality it should make
+		very little (read no) difference because this code path
+		is only taken when the rbs is empty. */
 
-		mutex_exit(&trx_sys->mutex);
+		mutex_exit(&trx_sys->serial_mutex);
 
 		ptr = ib_bh_push(purge_sys->ib_bh, &rseg_queue);
 		ut_a(ptr);
 
 		mutex_exit(&purge_sys->bh_mutex);
 	} else {
-		mutex_exit(&trx_sys->mutex);
+		mutex_exit(&trx_sys->serial_mutex);
 	}
 }
 
@@ -1400,8 +1501,10 @@ trx_commit_in_memory(
 			trx->state = TRX_STATE_NOT_STARTED;
 			MONITOR_INC(MONITOR_TRX_RO_COMMIT);
 		} else {
+			trx_sys_rw_trx_remove(trx);
+
 			mutex_enter(&trx_sys->mutex);
-			/* The following also removes trx from trx_serial_list */
+
 			trx_release_descriptor(trx);
 
 			check_trx_state(trx);
@@ -1421,6 +1524,8 @@ trx_commit_in_memory(
 			view. */
 			trx->state = TRX_STATE_NOT_STARTED;
 			mutex_exit(&trx_sys->mutex);
+
+			trx_serial_list_remove(trx);
 		}
 	}
 
@@ -1491,6 +1596,17 @@ trx_commit_in_memory(
 	trx_named_savept_t*	savep = UT_LIST_GET_FIRST(trx->trx_savepoints);
 	trx_roll_savepoints_free(trx, savep);
 
+	if (trx->rseg != NULL && !trx->is_recovered) {
+		trx_rseg_t*	rseg = trx->rseg;
+
+		/* Recovered transactions were not assigned their rollback
+		segment by trx_assign_rseg_low(). */
+		mutex_enter(&rseg->mutex);
+		ut_ad(rseg->trx_ref_count > 0);
+		rseg->trx_ref_count--;
+		mutex_exit(&rseg->mutex);
+	}
+
 	trx->rseg = NULL;
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
@@ -1636,6 +1752,8 @@ trx_cleanup_at_db_startup(
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
 
+	trx_sys_rw_trx_remove(trx);
+
 	mutex_enter(&trx_sys->mutex);
 
 	ut_a(!trx->read_only);
@@ -1652,6 +1770,8 @@ trx_cleanup_at_db_startup(
 
 	mutex_exit(&trx_sys->mutex);
 
+	trx_serial_list_remove(trx);
+
 	/* Change the transaction state without mutex protection, now
 	that it no longer is in the trx_list. Recovered transactions
 	are never placed in the mysql_trx_list. */
@@ -2557,6 +2677,8 @@ trx_set_rw_mode(
 
 	mutex_enter(&trx_sys->mutex);
 
+	trx_sys_snapshot_change_start();
+
 	ut_ad(trx->id == 0);
 	trx->id = trx_sys_get_new_trx_id();
 
@@ -2577,5 +2699,9 @@ trx_set_rw_mode(
 
 	trx_reserve_descriptor(trx);
 
+	trx_sys_snapshot_change_end();
+
 	mutex_exit(&trx_sys->mutex);
+
+	trx_sys_rw_trx_add(trx);
 }